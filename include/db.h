@@ -231,10 +231,33 @@ extern "C" {
 
 struct Db;
 struct DbItem;
+struct DbCached;
+struct DbSave;
 struct DbModel;
 struct DbParams;
 
-#define DB_VERSION          2
+/**
+    Prepared query returned by dbPrepare
+    @stability Evolving
+ */
+typedef struct DbQuery DbQuery;
+
+/**
+    Cursor returned by dbCursorOpen
+    @stability Evolving
+ */
+typedef struct DbCursor DbCursor;
+
+#define DB_VERSION          3                           /**< Segmented database file format */
+#define DB_LEGACY_VERSION   2                           /**< Unsegmented database and journal format */
+#define DB_JOURNAL_VERSION  3                           /**< Journal format with checksummed records */
+
+/*
+    Journal sync policies for dbSetJournalParams
+ */
+#define DB_SYNC_ALWAYS      0                           /**< Write and fsync each change */
+#define DB_SYNC_BATCH       1                           /**< Group changes and write with one fsync */
+#define DB_SYNC_NONE        2                           /**< Write each change without fsync */
 
 #ifndef DB_MAX_LOG_AGE
     #define DB_MAX_LOG_AGE  (60 * TPS)                  /**< Maximum age of log file */
@@ -242,6 +265,18 @@ struct DbParams;
 #ifndef DB_MAX_LOG_SIZE
     #define DB_MAX_LOG_SIZE (1024 * 1024)               /**< Maximum journal size */
 #endif
+#ifndef DB_MAX_DELTA
+    #define DB_MAX_DELTA    50                          /**< Max delta segments as a percent of the base */
+#endif
+#ifndef DB_SAVE_YIELD
+    #define DB_SAVE_YIELD   500                         /**< Items written between yields in background saves */
+#endif
+#ifndef DB_SYNC_DELAY
+    #define DB_SYNC_DELAY   10                          /**< Maximum time to batch journal changes */
+#endif
+#ifndef DB_SYNC_COUNT
+    #define DB_SYNC_COUNT   64                          /**< Maximum journal changes in a batch */
+#endif
 #ifndef DB_MAX_KEY
     #define DB_MAX_KEY      1024                        /**< Maximum sort key length */
 #endif
@@ -284,6 +319,7 @@ typedef struct Db {
     char *path;             /**< On-disk path */
     RHash *models;          /**< List of schema models */
     RbTree *primary;        /**< Red/black tree primary index */
+    RHash *indexes;         /**< Secondary indexes (DbIndex) keyed by index name */
     RList *callbacks;       /**< Database change notification triggers */
     Json *context;          /**< Global context properties applied to all API operations */
     char *error;            /**< API error message */
@@ -291,13 +327,34 @@ typedef struct Db {
     FILE *journal;          /**< Journal file descriptor */
     int flags;              /**< Database configuration flags (reserved for future use) */
     char *journalPath;      /**< On-disk journal filename */
+    char *prevJournalPath;  /**< Journal of changes made before a background save started */
+    struct DbSave *save;    /**< Background save in progress */
+    void *map;              /**< Memory mapped database file referenced by loaded items (DB_OPEN_MMAP) */
+    size_t mapSize;         /**< Size of the memory mapped database file */
     size_t journalSize;      /**< Current size of journal file */
     Ticks journalCreated;   /**< When journal file recreated */
     size_t maxJournalSize;   /**< Maximum size of the journal before saving */
     Ticks maxJournalAge;    /**< Maximum age of journal file before saving */
     REvent journalEvent;    /**< Timeout for journal save */
+    RBuf *journalBuf;       /**< Journal records pending write */
+    REvent syncEvent;       /**< Timeout for writing batched journal records */
+    Ticks syncDelay;        /**< Maximum time to batch journal records (DB_SYNC_BATCH) */
+    int syncCount;          /**< Maximum journal records to batch (DB_SYNC_BATCH) */
+    int pending;            /**< Number of journal records pending write */
+    int journalSync;        /**< Journal sync policy: DB_SYNC_ALWAYS, DB_SYNC_BATCH or DB_SYNC_NONE */
     REvent commitEvent;     /**< Timeout for commit event */
     RHash *changes;         /**< Hash of pending changes */
+    RHash *dirty;           /**< Keys of items changed since the last save */
+    size_t baseSize;        /**< Size of the database file up to the end of the base snapshot */
+    size_t deltaSize;       /**< Size of delta segments appended after the base snapshot */
+    size_t saveBytes;       /**< Bytes written by the last save */
+    uint64 generation;      /**< Incremented when items are inserted or removed from an index */
+    struct DbCached *cache; /**< Most recently used parsed item. Circular list, cache->prev is the oldest */
+    size_t cacheSize;       /**< Estimated memory used by parsed item JSON in the cache. Zero if unlimited */
+    size_t cacheMax;        /**< Parsed item cache budget in bytes. Zero for unlimited */
+    uint64 cacheHits;       /**< Item accesses that found parsed JSON */
+    uint64 cacheMisses;     /**< Item accesses that parsed the item value */
+    uint64 cacheEvictions;  /**< Parsed items converted back to strings to meet the budget */
     Ticks due;              /**< When delayed commits are due */
     int code;               /**< API error code */
     bool journalError : 1;  /**< Journal I/O error */
@@ -338,6 +395,19 @@ typedef struct DbModel {
     RHash *fields;          /**< Hash of model fields */
 } DbModel;
 
+/*
+    Secondary index
+    @description Secondary indexes are declared in the schema "indexes" collection and are maintained
+    locally if one or more models define the index sort field. Index entries reference primary items.
+    Items that do not define the index sort field are not indexed (sparse index).
+    @internal
+ */
+typedef struct DbIndex {
+    cchar *name;            /**< Index name */
+    cchar *sort;            /**< Name of the index sort key field */
+    RbTree *tree;           /**< Red/black tree of index entries */
+} DbIndex;
+
 typedef int (*DbWhere)(Json *json, int nid, cvoid *arg);
 
 /**
@@ -352,8 +422,8 @@ typedef struct DbParams {
     bool upsert : 1;         /**< Update on create if present. Create on update if missing */
     int delay;               /**< Delay before commmiting changes (Delay in msec, -1 == nocommit) */
     int limit;               /**< Limit the number of returned or removed items */
-    cchar *index;            /**< Index name. Default to "primary". Currently only supports
-                                "primary" */
+    cchar *index;            /**< Index name. Default to "primary". Secondary indexes are used by
+                                the get and find APIs only. Mutations always use the primary index */
     cchar *next;             /**< Pagination token starting point for the next page of results */
     DbWhere where;           /**< Where query expression callback */
     cvoid *arg;              /**< Argument to where callback */
@@ -370,6 +440,7 @@ typedef struct DbItem {
     char *key;               /**< Indexed name of the item. Used as the sort key */
     char *value;             /**< Text value of the item (JSON string), may be stale if json set */
     Json *json;              /**< Parsed JSON value of the item, takes precedence over value */
+    struct DbCached *cached; /**< Parsed JSON cache entry */
     uint allocatedName : 1;  /**< The name is allocated and must be freed when removed */
     uint allocatedValue : 1; /**< The value is allocated and must be freed when removed */
     uint delayed : 1;        /**< Update to journal and cloud delayed */
@@ -510,8 +581,8 @@ PUBLIC double dbFieldDouble(const DbItem *item, cchar *fieldName);
         \n
         int limit;        // Limit the number of returned or removed items.
         \n
-        cchar *index;     // Name of the index to use. Defaults to "primary". Currently only
-           supports "primary".
+        cchar *index;     // Name of the index to use. Defaults to "primary". Secondary indexes
+           declared in the schema "indexes" are searched using the index sort key property.
         \n
         cchar *next;      // Next pagination token to use as the starting point for the next page of
            results.
@@ -525,6 +596,92 @@ PUBLIC double dbFieldDouble(const DbItem *item, cchar *fieldName);
  */
 PUBLIC RList *dbFind(Db *db, cchar *model, Json *props, DbParams *params);
 
+/**
+    Prepare a query for repeated execution
+    @description Validates, templates and compiles the query properties once so that repeated queries
+        via dbFindPrepared avoid the per-call setup of dbFind. Item expiry is evaluated using a single
+        timestamp per execution.
+    @param db Database instance returned via #dbOpen
+    @param model Name of the schema model for matching items. Set to NULL if no model is required.
+    @param props JSON object containing item properties to match. See #dbFind for details.
+    @param params List of API parameters. Use the macro DB_PARAMS(key = value, ...) to specify.
+        The index, where and arg parameters are retained by the query.
+    @return A prepared query. Caller must free using dbFreeQuery before closing the database.
+    @stability Evolving
+ */
+PUBLIC DbQuery *dbPrepare(Db *db, cchar *model, Json *props, DbParams *params);
+
+/**
+    Find matching items using a prepared query
+    @param query Query returned via #dbPrepare
+    @param params Optional API parameters for this execution. Use the macro DB_PARAMS(key = value, ...)
+        to specify.
+        \n
+        int limit;        // Limit the number of returned items.
+        \n
+        cchar *next;      // Next pagination token to use as the starting point for the next page of
+           results.
+        \n
+    @return A list of matching items. Caller must free the result using rFreeList.
+    @stability Evolving
+ */
+PUBLIC RList *dbFindPrepared(DbQuery *query, DbParams *params);
+
+/**
+    Free a prepared query
+    @param query Query returned via #dbPrepare
+    @stability Evolving
+ */
+PUBLIC void dbFreeQuery(DbQuery *query);
+
+/**
+    Open a cursor to iterate over matching items
+    @description Cursors walk the index lazily and return one matching item at a time so that
+        large result sets do not need to be collected into a list. The database may be modified
+        while a cursor is open. The walk resumes after the last returned item.
+    @param db Database instance returned via #dbOpen
+    @param model Name of the schema model for matching items. Set to NULL if no model is required.
+    @param props JSON object containing item properties to match. See #dbFind for details.
+    @param params List of API parameters. Use the macro DB_PARAMS(key = value, ...) to specify.
+        \n
+        int limit;        // Limit the number of returned items.
+        \n
+        cchar *index;     // Name of the index to use. Defaults to "primary".
+        \n
+        cchar *next;      // Pagination token to use as the starting point.
+        \n
+        DbWhere where;    // Where query expression callback function.
+        \n
+    @return A cursor. Caller must close using dbCursorClose before closing the database.
+    @stability Evolving
+ */
+PUBLIC DbCursor *dbCursorOpen(Db *db, cchar *model, Json *props, DbParams *params);
+
+/**
+    Get the next matching item from a cursor
+    @description Expired items passed over by the walk are removed before this call returns.
+    @param cursor Cursor returned via #dbCursorOpen
+    @return The next matching item or NULL if there are no more items. Caller must not free.
+    @stability Evolving
+ */
+PUBLIC const DbItem *dbCursorNext(DbCursor *cursor);
+
+/**
+    Get the pagination token for the next page of results
+    @param cursor Cursor returned via #dbCursorOpen
+    @return The token to provide as the "next" parameter to resume after the last returned item.
+        Returns NULL if all matching items have been returned. Caller must not free.
+    @stability Evolving
+ */
+PUBLIC cchar *dbCursorToken(DbCursor *cursor);
+
+/**
+    Close a cursor
+    @param cursor Cursor returned via #dbCursorOpen
+    @stability Evolving
+ */
+PUBLIC void dbCursorClose(DbCursor *cursor);
+
 /**
     Find the first matching item.
     @param db Database instance returned via #dbOpen
@@ -784,13 +941,18 @@ PUBLIC int dbLoadDataItems(Db *db, Json *json, JsonNode *parent);
  */
 #define DB_READ_ONLY  0x1   /**< Don't write to disk */
 #define DB_OPEN_RESET 0x2   /**< Reset (erase) database on open */
+#define DB_OPEN_MMAP  0x4   /**< Load the database by memory mapping the file (Unix only) */
 
 /**
     Open a database
     @param path Filename for from which to load and save the database when calling dbSave. On open,
        an initial load is performed from the file at path.
     @param schema OneTable data schema describing the indexes and data models
-    @param flags Reserved. Set to zero.
+    @param flags Set to DB_READ_ONLY to not write to disk, DB_OPEN_RESET to erase the database on open
+       or DB_OPEN_MMAP to load by memory mapping the database file. With DB_OPEN_MMAP, loaded items
+       reference their keys and values in the mapped file and are only copied when modified. This
+       gives fast startup and a smaller heap for read-mostly data. The mapping is retained until the
+       database is closed.
     @stability Evolving
     @see dbClose
  */
@@ -848,9 +1010,20 @@ PUBLIC int dbRemove(Db *db, cchar *model, Json *props, DbParams *params);
 
 /**
     Save the database
+    @description The database file is a base snapshot followed by delta segments. When saving to the
+    database path, only the items changed since the last save are appended as a delta segment. A full
+    snapshot is written when the delta segments exceed DB_MAX_DELTA percent of the base snapshot or
+    when saving to another filename.
+    \n\n
+    Saves triggered automatically by the journal size or age that require a full snapshot are written
+    by a background fiber that yields every DB_SAVE_YIELD items. Changes made meanwhile go to a fresh
+    journal and are appended as a delta when the snapshot completes. If a background save is in
+    progress, dbSave on the database path returns immediately as the background save will include
+    all changes.
     @param db Database instance
     @param filename Optional filename to save data to. If set to NULL, the data is saved to the name
        given when opening the database via #dbOpen.
+    @return Zero if successful, otherwise a negative error code
     @stability Evolving
  */
 PUBLIC int dbSave(Db *db, cchar *filename);
@@ -982,19 +1155,41 @@ PUBLIC const DbItem *dbSetNum(Db *db, cchar *model, cchar *fieldName, int64 valu
     @stability Evolving
  */
 PUBLIC const DbItem *dbSetString(Db *db, cchar *model, cchar *fieldName, cchar *value, Json *props, DbParams *params);
+/**
+    Set the parsed item cache budget
+    @description Items are stored as compact JSON strings and parsed on first access. The parsed
+    JSON is kept in a least recently used cache. When the estimated memory used by parsed items
+    exceeds the budget, the least recently used items are converted back to strings.
+    Cache activity is reported via the Db cacheHits, cacheMisses and cacheEvictions fields.
+    \n\n
+    With a budget, the JSON returned by dbJson and the values returned by dbField are valid only
+    until the next database call.
+    @param db Database instance returned from dbOpen
+    @param size Maximum memory in bytes for parsed items. Set to zero for no limit (default).
+    @stability Evolving
+ */
+PUBLIC void dbSetCacheSize(Db *db, size_t size);
+
 /**
     Configure database journaling parameters
     @description Sets the journaling behavior for database persistence. The journal records
     changes before they are written to the main database file, providing crash recovery capability.
     Changes are automatically committed when either the delay time expires or the journal
     reaches the maximum size limit.
+    \n\n
+    The sync policy controls how journal records reach the disk. DB_SYNC_ALWAYS writes and fsyncs
+    each change. DB_SYNC_BATCH groups changes made within DB_SYNC_DELAY milliseconds (or up to
+    DB_SYNC_COUNT changes) and appends them with a single write and fsync. DB_SYNC_NONE writes each
+    change but leaves flushing to the operating system. Each journal record has a checksum so a torn
+    final record is discarded on recovery.
     @param db Database instance returned from dbOpen
     @param delay Maximum time in milliseconds to delay before committing journal changes to
     the persistent database file
     @param size Maximum journal file size in bytes before flushing to the persistent database file
+    @param sync Journal sync policy. Set to DB_SYNC_ALWAYS, DB_SYNC_BATCH or DB_SYNC_NONE.
     @stability Evolving
  */
-PUBLIC void dbSetJournalParams(Db *db, Ticks delay, size_t size);
+PUBLIC void dbSetJournalParams(Db *db, Ticks delay, size_t size, int sync);
 
 /**
     Add a database change trigger callback
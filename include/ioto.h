@@ -658,6 +658,18 @@ PUBLIC ssize webWriteItem(Web *web, const DbItem *item);
  */
 PUBLIC ssize webWriteItems(Web *web, RList *items);
 
+/**
+    Write the items from a database cursor as part of a web response
+    @description This routine serializes items one at a time as they are returned by the cursor so that
+        memory use does not grow with the number of items. If the response length is not defined, the
+        response is sent using chunked transfer encoding. It will NOT call webFinalize.
+    @param web Web object
+    @param cursor Database cursor returned via dbCursorOpen. The caller must close the cursor.
+    @return The number of bytes written.
+    @stability Evolving
+ */
+PUBLIC ssize webWriteCursor(Web *web, DbCursor *cursor);
+
 /**
     Write a database item response.
     @description This routine serialize a database item into JSON and validates the item's fields
@@ -55,6 +55,7 @@ extern "C" {
 /******************************** JSON ****************************************/
 
 struct Json;
+struct JsonIndex;
 struct JsonNode;
 
 #ifndef JSON_BLEND
@@ -65,6 +66,14 @@ struct JsonNode;
     #define ME_JSON_MAX_NODES    100000               /**< Maximum number of elements in json text */
 #endif
 
+#ifndef ME_JSON_INDEX
+    #define ME_JSON_INDEX        32                   /**< Children in an object before lookups build a hash index */
+#endif
+
+#ifndef ME_JSON_ARENA
+    #define ME_JSON_ARENA        4096                 /**< Default size of arena chunks for names and values */
+#endif
+
 #ifndef JSON_MAX_LINE_LENGTH
     #define JSON_MAX_LINE_LENGTH 120                  /**< Default Maximum length of a line for compacted output */
 #endif
@@ -240,6 +249,11 @@ struct JsonNode;
     ensures that references returned by jsonGet() and jsonGetNode() remain valid, making it
     safe to hold multiple references without concern for tree modifications.
 
+    Read APIs may update internal state even when given a const Json. Lookups in objects with more than
+    ME_JSON_INDEX properties build and extend property hash indexes, and numeric getters cache parsed numbers
+    in the nodes. This happens for locked objects too. A Json object must not be accessed by multiple threads
+    at the same time, including concurrent readers, without external locking.
+
     Memory management is handled automatically through the R runtime. The entire tree is freed
     when jsonFree() is called on the root JSON object.
     @stability Evolving
@@ -257,8 +271,11 @@ typedef struct Json {
     char *property;                  /**< Internal buffer for building property names during parsing */
     size_t propertyLength;           /**< Current allocated size of the property buffer */
     char *value;                     /**< Cached serialized string result from jsonString() calls */
+    struct JsonIndex **index;        /**< Property hash indexes for large objects by object node ID (internal) */
+    struct JsonArena *arena;         /**< Arena for allocated names and values if enabled (internal) */
     int size;                        /**< Total allocated capacity of the nodes array */
     int count;                       /**< Number of nodes currently used in the tree */
+    int builder;                     /**< Index + 1 of the innermost open object or array in builder mode */
     int lineNumber : 16;             /**< Current line number during parsing (for error reporting) */
     uint lock : 1;                   /**< Lock flag preventing modifications when set */
     uint flags : 7;                  /**< Internal parser flags (reserved for library use) */
@@ -281,7 +298,11 @@ typedef struct Json {
 
     Memory management for name and value strings is tracked through the allocatedName
     and allocatedValue flags, allowing the library to optimize memory usage by avoiding
-    unnecessary string copies when possible.
+    unnecessary string copies when possible. Strings allocated from an arena (see jsonSetArena) are not
+    flagged as they are freed with the arena.
+
+    Numeric getters cache the parsed number in the node so repeated reads do not reparse the value string.
+    The cache is cleared whenever the value changes.
     @stability Evolving
  */
 typedef struct JsonNode {
@@ -291,6 +312,13 @@ typedef struct JsonNode {
     uint type : 6;             /**< Node type: JSON_OBJECT, JSON_ARRAY, JSON_STRING, JSON_PRIMITIVE, etc. */
     uint allocatedName : 1;    /**< True if name string was allocated and must be freed by JSON library */
     uint allocatedValue : 1;   /**< True if value string was allocated and must be freed by JSON library */
+    uint cached : 2;           /**< Type of number cached from the value (internal) */
+    uint numberBuffer : 1;     /**< Allocated value is a fixed size buffer for in-place numeric updates (internal) */
+    uint indexed : 1;          /**< Object has a property hash index (internal) */
+    union {
+        int64 integer;         /**< Cached integer or date value */
+        double real;           /**< Cached floating point value */
+    } number;                  /**< Number parsed from the value by numeric getters (internal) */
 #if ME_DEBUG
     int lineNumber;            /**< Source line number in original JSON text (debug builds only) */
 #endif
@@ -334,6 +362,30 @@ PUBLIC Json *jsonAlloc(void);
  */
 PUBLIC void jsonFree(Json *json);
 
+/**
+    Allocate node names and values from an arena
+    @description In arena mode, names and values created by jsonSet, jsonBlend and related APIs are copied into
+        chunks owned by the JSON object rather than being individually allocated. The chunks are freed in one
+        operation by jsonFree. Strings replaced by later updates are not reclaimed until jsonFree, so this mode
+        suits documents that are built or modified and then discarded, rather than long lived documents that are
+        updated indefinitely. Strings too large for a chunk receive a dedicated chunk.
+        Arena mode cannot be disabled once enabled. Strings allocated before calling this routine are unaffected.
+    @param json JSON object
+    @param chunkSize Size of each arena chunk in bytes. Set to zero for the default of ME_JSON_ARENA.
+    @return Zero if successful. Otherwise a negative error code.
+    @stability Evolving
+ */
+PUBLIC int jsonSetArena(Json *json, size_t chunkSize);
+
+/**
+    Get the number of arena chunks allocated for a JSON object
+    @description Each chunk is a single memory allocation. This can be used to measure allocations in arena mode.
+    @param json JSON object
+    @return The number of chunks. Returns zero if arena mode is not enabled.
+    @stability Evolving
+ */
+PUBLIC int jsonGetArenaChunks(const Json *json);
+
 /**
     Lock a json object from further updates
     @description This call is useful to block all further updates via jsonSet.
@@ -847,6 +899,60 @@ PUBLIC int jsonSetNumber(Json *json, int nid, cchar *key, int64 value);
  */
 PUBLIC int jsonSetString(Json *json, int nid, cchar *key, cchar *value);
 
+/**
+    Start building a JSON object or array in document order
+    @description Builder mode appends nodes at the end of the tree with O(1) amortized work per node. This is much
+        faster than jsonSet when constructing large objects from scratch as jsonSet must search for existing
+        properties and insert nodes into the tree. Add properties with jsonBuilderValue, jsonBuilderObject and
+        jsonBuilderArray and close each object or array with jsonBuilderEnd. Property names are not checked
+        for duplicates and may not contain "." or "[]" path separators.
+        The JSON object is locked against jsonSet updates and must not be read until the outermost object or array
+        is closed.
+    @param json Empty JSON object returned by jsonAlloc
+    @param type JSON_OBJECT or JSON_ARRAY
+    @return Zero (the root node ID) if successful. Otherwise a negative error code.
+    @stability Evolving
+ */
+PUBLIC int jsonBuilderBegin(Json *json, int type);
+
+/**
+    Append an object and make it the current builder container
+    @param json JSON object in builder mode
+    @param name Property name. Ignored if the current container is an array.
+    @return The node ID of the new object. Otherwise a negative error code.
+    @stability Evolving
+ */
+PUBLIC int jsonBuilderObject(Json *json, cchar *name);
+
+/**
+    Append an array and make it the current builder container
+    @param json JSON object in builder mode
+    @param name Property name. Ignored if the current container is an array.
+    @return The node ID of the new array. Otherwise a negative error code.
+    @stability Evolving
+ */
+PUBLIC int jsonBuilderArray(Json *json, cchar *name);
+
+/**
+    Append a value to the current builder container
+    @param json JSON object in builder mode
+    @param name Property name. Ignored if the current container is an array.
+    @param value String representation of the value. The value is copied. If NULL, "undefined" is used.
+    @param type Value type: JSON_STRING or JSON_PRIMITIVE. Set to zero to determine the type from the value.
+    @return The node ID of the new value. Otherwise a negative error code.
+    @stability Evolving
+ */
+PUBLIC int jsonBuilderValue(Json *json, cchar *name, cchar *value, int type);
+
+/**
+    Close the current builder object or array
+    @description Closing the outermost object or array ends builder mode and unlocks the JSON object.
+    @param json JSON object in builder mode
+    @return The node ID of the closed object or array. Otherwise a negative error code.
+    @stability Evolving
+ */
+PUBLIC int jsonBuilderEnd(Json *json);
+
 /**
     Directly update a node value.
     @description This is an internal API and is subject to change without notice. It offers a higher performance path
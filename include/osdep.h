@@ -941,6 +941,15 @@
 #else
     #define ME_HAS_SENDFILE 0
 #endif
+
+/*
+    Splice support for zero-copy socket to file transfers
+ */
+#if LINUX && !__UCLIBC__
+    #define ME_HAS_SPLICE 1
+#else
+    #define ME_HAS_SPLICE 0
+#endif
 #if MACOSX
     #include    <stdbool.h>
     #include    <mach-o/dyld.h>
@@ -1313,6 +1313,10 @@ typedef int64 REvent;
 
 #define R_EVENT_FAST              0x1   /**< Fast event flag - must not block and runs off main fiber */
 
+#ifndef ME_R_EVENT_QUEUE
+    #define ME_R_EVENT_QUEUE      64    /**< Initial event queue capacity. Grows as required */
+#endif
+
 /**
     Callback function for events
     @param data Opaque data argument
@@ -1475,6 +1479,7 @@ typedef struct RWait {
     int mask;               /**< Current event mask */
     int eventMask;          /**< I/O events received */
     int flags;              /**< Wait handler flags (R_WAIT_MAIN_FIBER) */
+    int slot;               /**< Index in the deadline queue. Set to -1 if no deadline is queued */
     Socket fd;              /**< File descriptor to wait upon */
 } RWait;
 
@@ -3419,6 +3424,15 @@ PUBLIC RHash *rAllocHash(size_t size, int flags);
  */
 PUBLIC void rFreeHash(RHash *hash);
 
+/**
+    Remove all names from a hash table
+    @description Remove and free all names and values while retaining the allocated hash table capacity
+        so the table can be reused without reallocation.
+    @param hash Hash table to clear
+    @stability Evolving
+ */
+PUBLIC void rClearHash(RHash *hash);
+
 /**
     Copy a hash table
     @param master Original hash table
@@ -4121,6 +4135,17 @@ typedef void (*RSocketCustom)(struct RSocket *sp, int cmd, void *arg, int flags)
  */
 #define R_SOCKET_CONFIG_TLS 1               /**< Custom callback to configure TLS */
 
+/**
+    I/O vector element for gathered socket writes
+    @stability Evolving
+ */
+typedef struct RIOVec {
+    cvoid *base;                            /**< Start of the data block */
+    size_t len;                             /**< Length of the data block */
+} RIOVec;
+
+#define R_MAX_IOVEC 16                      /**< Maximum number of vector elements for rWriteSocketv */
+
 typedef struct RSocket {
     Socket fd;                              /**< Actual socket file handle */
     struct Rtls *tls;
@@ -4497,6 +4522,21 @@ PUBLIC ssize rWriteSocket(RSocket *sp, cvoid *buf, size_t bufsize, Ticks deadlin
  */
 PUBLIC ssize rWriteSocketSync(RSocket *sp, cvoid *buf, size_t len);
 
+/**
+    Write a vector of blocks to a socket until a deadline is reached
+    @description Write a set of data blocks to a socket as a single gathered write. This avoids a system call
+        per block and for TLS connections, coalesces small blocks into a single TLS record. This call will yield
+        the current fiber and resume the main fiber while waiting for the socket to drain.
+    @pre Must be called from a fiber.
+    @param sp Socket object returned from rAllocSocket
+    @param iov Array of RIOVec blocks to write. Zero length blocks are skipped. The array is not modified.
+    @param count Number of elements in iov. Must not be greater than R_MAX_IOVEC.
+    @param deadline System time in ticks to wait until. Set to zero for no deadline.
+    @return The total count of bytes written. Return a negative error code on errors.
+    @stability Evolving
+ */
+PUBLIC ssize rWriteSocketv(RSocket *sp, const RIOVec *iov, int count, Ticks deadline);
+
 #if ME_HAS_SENDFILE
 /**
     Send a file over a socket using zero-copy sendfile.
@@ -4514,6 +4554,27 @@ PUBLIC ssize rWriteSocketSync(RSocket *sp, cvoid *buf, size_t len);
 PUBLIC ssize rSendFile(RSocket *sock, int fd, Offset offset, size_t len);
 #endif
 
+#if ME_HAS_SPLICE
+/**
+    Receive socket data into a file using zero-copy splice.
+    @description This function uses the kernel splice() system call to move data from a socket to a file
+        via a pipe without copying through user space. This is only available for non-TLS connections on Linux.
+        Data already read and buffered by the caller must be written to the file first. The data is written at
+        the given offset and the file position of fd is not changed.
+    @pre Must be called from a fiber.
+    @param sock RSocket pointer. Uses sock->wait if present for efficient I/O waiting.
+    @param fd File descriptor of the file to write.
+    @param offset File offset to start writing at.
+    @param len Number of bytes to receive.
+    @param deadline System time in ticks to wait until. Set to zero for no deadline.
+    @return The number of bytes received. This is less than len if the peer closed the connection or if the
+        file does not support splice, in which case the caller should read the remainder from the socket.
+        Returns a negative error code if no data could be received.
+    @stability Evolving
+ */
+PUBLIC ssize rReceiveFile(RSocket *sock, int fd, Offset offset, size_t len, Ticks deadline);
+#endif
+
 #endif /* R_USE_SOCKET */
 
 /************************************ Threads ************************************/
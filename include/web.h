@@ -2,7 +2,7 @@
     web.h - Fast, secure, tiny web server for embedded applications
 
     The Web Server Module provides a high-performance, secure web server designed
-    for embedded applications. Features include HTTP/1.0 and HTTP/1.1 support, TLS/SSL encryption,
+    for embedded applications. Features include HTTP/1.0, HTTP/1.1 and HTTP/2 support, TLS/SSL encryption,
     WebSocket support, SSE (Server-Sent Events), file upload/download capabilities, session management
     with XSRF protection, comprehensive input validation and sanitization, configurable request/response
     limits, flexible routing system, and the ability to invoke C functions bound to URL routes.
@@ -75,6 +75,22 @@ extern "C" {
 #ifndef ME_HTTP_SENDFILE
     #define ME_HTTP_SENDFILE        ME_HAS_SENDFILE /**< Enable sendfile for zero-copy file transfers */
 #endif
+#ifndef ME_WEB_SPLICE
+    #define ME_WEB_SPLICE           ME_HAS_SPLICE   /**< Enable splice for zero-copy PUT uploads */
+#endif
+#ifndef ME_WEB_HEADER_INDEX
+    #define ME_WEB_HEADER_INDEX     32              /**< Request header index slots. Must be a power of 2 */
+#endif
+#ifndef ME_WEB_COMPRESS
+    #define ME_WEB_COMPRESS         0               /**< Enable on-the-fly gzip compression. Requires zlib (-lz) */
+#endif
+#ifndef ME_WEB_HTTP2
+    #if ME_WIN_LIKE || ME_UNIX_LIKE
+        #define ME_WEB_HTTP2        1               /**< Enable HTTP/2 via TLS ALPN and cleartext prior knowledge */
+    #else
+        #define ME_WEB_HTTP2        0
+    #endif
+#endif
 #ifndef ME_WEB_FIBER_BLOCKS
     #if ME_WIN_LIKE || ME_UNIX_LIKE
         #define ME_WEB_FIBER_BLOCKS 1               /**< Enable fiber exception blocks for handler crash recovery */
@@ -181,8 +197,12 @@ extern "C" {
 struct Web;
 struct WebAction;
 struct WebHost;
+struct WebHttp2;
+struct WebMatch;
 struct WebRoute;
 struct WebSession;
+struct WebSessionStore;
+struct WebStream;
 struct WebUpload;
 struct WebUser;
 
@@ -272,6 +292,11 @@ typedef struct WebRoute {
     cchar *redirect;                    /**< Redirection */
     cchar *trim;                        /**< Portion to trim from path */
     bool stream;                        /**< Stream request body */
+#if ME_WEB_COMPRESS
+    bool compress;                      /**< Compress responses on-the-fly using gzip */
+    ssize compressMin;                  /**< Minimum response size to compress */
+    RList *compressMime;                /**< Mime type prefixes eligible for compression */
+#endif
 
     //  Client-side cache control configuration (opt-in via configuration)
     int cacheMaxAge;                    /**< Client cache max-age in seconds (0 = no max-age) */
@@ -335,6 +360,32 @@ typedef struct WebUser {
 PUBLIC void webFreeUser(WebUser *user);
 
 /************************************* Host ***********************************/
+#define WEB_VARIANT_BR   0x1    /**< Brotli document variant */
+#define WEB_VARIANT_GZIP 0x2    /**< Gzip document variant */
+
+/**
+    Cached static document
+    @description In-memory copy of a small static document and its response metadata. Cached documents are
+        served with a single write and without filesystem calls until revalidated.
+    @stability Internal
+ */
+typedef struct WebFile {
+    char *key;                  /**< Cache key of content encoding and document path */
+    char *path;                 /**< Filesystem path of the cached (possibly compressed) variant */
+    char *data;                 /**< Document content */
+    size_t size;                /**< Document size in bytes */
+    time_t modified;            /**< Document modification time */
+    uint64 inode;               /**< Document inode number */
+    cchar *encoding;            /**< Content encoding of the variant ("br", "gzip") or NULL */
+    int absent;                 /**< Encodings with no variant for an identity document (WEB_VARIANT_*) */
+    char *etag;                 /**< Unquoted ETag for conditional request matching */
+    char *etagHeader;           /**< Quoted ETag response header value */
+    char *lastModified;         /**< Last-Modified response header value */
+    Ticks checked;              /**< Time the document was last validated against the filesystem */
+    int inuse;                  /**< Count of requests currently sending the document */
+    bool stale : 1;             /**< Document removed from the cache while in use */
+} WebFile;
+
 /**
     Web host structure
     @description The web host defines a complete web server instance with its configuration,
@@ -346,6 +397,7 @@ PUBLIC void webFreeUser(WebUser *user);
 typedef struct WebHost {
     RList *listeners;           /**< List of WebListen objects - listening endpoints for this host */
     RList *webs;                /**< List of active Web request objects currently being processed */
+    RList *pool;                /**< Free list of recycled Web objects retaining their buffers */
     Json *config;               /**< JSON5 configuration object containing all host settings */
     Json *signatures;           /**< API signatures for request/response validation */
 
@@ -353,6 +405,10 @@ typedef struct WebHost {
     bool freeConfig : 1;        /**< True if config object was allocated and must be freed */
     bool httpOnly : 1;          /**< Default HttpOnly flag for session cookies */
     bool strictSignatures : 1;  /**< Enforce strict API signature compliance for validation */
+    bool cork : 1;              /**< Gather response headers and initial body output into a single write */
+#if ME_WEB_HTTP2
+    bool http2 : 1;             /**< Accept HTTP/2 connections (web.http2, default false) */
+#endif
 #if ME_WEB_FIBER_BLOCKS
     bool fiberBlocks : 1;       /**< Enable fiber exception blocks for handler crash recovery */
 #endif
@@ -360,10 +416,15 @@ typedef struct WebHost {
     WebHook hook;               /**< Event notification callback function */
     RHash *users;               /**< Hash table of authenticated users and their credentials */
     RHash *sessions;            /**< Hash table of active client sessions indexed by session ID */
+    struct WebSession *sessionFirst; /**< Session expiring soonest (head of the expiry list) */
+    struct WebSession *sessionLast;  /**< Session expiring last (tail of the expiry list) */
+    struct WebSessionStore *sessionStore; /**< Optional persistent session store */
     RHash *methods;             /**< Supported HTTP method verbs (GET, POST, PUT, DELETE, etc.) */
     RHash *mimeTypes;           /**< MIME type mappings indexed by file extension */
     RList *actions;             /**< Ordered list of WebAction objects for URL-to-function bindings */
     RList *routes;              /**< Ordered list of WebRoute objects for request routing */
+    struct WebMatch *actionIndex; /**< Prefix trie of action match patterns */
+    struct WebMatch *routeIndex;  /**< Prefix and exact match trie of route patterns */
     RList *redirects;           /**< Ordered list of WebRedirect objects for URL redirections */
     REvent sessionEvent;        /**< Session timer event */
     int roles;                  /**< Base ID of roles in config */
@@ -383,6 +444,16 @@ typedef struct WebHost {
     int sessionTimeout;         /**< Maximum seconds of inactivity before session expires */
     int connections;            /**< Current count of active client connections */
     int64 connSequence;         /**< Connection sequence number for per-host connection tracking */
+    int maxPool;                /**< High-water mark of recycled Web objects kept in the pool */
+    uint64 poolHits;            /**< Count of connections that reused a pooled Web object */
+    uint64 poolMisses;          /**< Count of connections that allocated a new Web object */
+
+    RHash *files;               /**< Static file cache of WebFile objects indexed by encoding and path */
+    RList *fileOrder;           /**< Cached files in insertion order for eviction */
+    size_t cacheSize;           /**< Total bytes of cached file content */
+    ssize maxCache;             /**< Maximum bytes of cached file content. Zero disables the cache */
+    ssize maxCacheItem;         /**< Maximum size of a single cached file */
+    Ticks cacheCheck;           /**< Period to revalidate cached files against the filesystem */
 
 #if ME_WEB_HTTP_AUTH
     //  HTTP authentication configuration (Basic/Digest protocols)
@@ -417,6 +488,7 @@ typedef struct WebHost {
     int maxSessions;            /**< Maximum number of concurrent user sessions */
     int maxUpload;              /**< Maximum file upload size in bytes */
     int maxUploads;             /**< Maximum number of files per upload request */
+    int maxStreams;             /**< Maximum number of concurrent HTTP/2 streams per connection */
 
 #if ME_COM_WEBSOCK
     cchar *webSocketsProtocol;  /**< WebSocket application sub-protocol identifier */
@@ -443,6 +515,31 @@ typedef struct WebHost {
  */
 PUBLIC void webAddAction(WebHost *host, cchar *prefix, WebProc fn, cchar *role);
 
+/**
+    Find the action for a request path
+    @description Returns the first action, in the order defined, whose URL prefix matches the path.
+        Actions are indexed by prefix so the lookup cost is proportional to the path length rather than
+        the number of actions.
+    @param host Web host object
+    @param path Request URL path
+    @return The matching WebAction or NULL if no action matches
+    @stability Evolving
+ */
+PUBLIC WebAction *webLookupAction(WebHost *host, cchar *path);
+
+/**
+    Find the route for a request path
+    @description Returns the first route, in the order defined, whose match pattern matches the path.
+        Exact routes must match the entire path. Prefix routes must match the start of the path.
+        Routes are indexed when the host is created so the lookup cost is proportional to the path length
+        rather than the number of routes.
+    @param host Web host object
+    @param path Request URL path
+    @return The matching WebRoute or NULL if no route matches
+    @stability Evolving
+ */
+PUBLIC WebRoute *webLookupRoute(WebHost *host, cchar *path);
+
 /**
  * @name Debug Tracing Flags
  * @description Flags for webAllocHost() to control debug tracing output.
@@ -594,6 +691,11 @@ typedef struct Web {
     RBuf *rx;                   /**< Raw incoming data buffer for request parsing */
     // RBuf *trace;                /**< Packet trace buffer for debugging */
     RBuf *buffer;               /**< Response output buffer for efficient response generation */
+    RBuf *cork;                 /**< Corked response headers and body awaiting a gathered write */
+#if ME_WEB_COMPRESS
+    void *deflate;              /**< Response compression stream (z_stream) */
+    int deflateFlush;           /**< Deflate flush mode for each write (Z_NO_FLUSH or Z_SYNC_FLUSH) */
+#endif
 
     Offset chunkRemaining;      /**< Bytes remaining in current HTTP chunk */
     ssize rxLen;                /**< Total expected request content length */
@@ -633,6 +735,7 @@ typedef struct Web {
     uint ifMatchPresent:1;      /**< If-Match header was present */
     uint ifNoneMatch:1;         /**< If-None-Match header was present */
     uint ifRange:1;             /**< If-Range header was present */
+    uint headerOverflow:1;      /**< Request headers did not all fit in the header index */
 
     WebHost *host;              /**< Owning host object */
     struct WebSession *session; /**< Session state */
@@ -650,11 +753,15 @@ typedef struct Web {
 
     RBuf *rxHeaders;            /**< Request received headers */
     RHash *txHeaders;           /**< Output headers */
+    uint headerIndex[ME_WEB_HEADER_INDEX]; /**< Hashed request header name offsets (plus one) into rxHeaders */
 
     //  Parsed request
+    cchar *acceptEncoding;      /**< Request Accept-Encoding header value */
+    cchar *authorization;       /**< Request Authorization header value */
     cchar *contentType;         /**< Receive content type header value */
     cchar *contentDisposition;  /**< Receive content disposition header value */
     cchar *ext;                 /**< Request URL extension */
+    cchar *hostHeader;          /**< Request Host header value */
     cchar *mime;                /**< Request mime type based on the extension */
     cchar *origin;              /**< Request origin header */
     cchar *protocol;            /**< Request HTTP protocol. Set to HTTP/1.0 or HTTP/1.1 */
@@ -723,6 +830,10 @@ typedef struct Web {
 #if ME_COM_WEBSOCK
     struct WebSocket *webSocket;/**< Web socket object */
 #endif
+#if ME_WEB_HTTP2
+    struct WebHttp2 *http2;     /**< HTTP/2 connection state if the connection is using HTTP/2 */
+    struct WebStream *stream;   /**< HTTP/2 stream if the request was received on an HTTP/2 connection */
+#endif
 } Web;
 
 /**
@@ -851,7 +962,8 @@ PUBLIC char *webGetCookie(Web *web, cchar *name);
 /**
     Get a request header value
     @description Retrieve the value of a specific HTTP request header. Header name
-        matching is case-insensitive per HTTP standards.
+        matching is case-insensitive per HTTP standards. Header names are indexed when the request
+        is parsed, so lookups do not rescan the headers. If a header is repeated, the first value is returned.
     @param web Web request object
     @param key HTTP header name (case-insensitive)
     @return Header value string, or NULL if header not found
@@ -1187,6 +1299,21 @@ PUBLIC ssize webWriteFmt(Web *web, cchar *fmt, ...);
  */
 PUBLIC ssize webWriteJson(Web *web, const Json *json);
 
+/**
+    Flush corked response output
+    @description When the host "cork" mode is enabled (the default), response headers written implicitly
+        by webWrite() are gathered with the first body output and sent in a single write when the response
+        is finalized, when the cork buffer is full or when more output is written. Handlers that write some output
+        and then wait before writing more should call webFlush to send the gathered output immediately.
+        For compressed responses, webFlush also emits the output buffered by the compressor.
+        This routine will block the current fiber if necessary. Other fibers continue to run.
+    @pre Must only be called from a fiber.
+    @param web Web object
+    @return The number of bytes written or a negative error code.
+    @stability Evolving
+ */
+PUBLIC ssize webFlush(Web *web);
+
 /**
     Write request response headers
     @description This will write the HTTP response headers. This writes the supplied headers and any required headers if
@@ -1272,11 +1399,17 @@ PUBLIC ssize webWriteValidatedData(Web *web, cchar *buf, cchar *sigKey);
 /*
     Internal APIs
  */
+PUBLIC bool webAcceptsEncoding(cchar *header, cchar *encoding);
 PUBLIC void webAddStandardHeaders(Web *web);
 PUBLIC int webAlloc(WebListen *listen, RSocket *sock);
+#if ME_WEB_COMPRESS
+PUBLIC bool webCanCompress(Web *web, cchar *mime, ssize size);
+PUBLIC void webFreeCompress(Web *web);
+#endif
 PUBLIC bool webCheckSignature(Web *web, Json *json, int nid, JsonNode *signature, int depth);
 PUBLIC int webConsumeInput(Web *web);
 PUBLIC int webFileHandler(Web *web);
+PUBLIC void webFlushFileCache(WebHost *host);
 PUBLIC void webFree(Web *web);
 PUBLIC void webFreeRanges(Web *web);
 PUBLIC void webClose(Web *web);
@@ -1287,6 +1420,9 @@ PUBLIC Json *webParseJson(Web *web);
 PUBLIC bool webParseHeadersBlock(Web *web, char *headers, size_t headersSize, bool upload);
 PUBLIC int webReadBody(Web *web);
 PUBLIC void webSetCacheControlHeaders(Web *web);
+#if ME_WEB_SPLICE && (ME_DEBUG || ME_BENCHMARK)
+PUBLIC void webSetSpliceLimit(ssize limit);
+#endif
 PUBLIC void webTestInit(WebHost *host, cchar *prefix);
 PUBLIC void webUpdateDeadline(Web *web);
 PUBLIC int webValidateUrl(Web *web);
@@ -1308,9 +1444,52 @@ typedef struct WebSession {
     char *id;                              /**< Session ID key */
     int lifespan;                          /**< Session inactivity timeout (secs) */
     Ticks expires;                         /**< When the session expires */
+    Ticks saved;                           /**< Expiry time last written to the session store */
     RHash *cache;                          /**< Cache of session variables */
+    struct WebSession *prev;               /**< Previous session in the host expiry list */
+    struct WebSession *next;               /**< Next session in the host expiry list */
 } WebSession;
 
+/**
+    Session store
+    @description A session store persists session state outside the process so that sessions survive restarts
+        and may be shared. Active sessions are still held in memory. Sessions that are not found in memory are
+        loaded via the load callback. Session variables are serialized as a JSON object of string values.
+        Expiry times are absolute wall-clock times in milliseconds since the epoch.
+    @stability Evolving
+ */
+typedef struct WebSessionStore {
+    /**
+        Load a session. Set *expires to the session expiry time.
+        Return the JSON text of the session variables (caller must free) or NULL if not found.
+     */
+    char *(*load)(struct WebSessionStore *store, cchar *id, Time *expires);
+    /** Save a session with its JSON serialized variables. Return zero if successful. */
+    int (*save)(struct WebSessionStore *store, cchar *id, cchar *data, Time expires);
+    /** Remove a session from the store */
+    void (*remove)(struct WebSessionStore *store, cchar *id);
+    void *arg;                             /**< Store private data */
+} WebSessionStore;
+
+/**
+    Define the session store for a host
+    @description Sessions are created, refreshed and destroyed in memory. If a store is defined, sessions are also
+        written through to the store and loaded from the store on demand.
+    @param host Host object
+    @param store Session store. The store must persist until the host is freed. Set to NULL to remove.
+    @stability Evolving
+ */
+PUBLIC void webSetSessionStore(WebHost *host, WebSessionStore *store);
+
+/**
+    Flush sessions from memory
+    @description This frees all in-memory sessions. Sessions saved to a session store are retained in the store
+        and will be reloaded on demand.
+    @param host Host object
+    @stability Evolving
+ */
+PUBLIC void webFlushSessions(WebHost *host);
+
 /**
     Add the security token to the response.
     @description To minimize form replay attacks, an XSRF security token can be utilized for requests on a route.
@@ -1598,6 +1777,82 @@ PUBLIC void webSetHook(WebHost *host, WebHook hook);
 //  Internal
 PUBLIC int webHook(Web *web, int event);
 
+/*********************************** HTTP/2 ***********************************/
+#if ME_WEB_HTTP2 || DOXYGEN
+
+#define WEB_HTTP2_PREFACE "PRI * HTTP/2.0\r\n\r\n" /**< Start of the HTTP/2 client connection preface */
+
+/**
+    HTTP/2 connection
+    @description An HTTP/2 connection multiplexes concurrent request streams over one socket. The connection fiber
+        reads and writes all frames. Each stream is served by its own fiber and Web request object.
+        HTTP/2 is negotiated via TLS ALPN ("h2") or by a cleartext client that sends the connection preface.
+    @stability Internal
+ */
+typedef struct WebHttp2 {
+    Web *web;                   /**< Connection web object. The rx buffer holds received frames */
+    RFiber *fiber;              /**< Connection fiber that reads and writes frames */
+    RList *streams;             /**< Open WebStream objects */
+    RBuf *tx;                   /**< Frames queued for writing */
+    RBuf *spare;                /**< Spare frame buffer swapped with tx while writing */
+    RBuf *headers;              /**< Header block assembled from HEADERS and CONTINUATION frames */
+    RList *table;               /**< HPACK dynamic table. Entries are "name\0value" with the newest last */
+    int tableSize;              /**< HPACK dynamic table size in octets */
+    int tableMax;               /**< HPACK dynamic table maximum size */
+    int64 sendWindow;           /**< Connection flow control window for sending DATA */
+    int64 recvWindow;           /**< Connection flow control window for receiving DATA */
+    int recvConsumed;           /**< Received DATA octets not yet returned via WINDOW_UPDATE */
+    int peerWindow;             /**< Initial stream send window from the peer settings */
+    int peerMaxFrame;           /**< Maximum frame size accepted by the peer */
+    int lastStream;             /**< Highest stream identifier opened by the peer */
+    int headerStream;           /**< Stream identifier of the header block in progress */
+    int headerFlags;            /**< HEADERS frame flags for the header block in progress */
+    int active;                 /**< Number of streams being served */
+    int pending;                /**< Number of streams waiting for a fiber to be available */
+    Ticks deadline;             /**< Deadline of the current connection wait */
+    bool closed : 1;            /**< Connection has closed or failed */
+    bool goaway : 1;            /**< GOAWAY sent or received. No new streams are accepted */
+    bool preface : 1;           /**< Client connection preface received */
+    bool waiting : 1;           /**< Connection fiber is waiting for I/O or stream activity */
+} WebHttp2;
+
+/**
+    HTTP/2 request stream
+    @description Each stream carries one request and response. The request headers are presented to the Web
+        request object in HTTP/1 form so the standard request pipeline serves the stream.
+    @stability Internal
+ */
+typedef struct WebStream {
+    WebHttp2 *h2;               /**< Owning connection */
+    Web *web;                   /**< Request object serving the stream */
+    RFiber *fiber;              /**< Fiber serving the stream */
+    RBuf *rx;                   /**< Received request body data */
+    int id;                     /**< Stream identifier */
+    int recvWindow;             /**< Stream flow control window for receiving DATA */
+    int recvConsumed;           /**< Request body octets read but not yet returned via WINDOW_UPDATE */
+    int64 sendWindow;           /**< Stream flow control window for sending DATA */
+    Ticks deadline;             /**< Deadline while waiting */
+    bool body : 1;              /**< Request has a body. The HEADERS frame did not end the stream */
+    bool started : 1;           /**< Stream fiber has been started */
+    bool eof : 1;               /**< End of the request stream received */
+    bool ended : 1;             /**< End of the response stream sent */
+    bool reset : 1;             /**< Stream reset by either endpoint */
+    bool waiting : 1;           /**< Stream fiber is waiting for data, flow control window or queue space */
+} WebStream;
+
+/*
+    Internal APIs
+ */
+PUBLIC Web *webAllocStream(Web *parent, WebStream *stream);
+PUBLIC RBuf *webEncodeStreamHeaders(Web *web, int status);
+PUBLIC void webFreeHttp2(WebHttp2 *h2);
+PUBLIC int webProcessHttp2(Web *web);
+PUBLIC ssize webReadStream(Web *web, char *buf, size_t bufsize, Ticks deadline);
+PUBLIC void webResetStream(Web *web);
+PUBLIC void webServeStream(Web *web);
+PUBLIC ssize webWriteStream(Web *web, cvoid *buf, size_t bufsize, bool finalizing);
+#endif /* ME_WEB_HTTP2 */
+
 /********************************* Web Sockets ********************************/
 #if ME_COM_WEBSOCK
 /**
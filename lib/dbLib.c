@@ -717,9 +717,91 @@ typedef struct Env {
     RList *expiredItems;        /* List of expired items */
     cchar *indexSort;           /* Sort key property name */
     cchar *compare;             /* Compare operation for the query */
+    char *keyPrefix;            /* Primary key prefix to match when using a secondary index */
+    char *now;                  /* Current ISO date for expiry checks. Computed once per query */
+    struct DbPredicate *predicates; /* Compiled property matches for prepared queries */
+    int predicateCount;         /* Number of compiled property matches */
     bool mustMatch;             /* Must match properties or where callback */
 } Env;
 
+/*
+    Compiled property match for a prepared query. References a top level node in the query properties.
+ */
+typedef struct DbPredicate {
+    cchar *name;                /* Property name */
+    cchar *value;               /* Value to match */
+    int nid;                    /* Node ID of the property in the query properties */
+    int type;                   /* JSON node type */
+} DbPredicate;
+
+/*
+    Prepared query. The environment is set up once and reused for each execution.
+ */
+struct DbQuery {
+    Env env;                    /* Query environment with prepared properties */
+    DbParams params;            /* Copy of the prepare parameters */
+    char *index;                /* Copy of the index name */
+};
+
+/*
+    Cursor over the results of a prepared query. The cursor holds the next index node to examine.
+    If the index is modified between calls, the walk resumes after the last returned item.
+ */
+struct DbCursor {
+    DbQuery *query;             /* Prepared query */
+    RbNode *rp;                 /* Next index node to examine */
+    char *key;                  /* Primary key of the last returned item */
+    char *indexKey;             /* Secondary index key of the last returned item */
+    uint64 generation;          /* Index generation when rp was computed */
+    int count;                  /* Number of items returned */
+    int limit;                  /* Maximum number of items to return */
+    bool started : 1;           /* Walk has started */
+    bool done : 1;              /* Walk is complete */
+};
+
+/*
+    Secondary index entry. Entries reference the primary item and own a copy of the index key value.
+ */
+typedef struct DbIndexEntry {
+    DbItem index;               /* Index key. Must be first so index trees can use compareItems */
+    DbItem *item;               /* Primary item */
+} DbIndexEntry;
+
+/*
+    Database file segment header. The database file has a version followed by a base snapshot segment
+    and zero or more delta segments of changed items. Segment records are:
+    key length, key, value length, value. Lengths include a trailing null. A zero value length
+    records the removal of an item.
+ */
+typedef struct DbSegment {
+    uint32 type;                /* SEGMENT_BASE or SEGMENT_DELTA */
+    uint32 count;               /* Number of records */
+    uint32 length;              /* Length of the records following the header */
+    uint32 crc;                 /* CRC-32 of the records */
+} DbSegment;
+
+/*
+    Background save state. The db is cleared if the database is closed before the save completes.
+ */
+typedef struct DbSave {
+    Db *db;                     /* Database being saved */
+    char *temp;                 /* Temporary snapshot filename */
+} DbSave;
+
+/*
+    Parsed item cache entry. Entries form a circular list in most recently used order.
+ */
+typedef struct DbCached {
+    DbItem *item;               /* Item owning the parsed JSON */
+    struct DbCached *prev;      /* Next more recently used entry */
+    struct DbCached *next;      /* Next less recently used entry */
+    size_t size;                /* Estimated memory used by the parsed JSON */
+} DbCached;
+
+#define SEGMENT_BASE  1
+#define SEGMENT_DELTA 2
+#define SAVE_CHUNK    (64 * 1024) /* Size of base snapshot writes */
+
 typedef struct DbCallback {
     DbCallbackProc proc;        /* Function callback */
     char *model;                /* Target model - if null, then all models */
@@ -752,46 +834,78 @@ static DbChange *allocChange(Db *db, DbModel *model, DbItem *item, DbParams *par
                              Ticks due);
 static DbField *allocField(Db *db, cchar *name, Json *json, int fid);
 static DbItem *allocItem(cchar *name, Json *json, char *value);
+static void addIndexes(Db *db, DbItem *item);
 static DbModel *allocModel(Db *db, cchar *name, cchar *sync, Time delay);
 static int applyChange(Db *db, cchar *cmd, cchar *model, cchar *value);
-static int applyJournal(Db *db);
+static int applyJournal(Db *db, cchar *path);
+static int autoSave(Db *db);
+static int applyRecords(Db *db, FILE *fp);
 static bool checkEnum(DbField *field, cchar *value);
-static void clearItem(DbItem *item);
+static bool isFullSave(Db *db, cchar *path);
+static void cacheItem(Db *db, DbItem *item, bool resize);
+static void clearItem(Db *db, DbItem *item);
 static void commitChange(Db *db);
+static int compareEntries(cvoid *d1, cvoid *d2, Env *env);
 static int compareItems(cvoid *d1, cvoid *d2, Env *env);
 static void change(Db *db, DbModel *model, DbItem *item, DbParams *params, cchar *cmd);
 static int dberror(Db *db, int code, cchar *fmt, ...);
 static void freeChange(Db *db, DbChange *change);
 static void freeField(DbField *field);
 static void freeModel(DbModel *model);
+static void freeEntry(Db *db, DbIndexEntry *entry);
 static void freeItem(Db *db, DbItem *node);
 static int flushJournal(Db *db);
-static RbTree *getIndex(Db *db, DbParams *params);
+static uint32 getCrc(uint32 crc, cvoid *buf, size_t len);
+static RbTree *getIndex(Db *db, cchar *name);
+static DbItem *getItem(Env *env, RbNode *rp);
 static cchar *getIndexName(Db *db, DbParams *params);
 static cchar *getIndexHash(Db *db, cchar *index);
 static cchar *getIndexSort(Db *db, cchar *index);
 static void invokeCallbacks(Db *db, DbModel *model, DbItem *item, DbParams *params, cchar *cmd,
                             int event);
-static bool matchItem(RbNode *rp, Json *j1, JsonNode *n1, Json *j2, JsonNode *n2, Env *env);
+static int loadRecords(Db *db, cchar *data, size_t len, bool mapped);
+static void markDirty(Db *db, cchar *key);
+static int putRecord(RBuf *buf, cchar *key, cchar *value);
+static void insertItem(Db *db, DbItem *item);
+static RbNode *lookupAfter(RbTree *rbt, cvoid *probe);
+static RbNode *lookupNext(Env *env);
+static bool matchItem(DbItem *item, Json *j1, JsonNode *n1, Json *j2, JsonNode *n2, Env *env);
+static RList *findItems(Env *env);
+static void pruneExpired(Env *env);
 static int mapTypes(Db *db, DbModel *model, Json *props);
 static int loadData(Db *db, cchar *path);
+static int loadLegacy(Db *db, FILE *fp);
+static int loadSegments(Db *db, FILE *fp);
+#if ME_UNIX_LIKE
+static int loadMapped(Db *db, cchar *path);
+#endif
 static int loadIndexes(Db *db);
 static int loadModels(Db *db, Json *json);
 static int loadSchema(Db *db, cchar *schema);
 static cchar *readBlock(Db *db, FILE *fp, RBuf *buf);
 static size_t readSize(FILE *fp);
 static int readItem(FILE *fp, DbItem **item);
+static int readSegmentItem(FILE *fp, DbItem **item, uint32 *crc);
+static int readRecord(Db *db, FILE *fp, RBuf *buf, cchar **cmd, cchar **model, cchar **value);
 static int recreateJournal(Db *db);
+static void removeIndexes(Db *db, DbItem *item);
+static void removeItem(Db *db, RbNode *rp);
 static int saveDb(Db *db);
+static int saveDelta(Db *db);
+static void saveFiber(DbSave *save);
+static ssize saveSnapshot(Db *db, FILE *fp);
 static void selectProperties(Db *db, DbModel *model, Json *props, DbParams *params, cchar *cmd);
 static void setDefaults(Db *db, DbModel *model, Json *props);
 static void setTemplates(Db *db, DbModel *model, Json *props);
 static void setTimestamps(DbModel *model, Json *props, cchar *cmd);
-static Json *toJson(DbItem *item);
-static int writeBlock(Db *db, cchar *buf);
+static int startSave(Db *db);
+static int syncJournal(Db *db);
+static void syncJournalEvent(Db *db);
+static Json *toJson(Db *db, DbItem *item);
+static void uncacheItem(Db *db, DbItem *item, bool compact);
+static void updateIndexes(Db *db, DbItem *item, bool add);
 static int writeChangeToJournal(Db *db, DbModel *model, DbItem *item, cchar *cmd);
-static int writeItem(FILE *fp, DbItem *item);
-static int writeSize(Db *db, uint32_t len);
+static int writeChunk(FILE *fp, RBuf *buf, DbSegment *seg);
 
 /************************************** Code ***********************************/
 /*
@@ -801,7 +915,7 @@ static int writeSize(Db *db, uint32_t len);
 PUBLIC Db *dbOpen(cchar *path, cchar *schema, int flags)
 {
     Db  *db;
-    int count;
+    int count, prevCount;
 
     if (!path || !*path || !schema || !*schema) {
         return NULL;
@@ -818,12 +932,18 @@ PUBLIC Db *dbOpen(cchar *path, cchar *schema, int flags)
         //  SECURITY Acceptable: developers responsibility to validate the path
         db->path = sclone(path);
         db->journalPath = sfmt("%s.jnl", db->path);
+        db->prevJournalPath = sfmt("%s.jnl.prev", db->path);
         db->maxJournalSize = DB_MAX_LOG_SIZE;
         db->maxJournalAge = DB_MAX_LOG_AGE;
+        db->journalBuf = rAllocBuf(ME_BUFSIZE);
+        db->journalSync = DB_SYNC_ALWAYS;
+        db->syncDelay = DB_SYNC_DELAY;
+        db->syncCount = DB_SYNC_COUNT;
     }
     db->callbacks = rAllocList(0, R_DYNAMIC_VALUE);
     db->context = jsonAlloc();
     db->changes = rAllocHash(0, 0);
+    db->dirty = rAllocHash(0, R_TEMPORAL_NAME | R_STATIC_VALUE);
     if (loadSchema(db, schema) < 0) {
         rError("db", "%s", db->error);
         dbClose(db);
@@ -835,16 +955,23 @@ PUBLIC Db *dbOpen(cchar *path, cchar *schema, int flags)
             dbClose(db);
             return 0;
         }
-        //  Recover journal data incase sudden shutdown
-        if ((count = applyJournal(db)) < 0) {
+        /*
+            Recover journal data incase sudden shutdown. The previous journal exists if the
+            shutdown interrupted a background save and holds changes made before the save began.
+         */
+        if ((prevCount = applyJournal(db, db->prevJournalPath)) < 0 ||
+            (count = applyJournal(db, db->journalPath)) < 0) {
             rError("db", "%s", db->error);
             dbClose(db);
             return 0;
         }
+        count += prevCount;
         if (count > 0) {
             dbSave(db, NULL);
         }
         if (count >= 0 && !(db->flags & DB_READ_ONLY)) {
+            //  Remove the previous journal first so an outage cannot replay it over the recreated journal
+            unlink(db->prevJournalPath);
             if (recreateJournal(db) < 0) {
                 rError("db", "%s", db->error);
                 dbClose(db);
@@ -858,19 +985,31 @@ PUBLIC Db *dbOpen(cchar *path, cchar *schema, int flags)
 PUBLIC void dbClose(Db *db)
 {
     DbModel    *model;
+    DbIndex    *index;
     DbCallback *cb;
     DbChange   *change;
     RName      *np;
     int        ci;
 
+    bool       abandoned;
+
     if (!db) {
         return;
     }
     rStopEvent(db->journalEvent);
+    rStopEvent(db->syncEvent);
 
+    abandoned = 0;
+    if (db->save) {
+        //  Abandon the background save. The fiber will exit when next resumed.
+        db->save->db = 0;
+        unlink(db->save->temp);
+        db->save = 0;
+        abandoned = 1;
+    }
     if (!(db->flags & DB_READ_ONLY)) {
         //  Perform a complete save of the in-memory database if the journal has data
-        if (db->journalSize) {
+        if (db->journalSize || abandoned) {
             dbSave(db, NULL);
         }
         //  Clean shutdown removes the journal
@@ -893,9 +1032,23 @@ PUBLIC void dbClose(Db *db)
     rFreeList(db->callbacks);
     rFreeHash(db->models);
     rFreeHash(db->changes);
+    rFreeHash(db->dirty);
+    for (ITERATE_NAME_DATA(db->indexes, np, index)) {
+        rbFree(index->tree);
+        rFree(index);
+    }
+    rFreeHash(db->indexes);
     rbFree(db->primary);
+#if ME_UNIX_LIKE
+    //  Items may reference the mapping so unmap after freeing items
+    if (db->map) {
+        munmap(db->map, db->mapSize);
+    }
+#endif
     rFree(db->error);
     rFree(db->journalPath);
+    rFree(db->prevJournalPath);
+    rFreeBuf(db->journalBuf);
     rFree(db->path);
     jsonFree(db->schema);
     jsonFree(db->context);
@@ -1052,14 +1205,55 @@ static int loadModels(Db *db, Json *json)
 }
 
 /*
-    Load primary index. Currently only supporting a primary index.
+    Load the primary index and any secondary indexes.
+    Secondary indexes are only maintained if a model defines the index sort field. Other schema indexes
+    (such as cloud-side GSIs) are ignored in the local database.
  */
 static int loadIndexes(Db *db)
 {
+    DbIndex  *index;
+    DbModel  *model;
+    JsonNode *node;
+    RName    *np;
+    cchar    *sort;
+    int      iid;
+
     if (!db) {
         return R_ERR_BAD_ARGS;
     }
     db->primary = rbAlloc(0, (RbCompare) compareItems, (RbFree) freeItem, db);
+
+    if ((iid = jsonGetId(db->schema, 0, "indexes")) < 0) {
+        return 0;
+    }
+    for (ITERATE_JSON_ID(db->schema, iid, node, nid)) {
+        if (smatch(node->name, "primary")) {
+            continue;
+        }
+        if ((sort = getIndexSort(db, node->name)) == 0) {
+            continue;
+        }
+        for (ITERATE_NAME_DATA(db->models, np, model)) {
+            if (rLookupName(model->fields, sort)) {
+                break;
+            }
+        }
+        if (!np) {
+            //  No model defines the sort field
+            continue;
+        }
+        if ((index = rAllocType(DbIndex)) == 0) {
+            return R_ERR_MEMORY;
+        }
+        //  Memory is preserved in the schema
+        index->name = node->name;
+        index->sort = sort;
+        index->tree = rbAlloc(0, (RbCompare) compareEntries, (RbFree) freeEntry, db);
+        if (!db->indexes) {
+            db->indexes = rAllocHash(0, 0);
+        }
+        rAddName(db->indexes, index->name, index, R_TEMPORAL_NAME | R_STATIC_VALUE);
+    }
     return 0;
 }
 
@@ -1069,9 +1263,9 @@ static int loadIndexes(Db *db)
  */
 static int loadData(Db *db, cchar *path)
 {
-    DbItem *item;
     uint16 version;
     FILE   *fp;
+    int    rc;
 
     if (!db || !path || !*path) {
         return R_ERR_BAD_ARGS;
@@ -1084,33 +1278,227 @@ static int loadData(Db *db, cchar *path)
             fclose(fp);
             return dberror(db, R_ERR_CANT_OPEN, "Cannot read database %s, errno %d", path, errno);
         }
-        if (version != DB_VERSION) {
+#if ME_UNIX_LIKE
+        if (version == DB_VERSION && (db->flags & DB_OPEN_MMAP)) {
+            fclose(fp);
+            fp = 0;
+            rc = loadMapped(db, path);
+        } else
+#endif
+        if (version == DB_VERSION) {
+            rc = loadSegments(db, fp);
+        } else if (version == DB_LEGACY_VERSION) {
+            rc = loadLegacy(db, fp);
+        } else {
+            rc = dberror(db, R_ERR_CANT_OPEN, "Incorrect database version %d", version);
+        }
+        if (fp) {
             fclose(fp);
-            return dberror(db, R_ERR_CANT_OPEN, "Incorrect database version %d", version);
         }
-        while (1) {
-            if (readItem(fp, &item) < 0) {
-                break;
+        //  Loaded items are already persisted
+        rFreeHash(db->dirty);
+        db->dirty = rAllocHash(0, R_TEMPORAL_NAME | R_STATIC_VALUE);
+        return rc;
+    }
+    return 0;
+}
+
+/*
+    Load a database saved without segments. The next save will write a segmented base snapshot.
+ */
+static int loadLegacy(Db *db, FILE *fp)
+{
+    DbItem *item;
+
+    while (1) {
+        if (readItem(fp, &item) < 0) {
+            break;
+        }
+        if (!item) {
+            break;
+        }
+        insertItem(db, item);
+        addIndexes(db, item);
+    }
+    return 0;
+}
+
+/*
+    Load the base snapshot and then apply delta segments in order.
+    The base is streamed. Delta segments are verified before being applied so a segment torn by an
+    outage while appending is ignored. The journal still holds those changes.
+ */
+static int loadSegments(Db *db, FILE *fp)
+{
+    struct stat sbuf;
+    DbSegment   seg;
+    DbItem      *item;
+    RBuf        *buf;
+    uint32      crc, count;
+    size_t      offset;
+
+    if (fstat(fileno(fp), &sbuf) < 0) {
+        return dberror(db, R_ERR_CANT_READ, "Cannot access database file");
+    }
+    offset = sizeof(uint16);
+    if (fread(&seg, sizeof(seg), 1, fp) != 1 || seg.type != SEGMENT_BASE) {
+        return dberror(db, R_ERR_CANT_READ, "Missing database base snapshot");
+    }
+    for (crc = 0, count = 0; count < seg.count; count++) {
+        if (readSegmentItem(fp, &item, &crc) < 0 || !item) {
+            break;
+        }
+        insertItem(db, item);
+        addIndexes(db, item);
+    }
+    if (count != seg.count || crc != seg.crc) {
+        //  The base is written to a temp file and renamed, so this is not an interrupted save
+        rError("db", "Corrupt database base snapshot, loaded %d of %d items", count, seg.count);
+        return 0;
+    }
+    offset += sizeof(seg) + seg.length;
+    db->baseSize = offset;
+
+    buf = rAllocBuf(ME_BUFSIZE);
+    while (fread(&seg, sizeof(seg), 1, fp) == 1) {
+        if (seg.type != SEGMENT_DELTA || offset + sizeof(seg) + seg.length > (size_t) sbuf.st_size) {
+            break;
+        }
+        rFlushBuf(buf);
+        if (rReserveBufSpace(buf, seg.length) < 0) {
+            break;
+        }
+        if (fread(buf->start, seg.length, 1, fp) != 1 || getCrc(0, buf->start, seg.length) != seg.crc) {
+            break;
+        }
+        if (loadRecords(db, buf->start, seg.length, 0) < 0) {
+            break;
+        }
+        offset += sizeof(seg) + seg.length;
+    }
+    rFreeBuf(buf);
+    db->deltaSize = offset - db->baseSize;
+    return 0;
+}
+
+#if ME_UNIX_LIKE
+/*
+    Load the database by mapping the file. Items reference their keys and values in the mapping rather
+    than allocating and copying. The base snapshot is not checksummed here as it is written to a temp
+    file and renamed into place, and verifying it would fault in every page. Delta segments are
+    verified as they may be torn by an outage while appending.
+ */
+static int loadMapped(Db *db, cchar *path)
+{
+    struct stat sbuf;
+    DbSegment   seg;
+    cchar       *data, *cp, *end, *records;
+    void        *map;
+    int         fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return dberror(db, R_ERR_CANT_OPEN, "Cannot open %s", path);
+    }
+    if (fstat(fd, &sbuf) < 0 || (size_t) sbuf.st_size < sizeof(uint16) + sizeof(seg)) {
+        close(fd);
+        return dberror(db, R_ERR_CANT_READ, "Missing database base snapshot");
+    }
+    map = mmap(NULL, (size_t) sbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return dberror(db, R_ERR_CANT_READ, "Cannot map database %s, errno %d", path, errno);
+    }
+    db->map = map;
+    db->mapSize = (size_t) sbuf.st_size;
+
+    data = map;
+    end = &data[db->mapSize];
+    for (cp = &data[sizeof(uint16)]; (size_t) (end - cp) >= sizeof(seg); cp = &records[seg.length]) {
+        memcpy(&seg, cp, sizeof(seg));
+        records = &cp[sizeof(seg)];
+        if (seg.length > (size_t) (end - records)) {
+            break;
+        }
+        if (!db->baseSize) {
+            if (seg.type != SEGMENT_BASE) {
+                return dberror(db, R_ERR_CANT_READ, "Missing database base snapshot");
             }
-            if (!item) {
-                break;
+            if (loadRecords(db, records, seg.length, 1) < 0) {
+                rError("db", "Corrupt database base snapshot");
             }
-            rbInsert(db->primary, item);
+            db->baseSize = (size_t) (&records[seg.length] - data);
+            continue;
         }
-        fclose(fp);
+        if (seg.type != SEGMENT_DELTA || getCrc(0, records, seg.length) != seg.crc ||
+            loadRecords(db, records, seg.length, 1) < 0) {
+            break;
+        }
+    }
+    db->deltaSize = db->baseSize ? (size_t) (cp - data) - db->baseSize : 0;
+    return 0;
+}
+#endif
+
+/*
+    Load the records of a segment. If mapped, the data is retained and items reference their keys and
+    values in place.
+ */
+static int loadRecords(Db *db, cchar *data, size_t len, bool mapped)
+{
+    DbItem   *item, search;
+    RbNode   *rp;
+    cchar    *cp, *end, *key;
+    uint32   klen, vlen;
+
+    for (cp = data, end = &data[len]; cp < end; ) {
+        if (end - cp < (ssize) sizeof(uint32)) {
+            return R_ERR_BAD_STATE;
+        }
+        memcpy(&klen, cp, sizeof(klen));
+        cp += sizeof(klen);
+        if (klen == 0 || klen > DB_MAX_KEY || end - cp < (ssize) (klen + sizeof(uint32))) {
+            return R_ERR_BAD_STATE;
+        }
+        key = cp;
+        cp += klen;
+        memcpy(&vlen, cp, sizeof(vlen));
+        cp += sizeof(vlen);
+        if (vlen > DB_MAX_ITEM + 1 || end - cp < (ssize) vlen || key[klen - 1] || (vlen && cp[vlen - 1])) {
+            return R_ERR_BAD_STATE;
+        }
+        if (vlen == 0) {
+            search.key = (char*) key;
+            if ((rp = rbLookup(db->primary, &search, NULL)) != 0) {
+                removeItem(db, rp);
+            }
+        } else {
+            if (mapped) {
+                //  Not allocated. Copied when the item is modified.
+                if ((item = rAllocType(DbItem)) == 0) {
+                    return R_ERR_MEMORY;
+                }
+                item->key = (char*) key;
+                item->value = (char*) cp;
+            } else if ((item = allocItem(key, 0, snclone(cp, vlen - 1))) == 0) {
+                return R_ERR_MEMORY;
+            }
+            insertItem(db, item);
+            addIndexes(db, item);
+        }
+        cp += vlen;
     }
     return 0;
 }
 
 /*
     Save the database to persistent store in binary (non-portable) form.
+    Saves to the database path append a delta segment of changed items unless the deltas have grown
+    large enough to warrant compacting into a new base snapshot.
  */
 PUBLIC int dbSave(Db *db, cchar *path)
 {
-    RbTree *rbt;
-    RbNode *rp;
     char   temp[ME_MAX_FNAME];
-    uint16 version;
+    ssize  size;
     FILE   *fp;
 
     if (!db) {
@@ -1119,51 +1507,390 @@ PUBLIC int dbSave(Db *db, cchar *path)
     if (db->flags & DB_READ_ONLY) {
         return 0;
     }
-    rbt = db->primary;
     path = path ? path : db->path;
     if (!path) {
         return dberror(db, R_ERR_BAD_ARGS, "No path to save to");
     }
-
-    /*
-        Write to temp and then rename incase of an outage while writing
-     */
-    sfmtbuf(temp, sizeof(temp), "%s.save", db->path);
-    if ((fp = fopen(temp, "w")) == NULL) {
-        return dberror(db, R_ERR_CANT_OPEN, "Cannot open %s", temp);
-    }
-    version = DB_VERSION;
-    if (fwrite(&version, sizeof(version), 1, fp) != 1) {
-        fclose(fp);
-        return dberror(db, R_ERR_CANT_WRITE, "Cannot write version to database file: %d", errno);
+    if (path == db->path && db->save) {
+        //  The background save will include all changes
+        return 0;
     }
-    for (rp = rbFirst(rbt); rp; rp = rbNext(rbt, rp)) {
-        if (writeItem(fp, rp->data) < 0) {
+    if (!isFullSave(db, path)) {
+        if (saveDelta(db) < 0) {
+            return db->code;
+        }
+    } else {
+        /*
+            Write to temp and then rename incase of an outage while writing
+         */
+        sfmtbuf(temp, sizeof(temp), "%s.save", db->path);
+        if ((fp = fopen(temp, "w")) == NULL) {
+            return dberror(db, R_ERR_CANT_OPEN, "Cannot open %s", temp);
+        }
+        if ((size = saveSnapshot(db, fp)) < 0) {
             fclose(fp);
-            return dberror(db, R_ERR_CANT_WRITE, "Cannot save item");
+            return dberror(db, R_ERR_CANT_WRITE, "Cannot save database: %d", errno);
         }
-    }
-    fclose(fp);
+        fclose(fp);
 
 #if ME_WIN_LIKE
-    unlink(path);
+        unlink(path);
 #endif
-    if (rename(temp, path) < 0) {
-        return dberror(db, R_ERR_CANT_WRITE, "Cannot rename save temp file");
+        if (rename(temp, path) < 0) {
+            return dberror(db, R_ERR_CANT_WRITE, "Cannot rename save temp file");
+        }
+        db->saveBytes = (size_t) size;
+        if (path == db->path) {
+            //  The snapshot holds the previous journal changes. Remove it before the journal is recreated.
+            unlink(db->prevJournalPath);
+            db->baseSize = (size_t) size;
+            db->deltaSize = 0;
+            rFreeHash(db->dirty);
+            db->dirty = rAllocHash(0, R_TEMPORAL_NAME | R_STATIC_VALUE);
+        }
     }
     /*
         If the above fails, the journal will still hold a record of all changes.
      */
-    if (path == db->path && recreateJournal(db) < 0) {
+    if (path == db->path) {
+        if (recreateJournal(db) < 0) {
+            return dberror(db, R_ERR_CANT_OPEN, "Cannot recreate journal file");
+        }
+    }
+    return 0;
+}
+
+/*
+    Test if a save to the given path requires a full snapshot rather than a delta
+ */
+static bool isFullSave(Db *db, cchar *path)
+{
+    return path != db->path || !db->baseSize || db->deltaSize * 100 >= db->baseSize * DB_MAX_DELTA ||
+           rFileExists(db->prevJournalPath);
+}
+
+/*
+    Save after journal changes. Full snapshots are written by a background fiber when running on a
+    fiber (the event loop is running) so the caller and the event loop are not blocked.
+ */
+static int autoSave(Db *db)
+{
+    if (db->save) {
+        return 0;
+    }
+    if (!rIsMain() && isFullSave(db, db->path) && !rFileExists(db->prevJournalPath)) {
+        return startSave(db);
+    }
+    return dbSave(db, NULL);
+}
+
+/*
+    Start a background save. The current journal is retained as the previous journal until the
+    snapshot is complete and changes from now on go to a fresh journal and dirty set.
+ */
+static int startSave(Db *db)
+{
+    DbSave *save;
+
+    if (syncJournal(db) < 0) {
+        return dbSave(db, NULL);
+    }
+    if (db->journal) {
+        fclose(db->journal);
+        db->journal = 0;
+    }
+    if (rename(db->journalPath, db->prevJournalPath) < 0) {
+        rError("db", "Cannot rename journal, errno %d", errno);
+        if (recreateJournal(db) < 0) {
+            return dberror(db, R_ERR_CANT_OPEN, "Cannot recreate journal file");
+        }
+        return dbSave(db, NULL);
+    }
+    if (recreateJournal(db) < 0) {
         return dberror(db, R_ERR_CANT_OPEN, "Cannot recreate journal file");
     }
+    rFreeHash(db->dirty);
+    db->dirty = rAllocHash(0, R_TEMPORAL_NAME | R_STATIC_VALUE);
+
+    if ((save = rAllocType(DbSave)) == 0) {
+        return R_ERR_MEMORY;
+    }
+    save->db = db;
+    save->temp = sfmt("%s.snap", db->path);
+    db->save = save;
+    if (rSpawnFiber("dbsave", (RFiberProc) saveFiber, save) < 0) {
+        db->save = 0;
+        rFree(save->temp);
+        rFree(save);
+        return dbSave(db, NULL);
+    }
+    return 0;
+}
+
+/*
+    Background save fiber. Writes a base snapshot yielding every DB_SAVE_YIELD items.
+    Iteration resumes by key after yielding as items may be removed meanwhile. Items changed during the
+    save are in the fresh dirty set and are appended as a delta once the snapshot is renamed into place.
+ */
+static void saveFiber(DbSave *save)
+{
+    DbSegment seg;
+    DbItem    *item;
+    Db        *db;
+    RBuf      *buf;
+    RbNode    *rp;
+    FILE      *fp;
+    char      *key, *value;
+    uint16    version;
+    int       count, rc;
+
+    db = save->db;
+    key = 0;
+    buf = 0;
+    if ((fp = fopen(save->temp, "w")) == NULL) {
+        rError("db", "Cannot open %s", save->temp);
+        goto done;
+    }
+    version = DB_VERSION;
+    memset(&seg, 0, sizeof(seg));
+    seg.type = SEGMENT_BASE;
+    rc = (fwrite(&version, sizeof(version), 1, fp) != 1 || fwrite(&seg, sizeof(seg), 1, fp) != 1) ?
+         R_ERR_CANT_WRITE : 0;
+    buf = rAllocBuf(SAVE_CHUNK);
+
+    for (count = 0, rp = rbFirst(db->primary); rp && rc == 0; ) {
+        item = rp->data;
+        value = item->json ? jsonToString(item->json, 0, 0, 0) : item->value;
+        rc = putRecord(buf, item->key, value);
+        if (value != item->value) {
+            rFree(value);
+        }
+        seg.count++;
+        if (rc == 0 && rGetBufLength(buf) >= SAVE_CHUNK) {
+            rc = writeChunk(fp, buf, &seg);
+        }
+        if (++count % DB_SAVE_YIELD == 0) {
+            rFree(key);
+            key = sclone(item->key);
+            rSleep(0);
+            if ((db = save->db) == 0) {
+                break;
+            }
+            rp = lookupAfter(db->primary, &(DbItem) { .key = key });
+        } else {
+            rp = rbNext(db->primary, rp);
+        }
+    }
+    if (db && rc == 0) {
+        rc = writeChunk(fp, buf, &seg);
+    }
+    if (db && (rc < 0 || fseek(fp, sizeof(version), SEEK_SET) < 0 || fwrite(&seg, sizeof(seg), 1, fp) != 1 ||
+               fflush(fp) < 0 || rFlushFile(fileno(fp)) < 0)) {
+        rc = R_ERR_CANT_WRITE;
+    }
+    fclose(fp);
+    if (!db) {
+        goto done;
+    }
+#if ME_WIN_LIKE
+    unlink(db->path);
+#endif
+    if (rc < 0 || rename(save->temp, db->path) < 0) {
+        //  The previous journal is retained so the next save will be a full snapshot
+        rError("db", "Cannot write database snapshot %s", save->temp);
+        unlink(save->temp);
+    } else {
+        /*
+            The snapshot holds the previous journal changes. Remove the previous journal before the current
+            journal is recreated so an outage cannot replay stale changes over the saved state.
+         */
+        unlink(db->prevJournalPath);
+        db->baseSize = sizeof(version) + sizeof(seg) + seg.length;
+        db->deltaSize = 0;
+        db->saveBytes = db->baseSize;
+        //  Append changes made during the save. This clears the dirty set.
+        if (saveDelta(db) < 0) {
+            //  The journal is retained and the next save will be a full snapshot
+            db->baseSize = 0;
+        } else {
+            recreateJournal(db);
+        }
+    }
+
+done:
+    if (db) {
+        db->save = 0;
+    }
+    rFreeBuf(buf);
+    rFree(key);
+    rFree(save->temp);
+    rFree(save);
+}
+
+/*
+    Write a full base snapshot. Returns the size of the file.
+ */
+static ssize saveSnapshot(Db *db, FILE *fp)
+{
+    DbSegment seg;
+    DbItem    *item;
+    RBuf      *buf;
+    RbNode    *rp;
+    char      *value;
+    uint16    version;
+    int       rc;
+
+    version = DB_VERSION;
+    memset(&seg, 0, sizeof(seg));
+    seg.type = SEGMENT_BASE;
+    if (fwrite(&version, sizeof(version), 1, fp) != 1 || fwrite(&seg, sizeof(seg), 1, fp) != 1) {
+        return R_ERR_CANT_WRITE;
+    }
+    buf = rAllocBuf(SAVE_CHUNK);
+    rc = 0;
+    for (rp = rbFirst(db->primary); rp && rc == 0; rp = rbNext(db->primary, rp)) {
+        item = rp->data;
+        value = item->json ? jsonToString(item->json, 0, 0, 0) : item->value;
+        rc = putRecord(buf, item->key, value);
+        if (value != item->value) {
+            rFree(value);
+        }
+        seg.count++;
+        if (rc == 0 && rGetBufLength(buf) >= SAVE_CHUNK) {
+            rc = writeChunk(fp, buf, &seg);
+        }
+    }
+    if (rc == 0) {
+        rc = writeChunk(fp, buf, &seg);
+    }
+    rFreeBuf(buf);
+    if (rc < 0 || fseek(fp, sizeof(version), SEEK_SET) < 0 || fwrite(&seg, sizeof(seg), 1, fp) != 1 ||
+        fflush(fp) < 0 || rFlushFile(fileno(fp)) < 0) {
+        return R_ERR_CANT_WRITE;
+    }
+    return (ssize) (sizeof(version) + sizeof(seg) + seg.length);
+}
+
+/*
+    Append a delta segment of the items changed since the last save
+ */
+static int saveDelta(Db *db)
+{
+    DbSegment seg;
+    DbItem    *item, search;
+    RBuf      *buf;
+    RbNode    *rp;
+    RName     *np;
+    FILE      *fp;
+    char      *value;
+    size_t    len;
+    int       rc;
+
+    db->saveBytes = 0;
+    if (rGetHashLength(db->dirty) == 0) {
+        return 0;
+    }
+    memset(&seg, 0, sizeof(seg));
+    seg.type = SEGMENT_DELTA;
+    buf = rAllocBuf(ME_BUFSIZE);
+    rc = 0;
+    for (ITERATE_NAMES(db->dirty, np)) {
+        search.key = (char*) np->name;
+        if ((rp = rbLookup(db->primary, &search, NULL)) != 0) {
+            item = rp->data;
+            value = item->json ? jsonToString(item->json, 0, 0, 0) : item->value;
+            rc |= putRecord(buf, item->key, value);
+            if (value != item->value) {
+                rFree(value);
+            }
+        } else {
+            rc |= putRecord(buf, np->name, NULL);
+        }
+        seg.count++;
+    }
+    len = (size_t) rGetBufLength(buf);
+    seg.length = (uint32) len;
+    seg.crc = getCrc(0, buf->start, len);
+
+    if (rc < 0 || (fp = fopen(db->path, "r+")) == NULL) {
+        rFreeBuf(buf);
+        return dberror(db, R_ERR_CANT_OPEN, "Cannot open %s", db->path);
+    }
+    if (fseek(fp, (long) (db->baseSize + db->deltaSize), SEEK_SET) < 0 ||
+        fwrite(&seg, sizeof(seg), 1, fp) != 1 || fwrite(buf->start, len, 1, fp) != 1 ||
+        fflush(fp) < 0 || rFlushFile(fileno(fp)) < 0) {
+        fclose(fp);
+        rFreeBuf(buf);
+        return dberror(db, R_ERR_CANT_WRITE, "Cannot write database delta: %d", errno);
+    }
+#if ME_UNIX_LIKE
+    //  Discard any segment torn by a prior outage
+    if (ftruncate(fileno(fp), (off_t) (db->baseSize + db->deltaSize + sizeof(seg) + len)) < 0) {
+        rTrace("db", "Cannot truncate %s", db->path);
+    }
+#endif
+    fclose(fp);
+    rFreeBuf(buf);
+
+    db->deltaSize += sizeof(seg) + len;
+    db->saveBytes = sizeof(seg) + len;
+    rFreeHash(db->dirty);
+    db->dirty = rAllocHash(0, R_TEMPORAL_NAME | R_STATIC_VALUE);
     return 0;
 }
 
+/*
+    Write buffered base snapshot records and update the segment length and checksum
+ */
+static int writeChunk(FILE *fp, RBuf *buf, DbSegment *seg)
+{
+    size_t len;
+
+    len = (size_t) rGetBufLength(buf);
+    if (len > 0 && fwrite(buf->start, len, 1, fp) != 1) {
+        return R_ERR_CANT_WRITE;
+    }
+    seg->crc = getCrc(seg->crc, buf->start, len);
+    seg->length += (uint32) len;
+    rFlushBuf(buf);
+    return 0;
+}
+
+/*
+    Append a database file record. A null value records the removal of the item.
+ */
+static int putRecord(RBuf *buf, cchar *key, cchar *value)
+{
+    uint32 len;
+
+    len = (uint32) slen(key) + 1;
+    if (rPutBlockToBuf(buf, (cchar*) &len, sizeof(len)) < 0 || rPutBlockToBuf(buf, key, len) < 0) {
+        return R_ERR_MEMORY;
+    }
+    len = value ? (uint32) slen(value) + 1 : 0;
+    if (rPutBlockToBuf(buf, (cchar*) &len, sizeof(len)) < 0) {
+        return R_ERR_MEMORY;
+    }
+    if (value && rPutBlockToBuf(buf, value, len) < 0) {
+        return R_ERR_MEMORY;
+    }
+    return 0;
+}
+
+/*
+    Record an item key as changed since the last save
+ */
+static void markDirty(Db *db, cchar *key)
+{
+    if (db->dirty && key) {
+        rAddName(db->dirty, key, 0, 0);
+    }
+}
+
 static int saveDb(Db *db)
 {
     db->journalEvent = 0;
-    return dbSave(db, NULL);
+    return autoSave(db);
 }
 
 /*
@@ -1175,7 +1902,8 @@ static int setup(Db *db, cchar *modelName, Json *props, DbParams *params, cchar
     DbModel  *model;
     DbField  *field;
     JsonNode *prop;
-    char     *cp;
+    cchar    *indexName, *primarySort;
+    char     *cp, *key;
 
     if (!db || !cmd || !env || !params) {
         return R_ERR_BAD_ARGS;
@@ -1183,7 +1911,16 @@ static int setup(Db *db, cchar *modelName, Json *props, DbParams *params, cchar
     memset(env, 0, sizeof(Env));
     rFree(db->error);
     db->error = 0;
-    
+
+    //  Secondary indexes are query only. Mutations always use the primary index.
+    indexName = (smatch(cmd, "find") || smatch(cmd, "get")) ? getIndexName(db, params) : "primary";
+    if ((env->index = getIndex(db, indexName)) == 0) {
+        if (props && (props->userFlags & USER_ALLOC)) {
+            jsonFree(props);
+        }
+        return dberror(db, R_ERR_BAD_ARGS, "Unknown index \"%s\"", indexName);
+    }
+
     if (!props) {
         props = jsonAlloc();
         jsonSetUserFlags(props, USER_ALLOC);
@@ -1199,8 +1936,7 @@ static int setup(Db *db, cchar *modelName, Json *props, DbParams *params, cchar
     env->db = db;
     env->props = props;
     env->params = params;
-    env->index = getIndex(db, params);
-    env->indexSort = getIndexSort(db, getIndexName(db, params));
+    env->indexSort = getIndexSort(db, indexName);
     env->mustMatch = env->params->where ? 1 : 0;
 
     if (modelName) {
@@ -1290,6 +2026,21 @@ static int setup(Db *db, cchar *modelName, Json *props, DbParams *params, cchar
     }
     //  Must be after find trims templates
     env->searchLen = slen(env->search.key);
+
+    if (env->index != db->primary) {
+        /*
+            A secondary index query may include an unresolved primary key template (e.g. "user#${id}").
+            Match the resolved prefix against the primary key of candidate items instead.
+         */
+        primarySort = getIndexSort(db, "primary");
+        key = (char*) jsonGet(env->props, 0, primarySort, 0);
+        if ((cp = scontains(key, "${")) != 0) {
+            *cp = '\0';
+            env->keyPrefix = sclone(key);
+            env->mustMatch = 1;
+            jsonRemove(env->props, 0, primarySort);
+        }
+    }
     
     if (env->params->log) {
         rInfo("db", "Command: \"%s\" Properties:\n%s", cmd, jsonString(env->props, JSON_HUMAN));
@@ -1299,9 +2050,6 @@ static int setup(Db *db, cchar *modelName, Json *props, DbParams *params, cchar
 
 static void freeEnv(Env *env)
 {
-    RbNode *rp;
-    int    next;
-
     if (!env) {
         return;
     }
@@ -1309,12 +2057,34 @@ static void freeEnv(Env *env)
         jsonFree(env->props);
         env->props = 0;
     }
+    pruneExpired(env);
+    rFreeList(env->expiredItems);
+    env->expiredItems = 0;
+    rFree(env->keyPrefix);
+    env->keyPrefix = 0;
+    rFree(env->now);
+    env->now = 0;
+    rFree(env->predicates);
+    env->predicates = 0;
+}
+
+/*
+    Remove expired items found while matching
+ */
+static void pruneExpired(Env *env)
+{
+    RbNode *rp;
+    DbItem *item;
+    int    next;
+
     if (env->expiredItems) {
-        for (ITERATE_ITEMS(env->expiredItems, rp, next)) {
+        for (ITERATE_ITEMS(env->expiredItems, item, next)) {
             if (env->params->log) {
-                rInfo("db", "Remove expired item:\n%s", jsonString(toJson(rp->data), JSON_HUMAN));
+                rInfo("db", "Remove expired item:\n%s", jsonString(toJson(env->db, item), JSON_HUMAN));
+            }
+            if ((rp = rbLookup(env->db->primary, item, NULL)) != 0) {
+                removeItem(env->db, rp);
             }
-            rbRemove(env->index, rp, 0);
         }
         rClearList(env->expiredItems);
     }
@@ -1360,7 +2130,9 @@ PUBLIC const DbItem *dbCreate(Db *db, cchar *modelName, Json *props, DbParams *p
     item = allocItem(env.search.key, env.props, 0);
     env.props = 0;
 
-    rbInsert(env.index, item);
+    insertItem(db, item);
+    addIndexes(db, item);
+    cacheItem(db, item, 1);
     change(db, env.model, item, params, env.params->upsert ? "upsert" : "create");
 
     if (env.params->log) {
@@ -1389,8 +2161,8 @@ PUBLIC const DbItem *dbGet(Db *db, cchar *modelName, Json *props, DbParams *para
         return 0;
     }
     for (ITERATE_INDEX(env.index, rp, &env.search, &env)) {
-        item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        item = getItem(&env, rp);
+        if (!env.mustMatch || matchItem(item, env.props, 0, toJson(db, item), 0, &env)) {
             if (env.params->log) {
                 dbPrintItem(item);
             }
@@ -1418,10 +2190,10 @@ PUBLIC cchar *dbGetField(Db *db, cchar *modelName, cchar *fieldName, Json *props
         return 0;
     }
     for (ITERATE_INDEX(env.index, rp, &env.search, &env)) {
-        item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        item = getItem(&env, rp);
+        if (!env.mustMatch || matchItem(item, env.props, 0, toJson(db, item), 0, &env)) {
             freeEnv(&env);
-            return jsonGet(toJson(item), 0, fieldName, 0);
+            return jsonGet(toJson(db, item), 0, fieldName, 0);
         }
     }
     freeEnv(&env);
@@ -1487,11 +2259,8 @@ PUBLIC cchar *dbGetString(Db *db, cchar *modelName, cchar *fieldName, Json *prop
  */
 PUBLIC RList *dbFind(Db *db, cchar *modelName, Json *props, DbParams *params)
 {
-    Env    env;
-    RbNode *rp;
-    DbItem *item;
-    RList  *list;
-    int    count, limit;
+    Env   env;
+    RList *list;
 
     if (!db) {
         return 0;
@@ -1499,48 +2268,293 @@ PUBLIC RList *dbFind(Db *db, cchar *modelName, Json *props, DbParams *params)
     if (SETUP(db, modelName, props, params, "find", &env) < 0) {
         return 0;
     }
-    limit = env.params->limit ? env.params->limit : MAXINT;
+    list = findItems(&env);
+    freeEnv(&env);
+    return list;
+}
+
+/*
+    Find the items matching a prepared environment
+ */
+static RList *findItems(Env *env)
+{
+    RbNode *rp;
+    DbItem *item;
+    RList  *list;
+    int    count, limit;
+
+    limit = env->params->limit ? env->params->limit : MAXINT;
     if ((list = rAllocList(0, 0)) == 0) {
-        freeEnv(&env);
         return 0;
     }
     count = 0;
 
-    if (env.params->next) {
+    if (env->params->next) {
         //  Lookup the exact last item and then step forward and match with the search key
-        if ((rp = rbLookupFirst(env.index, &env.next, &env)) != 0) {
-            if (env.search.key) {
-                rp = rbLookupNext(env.index, rp, &env.search, &env);
+        if ((rp = lookupNext(env)) != 0) {
+            if (env->search.key) {
+                rp = rbLookupNext(env->index, rp, &env->search, env);
             } else {
-                rp = rbNext(env.index, rp);
+                rp = rbNext(env->index, rp);
             }
         }
-    } else if (env.search.key) {
-        rp = rbLookupFirst(env.index, &env.search, &env);
+    } else if (env->search.key) {
+        rp = rbLookupFirst(env->index, &env->search, env);
     } else {
-        rp = rbFirst(db->primary);
+        rp = rbFirst(env->index);
     }
     while (rp) {
-        item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        item = getItem(env, rp);
+        if (!env->mustMatch || matchItem(item, env->props, 0, toJson(env->db, item), 0, env)) {
             rPushItem(list, item);
             if (++count >= limit) {
                 break;
             }
         }
-        if (env.search.key) {
-            rp = rbLookupNext(env.index, rp, &env.search, &env);
+        if (env->search.key) {
+            rp = rbLookupNext(env->index, rp, &env->search, env);
         } else {
-            rp = rbNext(db->primary, rp);
+            rp = rbNext(env->index, rp);
         }
     }
-    if (env.params->log) {
+    if (env->params->log) {
         dbPrintList(list);
     }
-    freeEnv(&env);
     return list;
 }
 
+/*
+    Prepare a query for repeated execution. The properties are validated, templated and compiled once.
+ */
+PUBLIC DbQuery *dbPrepare(Db *db, cchar *modelName, Json *props, DbParams *params)
+{
+    DbQuery     *query;
+    DbPredicate *pp;
+    Env         *env;
+    JsonNode    *prop;
+
+    if (!db) {
+        return 0;
+    }
+    if ((query = rAllocType(DbQuery)) == 0) {
+        return 0;
+    }
+    if (params) {
+        query->params = *params;
+        if (params->index) {
+            query->index = sclone(params->index);
+            query->params.index = query->index;
+        }
+        query->params.next = 0;
+    }
+    env = &query->env;
+    if (SETUP(db, modelName, props, &query->params, "find", env) < 0) {
+        dbFreeQuery(query);
+        return 0;
+    }
+    //  Compile the top level properties to match. The sort key is matched via the index lookup.
+    env->predicates = rAlloc(sizeof(DbPredicate) * (size_t) max(env->props->count, 1));
+    for (ITERATE_JSON(env->props, 0, prop, nid)) {
+        if (smatch(prop->name, env->indexSort)) {
+            continue;
+        }
+        pp = &env->predicates[env->predicateCount++];
+        pp->name = prop->name;
+        pp->value = prop->value;
+        pp->nid = nid;
+        pp->type = prop->type;
+    }
+    return query;
+}
+
+/*
+    Execute a prepared query. The params may supply the limit and next pagination token for this execution.
+ */
+PUBLIC RList *dbFindPrepared(DbQuery *query, DbParams *params)
+{
+    Env   *env;
+    RList *list;
+
+    if (!query) {
+        return 0;
+    }
+    env = &query->env;
+    rFree(env->db->error);
+    env->db->error = 0;
+
+    query->params.limit = params ? params->limit : 0;
+    query->params.next = params ? params->next : 0;
+    env->next.key = (char*) query->params.next;
+
+    //  Expiry is evaluated against one timestamp per execution
+    rFree(env->now);
+    env->now = 0;
+
+    list = findItems(env);
+    pruneExpired(env);
+    return list;
+}
+
+PUBLIC void dbFreeQuery(DbQuery *query)
+{
+    if (query) {
+        freeEnv(&query->env);
+        rFree(query->index);
+        rFree(query);
+    }
+}
+
+/*
+    Open a cursor to iterate over matching items without building a result list
+ */
+PUBLIC DbCursor *dbCursorOpen(Db *db, cchar *modelName, Json *props, DbParams *params)
+{
+    DbCursor *cursor;
+
+    if ((cursor = rAllocType(DbCursor)) == 0) {
+        return 0;
+    }
+    if ((cursor->query = dbPrepare(db, modelName, props, params)) == 0) {
+        rFree(cursor);
+        return 0;
+    }
+    cursor->limit = (params && params->limit) ? params->limit : MAXINT;
+    if (params && params->next) {
+        cursor->key = sclone(params->next);
+    }
+    return cursor;
+}
+
+/*
+    Position the cursor on the first candidate node
+ */
+static RbNode *startCursor(DbCursor *cursor)
+{
+    Env    *env;
+    RbNode *rp;
+
+    env = &cursor->query->env;
+    if (cursor->key) {
+        //  Resume after a prior page of results
+        env->params->next = cursor->key;
+        env->next.key = cursor->key;
+        if ((rp = lookupNext(env)) != 0) {
+            rp = env->search.key ? rbLookupNext(env->index, rp, &env->search, env) : rbNext(env->index, rp);
+        }
+        env->params->next = 0;
+        env->next.key = 0;
+
+    } else if (env->search.key) {
+        rp = rbLookupFirst(env->index, &env->search, env);
+    } else {
+        rp = rbFirst(env->index);
+    }
+    return rp;
+}
+
+/*
+    Reposition the cursor after the last returned item when the index has been modified
+ */
+static RbNode *resumeCursor(DbCursor *cursor)
+{
+    DbIndexEntry probe;
+    DbItem       item;
+    Env          *env;
+    RbNode       *rp;
+
+    env = &cursor->query->env;
+    if (!cursor->key) {
+        return startCursor(cursor);
+    }
+    if (env->index == env->db->primary) {
+        rp = lookupAfter(env->index, &(DbItem) { .key = cursor->key });
+    } else {
+        item.key = cursor->key;
+        probe.index.key = cursor->indexKey;
+        probe.item = &item;
+        rp = lookupAfter(env->index, &probe);
+    }
+    if (rp && env->search.key && env->index->compare(&env->search, rp->data, env) != 0) {
+        rp = 0;
+    }
+    return rp;
+}
+
+/*
+    Return the next matching item or NULL when there are no more items.
+    The returned item is valid until the next database call that modifies the database.
+ */
+PUBLIC const DbItem *dbCursorNext(DbCursor *cursor)
+{
+    Env    *env;
+    RbNode *rp, *next;
+    DbItem *item;
+
+    if (!cursor || cursor->done) {
+        return 0;
+    }
+    env = &cursor->query->env;
+    if (cursor->count >= cursor->limit) {
+        cursor->done = 1;
+        return 0;
+    }
+    if (!cursor->started) {
+        rp = startCursor(cursor);
+        cursor->started = 1;
+    } else if (cursor->generation != env->db->generation) {
+        rp = resumeCursor(cursor);
+    } else {
+        rp = cursor->rp;
+    }
+    for (; rp; rp = next) {
+        item = getItem(env, rp);
+        next = env->search.key ? rbLookupNext(env->index, rp, &env->search, env) : rbNext(env->index, rp);
+        if (!env->mustMatch || matchItem(item, env->props, 0, toJson(env->db, item), 0, env)) {
+            rFree(cursor->key);
+            cursor->key = sclone(item->key);
+            if (env->index != env->db->primary) {
+                rFree(cursor->indexKey);
+                cursor->indexKey = sclone(((DbIndexEntry*) rp->data)->index.key);
+            }
+            cursor->rp = next;
+            cursor->generation = env->db->generation;
+            cursor->count++;
+            /*
+                Remove expired items now as other requests may remove them before the cursor is closed.
+                This changes the generation so the next call resumes from the cursor key.
+             */
+            pruneExpired(env);
+            return item;
+        }
+    }
+    cursor->rp = 0;
+    cursor->done = 1;
+    pruneExpired(env);
+    return 0;
+}
+
+/*
+    Get the pagination token to resume after the last returned item.
+    Returns NULL if all matching items have been returned.
+ */
+PUBLIC cchar *dbCursorToken(DbCursor *cursor)
+{
+    if (!cursor || !cursor->key || (cursor->done && cursor->count < cursor->limit)) {
+        return 0;
+    }
+    return cursor->key;
+}
+
+PUBLIC void dbCursorClose(DbCursor *cursor)
+{
+    if (cursor) {
+        dbFreeQuery(cursor->query);
+        rFree(cursor->key);
+        rFree(cursor->indexKey);
+        rFree(cursor);
+    }
+}
+
 /*
     Find one database item.
  */
@@ -1557,8 +2571,8 @@ PUBLIC const DbItem *dbFindOne(Db *db, cchar *modelName, Json *props, DbParams *
         return 0;
     }
     for (ITERATE_INDEX(env.index, rp, &env.search, &env)) {
-        item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        item = getItem(&env, rp);
+        if (!env.mustMatch || matchItem(item, env.props, 0, toJson(db, item), 0, &env)) {
             freeEnv(&env);
             return item;
         }
@@ -1591,9 +2605,9 @@ PUBLIC int dbRemove(Db *db, cchar *modelName, Json *props, DbParams *params)
     for (count = 0, rp = rbLookupFirst(env.index, search, &env); rp; rp = next) {
         next = rbLookupNext(env.index, rp, search, &env);
         item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        if (!env.mustMatch || matchItem(item, env.props, 0, toJson(db, item), 0, &env)) {
             change(db, env.model, item, params, "remove");
-            rbRemove(env.index, rp, 0);
+            removeItem(db, rp);
             if (++count >= limit) {
                 break;
             }
@@ -1648,7 +2662,7 @@ again:
                 if (rEmitLog("trace", "db")) {
                     rTrace("db", "Remove expired item:\n%s", jsonString(json, JSON_HUMAN));
                 }
-                rbRemove(db->primary, rp, 0);
+                removeItem(db, rp);
                 count++;
                 if (allocJson) {
                     jsonFree(allocJson);
@@ -1676,15 +2690,9 @@ again:
 PUBLIC void dbCompact(Db *db)
 {
     RbNode *rp;
-    DbItem *item;
 
     for (rp = rbFirst(db->primary); rp; rp = rbNext(db->primary, rp)) {
-        item = rp->data;
-        if (item->json) {
-            item->value = jsonToString(item->json, 0, 0, 0);
-            item->allocatedValue = 1;
-            jsonFree(item->json);
-        }
+        uncacheItem(db, rp->data, 1);
     }
 }
 
@@ -1711,7 +2719,7 @@ PUBLIC const DbItem *dbSetField(Db *db, cchar *modelName, cchar *fieldName, ccha
 
     for (ITERATE_INDEX(env.index, rp, &env.search, &env)) {
         item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        if (!env.mustMatch || matchItem(item, env.props, 0, toJson(db, item), 0, &env)) {
             break;
         }
         item = 0;
@@ -1720,20 +2728,24 @@ PUBLIC const DbItem *dbSetField(Db *db, cchar *modelName, cchar *fieldName, ccha
         if (env.params->upsert) {
             setTimestamps(env.model, env.props, "update");
             item = allocItem(env.search.key, env.props, 0);
-            rbInsert(env.index, item);
+            insertItem(db, item);
         } else {
             dberror(db, R_ERR_NOT_READY, "Cannot set field, item does not exist");
             freeEnv(&env);
             return 0;
         }
+    } else {
+        removeIndexes(db, item);
     }
     if (value == NULL) {
-        jsonRemove(toJson(item), 0, fieldName);
+        jsonRemove(toJson(db, item), 0, fieldName);
     } else {
-        json = toJson(item);
+        json = toJson(db, item);
         setTimestamps(env.model, json, "update");
         jsonSet(json, 0, fieldName, value, 0);
     }
+    addIndexes(db, item);
+    cacheItem(db, item, 1);
     change(db, env.model, item, params, env.params->upsert ? "upsert" : "update");
     freeEnv(&env);
     return item;
@@ -1800,7 +2812,7 @@ PUBLIC const DbItem *dbUpdate(Db *db, cchar *modelName, Json *props, DbParams *p
     item = 0;
     for (ITERATE_INDEX(env.index, rp, &env.search, &env)) {
         item = rp->data;
-        if (!env.mustMatch || matchItem(rp, env.props, 0, toJson(item), 0, &env)) {
+        if (!env.mustMatch || matchItem(item, env.props, 0, toJson(db, item), 0, &env)) {
             break;
         }
         item = 0;
@@ -1808,13 +2820,14 @@ PUBLIC const DbItem *dbUpdate(Db *db, cchar *modelName, Json *props, DbParams *p
     setTimestamps(env.model, env.props, "update");
 
     if (item) {
+        removeIndexes(db, item);
         if (env.params->upsert) {
             env.props->userFlags &= (uchar) ~USER_ALLOC;
-            clearItem(item);
+            clearItem(db, item);
             item->json = env.props;
         } else {
             //  Preserve existing properties that are not being updated
-            jsonBlend(toJson(item), 0, 0, env.props, 0, 0, JSON_REMOVE_UNDEF);
+            jsonBlend(toJson(db, item), 0, 0, env.props, 0, 0, JSON_REMOVE_UNDEF);
         }
 
     } else {
@@ -1824,9 +2837,11 @@ PUBLIC const DbItem *dbUpdate(Db *db, cchar *modelName, Json *props, DbParams *p
             return 0;
         }
         if ((item = allocItem(env.search.key, env.props, 0)) != 0) {
-            rbInsert(env.index, item);
+            insertItem(db, item);
         }
     }
+    addIndexes(db, item);
+    cacheItem(db, item, 1);
     change(db, env.model, item, params, env.params->upsert ? "upsert" : "update");
     freeEnv(&env);
     return item;
@@ -1837,17 +2852,26 @@ PUBLIC cchar *dbField(const DbItem *item, cchar *fieldName)
     if (!item || !fieldName) {
         return 0;
     }
-    return jsonGet(toJson((DbItem*) item), 0, fieldName, 0);
+    return jsonGet(toJson(0, (DbItem*) item), 0, fieldName, 0);
 }
 
+/*
+    The JSON numeric getters cache the parsed number in the item node
+ */
 PUBLIC double dbFieldDouble(const DbItem *item, cchar *fieldName)
 {
-    return stof(dbField(item, fieldName));
+    if (!item || !fieldName) {
+        return 0;
+    }
+    return jsonGetDouble(toJson(0, (DbItem*) item), 0, fieldName, 0);
 }
 
 PUBLIC int64 dbFieldNumber(const DbItem *item, cchar *fieldName)
 {
-    return stoi(dbField(item, fieldName));
+    if (!item || !fieldName) {
+        return 0;
+    }
+    return jsonGetNum(toJson(0, (DbItem*) item), 0, fieldName, 0);
 }
 
 PUBLIC bool dbFieldBool(const DbItem *item, cchar *fieldName)
@@ -1880,7 +2904,7 @@ PUBLIC char *dbListToString(RList *items)
     buf = rAllocBuf(0);
     rPutCharToBuf(buf, '[');
     for (ITERATE_ITEMS(items, item, index)) {
-        rPutStringToBuf(buf, jsonToString(toJson((DbItem*) item), 0, 0, 0));
+        rPutStringToBuf(buf, jsonToString(toJson(0, (DbItem*) item), 0, 0, 0));
         rPutCharToBuf(buf, ',');
     }
     rAdjustBufEnd(buf, -1);
@@ -1893,7 +2917,7 @@ static void printItem(DbItem *item)
     char *value;
 
     if (!item) return;
-    value = jsonToString(toJson(item), 0, 0, JSON_HUMAN);
+    value = jsonToString(toJson(0, item), 0, 0, JSON_HUMAN);
     value[slen(value) - 1] = '\0';
     rPrintf("%s", value);
     rFree(value);
@@ -1909,7 +2933,7 @@ PUBLIC void dbPrintItem(const DbItem *item)
     char *value;
 
     if (item) {
-        value = jsonToString(toJson((DbItem*) item), 0, 0, JSON_HUMAN);
+        value = jsonToString(toJson(0, (DbItem*) item), 0, 0, JSON_HUMAN);
         rPrintf("%s: %s\n", item->key, value);
         rFree(value);
     } else {
@@ -1924,43 +2948,189 @@ PUBLIC void dbPrintList(RList *list)
     int          index;
 
     for (ITERATE_ITEMS(list, item, index)) {
-        value = jsonToString(toJson((DbItem*) item), 0, 0, JSON_HUMAN);
+        value = jsonToString(toJson(0, (DbItem*) item), 0, 0, JSON_HUMAN);
         rPrintf("    %s: %s\n", item->key, value);
         rFree(value);
     }
 
 }
 
-PUBLIC void dbPrintProperties(Json *props)
+PUBLIC void dbPrintProperties(Json *props)
+{
+    rPrintf("Properties\n%s\n", jsonToString(props, 0, 0, JSON_HUMAN));
+}
+
+PUBLIC void dbPrint(Db *db)
+{
+    RbNode *rp;
+
+    for (rp = rbFirst(db->primary); rp; rp = rbNext(db->primary, rp)) {
+        dbPrintItem(rp->data);
+    }
+}
+
+/*
+    This will convert an item value to JSON for queries and will create item.json and zero item.value.
+    If the database is supplied, the item is added to the parsed item cache. The public APIs that
+    are not given the database parse without caching and the item is cached when next accessed via the database.
+ */
+static Json *toJson(Db *db, DbItem *item)
+{
+    if (!item) {
+        return 0;
+    }
+    if (!item->json) {
+        item->json = jsonParse(item->value, 0);
+        if (item->allocatedValue) {
+            rFree(item->value);
+        }
+        item->value = 0;
+        if (db) {
+            db->cacheMisses++;
+        }
+    } else if (db) {
+        db->cacheHits++;
+    }
+    if (db) {
+        cacheItem(db, item, 0);
+    }
+    return item->json;
+}
+
+/*
+    Estimate the memory used by parsed item JSON
+ */
+static size_t getJsonSize(Json *json)
+{
+    JsonNode *node;
+    size_t   size;
+    int      i;
+
+    size = sizeof(Json) + (size_t) json->size * sizeof(JsonNode);
+    if (json->text) {
+        size += (size_t) (json->end - json->text);
+    }
+    for (i = 0; i < json->count; i++) {
+        node = &json->nodes[i];
+        if (node->allocatedName) {
+            size += slen(node->name) + 1;
+        }
+        if (node->allocatedValue) {
+            size += slen(node->value) + 1;
+        }
+    }
+    return size;
+}
+
+/*
+    Make the item the most recently used parsed item and evict the least recently used items
+    if the cache exceeds its budget. The given item is never evicted.
+    The item size is estimated when first cached and when resize is set after the item is modified.
+    Sizes are not tracked if the cache is unlimited. See dbSetCacheSize.
+ */
+static void cacheItem(Db *db, DbItem *item, bool resize)
 {
-    rPrintf("Properties\n%s\n", jsonToString(props, 0, 0, JSON_HUMAN));
-}
+    DbCached *cp;
 
-PUBLIC void dbPrint(Db *db)
-{
-    RbNode *rp;
+    if (!item || !item->json) {
+        return;
+    }
+    if ((cp = item->cached) != 0) {
+        if (cp != db->cache) {
+            //  Unlink and reinsert at the head
+            cp->prev->next = cp->next;
+            cp->next->prev = cp->prev;
+            cp->next = db->cache;
+            cp->prev = db->cache->prev;
+            cp->prev->next = cp;
+            cp->next->prev = cp;
+            db->cache = cp;
+        }
+        if (!resize || !db->cacheMax) {
+            return;
+        }
+        db->cacheSize -= cp->size;
 
-    for (rp = rbFirst(db->primary); rp; rp = rbNext(db->primary, rp)) {
-        dbPrintItem(rp->data);
+    } else {
+        if ((cp = rAllocType(DbCached)) == 0) {
+            return;
+        }
+        cp->item = item;
+        item->cached = cp;
+        if (db->cache) {
+            cp->next = db->cache;
+            cp->prev = db->cache->prev;
+            cp->prev->next = cp;
+            cp->next->prev = cp;
+        } else {
+            cp->next = cp->prev = cp;
+        }
+        db->cache = cp;
+    }
+    if (!db->cacheMax) {
+        return;
+    }
+    cp->size = getJsonSize(item->json);
+    db->cacheSize += cp->size;
+
+    while (db->cacheMax && db->cacheSize > db->cacheMax && db->cache->prev != cp) {
+        uncacheItem(db, db->cache->prev->item, 1);
+        db->cacheEvictions++;
     }
 }
 
 /*
-    This will convert an item value to JSON for queries and will create item.json and zero item.value
+    Remove an item from the parsed item cache. If compact is set, the parsed JSON is converted
+    back to a string and freed.
  */
-static Json *toJson(DbItem *item)
+static void uncacheItem(Db *db, DbItem *item, bool compact)
 {
-    if (!item) {
-        return 0;
+    DbCached *cp;
+
+    if ((cp = item->cached) != 0) {
+        if (cp->next == cp) {
+            db->cache = 0;
+        } else {
+            cp->prev->next = cp->next;
+            cp->next->prev = cp->prev;
+            if (db->cache == cp) {
+                db->cache = cp->next;
+            }
+        }
+        db->cacheSize -= cp->size;
+        item->cached = 0;
+        rFree(cp);
     }
-    if (!item->json) {
-        item->json = jsonParse(item->value, 0);
+    if (compact && item->json) {
         if (item->allocatedValue) {
             rFree(item->value);
         }
-        item->value = 0;
+        item->value = jsonToString(item->json, 0, 0, 0);
+        item->allocatedValue = 1;
+        jsonFree(item->json);
+        item->json = 0;
+    }
+}
+
+PUBLIC void dbSetCacheSize(Db *db, size_t size)
+{
+    DbCached *cp;
+
+    if (size && !db->cacheMax && db->cache) {
+        //  Sizes are not tracked while the cache is unlimited
+        db->cacheSize = 0;
+        cp = db->cache;
+        do {
+            cp->size = getJsonSize(cp->item->json);
+            db->cacheSize += cp->size;
+            cp = cp->next;
+        } while (cp != db->cache);
+    }
+    db->cacheMax = size;
+    while (db->cacheMax && db->cacheSize > db->cacheMax && db->cache) {
+        uncacheItem(db, db->cache->prev->item, 1);
+        db->cacheEvictions++;
     }
-    return item->json;
 }
 
 /*
@@ -1971,7 +3141,7 @@ static Json *toJson(DbItem *item)
  */
 PUBLIC const Json *dbJson(const DbItem *citem)
 {
-    return toJson((DbItem*) citem);
+    return toJson(0, (DbItem*) citem);
 }
 
 PUBLIC cchar *dbString(const DbItem *citem, int flags)
@@ -2177,20 +3347,41 @@ static void selectProperties(Db *db, DbModel *model, Json *props, DbParams *para
     Match an item in n1 against a target in n2.
     Env provides the comparison options
  */
-static bool matchItem(RbNode *rp, Json *j1, JsonNode *n1, Json *j2, JsonNode *n2, Env *env)
+static bool matchItem(DbItem *item, Json *j1, JsonNode *n1, Json *j2, JsonNode *n2, Env *env)
 {
-    JsonNode *c1, *c2;
-    cchar    *expires;
-    char     *now;
-    int      nid, rc;
+    DbPredicate *pp;
+    JsonNode    *c1, *c2;
+    cchar       *expires;
+    int         i, nid, rc;
 
     if (j2->count == 0) {
         return 0;
     }
+    if (n1 == 0 && env->keyPrefix && !sstarts(item->key, env->keyPrefix)) {
+        return 0;
+    }
     if (n2 == 0) {
         n2 = jsonGetNode(j2, 0, 0);
     }
-    if (j1->count > 0) {
+    if (n1 == 0 && env->predicates) {
+        /*
+            Match compiled properties of a prepared query
+         */
+        for (i = 0, pp = env->predicates; i < env->predicateCount; i++, pp++) {
+            if ((c2 = jsonGetNode(j2, jsonGetNodeId(j2, n2), pp->name)) == 0) {
+                return 0;
+            }
+            if (scmp(pp->value, c2->value) != 0) {
+                return 0;
+            }
+            if ((pp->type == JSON_OBJECT || pp->type == JSON_ARRAY) && (int) c2->type == pp->type) {
+                if (!matchItem(item, j1, &j1->nodes[pp->nid], j2, c2, env)) {
+                    return 0;
+                }
+            }
+        }
+
+    } else if (j1->count > 0) {
         if (n1 == 0) {
             n1 = jsonGetNode(j1, 0, 0);
         }
@@ -2209,12 +3400,12 @@ static bool matchItem(RbNode *rp, Json *j1, JsonNode *n1, Json *j2, JsonNode *n2
             if (rc != 0) return 0;
 
             if (c1->type == JSON_OBJECT && c2->type == JSON_OBJECT) {
-                if (!matchItem(rp, j1, c1, j2, c2, env)) {
+                if (!matchItem(item, j1, c1, j2, c2, env)) {
                     return 0;
                 }
             }
             if (c1->type == JSON_ARRAY && c2->type == JSON_ARRAY) {
-                if (!matchItem(rp, j1, c1, j2, c2, env)) {
+                if (!matchItem(item, j1, c1, j2, c2, env)) {
                     return 0;
                 }
             }
@@ -2230,16 +3421,17 @@ static bool matchItem(RbNode *rp, Json *j1, JsonNode *n1, Json *j2, JsonNode *n2
     }
     if (rc && env->model->expiresField) {
         expires = jsonGet(j2, 0, env->model->expiresField, 0);
-        now = rGetIsoDate(rGetTime());
-        if (expires && scmp(expires, now) <= 0) {
-            //  Add item to expired list to cleanup in freeEnv
+        if (!env->now) {
+            env->now = rGetIsoDate(rGetTime());
+        }
+        if (expires && scmp(expires, env->now) <= 0) {
+            //  Add item to expired list to cleanup in pruneExpired before the caller can run
             if (!env->expiredItems) {
                 env->expiredItems = rAllocList(0, 0);
             }
-            rAddItem(env->expiredItems, rp);
+            rAddItem(env->expiredItems, item);
             rc = 0;
         }
-        rFree(now);
     }
     return rc;
 }
@@ -2384,13 +3576,22 @@ static void freeItem(Db *db, DbItem *item)
         rFree(item->key);
         item->key = 0;
     }
-    clearItem(item);
+    clearItem(db, item);
     rFree(item);
 }
 
-static void clearItem(DbItem *item)
+static void freeEntry(Db *db, DbIndexEntry *entry)
+{
+    if (entry) {
+        rFree(entry->index.key);
+        rFree(entry);
+    }
+}
+
+static void clearItem(Db *db, DbItem *item)
 {
     if (item) {
+        uncacheItem(db, item, 0);
         if (item->allocatedValue) {
             rFree(item->value);
             item->value = 0;
@@ -2409,12 +3610,165 @@ static cchar *getIndexName(Db *db, DbParams *params)
 }
 
 /*
-    Get the index to use for this API call. Currently only supports a primary index.
-    Defaults to the primary if params is null.
+    Get the named index tree. Returns null if the index is not defined or not maintained locally.
+ */
+static RbTree *getIndex(Db *db, cchar *name)
+{
+    DbIndex *index;
+
+    if (smatch(name, "primary")) {
+        return db->primary;
+    }
+    if ((index = rLookupName(db->indexes, name)) == 0) {
+        return 0;
+    }
+    return index->tree;
+}
+
+/*
+    Get the item for an index node. Secondary index nodes reference the primary item.
+ */
+static DbItem *getItem(Env *env, RbNode *rp)
+{
+    if (env->index == env->db->primary) {
+        return rp->data;
+    }
+    return ((DbIndexEntry*) rp->data)->item;
+}
+
+/*
+    Find the first primary item with a key greater than the given key
+ */
+static RbNode *lookupAfter(RbTree *rbt, cvoid *probe)
+{
+    RbNode *p, *found;
+
+    found = 0;
+    for (p = RB_FIRST(rbt); p != RB_NIL(rbt); ) {
+        if (rbt->compare(probe, p->data, NULL) < 0) {
+            found = p;
+            p = p->left;
+        } else {
+            p = p->right;
+        }
+    }
+    return found;
+}
+
+/*
+    Lookup the index node for the last item of a prior page of results.
+    The pagination token is the primary key of the last item.
+ */
+static RbNode *lookupNext(Env *env)
+{
+    DbIndexEntry probe;
+    DbIndex      *index;
+    RbNode       *rp;
+    Json         *json, *allocJson;
+    cchar        *key;
+
+    if (env->index == env->db->primary) {
+        return rbLookupFirst(env->index, &env->next, env);
+    }
+    if ((rp = rbLookup(env->db->primary, &env->next, NULL)) == 0) {
+        return 0;
+    }
+    probe.item = rp->data;
+    index = rLookupName(env->db->indexes, getIndexName(env->db, env->params));
+
+    allocJson = 0;
+    json = probe.item->json ? probe.item->json : (allocJson = jsonParse(probe.item->value, 0));
+    if ((key = jsonGet(json, 0, index->sort, 0)) != 0) {
+        probe.index.key = (char*) key;
+        rp = rbLookup(index->tree, &probe, NULL);
+    } else {
+        rp = 0;
+    }
+    jsonFree(allocJson);
+    return rp;
+}
+
+/*
+    Insert an item into the primary index. An existing item with the same key is replaced and freed,
+    so it is first removed from the secondary indexes. Caller must call addIndexes for the new item.
+ */
+static void insertItem(Db *db, DbItem *item)
+{
+    RbNode *rp;
+
+    if (db->indexes && (rp = rbLookup(db->primary, item, NULL)) != 0) {
+        removeIndexes(db, rp->data);
+    }
+    rbInsert(db->primary, item);
+    db->generation++;
+}
+
+/*
+    Remove and free an item from the primary and all secondary indexes
+ */
+static void removeItem(Db *db, RbNode *rp)
+{
+    markDirty(db, ((DbItem*) rp->data)->key);
+    removeIndexes(db, rp->data);
+    rbRemove(db->primary, rp, 0);
+    db->generation++;
+}
+
+/*
+    Add or remove an item from the secondary indexes.
+    Must be called before an item is modified (remove) and after (add) so the index keys are current.
  */
-static RbTree *getIndex(Db *db, DbParams *params)
+static void updateIndexes(Db *db, DbItem *item, bool add)
+{
+    DbIndexEntry *entry, probe;
+    DbIndex      *index;
+    RbNode       *rp;
+    RName        *np;
+    Json         *json, *allocJson;
+    cchar        *key;
+
+    if (!db->indexes || !item) {
+        return;
+    }
+    db->generation++;
+
+    //  Don't retain a parsed tree for compact items
+    allocJson = 0;
+    json = item->json ? item->json : (allocJson = jsonParse(item->value, 0));
+
+    for (ITERATE_NAME_DATA(db->indexes, np, index)) {
+        if ((key = jsonGet(json, 0, index->sort, 0)) == 0) {
+            //  Sparse index
+            continue;
+        }
+        if (add) {
+            if ((entry = rAllocType(DbIndexEntry)) == 0) {
+                break;
+            }
+            entry->index.key = sclone(key);
+            entry->index.allocatedName = 1;
+            entry->item = item;
+            rbInsert(index->tree, entry);
+
+        } else {
+            probe.index.key = (char*) key;
+            probe.item = item;
+            if ((rp = rbLookup(index->tree, &probe, NULL)) != 0) {
+                rbRemove(index->tree, rp, 0);
+            }
+        }
+    }
+    jsonFree(allocJson);
+}
+
+static void addIndexes(Db *db, DbItem *item)
 {
-    return db->primary;
+    updateIndexes(db, item, 1);
+}
+
+static void removeIndexes(Db *db, DbItem *item)
+{
+    updateIndexes(db, item, 0);
 }
 
 /*
@@ -2520,32 +3874,45 @@ static int readItem(FILE *fp, DbItem **item)
 }
 
 /*
-    Persist an item to the on-disk store
+    Read a base snapshot item and accumulate the record checksum
  */
-static int writeItem(FILE *fp, DbItem *item)
+static int readSegmentItem(FILE *fp, DbItem **item, uint32 *crc)
 {
-    char     *value;
     uint32_t length;
+    char     key[DB_MAX_KEY];
+    char     *data;
 
-    length = (uint32_t) slen(item->key);
-    if (fwrite(&length, sizeof(length), 1, fp) != 1) {
-        return R_ERR_CANT_WRITE;
+    *item = 0;
+    if (fread(&length, sizeof(length), 1, fp) != 1) {
+        return R_ERR_CANT_READ;
     }
-    if (fwrite(item->key, (size_t) length, 1, fp) != 1) {
-        return R_ERR_CANT_WRITE;
+    if (length == 0 || length > DB_MAX_KEY) {
+        return R_ERR_BAD_STATE;
     }
-    value = item->json ? jsonToString(item->json, 0, 0, 0) : item->value;
+    *crc = getCrc(*crc, &length, sizeof(length));
+    if (fread(key, (size_t) length, 1, fp) != 1) {
+        return R_ERR_CANT_READ;
+    }
+    *crc = getCrc(*crc, key, length);
+    key[length - 1] = '\0';
 
-    length = (uint32_t) slen(value);
-    if (fwrite(&length, sizeof(length), 1, fp) != 1) {
-        return R_ERR_CANT_WRITE;
+    if (fread(&length, sizeof(length), 1, fp) != 1) {
+        return R_ERR_CANT_READ;
     }
-    if (fwrite(value, (size_t) length, 1, fp) != 1) {
-        return R_ERR_CANT_WRITE;
+    if (length == 0 || length > DB_MAX_ITEM + 1) {
+        return R_ERR_BAD_STATE;
     }
-    if (value != item->value) {
-        rFree(value);
+    *crc = getCrc(*crc, &length, sizeof(length));
+    if ((data = rAlloc((size_t) length)) == 0) {
+        return R_ERR_MEMORY;
     }
+    if (fread(data, (size_t) length, 1, fp) != 1) {
+        rFree(data);
+        return R_ERR_CANT_READ;
+    }
+    *crc = getCrc(*crc, data, length);
+    data[length - 1] = '\0';
+    *item = allocItem(key, 0, data);
     return 0;
 }
 
@@ -2576,6 +3943,7 @@ static void change(Db *db, DbModel *model, DbItem *item, DbParams *params, cchar
     Ticks    delay, when;
     int      events;
 
+    markDirty(db, item->key);
     delay = getDelay(db, model, params);
     if (delay > 0) {
         /*
@@ -2659,37 +4027,86 @@ static void commitChange(Db *db)
 /*
     Write a changed item to the journal and handle journal resets
     Errors are handled by low level I/O routines setting db->journalError
+
+    Each journal record is a length and CRC header followed by the payload of three null terminated
+    strings: command, model name and item value. Records are appended to the journal buffer and
+    written according to the journal sync policy.
  */
 static int writeChangeToJournal(Db *db, DbModel *model, DbItem *item, cchar *cmd)
 {
-    char *value;
-    int  bufsize;
+    char     *value;
+    uint32_t hdr[2];
+    size_t   cmdLen, modelLen, valueLen;
 
     //  Journal will be unset when booting and applying prior journal
     if (!db->journal) return 0;
 
-    /*
-        Compute the size of the change record as three null terminated strings.
-        The string lengths are not read into the buffer.
-     */
     value = item->json ? jsonToString(item->json, 0, 0, 0) : item->value;
-    bufsize = (int) (slen(cmd) + slen(model->name) + slen(value) + 3);
     item->delayed = 0;
 
-    //  These set journalError on errors - handled below
-    writeSize(db, (uint32_t) bufsize);
-    writeBlock(db, cmd);
-    writeBlock(db, model->name);
-    writeBlock(db, value);
-
+    cmdLen = slen(cmd) + 1;
+    modelLen = slen(model->name) + 1;
+    valueLen = slen(value) + 1;
+    hdr[0] = (uint32_t) (cmdLen + modelLen + valueLen);
+    hdr[1] = getCrc(getCrc(getCrc(0, cmd, cmdLen), model->name, modelLen), value, valueLen);
+
+    if (rPutBlockToBuf(db->journalBuf, (cchar*) hdr, sizeof(hdr)) != sizeof(hdr) ||
+        rPutBlockToBuf(db->journalBuf, cmd, cmdLen) != (ssize) cmdLen ||
+        rPutBlockToBuf(db->journalBuf, model->name, modelLen) != (ssize) modelLen ||
+        rPutBlockToBuf(db->journalBuf, value, valueLen) != (ssize) valueLen) {
+        dberror(db, R_ERR_MEMORY, "Cannot buffer journal record");
+        db->journalError = 1;
+    }
     if (value != item->value) {
         rFree(value);
     }
-    if (fflush(db->journal) < 0 || rFlushFile(fileno(db->journal)) < 0) {
+    db->journalSize += sizeof(hdr) + hdr[0];
+    db->pending++;
+
+    if (db->journalSync != DB_SYNC_BATCH || db->pending >= db->syncCount) {
+        syncJournal(db);
+    } else if (!db->syncEvent) {
+        db->syncEvent = rStartEvent((REventProc) syncJournalEvent, db, db->syncDelay);
+    }
+    return flushJournal(db);
+}
+
+/*
+    Write pending journal records with a single write and (unless DB_SYNC_NONE) a single fsync
+ */
+static int syncJournal(Db *db)
+{
+    RBuf   *buf;
+    size_t len;
+
+    if (db->syncEvent) {
+        rStopEvent(db->syncEvent);
+        db->syncEvent = 0;
+    }
+    buf = db->journalBuf;
+    if (!buf || !db->journal || (len = (size_t) rGetBufLength(buf)) == 0) {
+        return 0;
+    }
+    if (fwrite(buf->start, len, 1, db->journal) != 1) {
+        dberror(db, R_ERR_CANT_WRITE, "Cannot write to db journal file");
+        db->journalError = 1;
+
+    } else if (fflush(db->journal) < 0 ||
+               (db->journalSync != DB_SYNC_NONE && rFlushFile(fileno(db->journal)) < 0)) {
         dberror(db, R_ERR_CANT_WRITE, "Cannot flush journal: %d", errno);
         db->journalError = 1;
     }
-    return flushJournal(db);
+    rFlushBuf(db->journalBuf);
+    db->pending = 0;
+    return db->journalError ? R_ERR_CANT_WRITE : 0;
+}
+
+static void syncJournalEvent(Db *db)
+{
+    db->syncEvent = 0;
+    if (syncJournal(db) < 0) {
+        flushJournal(db);
+    }
 }
 
 static int flushJournal(Db *db)
@@ -2701,7 +4118,7 @@ static int flushJournal(Db *db)
         (rGetTicks() - db->journalCreated) >= db->maxJournalAge) {
         if (db->servicing) {
             db->needSave = 1;
-        } else if (dbSave(db, NULL) < 0) {
+        } else if (autoSave(db) < 0) {
             return R_ERR_CANT_WRITE;
         }
 
@@ -2711,33 +4128,30 @@ static int flushJournal(Db *db)
     return db->journalError ? R_ERR_CANT_WRITE : 0;
 }
 
-static int writeSize(Db *db, uint32_t len)
-{
-    if (fwrite(&len, sizeof(len), 1, db->journal) != 1) {
-        db->journalError = 1;
-        return dberror(db, R_ERR_CANT_WRITE, "Cannot write to db journal file");
-    }
-    return 0;
-}
-
 /*
-    Write the string including the trailing null
+    CRC-32 (IEEE 802.3) used to detect torn or corrupt journal records
  */
-static int writeBlock(Db *db, cchar *buf)
+static uint32 getCrc(uint32 crc, cvoid *buf, size_t len)
 {
-    uint32_t len;
-
-    len = (uint32_t) (slen(buf) + 1);
-    if (fwrite(&len, sizeof(len), 1, db->journal) != 1) {
-        db->journalError = 1;
-        return dberror(db, R_ERR_CANT_WRITE, "Cannot write to db journal file");
+    static uint32 table[256];
+    cuchar        *cp;
+    uint32        c;
+    int           i, j;
+
+    if (table[1] == 0) {
+        for (i = 0; i < 256; i++) {
+            c = (uint32) i;
+            for (j = 0; j < 8; j++) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
     }
-    if (fwrite(buf, (size_t) len, 1, db->journal) != 1) {
-        db->journalError = 1;
-        return dberror(db, R_ERR_CANT_WRITE, "Cannot write to db journal file");
+    crc = ~crc;
+    for (cp = buf; len > 0; len--) {
+        crc = table[(crc ^ *cp++) & 0xFF] ^ (crc >> 8);
     }
-    db->journalSize += sizeof(len) + (size_t) len;
-    return 0;
+    return ~crc;
 }
 
 /*
@@ -2750,12 +4164,20 @@ static int recreateJournal(Db *db)
     if (db->journal) {
         fclose(db->journal);
     }
+    //  Pending records are discarded as the database has been saved or is being recreated
+    if (db->syncEvent) {
+        rStopEvent(db->syncEvent);
+        db->syncEvent = 0;
+    }
+    rFlushBuf(db->journalBuf);
+    db->pending = 0;
+
     if ((db->journal = fopen(db->journalPath, "w")) == NULL) {
         return dberror(db, R_ERR_CANT_OPEN, "Cannot open database journal %s, errno %d",
                        db->journalPath, errno);
     }
-    version = DB_VERSION;
-    if (fwrite(&version, sizeof(version), 1, db->journal) != 1) {
+    version = DB_JOURNAL_VERSION;
+    if (fwrite(&version, sizeof(version), 1, db->journal) != 1 || fflush(db->journal) < 0) {
         return dberror(db, R_ERR_CANT_WRITE, "Cannot write version to db journal file");
     }
     db->journalCreated = rGetTicks();
@@ -2768,7 +4190,7 @@ static int recreateJournal(Db *db)
     Apply the journal of changes to the database state
     Return 1 if journal data was applied, 0 if not, negative for errors.
  */
-static int applyJournal(Db *db)
+static int applyJournal(Db *db, cchar *path)
 {
     struct stat sbuf;
     FILE        *fp;
@@ -2778,20 +4200,26 @@ static int applyJournal(Db *db)
     size_t      bufsize;
     int         rc;
 
-    if (stat(db->journalPath, &sbuf) < 0 || sbuf.st_size == 0) {
+    if (stat(path, &sbuf) < 0 || sbuf.st_size == 0) {
         return 0;
     }
-    if ((fp = fopen(db->journalPath, "r")) == NULL) {
-        return dberror(db, R_ERR_CANT_OPEN, "Cannot open database journal %s, errno %d", db->journalPath, errno);
+    if ((fp = fopen(path, "r")) == NULL) {
+        return dberror(db, R_ERR_CANT_OPEN, "Cannot open database journal %s, errno %d", path, errno);
     }
     if (fread(&version, sizeof(version), 1, fp) != 1) {
         fclose(fp);
-        return dberror(db, R_ERR_CANT_OPEN, "Cannot read database journal %s, errno %d", db->journalPath, errno);
+        return dberror(db, R_ERR_CANT_OPEN, "Cannot read database journal %s, errno %d", path, errno);
+    }
+    if (version == DB_JOURNAL_VERSION) {
+        rc = applyRecords(db, fp);
+        fclose(fp);
+        return rc;
     }
-    if (version != DB_VERSION) {
+    if (version != DB_LEGACY_VERSION) {
         fclose(fp);
         return dberror(db, R_ERR_CANT_OPEN, "Incorrect database journal version %d", version);
     }
+    //  Legacy journal without record checksums
     buf = rAllocBuf(ME_BUFSIZE);
     rc = 0;
     while ((bufsize = readSize(fp)) != 0) {
@@ -2816,6 +4244,82 @@ static int applyJournal(Db *db)
     return rc;
 }
 
+/*
+    Apply checksummed journal records. A short or corrupt record marks the torn tail of a journal
+    that was being written when the system stopped. It and any following data are ignored.
+ */
+static int applyRecords(Db *db, FILE *fp)
+{
+    RBuf  *buf;
+    cchar *cmd, *model, *value;
+    int   rc, status;
+
+    buf = rAllocBuf(ME_BUFSIZE);
+    rc = 0;
+    cmd = model = value = 0;
+    while ((status = readRecord(db, fp, buf, &cmd, &model, &value)) > 0) {
+        if (!cmd || !*cmd || !model || !value) {
+            status = R_ERR_BAD_STATE;
+            break;
+        }
+        if (applyChange(db, cmd, model, value) < 0) {
+            rc = R_ERR_CANT_READ;
+            break;
+        }
+        rc++;
+        rFlushBuf(buf);
+    }
+    if (status < 0) {
+        rError("db", "Discarding torn journal record after %d changes", rc);
+    }
+    rFreeBuf(buf);
+    return rc;
+}
+
+/*
+    Read and verify one journal record. Returns 1 if a record was read, 0 at the end of the journal
+    and negative if the record is short or corrupt.
+ */
+static int readRecord(Db *db, FILE *fp, RBuf *buf, cchar **cmd, cchar **model, cchar **value)
+{
+    uint32_t hdr[2];
+    cchar    *start, *end, *cp;
+    size_t   len;
+
+    *cmd = *model = *value = 0;
+    len = fread(hdr, 1, sizeof(hdr), fp);
+    if (len == 0) {
+        return 0;
+    }
+    if (len != sizeof(hdr) || hdr[0] < 3 || hdr[0] > DB_MAX_ITEM + 2 * DB_MAX_KEY) {
+        return R_ERR_BAD_STATE;
+    }
+    if (rReserveBufSpace(buf, hdr[0]) < 0) {
+        return dberror(db, R_ERR_MEMORY, "Cannot allocate journal record buffer");
+    }
+    start = rGetBufStart(buf);
+    if (fread((char*) start, hdr[0], 1, fp) != 1 || getCrc(0, start, hdr[0]) != hdr[1]) {
+        return R_ERR_BAD_STATE;
+    }
+    end = &start[hdr[0]];
+    if (end[-1] != '\0') {
+        return R_ERR_BAD_STATE;
+    }
+    *cmd = start;
+    for (cp = start; *cp; cp++) {}
+    if (++cp >= end) {
+        return R_ERR_BAD_STATE;
+    }
+    *model = cp;
+    for (; *cp; cp++) {}
+    if (++cp >= end) {
+        return R_ERR_BAD_STATE;
+    }
+    *value = cp;
+    rAdjustBufEnd(buf, (ssize) hdr[0]);
+    return 1;
+}
+
 static size_t readSize(FILE *fp)
 {
     uint32_t len;
@@ -2928,10 +4432,15 @@ static void invokeCallbacks(Db *db, DbModel *model, DbItem *item, DbParams *para
     }
 }
 
-PUBLIC void dbSetJournalParams(Db *db, Ticks delay, size_t maxSize)
+PUBLIC void dbSetJournalParams(Db *db, Ticks delay, size_t maxSize, int sync)
 {
     db->maxJournalAge = delay;
     db->maxJournalSize = maxSize;
+    if (sync != db->journalSync) {
+        //  Write any batched records before changing policy
+        syncJournal(db);
+        db->journalSync = sync;
+    }
 }
 
 static void addContext(Db *db, Json *props)
@@ -2970,6 +4479,22 @@ static int compareItems(cvoid *n1, cvoid *n2, Env *env)
     return scmp(d1->key, d2->key);
 }
 
+/*
+    Compare secondary index entries.
+    Entries with equal index keys are ordered by their primary key so each entry can be located exactly
+    when inserting or removing (no env). Queries supply an env and match all entries for the index key.
+ */
+static int compareEntries(cvoid *n1, cvoid *n2, Env *env)
+{
+    int rc;
+
+    rc = compareItems(n1, n2, env);
+    if (rc == 0 && !env) {
+        rc = scmp(((DbIndexEntry*) n1)->item->key, ((DbIndexEntry*) n2)->item->key);
+    }
+    return rc;
+}
+
 PUBLIC cchar *dbGetError(Db *db)
 {
     if (!db) {
@@ -3080,6 +4605,7 @@ PUBLIC void dbReset(cchar *path)
 
     unlink(path);
     unlink(sfmtbuf(pbuf, sizeof(pbuf), "%s.jnl", path));
+    unlink(sfmtbuf(pbuf, sizeof(pbuf), "%s.jnl.prev", path));
 }
 
 PUBLIC cchar *dbType(Db *db)
@@ -51,6 +51,19 @@
     #define ME_JSON_DEFAULT_PROPERTY 64        /**< Default property name buffer size in bytes */
 #endif
 
+/*
+    Numbers cached in JsonNode.number
+ */
+#define JSON_CACHE_INT               1         /**< Integer from stoi */
+#define JSON_CACHE_DOUBLE            2         /**< Floating point number from atof */
+#define JSON_CACHE_DATE              3         /**< Date from jsonGetDate */
+
+#define JSON_NUMBER_SIZE             32        /**< Size of value buffers for formatted numbers */
+
+#ifndef ME_JSON_SIMD
+    #define ME_JSON_SIMD             1         /**< Scan strings, whitespace and comments in vector blocks */
+#endif
+
 #ifndef ME_JSON_BUFSIZE
     /*
         Most conversions are done for short properties and values, so we use a small buffer size.
@@ -59,17 +72,76 @@
 #endif
 
 
+/*
+    Hash index of the properties of a large object. Slots hold child node IDs + 1 (zero for empty).
+    Indexes are built by findProperty when a lookup scans ME_JSON_INDEX children and are discarded when nodes
+    in or before the object are inserted, removed or renamed. Properties appended to the object after the last
+    indexed child are added on the next lookup. Indexed objects are flagged via JsonNode.indexed so lookups on
+    other objects do not search for an index. Indexes are hashed by object node ID into JSON_INDEX_BUCKETS chains.
+    As lookups via const APIs create, extend and reorder indexes, reads are not safe to perform concurrently.
+ */
+#define JSON_INDEX_BUCKETS 16
+
+typedef struct JsonIndex {
+    struct JsonIndex *next;                    /**< Next index in the bucket (most recently used first) */
+    int nid;                                   /**< Object node ID */
+    int tail;                                  /**< Last child node ID in the index */
+    int count;                                 /**< Number of indexed properties */
+    int size;                                  /**< Number of slots (power of two) */
+    int *slots;                                /**< Open addressed hash table of child node IDs + 1 */
+} JsonIndex;
+
+/*
+    Arena for node names and values. Strings are bump allocated from the current chunk and all chunks are freed
+    together by jsonFree. Large strings receive a dedicated chunk placed after the current chunk.
+ */
+typedef struct JsonChunk {
+    struct JsonChunk *next;                    /**< Next (older) chunk */
+    size_t size;                               /**< Size of data */
+    size_t used;                               /**< Bytes of data allocated */
+    char data[];                               /**< String storage */
+} JsonChunk;
+
+typedef struct JsonArena {
+    JsonChunk *chunks;                         /**< Current chunk followed by older chunks */
+    size_t chunkSize;                          /**< Size of data in new chunks */
+    int count;                                 /**< Number of chunks */
+} JsonArena;
+
+/*
+    Vector scanning is selected at compile time for the target instruction set: AVX2 if enabled via -mavx2,
+    SSE2 on all x86-64 targets, NEON on ARM. Otherwise the scalar loops are used.
+ */
+#if ME_JSON_SIMD && defined(__GNUC__) && defined(__AVX2__)
+    #include    <immintrin.h>
+    #define JSON_SIMD_AVX2 1
+    #define JSON_SIMD_SIZE 32
+#elif ME_JSON_SIMD && defined(__GNUC__) && defined(__SSE2__)
+    #include    <emmintrin.h>
+    #define JSON_SIMD_SSE2 1
+    #define JSON_SIMD_SIZE 16
+#elif ME_JSON_SIMD && defined(__GNUC__) && defined(__ARM_NEON)
+    #include    <arm_neon.h>
+    #define JSON_SIMD_NEON 1
+    #define JSON_SIMD_SIZE 16
+#endif
+
 static int maxLength = JSON_MAX_LINE_LENGTH;   // Maximum line length for compact output
 static int indentLevel = JSON_DEFAULT_INDENT;  // Indentation spaces per level
 
 /********************************** Forwards **********************************/
 
 static JsonNode *allocNode(Json *json, int type, cchar *name, cchar *value);
+static char *arenaAlloc(Json *json, size_t size);
 static int blendRecurse(Json *dest, int did, cchar *dkey, const Json *csrc, int sid, cchar *skey, int flags, int depth);
+static char *cloneString(Json *json, cchar *str);
 static void compactProperties(RBuf *buf, char *sol, int indent);
 static char *copyProperty(Json *json, cchar *key);
+static void dropIndexes(Json *json, int nid);
 static int expandValue(const Json *json, RBuf *buf, cchar *key, int indent, int flags);
+static void freeArena(Json *json);
 static void freeNode(JsonNode *node);
+static void freeValue(JsonNode *node);
 static bool isfnumber(cchar *s, size_t len);
 static int jerror(Json *json, cchar *fmt, ...);
 static int jquery(Json *json, int nid, cchar *key, cchar *value, int type);
@@ -106,6 +178,9 @@ PUBLIC void jsonFree(Json *json)
     for (node = json->nodes; node < &json->nodes[json->count]; node++) {
         freeNode(node);
     }
+    dropIndexes(json, 0);
+    rFree(json->index);
+    freeArena(json);
     rFree(json->text);
     rFree(json->value);
     rFree(json->property);
@@ -133,10 +208,114 @@ static void freeNode(JsonNode *node)
         rFree(node->name);
         node->allocatedName = 0;
     }
+    freeValue(node);
+}
+
+/*
+    Free a node value and invalidate any cached number. The node name is preserved.
+ */
+static void freeValue(JsonNode *node)
+{
     if (node->allocatedValue) {
         rFree(node->value);
         node->allocatedValue = 0;
     }
+    node->numberBuffer = 0;
+    node->cached = 0;
+}
+
+PUBLIC int jsonSetArena(Json *json, size_t chunkSize)
+{
+    if (!json) {
+        return R_ERR_BAD_ARGS;
+    }
+    if (chunkSize == 0) {
+        chunkSize = ME_JSON_ARENA;
+    }
+    if (!json->arena) {
+        json->arena = rAllocType(JsonArena);
+    }
+    json->arena->chunkSize = chunkSize;
+    return 0;
+}
+
+PUBLIC int jsonGetArenaChunks(const Json *json)
+{
+    if (!json || !json->arena) {
+        return 0;
+    }
+    return json->arena->count;
+}
+
+static void freeArena(Json *json)
+{
+    JsonChunk *chunk, *next;
+
+    if (!json->arena) {
+        return;
+    }
+    for (chunk = json->arena->chunks; chunk; chunk = next) {
+        next = chunk->next;
+        rFree(chunk);
+    }
+    rFree(json->arena);
+    json->arena = 0;
+}
+
+/*
+    Allocate memory from the arena. Requests larger than a quarter of the chunk size get a dedicated chunk so the
+    remainder of the current chunk is not wasted.
+ */
+static char *arenaAlloc(Json *json, size_t size)
+{
+    JsonArena *arena;
+    JsonChunk *chunk;
+    size_t    chunkSize;
+    char      *data;
+
+    arena = json->arena;
+    chunk = arena->chunks;
+    if (!chunk || size > chunk->size - chunk->used) {
+        chunkSize = size > arena->chunkSize / 4 ? size : arena->chunkSize;
+        if ((chunk = rAlloc(sizeof(JsonChunk) + chunkSize)) == 0) {
+            return 0;
+        }
+        chunk->size = chunkSize;
+        chunk->used = 0;
+        if (chunkSize == size && arena->chunks) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+        arena->count++;
+    }
+    data = &chunk->data[chunk->used];
+    chunk->used += size;
+    return data;
+}
+
+/*
+    Clone a string from the arena if enabled, otherwise from the heap. Like sclone, a null string is cloned as empty.
+ */
+static char *cloneString(Json *json, cchar *str)
+{
+    char   *ptr;
+    size_t len;
+
+    if (!json->arena) {
+        return sclone(str);
+    }
+    if (str == 0) {
+        str = "";
+    }
+    len = slen(str);
+    if ((ptr = arenaAlloc(json, len + 1)) != 0) {
+        memcpy(ptr, str, len);
+        ptr[len] = '\0';
+    }
+    return ptr;
 }
 
 static bool growNodes(Json *json, int num)
@@ -151,7 +330,13 @@ static bool growNodes(Json *json, int num)
         return 0;
     }
     if ((json->count + num) > json->size) {
-        json->size += max(num, ME_JSON_INC);
+        /*
+            Grow geometrically so that appending nodes one at a time is amortized O(1)
+         */
+        json->size += max(num, max(json->size / 2, ME_JSON_INC));
+        if (json->size > ME_JSON_MAX_NODES && (json->count + num) <= ME_JSON_MAX_NODES) {
+            json->size = ME_JSON_MAX_NODES;
+        }
         if (json->size > ME_JSON_MAX_NODES) {
             jerror(json, "Too many elements in json text");
             return 0;
@@ -178,6 +363,9 @@ static void initNode(Json *json, int nid)
     node->value = 0;
     node->allocatedValue = 0;
     node->allocatedName = 0;
+    node->cached = 0;
+    node->numberBuffer = 0;
+    node->indexed = 0;
     node->last = nid + 1;
 #if ME_DEBUG
     node->lineNumber = json->lineNumber;
@@ -196,6 +384,9 @@ static void setNode(Json *json, int nid, int type, cchar *name, int allocatedNam
         return;
     }
     node = &json->nodes[nid];
+    if (json->index && (node->type != (uint) type || (name != node->name && !smatch(name, node->name)))) {
+        dropIndexes(json, nid);
+    }
     node->type = (uint) type;
 
     if (name != node->name && !smatch(name, node->name)) {
@@ -206,10 +397,11 @@ static void setNode(Json *json, int nid, int type, cchar *name, int allocatedNam
         node->name = 0;
 
         if (name) {
-            node->allocatedName = (uint) allocatedName;
             if (allocatedName) {
-                name = sclone(name);
+                name = cloneString(json, name);
+                allocatedName = json->arena == 0;
             }
+            node->allocatedName = (uint) allocatedName;
             node->name = (char*) name;
         }
     }
@@ -225,12 +417,15 @@ static void setNode(Json *json, int nid, int type, cchar *name, int allocatedNam
             rFree(node->value);
         }
         node->value = 0;
+        node->cached = 0;
+        node->numberBuffer = 0;
 
         if (value) {
-            node->allocatedValue = (uint) allocatedValue;
             if (allocatedValue) {
-                value = sclone(value);
+                value = cloneString(json, value);
+                allocatedValue = json->arena == 0;
             }
+            node->allocatedValue = (uint) allocatedValue;
             node->value = (char*) value;
         }
     }
@@ -262,6 +457,7 @@ static void copyNodes(Json *dest, int did, Json *src, int sid, int slen)
     if (!dest || !src || did < 0 || did >= dest->count || sid < 0 || sid >= src->count) {
         return;
     }
+    dropIndexes(dest, did);
     dp = &dest->nodes[did];
     sp = &src->nodes[sid];
 
@@ -273,12 +469,12 @@ static void copyNodes(Json *dest, int did, Json *src, int sid, int slen)
             rFree(dp->value);
         }
         *dp = *sp;
-        if ((dp->name = sclone(sp->name)) != 0) {
-            dp->allocatedName = 1;
-        }
-        if ((dp->value = sclone(sp->value)) != 0) {
-            dp->allocatedValue = 1;
-        }
+        dp->name = cloneString(dest, sp->name);
+        dp->allocatedName = dp->name && !dest->arena;
+        dp->value = cloneString(dest, sp->value);
+        dp->allocatedValue = dp->value && !dest->arena;
+        dp->numberBuffer = 0;
+        dp->indexed = 0;
         dp->last = did + sp->last - sid;
     }
 }
@@ -287,6 +483,9 @@ static void copyNodes(Json *dest, int did, Json *src, int sid, int slen)
     Insert room for 'num' nodes at json->nodes[nid].
     This creates space by shifting existing nodes and updating all 'last' indices.
     Should be called at the end of an array or object to maintain tree structure.
+    Only the parent, its ancestors and the shifted nodes need their 'last' index updated. Nodes between the parent
+    and the insertion point are prior siblings (and their children) which end at or before 'nid'. So appending to
+    a recently opened parent does not visit the whole tree.
     Returns the node ID where insertion occurred, or negative error code on failure.
  */
 static int insertNodes(Json *json, int nid, int num, int parentId)
@@ -300,25 +499,22 @@ static int insertNodes(Json *json, int nid, int num, int parentId)
     if ((json->count + num) >= json->size && !growNodes(json, num)) {
         return R_ERR_MEMORY;
     }
+    dropIndexes(json, nid);
     node = &json->nodes[nid];
     if (nid < json->count) {
         memmove(node + num, node, (size_t) (json->count - nid) * sizeof(JsonNode));
     }
     json->count += num;
 
-    for (i = 0; i < json->count; i++) {
-        if (nid <= i && i < (nid + num)) {
-            continue;
-        }
+    for (i = 0; i <= parentId && i < nid; i++) {
         node = &json->nodes[i];
-        if (node->last == nid && i > parentId) {
-            // Current oldest sibling
-            continue;
-        }
         if (node->last >= nid) {
             node->last += num;
         }
     }
+    for (i = nid + num; i < json->count; i++) {
+        json->nodes[i].last += num;
+    }
     for (i = 0; i < (int) num; i++) {
         initNode(json, nid + i);
     }
@@ -333,6 +529,7 @@ static int removeNodes(Json *json, int nid, int num)
     if (!json || nid < 0 || nid >= json->count || num <= 0) {
         return R_ERR_BAD_ARGS;
     }
+    dropIndexes(json, nid);
     node = &json->nodes[nid];
     for (i = 0; i < num; i++) {
         freeNode(&json->nodes[nid + i]);
@@ -573,6 +770,156 @@ PUBLIC int jsonSave(Json *json, int nid, cchar *key, cchar *path, int mode, int
     return 0;
 }
 
+#if JSON_SIMD_NEON
+/*
+    Convert a NEON comparison result into a bit mask with 4 bits per byte
+ */
+static inline uint64 neonMask(uint8x16_t match)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+}
+#endif
+
+/*
+    Return a pointer to the first occurrence of 'a', 'b' or a null in the text before 'end'. Return 'end' if none.
+ */
+static char *scanChars(char *next, char *end, char a, char b)
+{
+#if JSON_SIMD_AVX2
+    __m256i va, vb, vz, v;
+    uint    mask;
+
+    va = _mm256_set1_epi8(a);
+    vb = _mm256_set1_epi8(b);
+    vz = _mm256_setzero_si256();
+    for (; next + JSON_SIMD_SIZE <= end; next += JSON_SIMD_SIZE) {
+        v = _mm256_loadu_si256((const __m256i*) next);
+        mask = (uint) _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va),
+                                                                           _mm256_cmpeq_epi8(v, vb)),
+                                                           _mm256_cmpeq_epi8(v, vz)));
+        if (mask) {
+            return next + __builtin_ctz(mask);
+        }
+    }
+#elif JSON_SIMD_SSE2
+    __m128i va, vb, vz, v;
+    uint    mask;
+
+    va = _mm_set1_epi8(a);
+    vb = _mm_set1_epi8(b);
+    vz = _mm_setzero_si128();
+    for (; next + JSON_SIMD_SIZE <= end; next += JSON_SIMD_SIZE) {
+        v = _mm_loadu_si128((const __m128i*) next);
+        mask = (uint) _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+                                                     _mm_cmpeq_epi8(v, vz)));
+        if (mask) {
+            return next + __builtin_ctz(mask);
+        }
+    }
+#elif JSON_SIMD_NEON
+    uint8x16_t va, vb, vz, v;
+    uint64     mask;
+
+    va = vdupq_n_u8((uint8_t) a);
+    vb = vdupq_n_u8((uint8_t) b);
+    vz = vdupq_n_u8(0);
+    for (; next + JSON_SIMD_SIZE <= end; next += JSON_SIMD_SIZE) {
+        v = vld1q_u8((const uint8_t*) next);
+        mask = neonMask(vorrq_u8(vorrq_u8(vceqq_u8(v, va), vceqq_u8(v, vb)), vceqq_u8(v, vz)));
+        if (mask) {
+            return next + (__builtin_ctzll(mask) >> 2);
+        }
+    }
+#endif
+    for (; next < end; next++) {
+        if (*next == a || *next == b || *next == 0) {
+            return next;
+        }
+    }
+    return end;
+}
+
+/*
+    Skip white space and count new lines. Return a pointer to the first non-space character or 'end'.
+ */
+static char *skipSpace(Json *json, char *next, char *end)
+{
+#if JSON_SIMD_AVX2
+    __m256i v, lines;
+    uint    mask, nl;
+#elif JSON_SIMD_SSE2
+    __m128i v, lines;
+    uint    mask, nl;
+#elif JSON_SIMD_NEON
+    uint8x16_t v, lines;
+    uint64     mask, nl;
+#endif
+
+    //  Single spaces between tokens are most common, so check the following character before using vector blocks
+    if (next + 1 < end && next[1] != ' ' && next[1] != '\t' && next[1] != '\r' && next[1] != '\n') {
+        if (*next == '\n') {
+            json->lineNumber++;
+        } else if (*next != ' ' && *next != '\t' && *next != '\r') {
+            return next;
+        }
+        return next + 1;
+    }
+#if JSON_SIMD_AVX2
+    for (; next + JSON_SIMD_SIZE <= end; next += JSON_SIMD_SIZE) {
+        v = _mm256_loadu_si256((const __m256i*) next);
+        lines = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+        mask = (uint) _mm256_movemask_epi8(_mm256_or_si256(
+                                               _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), lines),
+                                               _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+                                                               _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')))));
+        nl = (uint) _mm256_movemask_epi8(lines);
+        if (mask != 0xFFFFFFFF) {
+            mask = (uint) __builtin_ctz(~mask);
+            json->lineNumber += __builtin_popcount(nl & (uint) ((1ULL << mask) - 1));
+            return next + mask;
+        }
+        json->lineNumber += __builtin_popcount(nl);
+    }
+#elif JSON_SIMD_SSE2
+    for (; next + JSON_SIMD_SIZE <= end; next += JSON_SIMD_SIZE) {
+        v = _mm_loadu_si128((const __m128i*) next);
+        lines = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+        mask = (uint) _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), lines),
+                                                     _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')),
+                                                                  _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+        nl = (uint) _mm_movemask_epi8(lines);
+        if (mask != 0xFFFF) {
+            mask = (uint) __builtin_ctz(~mask);
+            json->lineNumber += __builtin_popcount(nl & ((1U << mask) - 1));
+            return next + mask;
+        }
+        json->lineNumber += __builtin_popcount(nl);
+    }
+#elif JSON_SIMD_NEON
+    for (; next + JSON_SIMD_SIZE <= end; next += JSON_SIMD_SIZE) {
+        v = vld1q_u8((const uint8_t*) next);
+        lines = vceqq_u8(v, vdupq_n_u8('\n'));
+        mask = neonMask(vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), lines),
+                                 vorrq_u8(vceqq_u8(v, vdupq_n_u8('\t')), vceqq_u8(v, vdupq_n_u8('\r')))));
+        nl = neonMask(lines);
+        if (mask != ~0ULL) {
+            mask = (uint64) __builtin_ctzll(~mask);
+            json->lineNumber += __builtin_popcountll(nl & ((1ULL << mask) - 1)) / 4;
+            return next + (mask >> 2);
+        }
+        json->lineNumber += __builtin_popcountll(nl) / 4;
+    }
+#endif
+    for (; next < end; next++) {
+        if (*next == '\n') {
+            json->lineNumber++;
+        } else if (*next != ' ' && *next != '\t' && *next != '\r') {
+            break;
+        }
+    }
+    return next;
+}
+
 /*
     Parse primitive values including key names and unquoted strings
     Return with json->next pointing to the character after the primitive value.
@@ -658,7 +1005,7 @@ static char *parseRegExp(Json *json)
  */
 static char *parseString(Json *json)
 {
-    char *end, *next, *op, *start, c, quote;
+    char *end, *next, *op, *span, *start, c, quote;
     int  d, j;
 
     if (!json || !json->next || !json->end) {
@@ -669,7 +1016,19 @@ static char *parseString(Json *json)
     end = json->end;
     quote = *next++;
 
-    for (op = start = next; next < end && *next; op++, next++) {
+    for (op = start = next; next < end; op++, next++) {
+        /*
+            Skip (or copy down after an escape) the characters up to the next quote, backslash or null
+         */
+        span = scanChars(next, end, quote, '\\');
+        if (op != next) {
+            memmove(op, next, (size_t) (span - next));
+        }
+        op += span - next;
+        next = span;
+        if (next >= end || *next == 0) {
+            break;
+        }
         c = *next;
         if (c == '\\' && next < end) {
             c = *++next;
@@ -722,13 +1081,11 @@ static char *parseString(Json *json)
             }
             *op = c;
 
-        } else if (c == quote) {
+        } else {
+            // Closing quote
             *op = '\0';
             json->next = next + 1;
             return start;
-
-        } else if (op != next) {
-            *op = c;
         }
     }
     // Ran out of input
@@ -749,13 +1106,14 @@ static int parseComment(Json *json)
     startLine = json->lineNumber;
 
     if (*next == '/') {
-        for (next++; next < json->end && *next && *next != '\n'; next++) {
-        }
+        next = scanChars(next + 1, json->end, '\n', '\n');
 
     } else if (*next == '*') {
-        for (next++; next < &json->end[-1] && (*next != '*' || next[1] != '/'); next++) {
+        for (next++; (next = scanChars(next, &json->end[-1], '*', '\n')) < &json->end[-1]; next++) {
             if (*next == '\n') {
                 json->lineNumber++;
+            } else if (*next == '*' && next[1] == '/') {
+                break;
             }
         }
         if (*next == '*' && next[1] == '/') {
@@ -845,14 +1203,10 @@ PUBLIC int jsonParseText(Json *json, char *text, int flags)
             break;
 
         case '\n':
-            json->lineNumber++;
-            json->next++;
-            break;
-
         case '\t':
         case '\r':
         case ' ':
-            json->next++;
+            json->next = skipSpace(json, json->next, json->end);
             break;
 
         case ',':
@@ -1081,11 +1435,134 @@ static char *getNextTerm(char *str, char **rest, int *type)
     return start;
 }
 
+/*
+    Discard the property indexes that may refer to nodes at or after 'nid'
+ */
+static void dropIndexes(Json *json, int nid)
+{
+    JsonIndex *index, *next, **prior;
+    int       bucket;
+
+    if (!json->index) {
+        return;
+    }
+    for (bucket = 0; bucket < JSON_INDEX_BUCKETS; bucket++) {
+        prior = &json->index[bucket];
+        for (index = json->index[bucket]; index; index = next) {
+            next = index->next;
+            if (index->nid >= nid || index->tail >= nid) {
+                *prior = next;
+                if (index->nid < json->count) {
+                    json->nodes[index->nid].indexed = 0;
+                }
+                rFree(index->slots);
+                rFree(index);
+            } else {
+                prior = &index->next;
+            }
+        }
+    }
+}
+
+#if ME_JSON_INDEX
+static void addIndex(Json *json, JsonIndex *index, int id)
+{
+    cchar *name;
+    int   *slots, i, mask, size, slot;
+
+    if ((index->count + 1) * 2 > index->size) {
+        //  Rehash at 50% load
+        slots = index->slots;
+        size = index->size;
+        index->size = max(size * 2, 64);
+        index->slots = rAlloc(sizeof(int) * (size_t) index->size);
+        memset(index->slots, 0, sizeof(int) * (size_t) index->size);
+        index->count = 0;
+        for (i = 0; i < size; i++) {
+            if (slots[i]) {
+                addIndex(json, index, slots[i] - 1);
+            }
+        }
+        rFree(slots);
+    }
+    index->tail = id;
+    if ((name = json->nodes[id].name) == 0) {
+        return;
+    }
+    mask = index->size - 1;
+    for (slot = (int) (shash(name, slen(name)) & (uint) mask); index->slots[slot]; slot = (slot + 1) & mask) {
+        if (smatch(json->nodes[index->slots[slot] - 1].name, name)) {
+            //  Duplicate property. Lookups return the first.
+            return;
+        }
+    }
+    index->slots[slot] = id + 1;
+    index->count++;
+}
+
+static void buildIndex(Json *json, int nid)
+{
+    JsonIndex *index;
+    int       id;
+
+    index = rAllocType(JsonIndex);
+    index->nid = nid;
+    index->tail = -1;
+    for (id = nid + 1; id < json->nodes[nid].last; id = json->nodes[id].last) {
+        addIndex(json, index, id);
+    }
+    if (!json->index) {
+        json->index = rAlloc(sizeof(JsonIndex*) * JSON_INDEX_BUCKETS);
+        memset(json->index, 0, sizeof(JsonIndex*) * JSON_INDEX_BUCKETS);
+    }
+    index->next = json->index[nid % JSON_INDEX_BUCKETS];
+    json->index[nid % JSON_INDEX_BUCKETS] = index;
+    json->nodes[nid].indexed = 1;
+}
+
+/*
+    Return the child node ID for a property of an indexed object or R_ERR_CANT_FIND if not present
+ */
+static int lookupIndex(Json *json, int nid, cchar *property)
+{
+    JsonIndex *index, **head, **prior;
+    int       id, last, mask, slot;
+
+    head = &json->index[nid % JSON_INDEX_BUCKETS];
+    prior = head;
+    for (index = *head; index->nid != nid; index = index->next) {
+        prior = &index->next;
+    }
+    if (index != *head) {
+        *prior = index->next;
+        index->next = *head;
+        *head = index;
+    }
+    //  Add properties appended since the index was built
+    last = json->nodes[nid].last;
+    for (id = json->nodes[index->tail].last; id < last; id = json->nodes[id].last) {
+        addIndex(json, index, id);
+    }
+    mask = index->size - 1;
+    for (slot = (int) (shash(property, slen(property)) & (uint) mask); index->slots[slot];
+         slot = (slot + 1) & mask) {
+        id = index->slots[slot] - 1;
+        if (smatch(json->nodes[id].name, property)) {
+            return id;
+        }
+    }
+    return R_ERR_CANT_FIND;
+}
+#endif
+
 static int findProperty(Json *json, int nid, cchar *property)
 {
     JsonNode *node, *np;
     ssize    index;
     int      id;
+#if ME_JSON_INDEX
+    int      count;
+#endif
 
     if (!json || nid < 0 || nid >= json->count) {
         return R_ERR_BAD_ARGS;
@@ -1121,13 +1598,27 @@ static int findProperty(Json *json, int nid, cchar *property)
         }
 
     } else if (node->type == JSON_OBJECT) {
+#if ME_JSON_INDEX
+        if (node->indexed) {
+            return lookupIndex(json, nid, property);
+        }
+        count = 0;
+#endif
         for (id = nid + 1; id < node->last; id = np->last) {
             np = &json->nodes[id];
             if (smatch(property, np->name)) {
-                return id;
+                break;
             }
+#if ME_JSON_INDEX
+            count++;
+#endif
         }
-        return R_ERR_CANT_FIND;
+#if ME_JSON_INDEX
+        if (count >= ME_JSON_INDEX) {
+            buildIndex(json, nid);
+        }
+#endif
+        return id < node->last ? id : R_ERR_CANT_FIND;
     }
     return R_ERR_BAD_STATE;
 }
@@ -1259,6 +1750,7 @@ PUBLIC int jsonGetId(const Json *json, int nid, cchar *key)
         return R_ERR_CANT_FIND;
     }
     if (key && *key) {
+        //  Cast const away as the lookup may build a property index
         if ((nid = jquery((Json*) json, nid, key, 0, 0)) < 0) {
             return R_ERR_CANT_FIND;
         }
@@ -1346,27 +1838,60 @@ PUBLIC bool jsonGetBool(Json *json, int nid, cchar *key, bool defaultValue)
     return defaultValue;
 }
 
+/*
+    Get the node for a numeric getter. Returns NULL if the property is missing or null.
+ */
+static JsonNode *getNumberNode(Json *json, int nid, cchar *key)
+{
+    JsonNode *node;
+
+    if (!json || nid < 0 || nid >= json->count) {
+        return NULL;
+    }
+    if (key && *key) {
+        if ((nid = jquery(json, nid, key, 0, 0)) < 0) {
+            return NULL;
+        }
+    }
+    node = &json->nodes[nid];
+    if (!node->cached && node->type & JSON_PRIMITIVE && smatch(node->value, "null")) {
+        return NULL;
+    }
+    return node;
+}
+
+/*
+    Return the string value used by the numeric getters. Objects and arrays convert as for jsonGet.
+ */
+static cchar *numberValue(JsonNode *node)
+{
+    if (node->type & JSON_OBJECT) {
+        return "{}";
+    } else if (node->type & JSON_ARRAY) {
+        return "[]";
+    }
+    return node->value;
+}
+
 PUBLIC Time jsonGetDate(Json *json, int nid, cchar *key, int64 defaultValue)
 {
-    cchar *value;
-    char  defbuf[16];
+    JsonNode *node;
+    cchar    *value;
 
-    sfmtbuf(defbuf, sizeof(defbuf), "%lld", defaultValue);
-    value = jsonGet(json, nid, key, defbuf);
-    if (snumber(value)) {
-        return stoi(value);
+    if ((node = getNumberNode(json, nid, key)) == NULL) {
+        return defaultValue;
     }
-    return rParseIsoDate(value);
+    if (node->cached != JSON_CACHE_DATE) {
+        value = numberValue(node);
+        node->number.integer = snumber(value) ? stoi(value) : rParseIsoDate(value);
+        node->cached = JSON_CACHE_DATE;
+    }
+    return node->number.integer;
 }
 
 PUBLIC int jsonGetInt(Json *json, int nid, cchar *key, int defaultValue)
 {
-    cchar *value;
-    char  defbuf[16];
-
-    sfmtbuf(defbuf, sizeof(defbuf), "%d", defaultValue);
-    value = jsonGet(json, nid, key, defbuf);
-    return (int) stoi(value);
+    return (int) jsonGetNum(json, nid, key, defaultValue);
 }
 
 PUBLIC ssize jsonGetLength(Json *json, int nid, cchar *key)
@@ -1387,22 +1912,30 @@ PUBLIC ssize jsonGetLength(Json *json, int nid, cchar *key)
 
 PUBLIC int64 jsonGetNum(Json *json, int nid, cchar *key, int64 defaultValue)
 {
-    cchar *value;
-    char  defbuf[16];
+    JsonNode *node;
 
-    sfmtbuf(defbuf, sizeof(defbuf), "%lld", defaultValue);
-    value = jsonGet(json, nid, key, defbuf);
-    return stoi(value);
+    if ((node = getNumberNode(json, nid, key)) == NULL) {
+        return defaultValue;
+    }
+    if (node->cached != JSON_CACHE_INT) {
+        node->number.integer = stoi(numberValue(node));
+        node->cached = JSON_CACHE_INT;
+    }
+    return node->number.integer;
 }
 
 PUBLIC double jsonGetDouble(Json *json, int nid, cchar *key, double defaultValue)
 {
-    cchar *value;
-    char  defbuf[16];
+    JsonNode *node;
 
-    sfmtbuf(defbuf, sizeof(defbuf), "%f", defaultValue);
-    value = jsonGet(json, nid, key, defbuf);
-    return atof(value);
+    if ((node = getNumberNode(json, nid, key)) == NULL) {
+        return defaultValue;
+    }
+    if (node->cached != JSON_CACHE_DOUBLE) {
+        node->number.real = stof(numberValue(node));
+        node->cached = JSON_CACHE_DOUBLE;
+    }
+    return node->number.real;
 }
 
 PUBLIC int64 jsonGetValue(Json *json, int nid, cchar *key, cchar *defaultValue)
@@ -1463,12 +1996,51 @@ PUBLIC int jsonSetBool(Json *json, int nid, cchar *key, bool value)
     return jsonSet(json, nid, key, data, JSON_PRIMITIVE);
 }
 
+/*
+    Set a formatted number. Updating an existing number writes the value in-place into a JSON_NUMBER_SIZE buffer
+    rather than allocating a new string for each update.
+ */
+static int setNumber(Json *json, int nid, cchar *key, cchar *value)
+{
+    JsonNode *node;
+    int      id;
+
+    if (!json || nid < 0 || nid >= json->count || json->lock ||
+        (id = jsonGetId(json, nid, key)) < 0 || json->nodes[id].type != JSON_PRIMITIVE) {
+        return jsonSet(json, nid, key, value, JSON_PRIMITIVE);
+    }
+    node = &json->nodes[id];
+    if (!smatch(node->value, value)) {
+#if JSON_TRIGGER
+        if (json->trigger) {
+            (json->trigger)(json->triggerArg, json, node, node->name, value, node->value);
+        }
+#endif
+        if (!node->numberBuffer) {
+            if (node->allocatedValue) {
+                rFree(node->value);
+            }
+            if (json->arena) {
+                node->value = arenaAlloc(json, JSON_NUMBER_SIZE);
+                node->allocatedValue = 0;
+            } else {
+                node->value = rAlloc(JSON_NUMBER_SIZE);
+                node->allocatedValue = 1;
+            }
+            node->numberBuffer = 1;
+        }
+        scopy(node->value, JSON_NUMBER_SIZE, value);
+        node->cached = 0;
+    }
+    return id;
+}
+
 PUBLIC int jsonSetDouble(Json *json, int nid, cchar *key, double value)
 {
-    char buf[32];
+    char buf[JSON_NUMBER_SIZE];
 
     rSnprintf(buf, sizeof(buf), "%f", value);
-    return jsonSet(json, nid, key, buf, JSON_PRIMITIVE);
+    return setNumber(json, nid, key, buf);
 }
 
 PUBLIC int jsonSetDate(Json *json, int nid, cchar *key, Time value)
@@ -1502,9 +2074,14 @@ PUBLIC int jsonSetFmt(Json *json, int nid, cchar *key, cchar *fmt, ...)
 
 PUBLIC int jsonSetNumber(Json *json, int nid, cchar *key, int64 value)
 {
-    char buf[32];
+    char buf[JSON_NUMBER_SIZE];
+    int  id;
 
-    return jsonSet(json, nid, key, sitosbuf(buf, sizeof(buf), value, 10), JSON_PRIMITIVE);
+    if ((id = setNumber(json, nid, key, sitosbuf(buf, sizeof(buf), value, 10))) >= 0) {
+        json->nodes[id].number.integer = value;
+        json->nodes[id].cached = JSON_CACHE_INT;
+    }
+    return id;
 }
 
 PUBLIC int jsonSetString(Json *json, int nid, cchar *key, cchar *value)
@@ -1512,6 +2089,108 @@ PUBLIC int jsonSetString(Json *json, int nid, cchar *key, cchar *value)
     return jsonSet(json, nid, key, value, JSON_STRING);
 }
 
+/*
+    Builder mode. Nodes are appended in document order so each call is O(1) amortized.
+    As in the parser, the 'last' field of an open object or array holds the index of its parent until closed.
+    The json->builder field holds the index + 1 of the innermost open object or array.
+ */
+PUBLIC int jsonBuilderBegin(Json *json, int type)
+{
+    JsonNode *node;
+
+    if (!json || (type != JSON_OBJECT && type != JSON_ARRAY)) {
+        return R_ERR_BAD_ARGS;
+    }
+    if (json->count > 0 || json->builder || json->lock) {
+        return R_ERR_BAD_STATE;
+    }
+    if ((node = allocNode(json, type, 0, 0)) == 0) {
+        return R_ERR_MEMORY;
+    }
+    node->last = -1;
+    json->builder = 1;
+    json->lock = 1;
+    return 0;
+}
+
+/*
+    Append a node to the innermost open object or array
+ */
+static int buildNode(Json *json, int type, cchar *name, cchar *value)
+{
+    int nid, parent;
+
+    if (!json || !json->builder) {
+        return R_ERR_BAD_STATE;
+    }
+    parent = json->builder - 1;
+    if (json->nodes[parent].type == JSON_ARRAY) {
+        name = 0;
+    } else if (!name) {
+        return R_ERR_BAD_ARGS;
+    }
+    if (!allocNode(json, type, 0, 0)) {
+        return R_ERR_MEMORY;
+    }
+    nid = json->count - 1;
+    setNode(json, nid, type, name, 1, value, 1);
+    return nid;
+}
+
+PUBLIC int jsonBuilderObject(Json *json, cchar *name)
+{
+    int nid;
+
+    if ((nid = buildNode(json, JSON_OBJECT, name, 0)) >= 0) {
+        json->nodes[nid].last = json->builder - 1;
+        json->builder = nid + 1;
+    }
+    return nid;
+}
+
+PUBLIC int jsonBuilderArray(Json *json, cchar *name)
+{
+    int nid;
+
+    if ((nid = buildNode(json, JSON_ARRAY, name, 0)) >= 0) {
+        json->nodes[nid].last = json->builder - 1;
+        json->builder = nid + 1;
+    }
+    return nid;
+}
+
+PUBLIC int jsonBuilderValue(Json *json, cchar *name, cchar *value, int type)
+{
+    if (type <= 0 && value) {
+        type = sleuthValueType(value, slen(value), 0);
+    }
+    if (type & (JSON_OBJECT | JSON_ARRAY)) {
+        return R_ERR_BAD_ARGS;
+    }
+    if (!value) {
+        value = "undefined";
+    }
+    return buildNode(json, type, name, value);
+}
+
+PUBLIC int jsonBuilderEnd(Json *json)
+{
+    JsonNode *node;
+    int      nid;
+
+    if (!json || !json->builder) {
+        return R_ERR_BAD_STATE;
+    }
+    nid = json->builder - 1;
+    node = &json->nodes[nid];
+    json->builder = node->last + 1;
+    node->last = json->count;
+    if (!json->builder) {
+        json->lock = 0;
+    }
+    return nid;
+}
+
 /*
     Update a node value
  */
@@ -1521,6 +2200,8 @@ PUBLIC void jsonSetNodeValue(JsonNode *node, cchar *value, int type, int flags)
         rFree(node->value);
         node->allocatedValue = 0;
     }
+    node->cached = 0;
+    node->numberBuffer = 0;
     if (flags & JSON_PASS_VALUE) {
         node->value = (char*) value;
     } else {
@@ -2079,14 +2760,15 @@ static int blendRecurse(Json *dest, int did, cchar *dkey, const Json *csrc, int
         }
     } else {
         if (flags & JSON_APPEND) {
-            freeNode(dp);
-            dp->value = sjoin(dp->value, " ", sp->value, NULL);
+            value = sjoin(dp->value, " ", sp->value, NULL);
+            freeValue(dp);
+            dp->value = value;
             dp->allocatedValue = 1;
             dp->type = JSON_STRING;
 
         } else if (flags & JSON_REPLACE) {
             value = sreplace(dp->value, sp->value, NULL);
-            freeNode(dp);
+            freeValue(dp);
             dp->value = value;
             dp->allocatedValue = 1;
             dp->type = sp->type;
@@ -2107,7 +2789,7 @@ static int blendRecurse(Json *dest, int did, cchar *dkey, const Json *csrc, int
 }
 
 /*
-    Deep copy of a JSON tree
+    Deep copy of a JSON tree. The clone uses arena allocation if the source does.
  */
 PUBLIC Json *jsonClone(const Json *csrc, int flags)
 {
@@ -2115,6 +2797,9 @@ PUBLIC Json *jsonClone(const Json *csrc, int flags)
 
     dest = jsonAlloc();
     if (csrc) {
+        if (csrc->arena) {
+            jsonSetArena(dest, csrc->arena->chunkSize);
+        }
         jsonBlend(dest, 0, 0, csrc, 0, 0, 0);
     }
     return dest;
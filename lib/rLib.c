@@ -987,16 +987,27 @@ typedef struct Event {
     RFiber *fiber;
     REventProc proc;
     void *arg;
-    struct Event *next;
+    struct Event *next;         /* Next event in the ID hash chain or due list */
     Ticks when;
     REvent id;
+    uint64 seq;                 /* Scheduling sequence to run events of the same time in order */
+    int slot;                   /* Index in the event queue heap */
     int fast;
 } Event;
 
 /*
-    Event queue. Note: events are not stored in list order
+    Event queue. A binary min-heap ordered by due time and then scheduling order.
  */
-static Event *events = 0;
+static Event  **events = 0;
+static int    eventCount = 0;
+static int    eventMax = 0;
+static uint64 eventSeq = 0;
+
+/*
+    Hash of events by ID. The size is a power of two and chains are linked via Event.next.
+ */
+static Event **eventHash = 0;
+static int   eventHashSize = 0;
 
 /*
     Event lock so rStartEvent can be thread safe
@@ -1017,14 +1028,20 @@ static RHash *watches;
 
 static void freeEvent(Event *ep);
 static REvent getNextID(void);
-static void linkEvent(Event *ep);
-static Event *lookupEvent(REvent id, Event **priorp);
+static int linkEvent(Event *ep);
+static Event *lookupEvent(REvent id);
+static void siftDown(int slot);
+static void siftUp(int slot);
+static void unlinkEvent(Event *ep);
 
 /************************************ Code ************************************/
 
 PUBLIC int rInitEvents(void)
 {
     events = 0;
+    eventCount = eventMax = 0;
+    eventHash = 0;
+    eventHashSize = 0;
     watches = rAllocHash(0, R_TEMPORAL_NAME | R_STATIC_VALUE);
     if (!watches) {
         return R_ERR_MEMORY;
@@ -1035,16 +1052,21 @@ PUBLIC int rInitEvents(void)
 
 PUBLIC void rTermEvents(void)
 {
-    Event *ep, *np;
     Watch *watch;
     RList *list;
     RName *name;
     uint  next;
+    int   i;
 
-    for (ep = events; ep; ep = np) {
-        np = ep->next;
-        freeEvent(ep);
+    for (i = 0; i < eventCount; i++) {
+        freeEvent(events[i]);
     }
+    rFree(events);
+    rFree(eventHash);
+    eventHash = 0;
+    eventHashSize = 0;
+    eventCount = eventMax = 0;
+
     for (ITERATE_NAME_DATA(watches, name, list)) {
         for (ITERATE_ITEMS(list, watch, next)) {
             rFree(watch);
@@ -1089,7 +1111,11 @@ PUBLIC REvent rAllocEvent(RFiber *fiber, REventProc proc, void *arg, Ticks delay
     ep->id = getNextID();
     ep->fiber = fiber;
     ep->fast = (!fiber && flags & R_EVENT_FAST) ? 1 : 0;
-    linkEvent(ep);
+    if (linkEvent(ep) < 0) {
+        ep->fiber = 0;
+        freeEvent(ep);
+        return 0;
+    }
     rWakeup();
     return ep->id;
 }
@@ -1115,18 +1141,14 @@ PUBLIC REvent rStartFastEvent(REventProc proc, void *arg, Ticks delay)
 
 PUBLIC int rStopEvent(REvent id)
 {
-    Event *ep, *prior;
+    Event *ep;
 
     if (id == 0) {
         return R_ERR_CANT_FIND;
     }
     rLock(&eventLock);
-    if ((ep = lookupEvent(id, &prior)) != 0) {
-        if (ep == events) {
-            events = ep->next;
-        } else if (prior) {
-            prior->next = ep->next;
-        }
+    if ((ep = lookupEvent(id)) != 0) {
+        unlinkEvent(ep);
         rUnlock(&eventLock);
         freeEvent(ep);
         return 0;
@@ -1140,8 +1162,9 @@ PUBLIC int rRunEvent(REvent id)
     Event *ep;
 
     rLock(&eventLock);
-    if ((ep = lookupEvent(id, NULL)) != 0) {
+    if ((ep = lookupEvent(id)) != 0) {
         ep->when = rGetTicks();
+        siftUp(ep->slot);
         rUnlock(&eventLock);
         rWakeup();
         return 0;
@@ -1166,14 +1189,14 @@ PUBLIC bool rLookupEvent(REvent id)
     Event *ep;
 
     rLock(&eventLock);
-    ep = lookupEvent(id, NULL);
+    ep = lookupEvent(id);
     rUnlock(&eventLock);
     return ep ? 1 : 0;
 }
 
 PUBLIC Ticks rRunEvents(void)
 {
-    Event      *ep, *next, *prior;
+    Event      *ep, *next;
     Event      *dueList, *dueTail;
     Ticks      now, deadline;
     REventProc proc;
@@ -1182,38 +1205,26 @@ PUBLIC Ticks rRunEvents(void)
 
     assert(rIsMain());
     now = rGetTicks();
-    deadline = MAXINT64;
 
     /*
-        Build a list of due events while holding the lock
+        Build a list of due events while holding the lock. Events are removed from the queue in due order.
      */
     rLock(&eventLock);
     dueList = NULL;
     dueTail = NULL;
-    prior = NULL;
 
-    for (ep = events; ep; ep = next) {
-        next = ep->next;
-        if (ep->when <= now && rState < R_STOPPING) {
-            //  Unlink from main list
-            if (ep == events) {
-                events = ep->next;
-            } else if (prior) {
-                prior->next = ep->next;
-            }
-            //  Add to due list
-            ep->next = NULL;
-            if (dueTail) {
-                dueTail->next = ep;
-                dueTail = ep;
-            } else {
-                dueList = dueTail = ep;
-            }
+    while (eventCount > 0 && events[0]->when <= now && rState < R_STOPPING) {
+        ep = events[0];
+        unlinkEvent(ep);
+        ep->next = NULL;
+        if (dueTail) {
+            dueTail->next = ep;
+            dueTail = ep;
         } else {
-            deadline = min(ep->when, deadline);
-            prior = ep;
+            dueList = dueTail = ep;
         }
     }
+    deadline = eventCount > 0 ? events[0]->when : MAXINT64;
     rUnlock(&eventLock);
 
     /*
@@ -1235,7 +1246,9 @@ PUBLIC Ticks rRunEvents(void)
                 if (!fiber) {
                     // Put back event until we have a fiber to run it on
                     ep->when = rGetTicks() + 1;
-                    linkEvent(ep);
+                    if (linkEvent(ep) < 0) {
+                        freeEvent(ep);
+                    }
                     continue;
                 }
             }
@@ -1256,7 +1269,7 @@ PUBLIC Time rGetNextDueEvent(void)
         return 0;
     }
     rLock(&eventLock);
-    when = events ? events->when : MAXINT64;
+    when = eventCount > 0 ? events[0]->when : MAXINT64;
     rUnlock(&eventLock);
     return when;
 }
@@ -1286,58 +1299,163 @@ static REvent getNextID(void)
     return id;
 }
 
-static Event *lookupEvent(REvent id, Event **priorp)
+static Event *lookupEvent(REvent id)
 {
-    Event *ep, *prior;
+    Event *ep;
 
-    for (prior = 0, ep = events; ep; ep = ep->next) {
+    if (eventHashSize == 0) {
+        return 0;
+    }
+    for (ep = eventHash[(uint64) id & (uint64) (eventHashSize - 1)]; ep; ep = ep->next) {
         if (ep->id == id) {
-            if (priorp) {
-                *priorp = prior;
-            }
             return ep;
         }
-        prior = ep;
     }
     return 0;
 }
 
+/*
+    Grow the ID hash and rehash all queued events. The hash is sized to match the queue capacity.
+ */
+static int growEventHash(int size)
+{
+    Event  **hash;
+    Event  *ep;
+    uint64 mask;
+    int    i;
+
+    if ((hash = rAlloc(sizeof(Event*) * (size_t) size)) == 0) {
+        return R_ERR_MEMORY;
+    }
+    memset(hash, 0, sizeof(Event*) * (size_t) size);
+    mask = (uint64) (size - 1);
+    for (i = 0; i < eventCount; i++) {
+        ep = events[i];
+        ep->next = hash[(uint64) ep->id & mask];
+        hash[(uint64) ep->id & mask] = ep;
+    }
+    rFree(eventHash);
+    eventHash = hash;
+    eventHashSize = size;
+    return 0;
+}
+
+/*
+    Return true if event e1 should run before event e2
+ */
+static bool beforeEvent(Event *e1, Event *e2)
+{
+    if (e1->when != e2->when) {
+        return e1->when < e2->when;
+    }
+    return e1->seq < e2->seq;
+}
+
+static void siftUp(int slot)
+{
+    Event *ep;
+    int   parent;
+
+    ep = events[slot];
+    while (slot > 0) {
+        parent = (slot - 1) / 2;
+        if (!beforeEvent(ep, events[parent])) {
+            break;
+        }
+        events[slot] = events[parent];
+        events[slot]->slot = slot;
+        slot = parent;
+    }
+    events[slot] = ep;
+    ep->slot = slot;
+}
+
+static void siftDown(int slot)
+{
+    Event *ep;
+    int   child;
+
+    ep = events[slot];
+    while ((child = slot * 2 + 1) < eventCount) {
+        if (child + 1 < eventCount && beforeEvent(events[child + 1], events[child])) {
+            child++;
+        }
+        if (!beforeEvent(events[child], ep)) {
+            break;
+        }
+        events[slot] = events[child];
+        events[slot]->slot = slot;
+        slot = child;
+    }
+    events[slot] = ep;
+    ep->slot = slot;
+}
+
 /*
     THREAD SAFE
-    Note: do an in-order insertion. This inserts after the last event of the same time.
+    Add an event to the queue. Events with the same due time run in order of scheduling.
  */
-static void linkEvent(Event *event)
+static int linkEvent(Event *event)
 {
-    Event *ep, *prior;
+    Event  **queue;
+    uint64 mask;
+    int    size;
 
     rLock(&eventLock);
-    if (events) {
-        prior = 0;
-        for (ep = events; ep; ep = ep->next) {
-            if (ep->when > event->when) {
-                if (ep == events) {
-                    // Insert at the head
-                    event->next = events;
-                    events = event;
-                } else {
-                    event->next = prior->next;
-                    prior->next = event;
-                }
-                break;
-            }
-            prior = ep;
-        }
-        // If loop completed without break, append at end
-        if (ep == NULL) {
-            prior->next = event;
-            event->next = NULL;
+    if (eventCount >= eventMax) {
+        size = eventMax ? eventMax * 2 : ME_R_EVENT_QUEUE;
+        if ((queue = rRealloc(events, sizeof(Event*) * (size_t) size)) == 0) {
+            rUnlock(&eventLock);
+            return R_ERR_MEMORY;
         }
-    } else {
-        // Add to the head
-        event->next = events;
-        events = event;
+        events = queue;
+        eventMax = size;
+    }
+    if (eventHashSize < eventMax && growEventHash(eventMax) < 0) {
+        rUnlock(&eventLock);
+        return R_ERR_MEMORY;
     }
+    event->seq = ++eventSeq;
+    event->slot = eventCount++;
+    events[event->slot] = event;
+    siftUp(event->slot);
+
+    mask = (uint64) (eventHashSize - 1);
+    event->next = eventHash[(uint64) event->id & mask];
+    eventHash[(uint64) event->id & mask] = event;
     rUnlock(&eventLock);
+    return 0;
+}
+
+/*
+    Remove an event from the queue and the ID hash. Caller must hold the event lock.
+ */
+static void unlinkEvent(Event *event)
+{
+    Event **epp;
+    Event *last;
+    int   slot;
+
+    for (epp = &eventHash[(uint64) event->id & (uint64) (eventHashSize - 1)]; *epp; epp = &(*epp)->next) {
+        if (*epp == event) {
+            *epp = event->next;
+            break;
+        }
+    }
+    event->next = NULL;
+
+    slot = event->slot;
+    last = events[--eventCount];
+    if (slot < eventCount) {
+        events[slot] = last;
+        last->slot = slot;
+        if (slot > 0 && beforeEvent(last, events[(slot - 1) / 2])) {
+            siftUp(slot);
+        } else {
+            siftDown(slot);
+        }
+    }
+    event->slot = -1;
 }
 
 PUBLIC void rWatch(cchar *name, RWatchProc proc, void *data)
@@ -3717,6 +3835,30 @@ PUBLIC void rFreeHash(RHash *hash)
     }
 }
 
+PUBLIC void rClearHash(RHash *hash)
+{
+    RName  *np;
+    size_t i;
+
+    if (!hash) {
+        return;
+    }
+    hash->free = -1;
+    for (i = 0; i < hash->size; i++) {
+        np = &hash->names[i];
+        if (np->flags) {
+            freeHashName(np);
+        }
+        memset(np, 0, sizeof(RName));
+        np->next = hash->free;
+        hash->free = (int) i;
+    }
+    for (i = 0; i < hash->numBuckets; i++) {
+        hash->buckets[i] = -1;
+    }
+    hash->length = 0;
+}
+
 static void freeHashName(RName *np)
 {
     if (np->flags & (R_DYNAMIC_NAME | R_TEMPORAL_NAME)) {
@@ -7032,8 +7174,10 @@ static int initEngine(Rtls *tp)
 
 static int selectAlpn(SSL *ssl, cuchar **out, uchar *outlen, cuchar *in, uint inlen, void *arg)
 {
-    Rtls  *tp;
-    cchar *alpn;
+    Rtls   *tp;
+    cchar  *alpn, *cp;
+    cuchar *proto;
+    size_t len;
 
     tp = arg;
     alpn = tp->alpn;
@@ -7041,14 +7185,24 @@ static int selectAlpn(SSL *ssl, cuchar **out, uchar *outlen, cuchar *in, uint in
         return SSL_TLSEXT_ERR_NOACK;
     }
     /*
-        WARNING: this appalling API expects pbuf to be static / persistent and sets *out to refer to it.
-        NOTE: ALPN protocol string only supports one protocol.
+        The ALPN string is a comma separated list of protocols in server preference order.
+        The client list (in) is in wire format of length prefixed names. *out must refer to persistent memory
+        so it is set to refer into the client list.
      */
-    if (SSL_select_next_proto((uchar**) out, outlen, (cuchar*) alpn, (uint) slen(alpn), in,
-                              inlen) != OPENSSL_NPN_NEGOTIATED) {
-        return SSL_TLSEXT_ERR_NOACK;
+    for (cp = alpn; *cp; cp += len) {
+        cp += strspn(cp, ", \t");
+        if ((len = strcspn(cp, ", \t")) == 0) {
+            break;
+        }
+        for (proto = in; proto < &in[inlen] && proto + *proto < &in[inlen]; proto += *proto + 1) {
+            if (*proto == len && memcmp(&proto[1], cp, len) == 0) {
+                *out = &proto[1];
+                *outlen = *proto;
+                return SSL_TLSEXT_ERR_OK;
+            }
+        }
     }
-    return SSL_TLSEXT_ERR_OK;
+    return SSL_TLSEXT_ERR_NOACK;
 }
 
 PUBLIC Rtls *rAcceptTls(Rtls *tp, Rtls *listen)
@@ -8691,6 +8845,7 @@ PUBLIC ssize rMakeArgs(cchar *command, char ***argvp, bool argsOnly)
 
 #define ME_SOCKET_TIMEOUT    (30 * 1000)
 #define ME_HANDSHAKE_TIMEOUT (30 * 1000)
+#define R_TLS_RECORD_SIZE    (16 * 1024)
 #ifndef ME_SOCKET_MAX
     #define ME_SOCKET_MAX    1000
 #endif
@@ -8704,6 +8859,10 @@ static RSocketCustom socketCustom;
 static void acceptSocket(RSocket *listen, int mask);
 static void socketHandlerFiber(RSocket *sp);
 static int getOsError(RSocket *sp);
+static ssize writeSocketv(RSocket *sp, RIOVec *iov, int count);
+#if ME_COM_SSL
+static ssize writeTlsv(RSocket *sp, RIOVec *iov, int count, size_t total, Ticks deadline);
+#endif
 #if ME_DEBUG
 static void traceSocket(Socket fd, cchar *label);
 #endif
@@ -9303,6 +9462,146 @@ PUBLIC ssize rWriteSocketSync(RSocket *sp, cvoid *buf, size_t bufsize)
     return bytes;
 }
 
+/*
+    Write a vector of blocks. Blocks are written with a single gathered system call where supported.
+ */
+PUBLIC ssize rWriteSocketv(RSocket *sp, const RIOVec *iov, int count, Ticks deadline)
+{
+    RIOVec vec[R_MAX_IOVEC];
+    ssize  written;
+    size_t total, toWrite;
+    int    i, n;
+
+    if (!sp || !iov || count < 0 || count > R_MAX_IOVEC) {
+        return R_ERR_BAD_ARGS;
+    }
+    for (i = n = 0, total = 0; i < count; i++) {
+        if (iov[i].base && iov[i].len > 0) {
+            vec[n++] = iov[i];
+            total += iov[i].len;
+        }
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (n == 1) {
+        return rWriteSocket(sp, vec[0].base, vec[0].len, deadline);
+    }
+#if ME_COM_SSL
+    if (sp->tls) {
+        return writeTlsv(sp, vec, n, total, deadline);
+    }
+#endif
+    if (deadline <= 0) {
+        deadline = rGetTicks() + ME_HANDSHAKE_TIMEOUT;
+    }
+    for (i = 0, toWrite = total; toWrite > 0; ) {
+        if ((written = writeSocketv(sp, &vec[i], n - i)) < 0) {
+            return written;
+        }
+        toWrite -= (size_t) written;
+        //  Step over the blocks that have been fully written
+        while (written > 0) {
+            if ((size_t) written >= vec[i].len) {
+                written -= (ssize) vec[i].len;
+                i++;
+            } else {
+                vec[i].base = (char*) vec[i].base + written;
+                vec[i].len -= (size_t) written;
+                written = 0;
+            }
+        }
+        if (toWrite > 0) {
+            if (rWaitForIO(sp->wait, R_WRITABLE, deadline) == 0) {
+                return R_ERR_TIMEOUT;
+            }
+        }
+    }
+    if (sp->flags & R_SOCKET_EOF) {
+        return R_ERR_CANT_WRITE;
+    }
+    return (ssize) total;
+}
+
+/*
+    Write a vector of blocks without yielding. Returns the number of bytes written which may be zero if the
+    socket cannot absorb more data.
+ */
+static ssize writeSocketv(RSocket *sp, RIOVec *iov, int count)
+{
+#if ME_UNIX_LIKE
+    struct iovec  vec[R_MAX_IOVEC];
+    struct msghdr msg;
+    ssize         written;
+    int           error, i;
+
+    if (sp->flags & R_SOCKET_EOF) {
+        return R_ERR_CANT_WRITE;
+    }
+    for (i = 0; i < count; i++) {
+        vec[i].iov_base = (void*) iov[i].base;
+        vec[i].iov_len = iov[i].len;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = vec;
+    msg.msg_iovlen = (size_t) count;
+
+    while ((written = sendmsg(sp->fd, &msg, MSG_NOSIGNAL)) < 0) {
+        error = getOsError(sp);
+        if (error == EINTR) {
+            continue;
+        } else if (error == EAGAIN || error == EWOULDBLOCK) {
+            return 0;
+        }
+        return -error;
+    }
+    sp->activity = rGetTime();
+    return written;
+#else
+    //  No gathered write support. Write the first block only.
+    return rWriteSocketSync(sp, iov[0].base, iov[0].len);
+#endif
+}
+
+#if ME_COM_SSL
+/*
+    Coalesce leading blocks into a single TLS record and write the remainder directly
+ */
+static ssize writeTlsv(RSocket *sp, RIOVec *iov, int count, size_t total, Ticks deadline)
+{
+    char   *buf;
+    size_t len, size, n;
+    int    i;
+
+    size = min(total, R_TLS_RECORD_SIZE);
+    if ((buf = rAlloc(size)) == 0) {
+        return R_ERR_MEMORY;
+    }
+    for (i = 0, len = 0; i < count && len < size; ) {
+        n = min(iov[i].len, size - len);
+        memcpy(&buf[len], iov[i].base, n);
+        len += n;
+        if (n < iov[i].len) {
+            iov[i].base = (char*) iov[i].base + n;
+            iov[i].len -= n;
+        } else {
+            i++;
+        }
+    }
+    if (rWriteSocket(sp, buf, len, deadline) < 0) {
+        rFree(buf);
+        return R_ERR_CANT_WRITE;
+    }
+    rFree(buf);
+    for (; i < count; i++) {
+        if (rWriteSocket(sp, iov[i].base, iov[i].len, deadline) < 0) {
+            return R_ERR_CANT_WRITE;
+        }
+    }
+    return (ssize) total;
+}
+#endif
+
 /*
     Set a socket into blocking I/O mode. from a socket.
     Sockets are opened in non-blocking mode by default.
@@ -9694,6 +9993,106 @@ PUBLIC ssize rSendFile(RSocket *sock, int fd, Offset offset, size_t len)
 }
 #endif /* ME_HAS_SENDFILE */
 
+#if ME_HAS_SPLICE
+/*
+    Copy pipe data to the file when the file does not support splice
+ */
+static ssize drainPipe(int pfd, int fd, loff_t *off, ssize len)
+{
+    char  buf[ME_BUFSIZE];
+    ssize nbytes, total;
+
+    for (total = 0; total < len; total += nbytes) {
+        if ((nbytes = read(pfd, buf, (size_t) min(len - total, (ssize) sizeof(buf)))) <= 0) {
+            return R_ERR_CANT_READ;
+        }
+        if (pwrite(fd, buf, (size_t) nbytes, (off_t) *off) != nbytes) {
+            return R_ERR_CANT_WRITE;
+        }
+        *off += nbytes;
+    }
+    return total;
+}
+
+/*
+    Receive socket data into a file using zero-copy splice. Data moves socket -> pipe -> file within the kernel.
+    Returns the number of bytes received or a negative error code.
+ */
+PUBLIC ssize rReceiveFile(RSocket *sock, int fd, Offset offset, size_t len, Ticks deadline)
+{
+    RWait  *wp;
+    loff_t off;
+    ssize  total, nbytes, written;
+    size_t remaining;
+    int    pfd[2];
+    bool   unsupported;
+
+    if (!sock || fd < 0 || sock->tls) {
+        return R_ERR_BAD_ARGS;
+    }
+    if (sock->flags & R_SOCKET_EOF) {
+        return R_ERR_CANT_READ;
+    }
+    wp = sock->wait;
+    if (!wp) {
+        sock->wait = wp = rAllocWait((int) sock->fd);
+    }
+    if (pipe2(pfd, O_CLOEXEC) < 0) {
+        return R_ERR_CANT_OPEN;
+    }
+    //  A larger pipe reduces the number of splice calls. This is a hint and failure is ignored.
+    fcntl(pfd[1], F_SETPIPE_SZ, ME_BUFSIZE * 64);
+
+    off = (loff_t) offset;
+    total = 0;
+    remaining = len;
+    unsupported = 0;
+    while (remaining > 0 && !unsupported) {
+        nbytes = splice((int) sock->fd, NULL, pfd[1], NULL, remaining, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (nbytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN) {
+                if (rWaitForIO(wp, R_READABLE, deadline) == 0) {
+                    total = total ? total : R_ERR_TIMEOUT;
+                    break;
+                }
+                continue;
+            }
+            sock->flags |= R_SOCKET_EOF;
+            total = total ? total : R_ERR_CANT_READ;
+            break;
+        } else if (nbytes == 0) {
+            sock->flags |= R_SOCKET_EOF;
+            total = total ? total : R_ERR_CANT_READ;
+            break;
+        }
+        //  Move the pipe data to the file. File writes do not return EAGAIN.
+        while (nbytes > 0) {
+            if ((written = splice(pfd[0], NULL, fd, &off, (size_t) nbytes, SPLICE_F_MOVE)) < 0 && errno == EINVAL) {
+                //  The file system does not support splice. Copy this data and let the caller read the rest.
+                written = drainPipe(pfd[0], fd, &off, nbytes);
+                unsupported = 1;
+            } else if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                total = R_ERR_CANT_WRITE;
+                remaining = 0;
+                break;
+            }
+            nbytes -= written;
+            total += written;
+            remaining -= (size_t) written;
+        }
+    }
+    close(pfd[0]);
+    close(pfd[1]);
+    sock->activity = rGetTime();
+    return total;
+}
+#endif /* ME_HAS_SPLICE */
+
 #endif /* R_USE_SOCKET */
 /*
     Copyright (c) Michael O'Brien. All Rights Reserved.
@@ -12244,11 +12643,22 @@ static RHash *waitMap;
 static Ticks nextDeadline;
 static bool  waiting = 0;
 
+/*
+    Min-heap of waits with deadlines ordered by deadline. Each RWait records its heap slot.
+ */
+static RWait **deadlines;
+static int   deadlineCount;
+static int   deadlineMax;
+
 /*********************************** Forwards *********************************/
 
+static int countDue(int slot, Ticks now);
 static void invokeExpired(void);
 static void invokeHandler(size_t fd, int event);
 static Ticks getTimeout(Ticks deadline);
+static void lowerDeadline(int slot);
+static void raiseDeadline(int slot);
+static void setDeadline(RWait *wp, Ticks deadline);
 
 /************************************* Code ***********************************/
 
@@ -12302,6 +12712,9 @@ PUBLIC int rInitWait(void)
 PUBLIC void rTermWait(void)
 {
     rFreeHash(waitMap);
+    rFree(deadlines);
+    deadlines = 0;
+    deadlineCount = deadlineMax = 0;
 
 #if ME_EVENT_NOTIFIER == R_EVENT_EPOLL || ME_EVENT_NOTIFIER == R_EVENT_KQUEUE
     if (waitfd >= 0) {
@@ -12333,6 +12746,7 @@ PUBLIC RWait *rAllocWait(int fd)
         return 0;
     }
     wp->fd = fd;
+    wp->slot = -1;
     if (!rAddName(waitMap, sitos(fd), wp, 0)) {
         rFree(wp);
         return 0;
@@ -12348,6 +12762,7 @@ PUBLIC void rFreeWait(RWait *wp)
     char fdbuf[32];
 
     if (wp) {
+        setDeadline(wp, 0);
         if (wp->fd != INVALID_SOCKET) {
 #if ME_EVENT_NOTIFIER == R_EVENT_SELECT || ME_EVENT_NOTIFIER == R_EVENT_WSAPOLL
             //  Must clear masks and recalculate highestFd (SELECT) or remove from pollFds (WSAPOLL)
@@ -12376,7 +12791,7 @@ PUBLIC void rResumeWaitFiber(RWait *wp, int mask)
  */
 PUBLIC void rSetWaitHandler(RWait *wp, RWaitProc handler, cvoid *arg, int64 mask, Ticks deadline, int flags)
 {
-    wp->deadline = deadline;
+    setDeadline(wp, deadline);
     wp->handler = handler;
     wp->arg = arg;
     wp->flags = flags;
@@ -12391,7 +12806,7 @@ PUBLIC void rSetWaitMask(RWait *wp, int64 mask, Ticks deadline)
     if (wp == 0) {
         return;
     }
-    wp->deadline = deadline;
+    setDeadline(wp, deadline);
     if (wp->mask == (int) mask) {
         return;
     }
@@ -12747,38 +13162,131 @@ PUBLIC int rWait(Ticks deadline)
 }
 
 /*
-    Invoke events that have expired deadlines
+    Invoke events that have expired deadlines.
+    Expired waits are removed from the deadline queue before invoking so each deadline fires once.
+    Handlers may modify the queue, so the earliest deadline is re-examined after each invocation.
  */
 static void invokeExpired(void)
 {
-    RWait  *wp;
-    RName  *np;
-    Ticks  now;
-    Socket expired[ME_MAX_EVENTS];
-    int    count;
-
-    now = rGetTicks();
-    count = 0;
+    RWait *wp;
+    Ticks now;
+    int   due;
 
     /*
-        First pass: collect expired fds without modifying the hash.
-        If more than ME_MAX_EVENTS expire simultaneously, extras are processed on the next rWait() call.
+        Only invoke the waits due at the start of the pass. Handlers may set new deadlines that have already
+        expired and these must wait for the next pass so other events and I/O are not starved.
      */
-    for (ITERATE_NAMES(waitMap, np)) {
-        wp = (RWait*) np->value;
-        if (wp->deadline && wp->deadline <= now) {
-            if (count < ME_MAX_EVENTS) {
-                expired[count++] = wp->fd;
+    now = rGetTicks();
+    due = countDue(0, now);
+    while (due-- > 0 && deadlineCount > 0 && deadlines[0]->deadline <= now) {
+        wp = deadlines[0];
+        setDeadline(wp, 0);
+        invokeHandler((size_t) wp->fd, R_TIMEOUT);
+    }
+}
+
+/*
+    Count the waits in the deadline queue at or below the given slot that are due at the given time
+ */
+static int countDue(int slot, Ticks now)
+{
+    if (slot >= deadlineCount || deadlines[slot]->deadline > now) {
+        return 0;
+    }
+    return 1 + countDue(slot * 2 + 1, now) + countDue(slot * 2 + 2, now);
+}
+
+/*
+    Set the wait deadline and (re)position the wait in the deadline queue. A zero deadline removes it.
+ */
+static void setDeadline(RWait *wp, Ticks deadline)
+{
+    RWait **queue;
+    RWait *last;
+    int   size, slot;
+
+    if (wp->slot >= 0 && wp->deadline == deadline) {
+        return;
+    }
+    wp->deadline = deadline;
+    if (wp->slot < 0) {
+        if (deadline == 0) {
+            return;
+        }
+        if (deadlineCount >= deadlineMax) {
+            size = deadlineMax ? deadlineMax * 2 : ME_MAX_EVENTS;
+            if ((queue = rRealloc(deadlines, sizeof(RWait*) * (size_t) size)) == 0) {
+                rError("wait", "Cannot grow deadline queue");
+                wp->deadline = 0;
+                return;
             }
+            deadlines = queue;
+            deadlineMax = size;
+        }
+        wp->slot = deadlineCount++;
+        deadlines[wp->slot] = wp;
+        raiseDeadline(wp->slot);
+
+    } else if (deadline == 0) {
+        slot = wp->slot;
+        wp->slot = -1;
+        last = deadlines[--deadlineCount];
+        if (slot < deadlineCount) {
+            deadlines[slot] = last;
+            last->slot = slot;
+            raiseDeadline(slot);
+            lowerDeadline(last->slot);
         }
+    } else {
+        raiseDeadline(wp->slot);
+        lowerDeadline(wp->slot);
     }
-    /*
-        Second pass: invoke handlers after iteration completes
-        This prevents hash modification during iteration which would corrupt the iterator
-     */
-    for (int i = 0; i < count; i++) {
-        invokeHandler((size_t) expired[i], R_TIMEOUT);
+}
+
+/*
+    Move a wait toward the top of the deadline queue
+ */
+static void raiseDeadline(int slot)
+{
+    RWait *wp;
+    int   parent;
+
+    wp = deadlines[slot];
+    while (slot > 0) {
+        parent = (slot - 1) / 2;
+        if (deadlines[parent]->deadline <= wp->deadline) {
+            break;
+        }
+        deadlines[slot] = deadlines[parent];
+        deadlines[slot]->slot = slot;
+        slot = parent;
+    }
+    deadlines[slot] = wp;
+    wp->slot = slot;
+}
+
+/*
+    Move a wait toward the bottom of the deadline queue
+ */
+static void lowerDeadline(int slot)
+{
+    RWait *wp;
+    int   child;
+
+    wp = deadlines[slot];
+    while ((child = slot * 2 + 1) < deadlineCount) {
+        if (child + 1 < deadlineCount && deadlines[child + 1]->deadline < deadlines[child]->deadline) {
+            child++;
+        }
+        if (wp->deadline <= deadlines[child]->deadline) {
+            break;
+        }
+        deadlines[slot] = deadlines[child];
+        deadlines[slot]->slot = slot;
+        slot = child;
     }
+    deadlines[slot] = wp;
+    wp->slot = slot;
 }
 
 /*
@@ -12854,16 +13362,11 @@ PUBLIC int rGetWaitFd(void)
 static Ticks getTimeout(Ticks deadline)
 {
     Ticks nextEvent, now, timeout;
-    RWait *wp;
-    RName *np;
 
     now = rGetTicks();
 
-    for (ITERATE_NAMES(waitMap, np)) {
-        wp = (RWait*) np->value;
-        if (wp->deadline) {
-            deadline = min(deadline, wp->deadline);
-        }
+    if (deadlineCount > 0) {
+        deadline = min(deadline, deadlines[0]->deadline);
     }
     if (nextDeadline < now) {
         nextDeadline = now;
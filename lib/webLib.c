@@ -1248,6 +1248,10 @@ static char *computeDigest(Web *web, cchar *password)
 
 /********************************** Includes **********************************/
 
+#if ME_WEB_COMPRESS
+    #include <zlib.h>
+#endif
+
 
 
 /************************************ Locals **********************************/
@@ -1256,16 +1260,30 @@ typedef struct stat FileInfo;
 
 /************************************ Forwards *********************************/
 
+static WebFile *cacheFile(Web *web, cchar *docPath, cchar *path, int fd, FileInfo *info, cchar *encoding, bool compress,
+                          int absent);
+#if ME_WEB_COMPRESS
+static char *gzipData(cchar *data, size_t size, size_t *len);
+#endif
 static int deleteFile(Web *web, char *path, size_t pathSize);
 static int fixRanges(Web *web, int64 fileSize);
+static void freeFile(WebFile *file);
+static void invalidateFile(WebHost *host, cchar *path);
+static WebFile *lookupFile(Web *web, cchar *key, cchar *path);
+static WebFile *lookupVariant(Web *web, cchar *path);
+static void releaseFile(WebFile *file);
+static void removeFile(WebHost *host, WebFile *file);
+static int sendCachedFile(Web *web, WebFile *file);
 static int getFile(Web *web, char *path, size_t pathSize);
-static cchar *getEncoding(Web *web);
 static int sendFile(Web *web, int fd, FileInfo *info, cchar *encoding);
 static int pickRanges(Web *web, FileInfo *info, cchar *etag);
 static int putFile(Web *web, char *path, size_t pathSize);
 static void redirectToDir(Web *web);
 static bool pickFile(Web *web, char path[ME_MAX_FNAME], FileInfo *info, cchar **pEncoding);
 static int sendFileContent(Web *web, int fd, FileInfo *info);
+#if ME_WEB_SPLICE
+static ssize spliceBody(Web *web, int fd);
+#endif
 static void writeRangeHeader(Web *web, WebRange *range, int64 fileSize);
 
 /************************************* Code ***********************************/
@@ -1295,10 +1313,24 @@ PUBLIC int webFileHandler(Web *web)
 
 static int getFile(Web *web, char *path, size_t pathSize)
 {
+    WebFile  *file;
     FileInfo info;
     cchar    *encoding;
-    int      fd, rc;
+    char     docPath[ME_MAX_FNAME];
+    bool     cache, compress;
+    int      absent, fd, rc;
 
+    /*
+        Small static documents are served from memory. Range requests always read the file.
+     */
+    cache = web->host->maxCache > 0 && !web->ranges;
+    if (cache) {
+        if ((file = lookupVariant(web, path)) != 0) {
+            return sendCachedFile(web, file);
+        }
+        //  Variants are cached under the requested path as pickFile may select a compressed or index document
+        scopy(docPath, sizeof(docPath), path);
+    }
     if (!pickFile(web, path, &info, &encoding)) {
         webHook(web, WEB_HOOK_NOT_FOUND);
         if (!web->finalized) {
@@ -1313,6 +1345,30 @@ static int getFile(Web *web, char *path, size_t pathSize)
         webError(web, 404, "Cannot open document");
         return R_ERR_CANT_OPEN;
     }
+    if (cache) {
+        /*
+            Uncompressed documents are compressed once when cached if the route compresses responses
+         */
+        compress = 0;
+#if ME_WEB_COMPRESS
+        compress = !encoding && webCanCompress(web, web->ext ? rLookupName(web->host->mimeTypes, web->ext) : 0,
+                                               (ssize) info.st_size);
+#endif
+        //  Record the accepted encodings that have no variant so identity is served for them from the cache
+        absent = 0;
+        if (!encoding) {
+            if (webAcceptsEncoding(web->acceptEncoding, "br")) {
+                absent |= WEB_VARIANT_BR;
+            }
+            if (!compress && webAcceptsEncoding(web->acceptEncoding, "gzip")) {
+                absent |= WEB_VARIANT_GZIP;
+            }
+        }
+        if ((file = cacheFile(web, docPath, path, fd, &info, encoding, compress, absent)) != 0) {
+            close(fd);
+            return sendCachedFile(web, file);
+        }
+    }
     rc = sendFile(web, fd, &info, encoding);
     close(fd);
     return rc;
@@ -1395,7 +1451,8 @@ static int putFile(Web *web, char *path, size_t pathSize)
     char     etag[24], *ptr;
     size_t   bufsize;
     ssize    nbytes;
-    int      fd, total;
+    int64    total;
+    int      fd;
 
     /*
         Check preconditions for state-changing requests per RFC 7232
@@ -1419,10 +1476,29 @@ static int putFile(Web *web, char *path, size_t pathSize)
     }
     assert(rGetBufLength(web->body) == 0);
 
+    invalidateFile(web->host, path);
     if ((fd = open(path, O_WRONLY | O_BINARY | O_CREAT | O_TRUNC, 0600)) < 0) {
         return webError(web, 404, "Cannot open document");
     }
     total = 0;
+#if ME_WEB_SPLICE
+    /*
+        Large bodies with a content length on cleartext HTTP/1 connections are spliced from the socket to the file.
+        The content length has already been validated against the upload limit. The loop below reads any remainder.
+     */
+    if (!rIsSocketSecure(web->sock) && !web->chunked && web->rxRemaining > WEB_BUF_BOOST_16X
+#if ME_WEB_HTTP2
+        && !web->stream
+#endif
+        ) {
+        if ((nbytes = spliceBody(web, fd)) < 0) {
+            close(fd);
+            unlink(path);
+            return (int) webWriteResponseString(web, 500, "PUT request failed with premature client disconnect");
+        }
+        total = nbytes;
+    }
+#endif
     //  Zero-copy: read directly from rx buffer
     bufsize = min(WEB_BUF_BOOST_16X, (size_t) web->rxRemaining);
     while ((nbytes = webReadDirect(web, &ptr, bufsize)) > 0) {
@@ -1430,7 +1506,7 @@ static int putFile(Web *web, char *path, size_t pathSize)
             close(fd);
             return webError(web, 500, "Cannot put document");
         }
-        total += (int) nbytes;
+        total += nbytes;
         if (total > web->host->maxUpload) {
             close(fd);
             unlink(path);
@@ -1449,6 +1525,63 @@ static int putFile(Web *web, char *path, size_t pathSize)
     return (int) webWriteResponseString(web, web->exists ? 204 : 201, "Document successfully updated");
 }
 
+#if ME_WEB_SPLICE
+#if ME_DEBUG || ME_BENCHMARK
+/*
+    Maximum PUT body bytes to splice per request (zero for no limit). Set by the test splice action.
+ */
+static ssize spliceLimit = 0;
+
+PUBLIC void webSetSpliceLimit(ssize limit)
+{
+    spliceLimit = limit;
+}
+#endif
+
+/*
+    Write the body data already buffered in web->rx and splice the rest of the body directly from the socket to the
+    file without copying through user space. Returns the number of bytes written or a negative error code.
+ */
+static ssize spliceBody(Web *web, int fd)
+{
+    ssize  nbytes, total;
+    size_t len;
+
+    total = 0;
+    if ((len = min(rGetBufLength(web->rx), (size_t) web->rxRemaining)) > 0) {
+        if (write(fd, web->rx->start, len) != (ssize) len) {
+            return R_ERR_CANT_WRITE;
+        }
+        rAdjustBufStart(web->rx, (ssize) len);
+        web->rxRemaining -= (int64) len;
+        total = (ssize) len;
+    }
+    if (web->rxRemaining > 0) {
+        len = (size_t) web->rxRemaining;
+#if ME_DEBUG || ME_BENCHMARK
+        if (spliceLimit > 0) {
+            len = min(len, (size_t) spliceLimit);
+        }
+#endif
+        if ((nbytes = rReceiveFile(web->sock, fd, total, len, web->deadline)) < 0) {
+            return nbytes;
+        }
+        web->rxRemaining -= nbytes;
+        web->rxRead += nbytes;
+        total += nbytes;
+        webUpdateDeadline(web);
+        /*
+            rReceiveFile does not move the file position. Advance it past the spliced data so a short splice
+            (unsupported file system, timeout or test limit) can be completed by the caller's buffered writes.
+         */
+        if (lseek(fd, (off_t) total, SEEK_SET) != (off_t) total) {
+            return R_ERR_CANT_WRITE;
+        }
+    }
+    return total;
+}
+#endif
+
 static int deleteFile(Web *web, char *path, size_t pathSize)
 {
     FileInfo info;
@@ -1475,6 +1608,7 @@ static int deleteFile(Web *web, char *path, size_t pathSize)
             return webError(web, 404, "Cannot locate document");
         }
     }
+    invalidateFile(web->host, path);
     if (unlink(path) != 0) {
         return webError(web, 404, "Cannot delete document");
     }
@@ -1494,12 +1628,20 @@ PUBLIC ssize webSendFile(Web *web, int fd, Offset offset, ssize len)
     if (len <= 0) {
         return 0;
     }
-    if (!web->wroteHeaders && webWriteHeaders(web) < 0) {
-        return R_ERR_CANT_WRITE;
-    }
 #if ME_HTTP_SENDFILE
-    //  Use zero-copy sendfile for non-TLS HTTP connections
+    //  Use zero-copy sendfile for non-TLS HTTP/1 connections
+#if ME_WEB_HTTP2
+    if (!rIsSocketSecure(web->sock) && !web->stream) {
+#else
     if (!rIsSocketSecure(web->sock)) {
+#endif
+        if (!web->wroteHeaders && webWriteHeaders(web) < 0) {
+            return R_ERR_CANT_WRITE;
+        }
+        //  Corked output must precede the file content
+        if (webFlush(web) < 0) {
+            return R_ERR_CANT_WRITE;
+        }
         written = rSendFile(web->sock, fd, offset, (size_t) len);
         if (written < 0 || written < len) {
             return webNetError(web, "Cannot send file");
@@ -1679,32 +1821,320 @@ static int sendFileContent(Web *web, int fd, FileInfo *info)
     return 0;
 }
 
+/********************************** File Cache ********************************/
+/*
+    Lookup a cached document. Documents are revalidated against the filesystem at most once per cacheCheck period.
+ */
+static WebFile *lookupFile(Web *web, cchar *key, cchar *path)
+{
+    WebHost  *host;
+    WebFile  *file;
+    FileInfo info;
+    Ticks    now;
+
+    host = web->host;
+    if ((file = rLookupName(host->files, key)) == 0) {
+        return 0;
+    }
+    now = rGetTicks();
+    if (now - file->checked >= host->cacheCheck) {
+        if (stat(file->path, &info) != 0 || info.st_mtime != file->modified ||
+            (size_t) info.st_size != file->size || (uint64) info.st_ino != file->inode) {
+            removeFile(host, file);
+            return 0;
+        }
+        file->checked = now;
+    }
+    if (sends(path, "/")) {
+        web->ext = strrchr(host->index, '.');
+    }
+    web->exists = 1;
+    return file;
+}
+
+/*
+    Lookup the cached variant of a document for the encodings accepted by the client. Variants are keyed by the
+    content encoding they hold: "br:path", "gzip:path" or ":path" for identity. Compressed variants are tried in
+    order of preference. The identity variant is used unless the route may offer an accepted encoding that has not
+    been found to be absent for the document. Otherwise the best variant is selected and cached on a miss.
+ */
+static WebFile *lookupVariant(Web *web, cchar *path)
+{
+    WebRoute *route;
+    WebFile  *file;
+    char     key[ME_MAX_FNAME + 8];
+    int      offered;
+
+    route = web->route;
+    offered = 0;
+    if (route->compressed && webAcceptsEncoding(web->acceptEncoding, "br")) {
+        if ((file = lookupFile(web, sfmtbuf(key, sizeof(key), "br:%s", path), path)) != 0) {
+            return file;
+        }
+        offered |= WEB_VARIANT_BR;
+    }
+#if ME_WEB_COMPRESS
+    if ((route->compressed || route->compress) && webAcceptsEncoding(web->acceptEncoding, "gzip")) {
+#else
+    if (route->compressed && webAcceptsEncoding(web->acceptEncoding, "gzip")) {
+#endif
+        if ((file = lookupFile(web, sfmtbuf(key, sizeof(key), "gzip:%s", path), path)) != 0) {
+            return file;
+        }
+        offered |= WEB_VARIANT_GZIP;
+    }
+    if ((file = lookupFile(web, sfmtbuf(key, sizeof(key), ":%s", path), path)) != 0) {
+        if ((offered & ~file->absent) == 0) {
+            return file;
+        }
+    }
+    return 0;
+}
+
+/*
+    Read a small regular file into the cache. If compress is true, the cached variant is gzip compressed.
+    The variant is keyed by the requested document path and its content encoding. An existing variant with the
+    same key is replaced. Older documents are evicted to keep within the maxCache byte budget.
+ */
+static WebFile *cacheFile(Web *web, cchar *docPath, cchar *path, int fd, FileInfo *info, cchar *encoding, bool compress,
+                          int absent)
+{
+    WebHost *host;
+    WebFile *file, *prior;
+    cchar   *suffix;
+    char    key[ME_MAX_FNAME + 8];
+    ssize   nbytes;
+    size_t  size, len;
+#if ME_WEB_COMPRESS
+    char    *data;
+#endif
+
+    host = web->host;
+    size = (size_t) info->st_size;
+    if (!S_ISREG(info->st_mode) || info->st_size > host->maxCacheItem || info->st_size > host->maxCache) {
+        return 0;
+    }
+    if ((file = rAllocType(WebFile)) == 0) {
+        return 0;
+    }
+    file->data = rAlloc(size + 1);
+    for (len = 0; len < size; len += (size_t) nbytes) {
+        if ((nbytes = read(fd, &file->data[len], (uint) (size - len))) <= 0) {
+            freeFile(file);
+            return 0;
+        }
+    }
+    file->data[size] = '\0';
+    file->size = size;
+    suffix = "";
+#if ME_WEB_COMPRESS
+    if (compress && (data = gzipData(file->data, size, &len)) != 0) {
+        if (len < size) {
+            rFree(file->data);
+            file->data = data;
+            file->size = size = len;
+            encoding = "gzip";
+            suffix = "-gzip";
+        } else {
+            //  Not worth compressing. Serve the identity document to gzip clients without compressing again.
+            rFree(data);
+            absent |= WEB_VARIANT_GZIP;
+        }
+    }
+#endif
+    sfmtbuf(key, sizeof(key), "%s:%s", encoding ? encoding : "", docPath);
+    if ((prior = rLookupName(host->files, key)) != 0) {
+        if (!encoding) {
+            absent |= prior->absent;
+        }
+        removeFile(host, prior);
+    }
+    file->key = sclone(key);
+    file->path = sclone(path);
+    file->modified = info->st_mtime;
+    file->inode = (uint64) info->st_ino;
+    file->encoding = encoding;
+    file->absent = encoding ? 0 : absent;
+    //  Generated variants have a distinct ETag from the uncompressed document
+    file->etag = sfmt("%lld%s", (int64) ((uint64) info->st_ino ^ (uint64) info->st_size ^ (uint64) info->st_mtime),
+                      suffix);
+    file->etagHeader = sfmt("\"%s\"", file->etag);
+    file->lastModified = webHttpDate(info->st_mtime);
+    file->checked = rGetTicks();
+
+    while (host->cacheSize + size > (size_t) host->maxCache) {
+        removeFile(host, rGetItem(host->fileOrder, 0));
+    }
+    rAddName(host->files, file->key, file, 0);
+    rAddItem(host->fileOrder, file);
+    host->cacheSize += size;
+    return file;
+}
+
+#if ME_WEB_COMPRESS
+/*
+    Compress a document using gzip
+ */
+static char *gzipData(cchar *data, size_t size, size_t *len)
+{
+    z_stream zs;
+    char     *out;
+    size_t   bound;
+
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    bound = deflateBound(&zs, (uLong) size);
+    out = rAlloc(bound);
+    zs.next_in = (Bytef*) data;
+    zs.avail_in = (uInt) size;
+    zs.next_out = (Bytef*) out;
+    zs.avail_out = (uInt) bound;
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
+        deflateEnd(&zs);
+        rFree(out);
+        return 0;
+    }
+    *len = zs.total_out;
+    deflateEnd(&zs);
+    return out;
+}
+#endif
+
+/*
+    Send a cached document. The headers and body are gathered into a single write.
+ */
+static int sendCachedFile(Web *web, WebFile *file)
+{
+    int rc;
+
+    //  Hold the file while writing as other fibers may remove it from the cache
+    file->inuse++;
+    rc = 0;
+    webAddHeaderStaticString(web, "Accept-Ranges", "bytes");
+    webAddHeaderStaticString(web, "Last-Modified", file->lastModified);
+    webAddHeaderStaticString(web, "ETag", file->etagHeader);
+
+    if (webContentNotModified(web, file->etag, file->modified)) {
+        web->txLen = 0;
+        web->status = 304;
+    } else {
+        web->status = 200;
+        web->txLen = (int64) file->size;
+        if (file->encoding) {
+            webAddHeaderStaticString(web, "Content-Encoding", file->encoding);
+            webAddHeaderStaticString(web, "Vary", "Origin, Accept-Encoding");
+        }
+        if (!web->head && file->size > 0 && webWrite(web, file->data, file->size) < 0) {
+            rc = R_ERR_CANT_WRITE;
+        }
+    }
+    webFinalize(web);
+    releaseFile(file);
+    return rc;
+}
+
+/*
+    Remove a document from the cache. It is freed when no longer in use.
+ */
+static void removeFile(WebHost *host, WebFile *file)
+{
+    rRemoveName(host->files, file->key);
+    rRemoveItem(host->fileOrder, file);
+    host->cacheSize -= file->size;
+    if (file->inuse > 0) {
+        file->stale = 1;
+    } else {
+        freeFile(file);
+    }
+}
+
+static void releaseFile(WebFile *file)
+{
+    if (--file->inuse == 0 && file->stale) {
+        freeFile(file);
+    }
+}
+
+static void freeFile(WebFile *file)
+{
+    rFree(file->key);
+    rFree(file->path);
+    rFree(file->data);
+    rFree(file->etag);
+    rFree(file->etagHeader);
+    rFree(file->lastModified);
+    rFree(file);
+}
+
+/*
+    Remove all cached variants of a document that is being modified
+ */
+static void invalidateFile(WebHost *host, cchar *path)
+{
+    WebFile *file;
+    cchar   *encodings[] = { "", "br", "gzip", NULL };
+    char    key[ME_MAX_FNAME + 8];
+    int     i;
+
+    if (host->maxCache <= 0) {
+        return;
+    }
+    for (i = 0; encodings[i]; i++) {
+        if ((file = rLookupName(host->files, sfmtbuf(key, sizeof(key), "%s:%s", encodings[i], path))) != 0) {
+            removeFile(host, file);
+        }
+    }
+}
+
+PUBLIC void webFlushFileCache(WebHost *host)
+{
+    WebFile *file;
+
+    if (!host || !host->fileOrder) {
+        return;
+    }
+    while ((file = rGetItem(host->fileOrder, 0)) != 0) {
+        removeFile(host, file);
+    }
+}
+
 /********************************** Compression *********************************/
 /*
-    Parse Accept-Encoding header and determine preferred compression
-    Returns: "br", "gzip", or NULL (no compression supported/preferred)
-    Preference order: br > gzip (Brotli offers better compression)
+    Test if an Accept-Encoding header accepts an encoding. An encoding with a quality value of zero is refused.
+    A "*" entry applies to encodings that are not listed.
  */
-static cchar *getEncoding(Web *web)
+PUBLIC bool webAcceptsEncoding(cchar *header, cchar *encoding)
 {
-    cchar *acceptEncoding;
-    bool  supportsBr, supportsGzip;
+    char   *copy, *tok, *next, *name, *param, *params;
+    double q, quality, wild;
 
-    if ((acceptEncoding = webGetHeader(web, "Accept-Encoding")) == 0) {
-        return NULL;
+    if (!header || !encoding) {
+        return 0;
     }
-    /*
-        Prefer brotli (better compression) if client supports it
-     */
-    supportsBr = scontains(acceptEncoding, "br") != NULL;
-    if (supportsBr) {
-        return "br";
+    copy = sclone(header);
+    quality = wild = -1;
+    for (tok = stok(copy, ",", &next); tok; tok = stok(NULL, ",", &next)) {
+        name = strim(stok(tok, ";", &params), " \t", R_TRIM_BOTH);
+        q = 1;
+        for (param = stok(params, ";", &params); param; param = stok(NULL, ";", &params)) {
+            param = strim(param, " \t", R_TRIM_BOTH);
+            if ((param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+                q = stof(&param[2]);
+            }
+        }
+        if (scaselessmatch(name, encoding)) {
+            quality = q;
+        } else if (smatch(name, "*")) {
+            wild = q;
+        }
     }
-    supportsGzip = scontains(acceptEncoding, "gzip") != NULL;
-    if (supportsGzip) {
-        return "gzip";
+    rFree(copy);
+    if (quality < 0) {
+        quality = wild;
     }
-    return NULL;
+    return quality > 0;
 }
 
 /*
@@ -1734,14 +2164,21 @@ static bool pickFile(Web *web, char path[ME_MAX_FNAME], FileInfo *info, cchar **
     }
     len = slen(path);
 
-    if (web->route->compressed && (*encoding = getEncoding(web)) != 0) {
-        if (smatch(*encoding, "br")) {
+    if (web->route->compressed) {
+        //  Prefer brotli (better compression) and fallback to gzip if there is no brotli variant
+        if (webAcceptsEncoding(web->acceptEncoding, "br")) {
             sncat(path, ME_MAX_FNAME, ".br");
-            found = stat(path, info) == 0;
+            if ((found = stat(path, info) == 0) != 0) {
+                *encoding = "br";
+            } else {
+                path[len] = '\0';
+            }
         }
-        if (!found && smatch(*encoding, "gzip")) {
+        if (!found && webAcceptsEncoding(web->acceptEncoding, "gzip")) {
             sncat(path, ME_MAX_FNAME, ".gz");
-            found = stat(path, info) == 0;
+            if ((found = stat(path, info) == 0) != 0) {
+                *encoding = "gzip";
+            }
         }
     }
     if (found) {
@@ -1778,6 +2215,19 @@ static bool pickFile(Web *web, char path[ME_MAX_FNAME], FileInfo *info, cchar **
 
 
 
+/*********************************** Locals ***********************************/
+/*
+    Route and action match index. This is a byte trie over the match patterns. Each node records the
+    lowest ordinal prefix and exact patterns ending at the node so lookups preserve first-match order.
+ */
+typedef struct WebMatch {
+    struct WebMatch *child;     /* First child node */
+    struct WebMatch *sibling;   /* Next sibling node */
+    int prefix;                 /* Ordinal of the first prefix pattern ending here, or -1 */
+    int exact;                  /* Ordinal of the first exact pattern ending here, or -1 */
+    uchar c;                    /* Character consumed to reach this node */
+} WebMatch;
+
 /************************************ Forwards *********************************/
 
 static WebListen *allocListen(WebHost *host, cchar *endpoint);
@@ -1787,9 +2237,16 @@ static int getTimeout(WebHost *host, cchar *field, cchar *defaultValue);
 static void initMethods(WebHost *host);
 static void initRedirects(WebHost *host);
 static void initRoutes(WebHost *host);
+static void addMatch(WebMatch *root, cchar *pattern, int ordinal, bool exact);
+static WebMatch *allocMatch(uchar c);
+static void freeMatch(WebMatch *node);
+static int lookupMatch(WebMatch *root, cchar *path);
 static void loadMimeTypes(WebHost *host);
 static void loadAuth(WebHost *host);
 static void parseCacheControl(WebRoute *route, Json *json, int id);
+#if ME_WEB_COMPRESS
+static void parseCompress(WebRoute *route, Json *json, int id);
+#endif
 static cchar *uploadDir(void);
 
 /************************************* Code ***********************************/
@@ -1828,9 +2285,13 @@ PUBLIC WebHost *webAllocHost(Json *config, int flags)
     }
     host->flags = flags;
     host->actions = rAllocList(0, 0);
+    host->actionIndex = allocMatch(0);
     host->listeners = rAllocList(0, 0);
     host->sessions = rAllocHash(0, 0);
     host->webs = rAllocList(0, 0);
+    host->pool = rAllocList(0, 0);
+    host->files = rAllocHash(0, 0);
+    host->fileOrder = rAllocList(0, 0);
     host->connSequence = 0;
 
     if (!config) {
@@ -1874,6 +2335,7 @@ PUBLIC WebHost *webAllocHost(Json *config, int flags)
     host->maxUpload = svaluei(jsonGet(host->config, 0, "web.limits.upload", "20MB"));
     host->maxUploads = svaluei(jsonGet(host->config, 0, "web.limits.uploads", "0"));
     host->maxRequests = svaluei(jsonGet(host->config, 0, "web.limits.requests", "1000"));
+    host->maxStreams = svaluei(jsonGet(host->config, 0, "web.limits.streams", "32"));
 #endif
 
     host->docs = rGetFilePath(jsonGet(host->config, 0, "web.documents", "@site"));
@@ -1884,6 +2346,14 @@ PUBLIC WebHost *webAllocHost(Json *config, int flags)
     host->httpOnly = jsonGetBool(host->config, 0, "web.sessions.httpOnly", 1);
     host->roles = jsonGetId(host->config, 0, "web.auth.roles");
     host->headers = jsonGetId(host->config, 0, "web.headers");
+    host->cork = jsonGetBool(host->config, 0, "web.cork", 1);
+#if ME_WEB_HTTP2
+    host->http2 = jsonGetBool(host->config, 0, "web.http2", 0);
+#endif
+    host->maxPool = svaluei(jsonGet(host->config, 0, "web.limits.pool", "16"));
+    host->maxCache = svaluei(jsonGet(host->config, 0, "web.limits.cache", "0"));
+    host->maxCacheItem = svaluei(jsonGet(host->config, 0, "web.limits.cacheItem", "64K"));
+    host->cacheCheck = getTimeout(host, "web.timeouts.cache", "1sec");
 #if ME_WEB_FIBER_BLOCKS
     // Defaults to false
     host->fiberBlocks = jsonGetBool(host->config, 0, "web.fiberBlocks", 0);
@@ -1922,13 +2392,22 @@ PUBLIC void webFreeHost(WebHost *host)
     }
     rFreeList(host->listeners);
 
+    //  Disable pooling so webFree releases active and pooled web objects
+    host->maxPool = 0;
     for (ITERATE_ITEMS(host->webs, web, next)) {
         webFree(web);
     }
+    while ((web = rPopItem(host->pool)) != 0) {
+        webFree(web);
+    }
     for (ITERATE_ITEMS(host->redirects, redirect, next)) {
         rFree(redirect);
     }
     rFreeList(host->webs);
+    rFreeList(host->pool);
+    webFlushFileCache(host);
+    rFreeHash(host->files);
+    rFreeList(host->fileOrder);
     rFreeList(host->redirects);
     rFreeHash(host->methods);
 
@@ -1937,9 +2416,13 @@ PUBLIC void webFreeHost(WebHost *host)
             rFreeHash(route->methods);
         }
         rFreeHash(route->extensions);
+#if ME_WEB_COMPRESS
+        rFreeList(route->compressMime);
+#endif
         rFree(route);
     }
     rFreeList(host->routes);
+    freeMatch(host->routeIndex);
 
     for (ITERATE_ITEMS(host->actions, action, next)) {
         rFree(action->match);
@@ -1947,6 +2430,7 @@ PUBLIC void webFreeHost(WebHost *host)
         rFree(action);
     }
     rFreeList(host->actions);
+    freeMatch(host->actionIndex);
 
     for (ITERATE_NAMES(host->sessions, np)) {
         rRemoveName(host->sessions, np->name);
@@ -2137,6 +2621,12 @@ PUBLIC int webSecureEndpoint(WebListen *listen)
     }
     if (rc == 0) {
         rSetSocketCerts(listen->sock, authority, key, certificate, NULL);
+#if ME_WEB_HTTP2
+        if (listen->host->http2) {
+            //  Offer HTTP/2 in preference to HTTP/1.1
+            rSetTlsAlpn(listen->sock->tls, "h2,http/1.1");
+        }
+#endif
     } else {
         rError("web", "Secure endpoint %s is not yet ready as it does not have a certificate or key.",
                listen->endpoint);
@@ -2263,6 +2753,48 @@ static void loadMimeTypes(WebHost *host)
     }
 }
 
+#if ME_WEB_COMPRESS
+/*
+    Parse on-the-fly compression configuration from route. The mime list defaults to common text formats.
+ */
+static void parseCompress(WebRoute *route, Json *json, int id)
+{
+    JsonNode *node, *mime;
+    cchar    **mp;
+    int      compressId;
+    static cchar *defaultMime[] = {
+        "text/", "application/json", "application/javascript", "application/xml", "image/svg+xml", NULL
+    };
+
+    //  Accept either "compress: true" or "compress: { enable, minSize, mime }"
+    if ((node = jsonGetNode(json, id, "compress")) == 0) {
+        return;
+    }
+    compressId = jsonGetId(json, id, "compress");
+    if (node->type == JSON_OBJECT) {
+        if (!jsonGetBool(json, compressId, "enable", 1)) {
+            return;
+        }
+    } else if (!jsonGetBool(json, id, "compress", 0)) {
+        return;
+    }
+    route->compress = 1;
+    route->compressMin = svalue(jsonGet(json, compressId, "minSize", "1K"));
+    route->compressMime = rAllocList(0, 0);
+    if (jsonGetNode(json, compressId, "mime")) {
+        for (ITERATE_JSON(json, jsonGetNode(json, compressId, "mime"), mime, mimeId)) {
+            if (mime->value) {
+                rAddItem(route->compressMime, mime->value);
+            }
+        }
+    } else {
+        for (mp = defaultMime; *mp; mp++) {
+            rAddItem(route->compressMime, *mp);
+        }
+    }
+}
+#endif
+
 /*
     Parse client-side cache control configuration from route
  */
@@ -2308,6 +2840,7 @@ static void initRoutes(WebHost *host)
     char     *methods;
 
     host->routes = rAllocList(0, 0);
+    host->routeIndex = allocMatch(0);
     json = host->config;
     routes = jsonGetNode(json, 0, "web.routes");
 
@@ -2317,7 +2850,7 @@ static void initRoutes(WebHost *host)
         rp->handler = "file";
         rp->methods = host->methods;
         rp->validate = 0;
-        rAddItem(host->routes, rp);
+        addMatch(host->routeIndex, rp->match, rAddItem(host->routes, rp), 0);
 
     } else {
         for (ITERATE_JSON(json, routes, route, id)) {
@@ -2340,6 +2873,9 @@ static void initRoutes(WebHost *host)
             rp->validate = jsonGetBool(json, id, "validate", 0);
             rp->xsrf = jsonGetBool(json, id, "xsrf", 0);
             rp->compressed = jsonGetBool(json, id, "compressed", 0);
+#if ME_WEB_COMPRESS
+            parseCompress(rp, json, id);
+#endif
 
             //  Parse client-side cache control configuration
             parseCacheControl(rp, json, id);
@@ -2362,45 +2898,148 @@ static void initRoutes(WebHost *host)
             } else {
                 rp->methods = host->methods;
             }
-            rAddItem(host->routes, rp);
+            addMatch(host->routeIndex, rp->match, rAddItem(host->routes, rp), rp->exact);
         }
     }
 }
 
-static void initRedirects(WebHost *host)
+static WebMatch *allocMatch(uchar c)
 {
-    Json        *json;
-    JsonNode    *redirects, *np;
-    WebRedirect *redirect;
-    cchar       *from, *to;
-    int         status;
+    WebMatch *node;
 
-    json = host->config;
-    redirects = jsonGetNode(json, 0, "web.redirect");
-    if (redirects == 0) {
-        return;
-    }
-    host->redirects = rAllocList(0, 0);
+    node = rAllocType(WebMatch);
+    node->prefix = -1;
+    node->exact = -1;
+    node->c = c;
+    return node;
+}
 
-    for (ITERATE_JSON(json, redirects, np, id)) {
-        from = jsonGet(json, id, "from", 0);
-        status = jsonGetInt(json, id, "status", 301);
-        to = jsonGet(json, id, "to", 0);
-        if (!status || !to) {
-            rError("web", "Bad redirection. Missing from, status or target");
-            continue;
-        }
-        redirect = rAllocType(WebRedirect);
-        redirect->from = from;
-        redirect->to = to;
-        redirect->status = status;
-        rPushItem(host->redirects, redirect);
+static void freeMatch(WebMatch *node)
+{
+    WebMatch *next;
+
+    for (; node; node = next) {
+        next = node->sibling;
+        freeMatch(node->child);
+        rFree(node);
     }
 }
 
 /*
-    Load authentication configuration from web.json5
-    Loads users, roles, and HTTP authentication settings
+    Add a pattern to the match index. Earlier patterns take precedence.
+ */
+static void addMatch(WebMatch *root, cchar *pattern, int ordinal, bool exact)
+{
+    WebMatch *node, *child;
+    cuchar   *cp;
+
+    if (ordinal < 0) {
+        return;
+    }
+    node = root;
+    for (cp = (cuchar*) (pattern ? pattern : ""); *cp; cp++) {
+        for (child = node->child; child && child->c != *cp; child = child->sibling) {}
+        if (!child) {
+            child = allocMatch(*cp);
+            child->sibling = node->child;
+            node->child = child;
+        }
+        node = child;
+    }
+    if (exact) {
+        if (node->exact < 0) {
+            node->exact = ordinal;
+        }
+    } else if (node->prefix < 0) {
+        node->prefix = ordinal;
+    }
+}
+
+/*
+    Return the ordinal of the first pattern matching the path or -1 if none match.
+    A single walk of the path visits every prefix pattern of the path.
+ */
+static int lookupMatch(WebMatch *root, cchar *path)
+{
+    WebMatch *node, *child;
+    cuchar   *cp;
+    int      best;
+
+    if (!root) {
+        return -1;
+    }
+    node = root;
+    best = node->prefix;
+    for (cp = (cuchar*) (path ? path : ""); *cp; cp++) {
+        for (child = node->child; child && child->c != *cp; child = child->sibling) {}
+        if (!child) {
+            break;
+        }
+        node = child;
+        if (node->prefix >= 0 && (best < 0 || node->prefix < best)) {
+            best = node->prefix;
+        }
+    }
+    if (*cp == '\0' && node->exact >= 0 && (best < 0 || node->exact < best)) {
+        best = node->exact;
+    }
+    return best;
+}
+
+PUBLIC WebRoute *webLookupRoute(WebHost *host, cchar *path)
+{
+    int ordinal;
+
+    if ((ordinal = lookupMatch(host->routeIndex, path)) < 0) {
+        return 0;
+    }
+    return rGetItem(host->routes, ordinal);
+}
+
+PUBLIC WebAction *webLookupAction(WebHost *host, cchar *path)
+{
+    int ordinal;
+
+    if ((ordinal = lookupMatch(host->actionIndex, path)) < 0) {
+        return 0;
+    }
+    return rGetItem(host->actions, ordinal);
+}
+
+static void initRedirects(WebHost *host)
+{
+    Json        *json;
+    JsonNode    *redirects, *np;
+    WebRedirect *redirect;
+    cchar       *from, *to;
+    int         status;
+
+    json = host->config;
+    redirects = jsonGetNode(json, 0, "web.redirect");
+    if (redirects == 0) {
+        return;
+    }
+    host->redirects = rAllocList(0, 0);
+
+    for (ITERATE_JSON(json, redirects, np, id)) {
+        from = jsonGet(json, id, "from", 0);
+        status = jsonGetInt(json, id, "status", 301);
+        to = jsonGet(json, id, "to", 0);
+        if (!status || !to) {
+            rError("web", "Bad redirection. Missing from, status or target");
+            continue;
+        }
+        redirect = rAllocType(WebRedirect);
+        redirect->from = from;
+        redirect->to = to;
+        redirect->status = status;
+        rPushItem(host->redirects, redirect);
+    }
+}
+
+/*
+    Load authentication configuration from web.json5
+    Loads users, roles, and HTTP authentication settings
  */
 static void loadAuth(WebHost *host)
 {
@@ -2476,7 +3115,7 @@ PUBLIC void webAddAction(WebHost *host, cchar *match, WebProc fn, cchar *role)
     action->match = sclone(match);
     action->role = sclone(role);
     action->fn = fn;
-    rAddItem(host->actions, action);
+    addMatch(host->actionIndex, action->match, rAddItem(host->actions, action), 0);
 }
 
 /*
@@ -2549,11 +3188,20 @@ static cchar validHeaderChars[128] = {
  */
 #define WEB_HTTP_HEADER_SIZE 1024
 
+/*
+    Maximum slots probed in the request header index before falling back to a linear scan
+ */
+#define WEB_HEADER_PROBES    8
+
 /************************************ Forwards *********************************/
 
+static Web *allocWeb(WebHost *host);
 static bool authenticateRequest(Web *web);
+static void freeWeb(Web *web);
 static void freeWebFields(Web *web, bool keepAlive);
 static int handleRequest(Web *web);
+static uint hashHeader(cchar *name);
+static void indexHeader(Web *web, cchar *key);
 static bool matchFrom(Web *web, cchar *from);
 static int parseHeaders(Web *web, size_t headerSize);
 static int parseMethod(Web *web, cchar *method);
@@ -2562,6 +3210,7 @@ static bool parseRangeHeader(Web *web, char *header);
 static int processBody(Web *web);
 static void processOptions(Web *web);
 static void processQuery(Web *web);
+static void recycleWeb(Web *web);
 static int redirectRequest(Web *web);
 static void resetWeb(Web *web);
 static bool routeRequest(Web *web);
@@ -2597,7 +3246,7 @@ PUBLIC int webAlloc(WebListen *listen, RSocket *sock)
         rFreeSocket(sock);
         return R_ERR_TOO_MANY;
     }
-    if ((web = rAllocType(Web)) == 0) {
+    if ((web = allocWeb(host)) == 0) {
         rFreeSocket(sock);
         return R_ERR_MEMORY;
     }
@@ -2607,15 +3256,6 @@ PUBLIC int webAlloc(WebListen *listen, RSocket *sock)
     web->listen = listen;
     web->host = listen->host;
     web->sock = sock;
-    web->rx = rAllocBuf(ME_BUFSIZE);
-    web->rxHeaders = rAllocBuf(ME_BUFSIZE);
-    web->rxRemaining = WEB_UNLIMITED;
-    web->txRemaining = WEB_UNLIMITED;
-    web->txLen = -1;
-    web->rxLen = -1;
-    web->signature = -1;
-    web->status = 200;
-    web->txHeaders = rAllocHash(16, R_DYNAMIC_VALUE);
 
     rAddItem(host->webs, web);
 
@@ -2631,19 +3271,130 @@ PUBLIC int webAlloc(WebListen *listen, RSocket *sock)
     return 0;
 }
 
+/*
+    Allocate a web instance object with request defaults.
+    Reuse a pooled web object if available. Pooled objects retain their rx, rxHeaders, txHeaders and etags.
+ */
+static Web *allocWeb(WebHost *host)
+{
+    Web *web;
+
+    if ((web = rPopItem(host->pool)) != 0) {
+        host->poolHits++;
+    } else {
+        if ((web = rAllocType(Web)) == 0) {
+            return 0;
+        }
+        web->rx = rAllocBuf(ME_BUFSIZE);
+        web->rxHeaders = rAllocBuf(ME_BUFSIZE);
+        web->txHeaders = rAllocHash(16, R_DYNAMIC_VALUE);
+        host->poolMisses++;
+    }
+    web->rxRemaining = WEB_UNLIMITED;
+    web->txRemaining = WEB_UNLIMITED;
+    web->txLen = -1;
+    web->rxLen = -1;
+    web->signature = -1;
+    web->status = 200;
+    return web;
+}
+
+#if ME_WEB_HTTP2
+/*
+    Allocate a web instance object for an HTTP/2 stream. The stream shares the connection socket and
+    serves a single request.
+ */
+PUBLIC Web *webAllocStream(Web *parent, WebStream *stream)
+{
+    Web *web;
+
+    if ((web = allocWeb(parent->listen->host)) == 0) {
+        return 0;
+    }
+    web->conn = parent->conn;
+    web->connectionStarted = parent->connectionStarted;
+    web->listen = parent->listen;
+    web->host = parent->listen->host;
+    web->sock = parent->sock;
+    web->stream = stream;
+    web->close = 1;
+    return web;
+}
+
+/*
+    Serve the request of an HTTP/2 stream. This runs on the stream fiber.
+ */
+PUBLIC void webServeStream(Web *web)
+{
+    web->fiber = rGetFiber();
+    if (serveRequest(web) == 0 && !web->finalized) {
+        webFinalize(web);
+    }
+}
+#endif
+
 /*
     Free the web instance object. This is called when the connection is closing.
-    It frees the web instance object fields and the socket.
+    It frees the socket and returns the web instance object to the host pool if below the high-water mark and
+    its buffers have not grown beyond the boost size. Otherwise, the object and its fields are freed.
  */
 PUBLIC void webFree(Web *web)
 {
-    rRemoveItem(web->host->webs, web);
+    WebHost *host;
+
+    host = web->host;
+    rRemoveItem(host->webs, web);
+#if ME_WEB_HTTP2
+    if (web->http2) {
+        //  Idle HTTP/2 connection closed by a timeout
+        webFreeHttp2(web->http2);
+        web->http2 = 0;
+    }
+#endif
     rFreeSocket(web->sock);
+    web->sock = 0;
+
+    if (rGetListLength(host->pool) < host->maxPool &&
+        rGetBufSize(web->rx) <= WEB_BUF_BOOST_4X && rGetBufSize(web->rxHeaders) <= WEB_BUF_BOOST_4X) {
+        recycleWeb(web);
+    } else {
+        freeWeb(web);
+    }
+}
+
+static void freeWeb(Web *web)
+{
     rFreeBuf(web->rx);
     freeWebFields(web, 0);
     rFree(web);
 }
 
+/*
+    Clear the web instance object and add it to the host pool. Per-request body and buffer objects are freed as
+    they are only allocated by some requests.
+ */
+static void recycleWeb(Web *web)
+{
+    WebHost *host;
+
+    host = web->host;
+    rFlushBuf(web->rx);
+    freeWebFields(web, 1);
+    rFreeBuf(web->body);
+    rFreeBuf(web->buffer);
+    rFreeBuf(web->cork);
+    web->body = 0;
+    web->buffer = 0;
+    web->cork = 0;
+    web->listen = 0;
+    web->close = 0;
+    web->conn = 0;
+    web->count = 0;
+    web->connectionStarted = 0;
+    web->host = host;
+    rAddItem(host->pool, web);
+}
+
 /*
     Free range request resources
     Used by both freeWebFields and action handlers to clean up ranges
@@ -2669,14 +3420,16 @@ PUBLIC void webFreeRanges(Web *web)
 /*
     Free the web instance object fields. This is called when the request is complete.
     The web instance object is preserved for the next request if keepAlive is true.
+    Corked output for pipelined requests is also preserved if keepAlive is true.
  */
 static void freeWebFields(Web *web, bool keepAlive)
 {
     RSocket   *sock;
     WebListen *listen;
     Ticks     connectionStarted;
-    RBuf      *rx, *rxHeaders, *body, *buffer;
+    RBuf      *rx, *rxHeaders, *body, *buffer, *cork;
     RList     *etags;
+    RHash     *txHeaders;
     int64     conn, count;
     int       close;
 
@@ -2695,15 +3448,26 @@ static void freeWebFields(Web *web, bool keepAlive)
         body = web->body;
         buffer = web->buffer;
         etags = web->etags;
+        cork = web->cork;
+    } else {
+        rFreeBuf(web->cork);
     }
 
     //  Free request-specific string resources
+#if ME_WEB_COMPRESS
+    webFreeCompress(web);
+#endif
     rFree(web->cookie);
     rFree(web->error);
     rFree(web->path);
     rFree(web->redirect);
     rFree(web->securityToken);
-    rFreeHash(web->txHeaders);
+    if (keepAlive) {
+        txHeaders = web->txHeaders;
+        rClearHash(txHeaders);
+    } else {
+        rFreeHash(web->txHeaders);
+    }
 
 #if ME_WEB_HTTP_AUTH
     rFree(web->authType);
@@ -2773,8 +3537,8 @@ static void freeWebFields(Web *web, bool keepAlive)
         web->body = body;
         web->buffer = buffer;
         web->etags = etags;
-        //  Recreate txHeaders (simpler than clearing sparse hash)
-        web->txHeaders = rAllocHash(16, R_DYNAMIC_VALUE);
+        web->txHeaders = txHeaders;
+        web->cork = cork;
     }
 }
 
@@ -2862,6 +3626,13 @@ static void webProcessRequest(Web *web)
             if (serveRequest(web) < 0) {
                 break;
             }
+#if ME_WEB_HTTP2
+            if (web->http2) {
+                //  Idle HTTP/2 connection. Release the fiber until more frames arrive.
+                webSetupKeepAliveWait(web);
+                return;
+            }
+#endif
             //  Check if we should continue
             if (web->close || web->sock->fd == INVALID_SOCKET) {
                 break;
@@ -2870,11 +3641,14 @@ static void webProcessRequest(Web *web)
             resetWeb(web);
 
             if (rGetBufLength(web->rx) == 0) {
-                //  No buffered data, setup wait for next request
+                //  No buffered data. Write responses held for pipelined requests and wait for the next request.
+                if (webFlush(web) < 0) {
+                    break;
+                }
                 webSetupKeepAliveWait(web);
                 return;
             }
-            //  Continue loop to process pipelined requests
+            //  Continue loop to process pipelined requests. Responses are corked until the pipeline drains.
         }
 #if ME_WEB_FIBER_BLOCKS
     } else {
@@ -2889,6 +3663,10 @@ static void webProcessRequest(Web *web)
     }
 #endif
     }
+    if (web->cork && web->sock->fd != INVALID_SOCKET) {
+        //  Responses to completed pipelined requests
+        webFlush(web);
+    }
     if (host->flags & WEB_SHOW_REQ_HEADERS) {
         rLog("raw", "web", "Disconnect: %s (fd %d)\n", web->listen->endpoint, web->sock->fd);
     }
@@ -2924,6 +3702,12 @@ static int serveRequest(Web *web)
     ssize size;
     size_t len;
 
+#if ME_WEB_HTTP2
+    if (web->http2) {
+        //  Frames received on an idle HTTP/2 connection
+        return webProcessHttp2(web);
+    }
+#endif
     web->started = rGetTicks();
 
     if (rGetTimeouts()) {
@@ -2956,6 +3740,14 @@ static int serveRequest(Web *web)
         // I/O error or pattern not found before limit
         return R_ERR_CANT_READ;
     }
+#if ME_WEB_HTTP2
+    if (web->count == 0 && !web->stream && web->host->http2 && size == sizeof(WEB_HTTP2_PREFACE) - 1 &&
+        memcmp(web->rx->start, WEB_HTTP2_PREFACE, (size_t) size) == 0) {
+        //  Cleartext HTTP/2 with prior knowledge or HTTP/2 negotiated via ALPN
+        rAdjustBufStart(web->rx, size);
+        return webProcessHttp2(web);
+    }
+#endif
     web->count++;
     web->headerSize = size;
 
@@ -2999,6 +3791,13 @@ static int handleRequest(Web *web)
         processOptions(web);
         return 0;
     }
+    /*
+        Write responses held for prior pipelined requests before reading a body or running an action as they
+        may block. Only file requests without a body are served without waiting.
+     */
+    if (web->cork && (web->rxRemaining != 0 || !smatch(handler, "file")) && webFlush(web) < 0) {
+        return R_ERR_CANT_WRITE;
+    }
     if (web->uploads && webProcessUpload(web) < 0) {
         return 0;
     }
@@ -3098,37 +3897,34 @@ static bool validateRequest(Web *web)
 static int webActionHandler(Web *web)
 {
     WebAction *action;
-    int next;
-
-    for (ITERATE_ITEMS(web->host->actions, action, next)) {
-        /*
-            Check if the request path matches the action match pattern.
-         */
-        if (sstarts(web->path, action->match)) {
-            /*
-                For public actions (role == NULL or "public"), do not deny access.
-                Attempt authorization only if a specific non-public role is required.
-             */
-            if (action->role && !smatch(action->role, "public")) {
-                if (!webCan(web, action->role)) {
-                    webError(web, 403, "Access Denied. User has insufficient privilege.");
-                    return 0;
-                }
-            }
-            /*
-                Ignore range requests for dynamic content
-                Action handlers generate dynamic content that cannot be ranged
-             */
-            webFreeRanges(web);
-            //  Set Accept-Ranges: none for dynamic content
-            webAddHeaderStaticString(web, "Accept-Ranges", "none");
 
-            webHook(web, WEB_HOOK_ACTION);
-            (action->fn)(web);
+    /*
+        Find the first action whose match pattern is a prefix of the request path.
+     */
+    if ((action = webLookupAction(web->host, web->path)) == 0) {
+        return webError(web, 404, "No action to handle request");
+    }
+    /*
+        For public actions (role == NULL or "public"), do not deny access.
+        Attempt authorization only if a specific non-public role is required.
+     */
+    if (action->role && !smatch(action->role, "public")) {
+        if (!webCan(web, action->role)) {
+            webError(web, 403, "Access Denied. User has insufficient privilege.");
             return 0;
         }
     }
-    return webError(web, 404, "No action to handle request");
+    /*
+        Ignore range requests for dynamic content
+        Action handlers generate dynamic content that cannot be ranged
+     */
+    webFreeRanges(web);
+    //  Set Accept-Ranges: none for dynamic content
+    webAddHeaderStaticString(web, "Accept-Ranges", "none");
+
+    webHook(web, WEB_HOOK_ACTION);
+    (action->fn)(web);
+    return 0;
 }
 
 /*
@@ -3140,48 +3936,39 @@ static bool routeRequest(Web *web)
 {
     WebRoute *route;
     char *path;
-    bool match;
-    int next;
 
-    for (ITERATE_ITEMS(web->host->routes, route, next)) {
-        if (route->exact) {
-            match = smatch(web->path, route->match);
-        } else {
-            match = sstarts(web->path, route->match);
-        }
-        if (match) {
-            if (!rLookupName(route->methods, web->method)) {
-                webError(web, 405, "Unsupported method.");
-                return 0;
-            }
-            web->route = route;
-            if (route->redirect) {
-                webRedirect(web, 302, route->redirect);
+    if ((route = webLookupRoute(web->host, web->path)) == 0) {
+        rInfo("web", "Cannot find route to serve request %s", web->path);
+        webHook(web, WEB_HOOK_NOT_FOUND);
 
-            } else if (route->role && !smatch(route->role, "public") && !web->options) {
-                if (!authenticateRequest(web)) {
-                    return 0;
-                }
-                if (!webCan(web, route->role)) {
-                    webError(web, 403, "Access Denied. User has insufficient privilege.");
-                    return 0;
-                }
-            }
-            if (route->trim && sstarts(web->path, route->trim)) {
-                path = sclone(&web->path[slen(route->trim)]);
-                rFree(web->path);
-                web->path = path;
-            }
-            return 1;
+        if (!web->error) {
+            webWriteResponseString(web, 404, "No matching route");
         }
+        return 0;
+    }
+    if (!rLookupName(route->methods, web->method)) {
+        webError(web, 405, "Unsupported method.");
+        return 0;
     }
-    rInfo("web", "Cannot find route to serve request %s", web->path);
-    webHook(web, WEB_HOOK_NOT_FOUND);
+    web->route = route;
+    if (route->redirect) {
+        webRedirect(web, 302, route->redirect);
 
-    if (!web->error) {
-        webWriteResponseString(web, 404, "No matching route");
+    } else if (route->role && !smatch(route->role, "public") && !web->options) {
+        if (!authenticateRequest(web)) {
+            return 0;
+        }
+        if (!webCan(web, route->role)) {
+            webError(web, 403, "Access Denied. User has insufficient privilege.");
+            return 0;
+        }
     }
-    return 0;
+    if (route->trim && sstarts(web->path, route->trim)) {
+        path = sclone(&web->path[slen(route->trim)]);
+        rFree(web->path);
+        web->path = path;
+    }
+    return 1;
 }
 
 static bool authenticateRequest(Web *web)
@@ -3641,19 +4428,27 @@ PUBLIC bool webParseHeadersBlock(Web *web, char *headers, size_t headersSize, bo
                 webNetError(web, "Bad upload headers");
                 return 0;
             }
+            if (!upload) {
+                indexHeader(web, key);
+            }
+            if (c == 'a') {
+                if (scaselessmatch(key, "accept-encoding")) {
+                    if (!web->acceptEncoding) {
+                        web->acceptEncoding = value;
+                    }
+                } else if (scaselessmatch(key, "authorization")) {
+                    if (!web->authorization) {
+                        web->authorization = value;
 #if ME_WEB_HTTP_AUTH
-            if (c == 'a' && scaselessmatch(key, "authorization")) {
-                //  Parse Authorization header: "Basic xxx" or "Digest xxx"
-                char *authType = value;
-                char *sp = strchr(value, ' ');
-                if (sp) {
-                    *sp++ = '\0';
-                    web->authType = sclone(authType);
-                    web->authDetails = sclone(sp);
-                }
-            } else
+                        //  Parse Authorization header: "Basic xxx" or "Digest xxx"
+                        if ((t = strchr(value, ' ')) != 0) {
+                            web->authType = snclone(value, (size_t) (t - value));
+                            web->authDetails = sclone(t + 1);
+                        }
 #endif
-            if (c == 'c') {
+                    }
+                }
+            } else if (c == 'c') {
                 if (scaselessmatch(key, "content-disposition")) {
                     web->contentDisposition = value;
 
@@ -3734,6 +4529,10 @@ PUBLIC bool webParseHeadersBlock(Web *web, char *headers, size_t headersSize, bo
                     }
                 }
 
+            } else if (c == 'h' && scaselessmatch(key, "host")) {
+                if (!web->hostHeader) {
+                    web->hostHeader = value;
+                }
             } else if (c == 'l' && scaselessmatch(key, "last-event-id")) {
                 web->lastEventId = stoi(value);
 
@@ -3775,11 +4574,61 @@ PUBLIC bool webParseHeadersBlock(Web *web, char *headers, size_t headersSize, bo
         return 0;
     }
     if (!web->chunked && !web->uploads && web->rxLen < 0) {
+#if ME_WEB_HTTP2
+        //  HTTP/2 request bodies without a content length are ended by the stream
+        if (!web->stream || !web->stream->body) {
+            web->rxRemaining = 0;
+        }
+#else
         web->rxRemaining = 0;
+#endif
     }
     return 1;
 }
 
+/*
+    Case-insensitive FNV-1a hash of a header name
+ */
+static uint hashHeader(cchar *name)
+{
+    cuchar *cp;
+    uint   hash;
+
+    hash = 2166136261U;
+    for (cp = (cuchar*) name; *cp; cp++) {
+        hash = (hash ^ (uint) tolower(*cp)) * 16777619U;
+    }
+    return hash;
+}
+
+/*
+    Add a tokenized header name to the request header index. The index stores offsets (plus one) into
+    rxHeaders so no allocations are required. The first occurrence of a repeated header is retained.
+    If the probe limit is reached, lookups of unindexed headers fall back to scanning the headers.
+ */
+static void indexHeader(Web *web, cchar *key)
+{
+    cchar *start;
+    uint  hash, i, offset, slot;
+
+    start = rGetBufStart(web->rxHeaders);
+    if (key < start || key >= rGetBufEnd(web->rxHeaders)) {
+        return;
+    }
+    hash = hashHeader(key);
+    for (i = 0; i < WEB_HEADER_PROBES; i++) {
+        slot = (hash + i) & (ME_WEB_HEADER_INDEX - 1);
+        if ((offset = web->headerIndex[slot]) == 0) {
+            web->headerIndex[slot] = (uint) (key - start) + 1;
+            return;
+        }
+        if (scaselessmatch(&start[offset - 1], key)) {
+            return;
+        }
+    }
+    web->headerOverflow = 1;
+}
+
 /*
     Headers have been tokenized with a null replacing the ":" and "\r\n"
  */
@@ -3787,11 +4636,30 @@ PUBLIC cchar *webGetHeader(Web *web, cchar *name)
 {
     cchar *cp, *end, *start;
     cchar *value;
+    uint  hash, i, offset;
 
+    if (!name) {
+        return 0;
+    }
     start = rGetBufStart(web->rxHeaders);
     end = rGetBufEnd(web->rxHeaders);
     value = 0;
 
+    hash = hashHeader(name);
+    for (i = 0; i < WEB_HEADER_PROBES; i++) {
+        if ((offset = web->headerIndex[(hash + i) & (ME_WEB_HEADER_INDEX - 1)]) == 0) {
+            break;
+        }
+        cp = &start[offset - 1];
+        if (scaselessmatch(cp, name)) {
+            cp += slen(cp) + 1;
+            while (isWhite(*cp)) cp++;
+            return cp;
+        }
+    }
+    if (!web->headerOverflow) {
+        return 0;
+    }
     for (cp = start; cp < end; cp++) {
         if (scaselessmatch(cp, name)) {
             cp += slen(name) + 1;
@@ -4053,10 +4921,18 @@ PUBLIC void webSetCacheControlHeaders(Web *web)
  */
 
 
-/********* Start of file ../../../src/io.c ************/
+/********* Start of file ../../../src/http2.c ************/
 
 /*
-    io.c - I/O for the web server
+    http2.c - HTTP/2 protocol support
+
+    An HTTP/2 connection is served by a connection fiber that reads and writes all frames. Each request stream is
+    served by its own fiber and Web request object. The request headers are decoded (HPACK) and presented to the
+    standard request pipeline in HTTP/1 form. Request body data and response output pass through per-stream buffers
+    subject to HTTP/2 flow control.
+
+    Server push and stream priorities are not supported. Responses are encoded without Huffman coding or the
+    dynamic table which keeps the encoder stateless.
 
     Copyright (c) All Rights Reserved. See copyright notice at the bottom of the file.
  */
@@ -4065,17 +4941,1775 @@ PUBLIC void webSetCacheControlHeaders(Web *web)
 
 
 
-/************************************ Forwards *********************************/
+#if ME_WEB_HTTP2
+/*********************************** Locals ***********************************/
+
+#define H2_FRAME_HEADER           9             /* Frame header size */
+#define H2_MAX_FRAME              16384         /* Default and maximum received frame size */
+#define H2_WINDOW                 65535         /* Initial flow control window */
+#define H2_MAX_WINDOW             0x7fffffff    /* Maximum flow control window */
+#define H2_TABLE_SIZE             4096          /* HPACK dynamic table size */
+#define H2_STATIC_FIELDS          61            /* Number of HPACK static table entries */
+#define H2_FIELD_OVERHEAD         32            /* HPACK per-entry size overhead */
+#define H2_RETRY (TPS / 50)    /* Period to retry starting streams when at the fiber limit */
+
+/*
+    Frame types
+ */
+#define H2_DATA                   0x0
+#define H2_HEADERS                0x1
+#define H2_PRIORITY               0x2
+#define H2_RST_STREAM             0x3
+#define H2_SETTINGS               0x4
+#define H2_PUSH_PROMISE           0x5
+#define H2_PING                   0x6
+#define H2_GOAWAY                 0x7
+#define H2_WINDOW_UPDATE          0x8
+#define H2_CONTINUATION           0x9
+
+/*
+    Frame flags
+ */
+#define H2_ACK                    0x1
+#define H2_END_STREAM             0x1
+#define H2_END_HEADERS            0x4
+#define H2_PADDED                 0x8
+#define H2_PRIORITY_FLAG          0x20
+
+/*
+    Settings
+ */
+#define H2_SETTINGS_ENABLE_PUSH   0x2
+#define H2_SETTINGS_MAX_STREAMS   0x3
+#define H2_SETTINGS_WINDOW_SIZE   0x4
+#define H2_SETTINGS_MAX_FRAME     0x5
+#define H2_SETTINGS_MAX_HEADERS   0x6
+
+/*
+    Error codes
+ */
+#define H2_NO_ERROR               0x0
+#define H2_PROTOCOL_ERROR         0x1
+#define H2_INTERNAL_ERROR         0x2
+#define H2_FLOW_CONTROL_ERROR     0x3
+#define H2_STREAM_CLOSED          0x5
+#define H2_FRAME_SIZE_ERROR       0x6
+#define H2_REFUSED_STREAM         0x7
+#define H2_COMPRESSION_ERROR      0x9
+#define H2_ENHANCE_YOUR_CALM      0xb
+
+/*
+    Request decoded from a header block
+ */
+typedef struct H2Request {
+    RBuf *headers;              /* Regular header fields in HTTP/1 form */
+    char *method;               /* :method pseudo-header */
+    char *path;                 /* :path pseudo-header */
+    char *authority;            /* :authority pseudo-header */
+    bool host : 1;              /* Request has a host header */
+    bool regular : 1;           /* Regular header fields have been decoded */
+    bool malformed : 1;         /* Request is malformed */
+} H2Request;
+
+/*
+    HPACK Huffman code (RFC 7541 Appendix B). Symbol 256 is EOS.
+ */
+static const uint HuffCodes[257] = {
+    0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+    0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+    0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+    0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+    0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+    0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+    0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+    0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+    0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+    0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+    0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+    0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+    0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+    0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+    0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+    0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+    0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+    0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+    0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+    0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+    0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+    0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+    0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+    0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+    0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+    0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+    0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+    0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+    0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+    0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+    0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+    0x3fffffff,
+};
 
-static char *findPatternFrom(RBuf *buf, cchar *pattern, size_t patLen, size_t fromOffset);
-static bool isprintable(cchar *s, size_t len);
-static ssize consumeChunkStart(Web *web, size_t desiredSize);
-static int consumeChunkData(Web *web, ssize nbytes);
-static ssize readSocketBuffer(Web *web, size_t desiredSize);
-static ssize readSocketBlock(Web *web, size_t desiredSize);
-static int writeChunkDivider(Web *web, size_t bufsize);
+static const uchar HuffLengths[257] = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+    30,
+};
 
-/************************************* Code ***********************************/
+/*
+    HPACK static table (RFC 7541 Appendix A)
+ */
+static cchar *StaticTable[H2_STATIC_FIELDS][2] = {
+    { ":authority", "" },
+    { ":method", "GET" },
+    { ":method", "POST" },
+    { ":path", "/" },
+    { ":path", "/index.html" },
+    { ":scheme", "http" },
+    { ":scheme", "https" },
+    { ":status", "200" },
+    { ":status", "204" },
+    { ":status", "206" },
+    { ":status", "304" },
+    { ":status", "400" },
+    { ":status", "404" },
+    { ":status", "500" },
+    { "accept-charset", "" },
+    { "accept-encoding", "gzip, deflate" },
+    { "accept-language", "" },
+    { "accept-ranges", "" },
+    { "accept", "" },
+    { "access-control-allow-origin", "" },
+    { "age", "" },
+    { "allow", "" },
+    { "authorization", "" },
+    { "cache-control", "" },
+    { "content-disposition", "" },
+    { "content-encoding", "" },
+    { "content-language", "" },
+    { "content-length", "" },
+    { "content-location", "" },
+    { "content-range", "" },
+    { "content-type", "" },
+    { "cookie", "" },
+    { "date", "" },
+    { "etag", "" },
+    { "expect", "" },
+    { "expires", "" },
+    { "from", "" },
+    { "host", "" },
+    { "if-match", "" },
+    { "if-modified-since", "" },
+    { "if-none-match", "" },
+    { "if-range", "" },
+    { "if-unmodified-since", "" },
+    { "last-modified", "" },
+    { "link", "" },
+    { "location", "" },
+    { "max-forwards", "" },
+    { "proxy-authenticate", "" },
+    { "proxy-authorization", "" },
+    { "range", "" },
+    { "referer", "" },
+    { "refresh", "" },
+    { "retry-after", "" },
+    { "server", "" },
+    { "set-cookie", "" },
+    { "strict-transport-security", "" },
+    { "transfer-encoding", "" },
+    { "user-agent", "" },
+    { "vary", "" },
+    { "via", "" },
+    { "www-authenticate", "" },
+};
+
+/*
+    Huffman decoding tree built on first use. Positive values index internal nodes and leaves store -(symbol + 1).
+ */
+static short huffTree[256][2];
+static int   huffNodes;
+
+/************************************ Forwards *********************************/
+
+static void addField(H2Request *req, cchar *name, cchar *value);
+static WebHttp2 *allocHttp2(Web *web);
+static void buildHuffman(void);
+static void closeHttp2(WebHttp2 *h2);
+static int connError(WebHttp2 *h2, int code, cchar *msg);
+static int decodeHeaders(WebHttp2 *h2, H2Request *req);
+static char *decodeHuffman(cuchar *data, size_t len);
+static int decodeInt(uchar **pp, uchar *end, int prefix, int64 *value);
+static char *decodeString(uchar **pp, uchar *end);
+static void encodeInt(RBuf *buf, int bits, int prefix, size_t value);
+static void encodeString(RBuf *buf, cchar *str, size_t len);
+static int endHeaders(WebHttp2 *h2, int id, int flags);
+static void evictFields(WebHttp2 *h2, size_t need);
+static Ticks expireStreams(WebHttp2 *h2);
+static void freeRequest(H2Request *req);
+static void freeStream(WebStream *stream);
+static uint getInt16(cuchar *p);
+static uint getInt24(cuchar *p);
+static uint getInt32(cuchar *p);
+static void indexField(WebHttp2 *h2, cchar *name, cchar *value);
+static cchar *lookupField(WebHttp2 *h2, int64 index, cchar **value);
+static WebStream *lookupStream(WebHttp2 *h2, int id);
+static void openStream(WebHttp2 *h2, int id, H2Request *req, bool eof);
+static int parseData(WebHttp2 *h2, int flags, int id, uchar *data, size_t len);
+static int parseFrame(WebHttp2 *h2, int type, int flags, int id, uchar *data, size_t len);
+static int parseFrames(WebHttp2 *h2);
+static int parseHeaderBlock(WebHttp2 *h2, int type, int flags, int id, uchar *data, size_t len);
+static int parseReset(WebHttp2 *h2, int id, uchar *data, size_t len);
+static int parseSettings(WebHttp2 *h2, int flags, int id, uchar *data, size_t len);
+static int parseWindowUpdate(WebHttp2 *h2, int id, uchar *data, size_t len);
+static void queueFrame(WebHttp2 *h2, int type, int flags, int id, cvoid *data, size_t len);
+static void queueHeaders(WebHttp2 *h2, int id, RBuf *block, bool end);
+static void queueInt(WebHttp2 *h2, int type, int id, uint value);
+static ssize readFrames(WebHttp2 *h2);
+static void resetStream(WebStream *stream, int code);
+static void resumeStream(WebStream *stream);
+static void resumeStreams(WebHttp2 *h2);
+static void serveStream(WebStream *stream);
+static void serveInline(WebHttp2 *h2);
+static void startStreams(WebHttp2 *h2);
+static bool serviceHttp2(WebHttp2 *h2);
+static int staticNameIndex(cchar *name);
+static int statusIndex(int status);
+static int pumpStream(WebStream *stream, Ticks deadline);
+static int waitStream(WebStream *stream, Ticks deadline);
+static void wakeConnection(WebHttp2 *h2);
+static int writeFrames(WebHttp2 *h2);
+
+/************************************* Code ***********************************/
+/*
+    Serve an HTTP/2 connection. This is called on the connection fiber once the client connection preface
+    has been identified and again when frames are received on an idle connection.
+    Returns when the connection is idle (web->http2 is set) or closed. The caller waits for further frames or
+    frees the connection web object.
+ */
+PUBLIC int webProcessHttp2(Web *web)
+{
+    WebHttp2 *h2;
+
+    if (!web->http2) {
+        if ((web->http2 = allocHttp2(web)) == 0) {
+            web->close = 1;
+            return R_ERR_MEMORY;
+        }
+        rTrace("web", "HTTP/2 connection %lld", web->conn);
+    }
+    h2 = web->http2;
+    h2->fiber = rGetFiber();
+    if (serviceHttp2(h2)) {
+        //  Idle with no active streams. The fiber is released until more frames arrive.
+        return 0;
+    }
+    closeHttp2(h2);
+    webFreeHttp2(h2);
+    web->http2 = 0;
+    web->close = 1;
+    return 0;
+}
+
+static WebHttp2 *allocHttp2(Web *web)
+{
+    WebHttp2 *h2;
+    uchar    settings[12];
+
+    if ((h2 = rAllocType(WebHttp2)) == 0) {
+        return 0;
+    }
+    h2->web = web;
+    h2->streams = rAllocList(0, 0);
+    h2->tx = rAllocBuf(ME_BUFSIZE);
+    h2->spare = rAllocBuf(ME_BUFSIZE);
+    h2->headers = rAllocBuf(ME_BUFSIZE);
+    h2->table = rAllocList(0, R_DYNAMIC_VALUE);
+    h2->tableMax = H2_TABLE_SIZE;
+    h2->sendWindow = H2_WINDOW;
+    h2->recvWindow = H2_WINDOW;
+    h2->peerWindow = H2_WINDOW;
+    h2->peerMaxFrame = H2_MAX_FRAME;
+
+    //  Server settings: the maximum number of concurrent streams and header list size
+    settings[0] = 0;
+    settings[1] = H2_SETTINGS_MAX_STREAMS;
+    settings[2] = (uchar) (web->host->maxStreams >> 24);
+    settings[3] = (uchar) (web->host->maxStreams >> 16);
+    settings[4] = (uchar) (web->host->maxStreams >> 8);
+    settings[5] = (uchar) web->host->maxStreams;
+    settings[6] = 0;
+    settings[7] = H2_SETTINGS_MAX_HEADERS;
+    settings[8] = (uchar) (web->host->maxHeader >> 24);
+    settings[9] = (uchar) (web->host->maxHeader >> 16);
+    settings[10] = (uchar) (web->host->maxHeader >> 8);
+    settings[11] = (uchar) web->host->maxHeader;
+    queueFrame(h2, H2_SETTINGS, 0, 0, settings, sizeof(settings));
+    return h2;
+}
+
+/*
+    Free the HTTP/2 connection state. All streams must have completed.
+ */
+PUBLIC void webFreeHttp2(WebHttp2 *h2)
+{
+    rFreeList(h2->streams);
+    rFreeList(h2->table);
+    rFreeBuf(h2->tx);
+    rFreeBuf(h2->spare);
+    rFreeBuf(h2->headers);
+    rFree(h2);
+}
+
+/*
+    Connection fiber loop. Parse received frames, write queued frames and wait for I/O or stream activity.
+    Returns true if the connection is idle and false if the connection should be closed.
+ */
+static bool serviceHttp2(WebHttp2 *h2)
+{
+    RSocket *sock;
+    Ticks   deadline;
+    ssize   nbytes;
+
+    sock = h2->web->sock;
+
+    //  The connection fiber waits explicitly for I/O. Remove the request wait handler interest.
+    rSetWaitMask(sock->wait, 0, 0);
+
+    while (!h2->closed) {
+        if (parseFrames(h2) < 0 || writeFrames(h2) < 0) {
+            break;
+        }
+        if (h2->pending) {
+            startStreams(h2);
+            if (h2->pending == h2->active) {
+                /*
+                    No fiber is available and none of this connection's streams are running. Serve a stream on
+                    the connection fiber so connections holding the available fibers cannot starve each other.
+                 */
+                serveInline(h2);
+                continue;
+            }
+        }
+        if (h2->goaway && h2->active == 0) {
+            break;
+        }
+        if ((nbytes = readFrames(h2)) < 0) {
+            break;
+        }
+        if (nbytes > 0 || rGetBufLength(h2->tx) > 0) {
+            continue;
+        }
+        if (!sock->wait || rIsSocketClosed(sock)) {
+            break;
+        }
+        if (h2->active == 0) {
+            return 1;
+        }
+        deadline = expireStreams(h2);
+        if (h2->pending) {
+            //  Retry starting pending streams when fibers are released by other connections
+            deadline = rGetTicks() + H2_RETRY;
+        }
+        h2->deadline = deadline;
+        h2->waiting = 1;
+        rWaitForIO(sock->wait, R_READABLE, deadline);
+        h2->waiting = 0;
+        h2->deadline = 0;
+    }
+    return 0;
+}
+
+/*
+    Close the connection. Streams are woken to observe the closure and the connection waits for their fibers to
+    complete before returning.
+ */
+static void closeHttp2(WebHttp2 *h2)
+{
+    WebStream *stream;
+    int       next;
+
+    if (!h2->goaway) {
+        queueInt(h2, H2_GOAWAY, 0, H2_NO_ERROR);
+    }
+    writeFrames(h2);
+    h2->closed = 1;
+
+    for (next = 0; next < rGetListLength(h2->streams); ) {
+        stream = rGetItem(h2->streams, next);
+        if (stream->started) {
+            resumeStream(stream);
+            next++;
+        } else {
+            //  Streams that have not started are freed here
+            h2->pending--;
+            freeStream(stream);
+        }
+    }
+    while (h2->active > 0) {
+        h2->waiting = 1;
+        rYieldFiber(0);
+        h2->waiting = 0;
+    }
+    rTrace("web", "HTTP/2 connection %lld closed", h2->web->conn);
+}
+
+/*
+    Read available frame data without blocking. Returns the number of bytes read or negative on EOF and errors.
+ */
+static ssize readFrames(WebHttp2 *h2)
+{
+    RBuf  *bp;
+    ssize nbytes;
+
+    bp = h2->web->rx;
+    rCompactBuf(bp);
+    rReserveBufSpace(bp, H2_FRAME_HEADER + H2_MAX_FRAME);
+    if ((nbytes = rReadSocketSync(h2->web->sock, (char*) rGetBufEnd(bp), rGetBufSpace(bp))) > 0) {
+        rAdjustBufEnd(bp, nbytes);
+        h2->web->rxRead += nbytes;
+    }
+    return nbytes;
+}
+
+/*
+    Write queued frames. Streams may queue further frames while the write blocks, so the queue is swapped with
+    the spare buffer and the buffer being written is never moved.
+ */
+static int writeFrames(WebHttp2 *h2)
+{
+    RBuf  *buf;
+    Ticks deadline;
+    ssize rc;
+
+    deadline = rGetTimeouts() ? rGetTicks() + h2->web->host->inactivityTimeout : 0;
+    while (rGetBufLength(h2->tx) > 0) {
+        buf = h2->tx;
+        h2->tx = h2->spare;
+        h2->spare = 0;
+        rc = rWriteSocket(h2->web->sock, rGetBufStart(buf), rGetBufLength(buf), deadline);
+        rFlushBuf(buf);
+        h2->spare = buf;
+        if (rc < 0) {
+            h2->closed = 1;
+            return R_ERR_CANT_WRITE;
+        }
+        //  Streams waiting for queue space may proceed
+        resumeStreams(h2);
+    }
+    return 0;
+}
+
+/*
+    Resume the streams whose wait deadlines have expired and return the deadline for the connection wait
+ */
+static Ticks expireStreams(WebHttp2 *h2)
+{
+    WebStream *stream;
+    Ticks     deadline, now;
+    int       next;
+
+    now = rGetTicks();
+    deadline = rGetTimeouts() ? now + h2->web->host->inactivityTimeout : 0;
+    for (ITERATE_ITEMS(h2->streams, stream, next)) {
+        if (stream->waiting && stream->deadline) {
+            if (stream->deadline <= now) {
+                resumeStream(stream);
+            } else if (!deadline || stream->deadline < deadline) {
+                deadline = stream->deadline;
+            }
+        }
+    }
+    return deadline;
+}
+
+/*
+    Wake the connection fiber if it is waiting for I/O
+ */
+static void wakeConnection(WebHttp2 *h2)
+{
+    if (h2->waiting) {
+        h2->waiting = 0;
+        //  Remove the I/O interest so only this resume can wake the connection fiber
+        rSetWaitMask(h2->web->sock->wait, 0, 0);
+        rResumeFiber(h2->fiber, 0);
+    }
+}
+
+static void resumeStream(WebStream *stream)
+{
+    if (stream->waiting) {
+        stream->waiting = 0;
+        rResumeFiber(stream->fiber, 0);
+    }
+}
+
+static void resumeStreams(WebHttp2 *h2)
+{
+    WebStream *stream;
+    int       next;
+
+    for (ITERATE_ITEMS(h2->streams, stream, next)) {
+        resumeStream(stream);
+    }
+}
+
+/*
+    Wait on a stream fiber for received data, flow control window or queue space.
+    The connection is woken to write queued frames or to observe an earlier deadline.
+ */
+static int waitStream(WebStream *stream, Ticks deadline)
+{
+    WebHttp2 *h2;
+
+    h2 = stream->h2;
+    if (h2->closed || stream->reset) {
+        return R_ERR_CANT_COMPLETE;
+    }
+    if (stream->fiber == h2->fiber) {
+        return pumpStream(stream, deadline);
+    }
+    stream->deadline = deadline;
+    stream->waiting = 1;
+    if (rGetBufLength(h2->tx) > 0 || (deadline && (!h2->deadline || deadline < h2->deadline))) {
+        wakeConnection(h2);
+    }
+    rYieldFiber(0);
+    stream->waiting = 0;
+    stream->deadline = 0;
+
+    if (h2->closed || stream->reset) {
+        return R_ERR_CANT_COMPLETE;
+    }
+    if (deadline && rGetTicks() >= deadline) {
+        return R_ERR_TIMEOUT;
+    }
+    return 0;
+}
+
+/*
+    Wait for a stream served on the connection fiber. There is no connection fiber to resume, so this performs one
+    iteration of the connection loop: write queued frames, then read and parse received frames.
+ */
+static int pumpStream(WebStream *stream, Ticks deadline)
+{
+    WebHttp2 *h2;
+    RSocket  *sock;
+    Ticks    wait;
+    ssize    nbytes;
+
+    h2 = stream->h2;
+    sock = h2->web->sock;
+    if (writeFrames(h2) < 0) {
+        return R_ERR_CANT_COMPLETE;
+    }
+    if ((nbytes = readFrames(h2)) < 0 || !sock->wait || rIsSocketClosed(sock)) {
+        h2->closed = 1;
+        return R_ERR_CANT_COMPLETE;
+    }
+    if (nbytes == 0) {
+        wait = rGetTimeouts() ? rGetTicks() + h2->web->host->inactivityTimeout : 0;
+        if (deadline && (!wait || deadline < wait)) {
+            wait = deadline;
+        }
+        rWaitForIO(sock->wait, R_READABLE, wait);
+        if ((nbytes = readFrames(h2)) < 0) {
+            h2->closed = 1;
+            return R_ERR_CANT_COMPLETE;
+        }
+    }
+    if (parseFrames(h2) < 0) {
+        h2->closed = 1;
+    }
+    if (h2->pending) {
+        startStreams(h2);
+    }
+    if (h2->closed || stream->reset) {
+        return R_ERR_CANT_COMPLETE;
+    }
+    if (nbytes == 0 && deadline && rGetTicks() >= deadline) {
+        return R_ERR_TIMEOUT;
+    }
+    return 0;
+}
+
+static uint getInt16(cuchar *p)
+{
+    return (uint) p[0] << 8 | (uint) p[1];
+}
+
+static uint getInt24(cuchar *p)
+{
+    return (uint) p[0] << 16 | (uint) p[1] << 8 | (uint) p[2];
+}
+
+static uint getInt32(cuchar *p)
+{
+    return (uint) p[0] << 24 | (uint) p[1] << 16 | (uint) p[2] << 8 | (uint) p[3];
+}
+
+/*
+    Queue a frame for writing by the connection fiber
+ */
+static void queueFrame(WebHttp2 *h2, int type, int flags, int id, cvoid *data, size_t len)
+{
+    uchar header[H2_FRAME_HEADER];
+
+    header[0] = (uchar) (len >> 16);
+    header[1] = (uchar) (len >> 8);
+    header[2] = (uchar) len;
+    header[3] = (uchar) type;
+    header[4] = (uchar) flags;
+    header[5] = (uchar) ((id >> 24) & 0x7f);
+    header[6] = (uchar) (id >> 16);
+    header[7] = (uchar) (id >> 8);
+    header[8] = (uchar) id;
+    rPutBlockToBuf(h2->tx, (cchar*) header, sizeof(header));
+    if (len > 0) {
+        rPutBlockToBuf(h2->tx, data, len);
+    }
+}
+
+/*
+    Queue a frame with a single 32-bit value: RST_STREAM, WINDOW_UPDATE or GOAWAY.
+    GOAWAY frames include the last stream identifier before the error code.
+ */
+static void queueInt(WebHttp2 *h2, int type, int id, uint value)
+{
+    uchar data[8], *p;
+
+    p = data;
+    if (type == H2_GOAWAY) {
+        *p++ = (uchar) ((h2->lastStream >> 24) & 0x7f);
+        *p++ = (uchar) (h2->lastStream >> 16);
+        *p++ = (uchar) (h2->lastStream >> 8);
+        *p++ = (uchar) h2->lastStream;
+        h2->goaway = 1;
+    }
+    *p++ = (uchar) (value >> 24);
+    *p++ = (uchar) (value >> 16);
+    *p++ = (uchar) (value >> 8);
+    *p++ = (uchar) value;
+    queueFrame(h2, type, 0, id, data, (size_t) (p - data));
+}
+
+/*
+    Queue a header block as a HEADERS frame and CONTINUATION frames if it exceeds the peer frame size
+ */
+static void queueHeaders(WebHttp2 *h2, int id, RBuf *block, bool end)
+{
+    cchar  *data;
+    size_t len, size;
+    int    flags, type;
+
+    data = rGetBufStart(block);
+    size = rGetBufLength(block);
+    type = H2_HEADERS;
+    flags = end ? H2_END_STREAM : 0;
+    do {
+        len = min(size, (size_t) h2->peerMaxFrame);
+        size -= len;
+        queueFrame(h2, type, flags | (size == 0 ? H2_END_HEADERS : 0), id, data, len);
+        data += len;
+        type = H2_CONTINUATION;
+        flags = 0;
+    } while (size > 0);
+}
+
+/*
+    Issue a connection error. The GOAWAY frame is written when the connection closes.
+ */
+static int connError(WebHttp2 *h2, int code, cchar *msg)
+{
+    rTrace("web", "HTTP/2 connection error %d: %s", code, msg);
+    queueInt(h2, H2_GOAWAY, 0, (uint) code);
+    return R_ERR_BAD_STATE;
+}
+
+/*
+    Reset a stream. The stream fiber is resumed to observe the reset.
+ */
+static void resetStream(WebStream *stream, int code)
+{
+    if (!stream->reset) {
+        stream->reset = 1;
+        queueInt(stream->h2, H2_RST_STREAM, stream->id, (uint) code);
+        resumeStream(stream);
+    }
+}
+
+/*
+    Reset the stream of a request after a network or protocol error. Other streams on the connection continue.
+ */
+PUBLIC void webResetStream(Web *web)
+{
+    WebStream *stream;
+
+    stream = web->stream;
+    if (!stream->reset && !stream->h2->closed) {
+        resetStream(stream, H2_INTERNAL_ERROR);
+        wakeConnection(stream->h2);
+    }
+}
+
+static WebStream *lookupStream(WebHttp2 *h2, int id)
+{
+    WebStream *stream;
+    int       next;
+
+    for (ITERATE_ITEMS(h2->streams, stream, next)) {
+        if (stream->id == id) {
+            return stream;
+        }
+    }
+    return 0;
+}
+
+/*
+    Parse complete frames from the connection rx buffer
+ */
+static int parseFrames(WebHttp2 *h2)
+{
+    RBuf   *bp;
+    uchar  *p;
+    size_t len;
+    int    id, type;
+
+    bp = h2->web->rx;
+    if (!h2->preface) {
+        if (rGetBufLength(bp) < 6) {
+            return 0;
+        }
+        if (memcmp(bp->start, "SM\r\n\r\n", 6) != 0) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad connection preface");
+        }
+        rAdjustBufStart(bp, 6);
+        h2->preface = 1;
+    }
+    while (!h2->closed && rGetBufLength(bp) >= H2_FRAME_HEADER) {
+        p = (uchar*) rGetBufStart(bp);
+        if ((len = getInt24(p)) > H2_MAX_FRAME) {
+            return connError(h2, H2_FRAME_SIZE_ERROR, "Frame is too big");
+        }
+        if (rGetBufLength(bp) < H2_FRAME_HEADER + len) {
+            break;
+        }
+        type = p[3];
+        id = (int) (getInt32(&p[5]) & 0x7fffffff);
+        if (h2->headerStream && (type != H2_CONTINUATION || id != h2->headerStream)) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Expected CONTINUATION frame");
+        }
+        if (parseFrame(h2, type, p[4], id, &p[H2_FRAME_HEADER], len) < 0) {
+            return R_ERR_BAD_STATE;
+        }
+        rAdjustBufStart(bp, (ssize) (H2_FRAME_HEADER + len));
+    }
+    return 0;
+}
+
+static int parseFrame(WebHttp2 *h2, int type, int flags, int id, uchar *data, size_t len)
+{
+    WebStream *stream;
+
+    switch (type) {
+    case H2_DATA:
+        return parseData(h2, flags, id, data, len);
+
+    case H2_HEADERS:
+    case H2_CONTINUATION:
+        return parseHeaderBlock(h2, type, flags, id, data, len);
+
+    case H2_PRIORITY:
+        //  Stream priorities are not supported
+        if (id == 0) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad PRIORITY frame");
+        }
+        if (len != 5 && (stream = lookupStream(h2, id)) != 0) {
+            resetStream(stream, H2_FRAME_SIZE_ERROR);
+        }
+        return 0;
+
+    case H2_RST_STREAM:
+        return parseReset(h2, id, data, len);
+
+    case H2_SETTINGS:
+        return parseSettings(h2, flags, id, data, len);
+
+    case H2_PUSH_PROMISE:
+        return connError(h2, H2_PROTOCOL_ERROR, "Clients cannot push");
+
+    case H2_PING:
+        if (id != 0 || len != 8) {
+            return connError(h2, len != 8 ? H2_FRAME_SIZE_ERROR : H2_PROTOCOL_ERROR, "Bad PING frame");
+        }
+        if (!(flags & H2_ACK)) {
+            queueFrame(h2, H2_PING, H2_ACK, 0, data, len);
+        }
+        return 0;
+
+    case H2_GOAWAY:
+        if (id != 0 || len < 8) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad GOAWAY frame");
+        }
+        //  Complete the active streams and then close
+        h2->goaway = 1;
+        return 0;
+
+    case H2_WINDOW_UPDATE:
+        return parseWindowUpdate(h2, id, data, len);
+
+    default:
+        //  Unknown frame types are ignored
+        return 0;
+    }
+}
+
+static int parseData(WebHttp2 *h2, int flags, int id, uchar *data, size_t len)
+{
+    WebStream *stream;
+    size_t    pad, size;
+
+    if (id == 0) {
+        return connError(h2, H2_PROTOCOL_ERROR, "DATA frame on connection stream");
+    }
+    //  Flow control accounts for the entire frame payload including padding
+    size = len;
+    if (flags & H2_PADDED) {
+        if (len < 1 || (pad = data[0]) >= len) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad DATA padding");
+        }
+        data++;
+        len -= pad + 1;
+    }
+    if ((int64) size > h2->recvWindow) {
+        return connError(h2, H2_FLOW_CONTROL_ERROR, "Connection flow control window exceeded");
+    }
+    /*
+        The connection window is restored as data is received. Stream windows bound the buffered request data.
+     */
+    h2->recvWindow -= (int64) size;
+    h2->recvConsumed += (int) size;
+    if (h2->recvConsumed >= H2_WINDOW / 2) {
+        queueInt(h2, H2_WINDOW_UPDATE, 0, (uint) h2->recvConsumed);
+        h2->recvWindow += h2->recvConsumed;
+        h2->recvConsumed = 0;
+    }
+    if ((stream = lookupStream(h2, id)) == 0 || stream->eof || stream->reset) {
+        if (id > h2->lastStream) {
+            return connError(h2, H2_PROTOCOL_ERROR, "DATA frame on idle stream");
+        }
+        if (stream && stream->eof && !stream->reset) {
+            resetStream(stream, H2_STREAM_CLOSED);
+        }
+        //  Frames in flight for closed or reset streams are ignored
+        return 0;
+    }
+    if ((int64) size > stream->recvWindow) {
+        resetStream(stream, H2_FLOW_CONTROL_ERROR);
+        return 0;
+    }
+    stream->recvWindow -= (int) size;
+    stream->recvConsumed += (int) (size - len);
+    rPutBlockToBuf(stream->rx, (cchar*) data, len);
+    if (flags & H2_END_STREAM) {
+        stream->eof = 1;
+    }
+    resumeStream(stream);
+    return 0;
+}
+
+/*
+    Assemble a header block from HEADERS and CONTINUATION frames
+ */
+static int parseHeaderBlock(WebHttp2 *h2, int type, int flags, int id, uchar *data, size_t len)
+{
+    size_t pad;
+
+    if (type == H2_HEADERS) {
+        if (id == 0 || (id & 1) == 0) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad HEADERS stream identifier");
+        }
+        pad = 0;
+        if (flags & H2_PADDED) {
+            if (len < 1) {
+                return connError(h2, H2_PROTOCOL_ERROR, "Bad HEADERS padding");
+            }
+            pad = data[0];
+            data++;
+            len--;
+        }
+        if (flags & H2_PRIORITY_FLAG) {
+            if (len < 5) {
+                return connError(h2, H2_PROTOCOL_ERROR, "Bad HEADERS priority");
+            }
+            data += 5;
+            len -= 5;
+        }
+        if (pad > len) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad HEADERS padding");
+        }
+        len -= pad;
+        rFlushBuf(h2->headers);
+        h2->headerFlags = flags;
+        h2->headerStream = id;
+
+    } else if (!h2->headerStream) {
+        return connError(h2, H2_PROTOCOL_ERROR, "Unexpected CONTINUATION frame");
+    }
+    if (rGetBufLength(h2->headers) + len > (size_t) h2->web->host->maxHeader) {
+        return connError(h2, H2_ENHANCE_YOUR_CALM, "Header block is too big");
+    }
+    rPutBlockToBuf(h2->headers, (cchar*) data, len);
+    if (flags & H2_END_HEADERS) {
+        h2->headerStream = 0;
+        return endHeaders(h2, id, h2->headerFlags);
+    }
+    return 0;
+}
+
+/*
+    Decode a complete header block and open a new stream
+ */
+static int endHeaders(WebHttp2 *h2, int id, int flags)
+{
+    H2Request req;
+    WebStream *stream;
+
+    stream = lookupStream(h2, id);
+    if (stream || id <= h2->lastStream) {
+        /*
+            Trailers or headers for a closed stream. These must still be decoded to maintain the dynamic table.
+         */
+        if (decodeHeaders(h2, NULL) < 0) {
+            return connError(h2, H2_COMPRESSION_ERROR, "Bad header block");
+        }
+        if (stream && !stream->reset) {
+            if (!(flags & H2_END_STREAM) || stream->eof) {
+                resetStream(stream, H2_PROTOCOL_ERROR);
+            } else {
+                stream->eof = 1;
+                resumeStream(stream);
+            }
+        }
+        return 0;
+    }
+    h2->lastStream = id;
+
+    memset(&req, 0, sizeof(req));
+    req.headers = rAllocBuf(ME_BUFSIZE);
+    if (decodeHeaders(h2, &req) < 0) {
+        freeRequest(&req);
+        return connError(h2, H2_COMPRESSION_ERROR, "Bad header block");
+    }
+    if (req.malformed || !req.method || !req.path || strpbrk(req.method, " \t") || strpbrk(req.path, " \t") ||
+        (req.path[0] != '/' && !smatch(req.path, "*"))) {
+        rTrace("web", "Malformed HTTP/2 request on stream %d", id);
+        queueInt(h2, H2_RST_STREAM, id, H2_PROTOCOL_ERROR);
+
+    } else if (h2->goaway || h2->active >= h2->web->host->maxStreams) {
+        queueInt(h2, H2_RST_STREAM, id, H2_REFUSED_STREAM);
+
+    } else {
+        openStream(h2, id, &req, (flags & H2_END_STREAM) != 0);
+    }
+    freeRequest(&req);
+    return 0;
+}
+
+static void freeRequest(H2Request *req)
+{
+    rFreeBuf(req->headers);
+    rFree(req->method);
+    rFree(req->path);
+    rFree(req->authority);
+}
+
+/*
+    Open a stream and spawn a fiber to serve the request. The request is presented in HTTP/1 form.
+ */
+static void openStream(WebHttp2 *h2, int id, H2Request *req, bool eof)
+{
+    WebStream *stream;
+    Web       *web;
+    RBuf      *rx;
+
+    if (slen(req->method) + slen(req->path) + slen(req->authority) + rGetBufLength(req->headers) + 32 >
+        (size_t) h2->web->host->maxHeader) {
+        queueInt(h2, H2_RST_STREAM, id, H2_ENHANCE_YOUR_CALM);
+        return;
+    }
+    if ((stream = rAllocType(WebStream)) == 0) {
+        queueInt(h2, H2_RST_STREAM, id, H2_REFUSED_STREAM);
+        return;
+    }
+    stream->h2 = h2;
+    stream->id = id;
+    stream->rx = rAllocBuf(ME_BUFSIZE);
+    stream->sendWindow = h2->peerWindow;
+    stream->recvWindow = H2_WINDOW;
+    stream->eof = eof;
+    stream->body = !eof;
+
+    if ((web = webAllocStream(h2->web, stream)) == 0) {
+        rFreeBuf(stream->rx);
+        rFree(stream);
+        queueInt(h2, H2_RST_STREAM, id, H2_REFUSED_STREAM);
+        return;
+    }
+    stream->web = web;
+    rx = web->rx;
+    rPutToBuf(rx, "%s %s HTTP/2.0\r\n", req->method, req->path);
+    if (req->authority && !req->host) {
+        rPutToBuf(rx, "Host: %s\r\n", req->authority);
+    }
+    rPutBlockToBuf(rx, rGetBufStart(req->headers), rGetBufLength(req->headers));
+    rPutStringToBuf(rx, "\r\n");
+
+    rAddItem(h2->streams, stream);
+    h2->active++;
+    h2->pending++;
+    startStreams(h2);
+}
+
+/*
+    Start fibers for streams that are pending. If the fiber limit is reached, the streams are started when
+    fibers become available.
+ */
+static void startStreams(WebHttp2 *h2)
+{
+    WebStream *stream;
+    int       next;
+
+    for (ITERATE_ITEMS(h2->streams, stream, next)) {
+        if (h2->pending == 0) {
+            break;
+        }
+        if (!stream->started) {
+            if (rSpawnFiber("http2", (RFiberProc) serveStream, stream) < 0) {
+                break;
+            }
+            stream->started = 1;
+            h2->pending--;
+        }
+    }
+}
+
+/*
+    Serve the first pending stream on the connection fiber
+ */
+static void serveInline(WebHttp2 *h2)
+{
+    WebStream *stream;
+    int       next;
+
+    for (ITERATE_ITEMS(h2->streams, stream, next)) {
+        if (!stream->started) {
+            stream->started = 1;
+            h2->pending--;
+            serveStream(stream);
+            break;
+        }
+    }
+}
+
+/*
+    Stream fiber. Serve the request and then close the stream.
+ */
+static void serveStream(WebStream *stream)
+{
+    WebHttp2 *h2;
+
+    h2 = stream->h2;
+    stream->fiber = rGetFiber();
+    webServeStream(stream->web);
+
+    if (!stream->reset && !h2->closed) {
+        if (!stream->ended) {
+            //  The response was not completed
+            resetStream(stream, H2_INTERNAL_ERROR);
+        } else if (!stream->eof) {
+            //  The response is complete. Stop the client sending request body data that will not be read.
+            resetStream(stream, H2_NO_ERROR);
+        }
+    }
+    freeStream(stream);
+    wakeConnection(h2);
+}
+
+static void freeStream(WebStream *stream)
+{
+    WebHttp2 *h2;
+    Web      *web;
+
+    h2 = stream->h2;
+    web = stream->web;
+    rRemoveItem(h2->streams, stream);
+    h2->active--;
+
+    //  The socket belongs to the connection
+    web->sock = 0;
+    webFree(web);
+    rFreeBuf(stream->rx);
+    rFree(stream);
+}
+
+static int parseReset(WebHttp2 *h2, int id, uchar *data, size_t len)
+{
+    WebStream *stream;
+
+    if (len != 4) {
+        return connError(h2, H2_FRAME_SIZE_ERROR, "Bad RST_STREAM frame");
+    }
+    if (id == 0 || id > h2->lastStream) {
+        return connError(h2, H2_PROTOCOL_ERROR, "RST_STREAM on idle stream");
+    }
+    if ((stream = lookupStream(h2, id)) != 0) {
+        stream->reset = 1;
+        resumeStream(stream);
+    }
+    return 0;
+}
+
+static int parseSettings(WebHttp2 *h2, int flags, int id, uchar *data, size_t len)
+{
+    WebStream *stream;
+    int64     delta;
+    size_t    i;
+    uint      value;
+    int       next;
+
+    if (id != 0) {
+        return connError(h2, H2_PROTOCOL_ERROR, "SETTINGS frame on a stream");
+    }
+    if (flags & H2_ACK) {
+        return len ? connError(h2, H2_FRAME_SIZE_ERROR, "Bad SETTINGS acknowledgement") : 0;
+    }
+    if (len % 6) {
+        return connError(h2, H2_FRAME_SIZE_ERROR, "Bad SETTINGS frame");
+    }
+    for (i = 0; i < len; i += 6) {
+        value = getInt32(&data[i + 2]);
+        switch (getInt16(&data[i])) {
+        case H2_SETTINGS_ENABLE_PUSH:
+            if (value > 1) {
+                return connError(h2, H2_PROTOCOL_ERROR, "Bad ENABLE_PUSH setting");
+            }
+            break;
+
+        case H2_SETTINGS_WINDOW_SIZE:
+            if (value > H2_MAX_WINDOW) {
+                return connError(h2, H2_FLOW_CONTROL_ERROR, "Bad INITIAL_WINDOW_SIZE setting");
+            }
+            //  Adjust the send windows of open streams by the change
+            delta = (int64) value - h2->peerWindow;
+            for (ITERATE_ITEMS(h2->streams, stream, next)) {
+                stream->sendWindow += delta;
+                if (stream->sendWindow > H2_MAX_WINDOW) {
+                    return connError(h2, H2_FLOW_CONTROL_ERROR, "Stream flow control window overflow");
+                }
+            }
+            h2->peerWindow = (int) value;
+            break;
+
+        case H2_SETTINGS_MAX_FRAME:
+            if (value < H2_MAX_FRAME || value > 0xffffff) {
+                return connError(h2, H2_PROTOCOL_ERROR, "Bad MAX_FRAME_SIZE setting");
+            }
+            //  Frames are limited to the queue size
+            h2->peerMaxFrame = (int) min(value, WEB_BUF_BOOST_4X);
+            break;
+
+        default:
+            //  Other settings govern features that are not used or are advisory
+            break;
+        }
+    }
+    queueFrame(h2, H2_SETTINGS, H2_ACK, 0, NULL, 0);
+    resumeStreams(h2);
+    return 0;
+}
+
+static int parseWindowUpdate(WebHttp2 *h2, int id, uchar *data, size_t len)
+{
+    WebStream *stream;
+    uint      increment;
+
+    if (len != 4) {
+        return connError(h2, H2_FRAME_SIZE_ERROR, "Bad WINDOW_UPDATE frame");
+    }
+    increment = getInt32(data) & 0x7fffffff;
+    if (id == 0) {
+        if (increment == 0) {
+            return connError(h2, H2_PROTOCOL_ERROR, "Bad WINDOW_UPDATE increment");
+        }
+        h2->sendWindow += increment;
+        if (h2->sendWindow > H2_MAX_WINDOW) {
+            return connError(h2, H2_FLOW_CONTROL_ERROR, "Connection flow control window overflow");
+        }
+        resumeStreams(h2);
+
+    } else if ((stream = lookupStream(h2, id)) != 0 && !stream->reset) {
+        if (increment == 0) {
+            resetStream(stream, H2_PROTOCOL_ERROR);
+            return 0;
+        }
+        stream->sendWindow += increment;
+        if (stream->sendWindow > H2_MAX_WINDOW) {
+            resetStream(stream, H2_FLOW_CONTROL_ERROR);
+            return 0;
+        }
+        resumeStream(stream);
+    }
+    return 0;
+}
+
+/*
+    Read request body data for a stream. This runs on the stream fiber and blocks until data is available.
+    Returns the number of bytes read, zero at the end of a body without a content length, or negative on errors.
+ */
+PUBLIC ssize webReadStream(Web *web, char *buf, size_t bufsize, Ticks deadline)
+{
+    WebStream *stream;
+    WebHttp2  *h2;
+    size_t    len;
+
+    stream = web->stream;
+    h2 = stream->h2;
+    while (rGetBufLength(stream->rx) == 0) {
+        if (stream->eof) {
+            if (web->rxLen < 0 && web->rxRemaining != 0) {
+                //  The request did not specify a content length. The end of the stream ends the body.
+                web->rxRemaining = 0;
+                return 0;
+            }
+            return R_ERR_CANT_READ;
+        }
+        if (waitStream(stream, deadline) < 0) {
+            return R_ERR_CANT_READ;
+        }
+    }
+    len = min(bufsize, rGetBufLength(stream->rx));
+    memcpy(buf, stream->rx->start, len);
+    rAdjustBufStart(stream->rx, (ssize) len);
+    if (rGetBufLength(stream->rx) == 0) {
+        rFlushBuf(stream->rx);
+    }
+    //  Restore the stream window once half has been consumed
+    stream->recvConsumed += (int) len;
+    if (stream->recvConsumed >= H2_WINDOW / 2 && !stream->eof) {
+        queueInt(h2, H2_WINDOW_UPDATE, stream->id, (uint) stream->recvConsumed);
+        stream->recvWindow += stream->recvConsumed;
+        stream->recvConsumed = 0;
+        wakeConnection(h2);
+    }
+    return (ssize) len;
+}
+
+/*
+    Write response output for a stream. The corked response header block is sent first.
+    Body data is sent in DATA frames subject to the stream and connection flow control windows.
+    This runs on the stream fiber and blocks while the windows are closed or the connection queue is full.
+ */
+PUBLIC ssize webWriteStream(Web *web, cvoid *buf, size_t bufsize, bool finalizing)
+{
+    WebStream *stream;
+    WebHttp2  *h2;
+    cchar     *data;
+    size_t    len;
+    int64     window;
+    bool      end;
+
+    stream = web->stream;
+    h2 = stream->h2;
+    if (stream->ended) {
+        return 0;
+    }
+    if (h2->closed || stream->reset) {
+        return R_ERR_CANT_WRITE;
+    }
+    if (web->cork) {
+        end = finalizing && bufsize == 0;
+        queueHeaders(h2, stream->id, web->cork, end);
+        rFreeBuf(web->cork);
+        web->cork = 0;
+        stream->ended = end;
+    }
+    for (data = buf; bufsize > 0; ) {
+        window = min(stream->sendWindow, h2->sendWindow);
+        if (window <= 0 || rGetBufLength(h2->tx) >= WEB_BUF_BOOST_16X) {
+            if (waitStream(stream, web->deadline) < 0) {
+                return R_ERR_CANT_WRITE;
+            }
+            continue;
+        }
+        len = (size_t) min((int64) bufsize, window);
+        len = min(len, (size_t) h2->peerMaxFrame);
+        bufsize -= len;
+        end = finalizing && bufsize == 0;
+        queueFrame(h2, H2_DATA, end ? H2_END_STREAM : 0, stream->id, data, len);
+        stream->sendWindow -= (int64) len;
+        h2->sendWindow -= (int64) len;
+        stream->ended = end;
+        data += len;
+    }
+    if (finalizing && !stream->ended) {
+        queueFrame(h2, H2_DATA, H2_END_STREAM, stream->id, NULL, 0);
+        stream->ended = 1;
+    }
+    wakeConnection(h2);
+    return 0;
+}
+
+/*
+    HPACK encode the response status and headers. Connection-specific headers are omitted.
+    Fields are encoded as literals without indexing and without Huffman coding.
+ */
+PUBLIC RBuf *webEncodeStreamHeaders(Web *web, int status)
+{
+    RName *header;
+    RBuf  *buf;
+    char  *name, code[16];
+    int   index;
+
+    buf = rAllocBuf(1024);
+    if ((index = statusIndex(status)) > 0) {
+        rPutCharToBuf(buf, (char) (0x80 | index));
+    } else {
+        //  Literal without indexing using the ":status" name in the static table
+        encodeInt(buf, 0x00, 4, 8);
+        SFMT(code, "%d", status);
+        encodeString(buf, code, slen(code));
+    }
+    if (!rEmitLog("trace", "web")) {
+        rTrace("web", "HTTP/2.0 %d %s", status, webGetStatusMsg(status));
+    }
+    for (ITERATE_NAMES(web->txHeaders, header)) {
+        if (scaselessmatch(header->name, "Connection") || scaselessmatch(header->name, "Keep-Alive") ||
+            scaselessmatch(header->name, "Transfer-Encoding") || scaselessmatch(header->name, "Upgrade") ||
+            scaselessmatch(header->name, "Proxy-Connection")) {
+            continue;
+        }
+        //  Field names must be lower case
+        name = slower(sclone(header->name));
+        if ((index = staticNameIndex(name)) > 0) {
+            encodeInt(buf, 0x00, 4, (size_t) index);
+        } else {
+            rPutCharToBuf(buf, 0);
+            encodeString(buf, name, slen(name));
+        }
+        encodeString(buf, (cchar*) header->value, slen((cchar*) header->value));
+        rFree(name);
+    }
+    return buf;
+}
+
+/*
+    Return the static table index for a response status
+ */
+static int statusIndex(int status)
+{
+    switch (status) {
+    case 200: return 8;
+    case 204: return 9;
+    case 206: return 10;
+    case 304: return 11;
+    case 400: return 12;
+    case 404: return 13;
+    case 500: return 14;
+    default: return 0;
+    }
+}
+
+/*
+    Return the static table index for a field name. Pseudo-header entries are not searched.
+ */
+static int staticNameIndex(cchar *name)
+{
+    int i;
+
+    for (i = 14; i < H2_STATIC_FIELDS; i++) {
+        if (smatch(StaticTable[i][0], name)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static void encodeInt(RBuf *buf, int bits, int prefix, size_t value)
+{
+    size_t max;
+
+    max = ((size_t) 1 << prefix) - 1;
+    if (value < max) {
+        rPutCharToBuf(buf, (char) (bits | (int) value));
+        return;
+    }
+    rPutCharToBuf(buf, (char) (bits | (int) max));
+    for (value -= max; value >= 128; value >>= 7) {
+        rPutCharToBuf(buf, (char) ((value & 0x7f) | 0x80));
+    }
+    rPutCharToBuf(buf, (char) value);
+}
+
+static void encodeString(RBuf *buf, cchar *str, size_t len)
+{
+    encodeInt(buf, 0x00, 7, len);
+    rPutBlockToBuf(buf, str, len);
+}
+
+/*
+    Decode the header block in h2->headers. If req is NULL, the fields are decoded only to maintain the dynamic table.
+ */
+static int decodeHeaders(WebHttp2 *h2, H2Request *req)
+{
+    uchar *p, *end;
+    cchar *entry, *value;
+    char  *fieldName, *fieldValue;
+    int64 index, size;
+    bool  indexing;
+
+    p = (uchar*) rGetBufStart(h2->headers);
+    end = p + rGetBufLength(h2->headers);
+    while (p < end) {
+        if (*p & 0x80) {
+            //  Indexed field
+            if (decodeInt(&p, end, 7, &index) < 0 || (entry = lookupField(h2, index, &value)) == 0) {
+                return R_ERR_BAD_FORMAT;
+            }
+            addField(req, entry, value);
+
+        } else if ((*p & 0xE0) == 0x20) {
+            //  Dynamic table size update
+            if (decodeInt(&p, end, 5, &size) < 0 || size > H2_TABLE_SIZE) {
+                return R_ERR_BAD_FORMAT;
+            }
+            h2->tableMax = (int) size;
+            evictFields(h2, 0);
+
+        } else {
+            //  Literal field with incremental indexing, without indexing or never indexed
+            indexing = (*p & 0xC0) == 0x40;
+            if (decodeInt(&p, end, indexing ? 6 : 4, &index) < 0) {
+                return R_ERR_BAD_FORMAT;
+            }
+            if (index) {
+                if ((entry = lookupField(h2, index, NULL)) == 0) {
+                    return R_ERR_BAD_FORMAT;
+                }
+                fieldName = sclone(entry);
+            } else if ((fieldName = decodeString(&p, end)) == 0) {
+                return R_ERR_BAD_FORMAT;
+            }
+            if ((fieldValue = decodeString(&p, end)) == 0) {
+                rFree(fieldName);
+                return R_ERR_BAD_FORMAT;
+            }
+            addField(req, fieldName, fieldValue);
+            if (indexing) {
+                indexField(h2, fieldName, fieldValue);
+            }
+            rFree(fieldName);
+            rFree(fieldValue);
+        }
+    }
+    return 0;
+}
+
+/*
+    Add a decoded field to the request. Pseudo-headers are saved and regular fields are converted to HTTP/1 form.
+ */
+static void addField(H2Request *req, cchar *name, cchar *value)
+{
+    cchar *cp;
+
+    if (!req || req->malformed) {
+        return;
+    }
+    //  Values are presented as HTTP/1 header lines so must not contain line breaks
+    if (*name == '\0' || strpbrk(value, "\r\n")) {
+        req->malformed = 1;
+        return;
+    }
+    if (*name == ':') {
+        if (req->regular) {
+            //  Pseudo-headers must precede regular fields
+            req->malformed = 1;
+        } else if (smatch(name, ":method") && !req->method) {
+            req->method = sclone(value);
+        } else if (smatch(name, ":path") && !req->path && *value) {
+            req->path = sclone(value);
+        } else if (smatch(name, ":authority") && !req->authority) {
+            req->authority = sclone(value);
+        } else if (!smatch(name, ":scheme")) {
+            req->malformed = 1;
+        }
+        return;
+    }
+    req->regular = 1;
+    for (cp = name; *cp; cp++) {
+        if (isupper((uchar) *cp) || *cp == ':' || isspace((uchar) *cp)) {
+            req->malformed = 1;
+            return;
+        }
+    }
+    //  Connection-specific fields are not permitted
+    if (smatch(name, "connection") || smatch(name, "keep-alive") || smatch(name, "proxy-connection") ||
+        smatch(name, "transfer-encoding") || smatch(name, "upgrade") ||
+        (smatch(name, "te") && !smatch(value, "trailers"))) {
+        req->malformed = 1;
+        return;
+    }
+    if (smatch(name, "host")) {
+        req->host = 1;
+    }
+    rPutToBuf(req->headers, "%s: %s\r\n", name, value);
+}
+
+/*
+    Lookup a field in the static or dynamic table. Returns the field name and sets *value to the field value.
+ */
+static cchar *lookupField(WebHttp2 *h2, int64 index, cchar **value)
+{
+    cchar *name, *fieldValue;
+    int   count;
+
+    if (index <= 0) {
+        return 0;
+    }
+    if (index <= H2_STATIC_FIELDS) {
+        name = StaticTable[index - 1][0];
+        fieldValue = StaticTable[index - 1][1];
+    } else {
+        count = rGetListLength(h2->table);
+        index -= H2_STATIC_FIELDS;
+        if (index > count) {
+            return 0;
+        }
+        name = rGetItem(h2->table, count - (int) index);
+        fieldValue = &name[slen(name) + 1];
+    }
+    if (value) {
+        *value = fieldValue;
+    }
+    return name;
+}
+
+/*
+    Add a field to the dynamic table. Entries are evicted oldest first to make room.
+ */
+static void indexField(WebHttp2 *h2, cchar *name, cchar *value)
+{
+    char   *entry;
+    size_t nlen, vlen, size;
+
+    nlen = slen(name);
+    vlen = slen(value);
+    size = nlen + vlen + H2_FIELD_OVERHEAD;
+    evictFields(h2, size);
+    if (size > (size_t) h2->tableMax) {
+        //  An entry larger than the table empties the table and is not added
+        return;
+    }
+    entry = rAlloc(nlen + vlen + 2);
+    memcpy(entry, name, nlen + 1);
+    memcpy(&entry[nlen + 1], value, vlen + 1);
+    rAddItem(h2->table, entry);
+    h2->tableSize += (int) size;
+}
+
+static void evictFields(WebHttp2 *h2, size_t need)
+{
+    cchar *entry;
+
+    while (rGetListLength(h2->table) > 0 && (size_t) h2->tableSize + need > (size_t) h2->tableMax) {
+        entry = rGetItem(h2->table, 0);
+        h2->tableSize -= (int) (slen(entry) + slen(&entry[slen(entry) + 1]) + H2_FIELD_OVERHEAD);
+        rRemoveItemAt(h2->table, 0);
+    }
+}
+
+/*
+    Decode an HPACK integer with an N-bit prefix
+ */
+static int decodeInt(uchar **pp, uchar *end, int prefix, int64 *value)
+{
+    uchar *p;
+    int64 v;
+    int   max, shift;
+
+    p = *pp;
+    if (p >= end) {
+        return R_ERR_BAD_FORMAT;
+    }
+    max = (1 << prefix) - 1;
+    v = *p++ & max;
+    if (v == max) {
+        for (shift = 0; ; shift += 7) {
+            if (p >= end || shift > 28) {
+                return R_ERR_BAD_FORMAT;
+            }
+            v += (int64) (*p & 0x7f) << shift;
+            if ((*p++ & 0x80) == 0) {
+                break;
+            }
+        }
+    }
+    *pp = p;
+    *value = v;
+    return 0;
+}
+
+/*
+    Decode an HPACK string literal. Returns an allocated string or NULL on errors.
+ */
+static char *decodeString(uchar **pp, uchar *end)
+{
+    uchar *p;
+    int64 len;
+    char  *str;
+    bool  huffman;
+
+    p = *pp;
+    if (p >= end) {
+        return 0;
+    }
+    huffman = (*p & 0x80) != 0;
+    if (decodeInt(&p, end, 7, &len) < 0 || len > end - p) {
+        return 0;
+    }
+    if (huffman) {
+        str = decodeHuffman(p, (size_t) len);
+    } else {
+        str = snclone((cchar*) p, (size_t) len);
+    }
+    *pp = p + len;
+    return str;
+}
+
+/*
+    Decode a Huffman encoded string. The padding must be at most 7 bits of the EOS prefix (all ones).
+ */
+static char *decodeHuffman(cuchar *data, size_t len)
+{
+    char   *str, *dp;
+    size_t i;
+    int    bit, bits, node, next, ones;
+
+    buildHuffman();
+    //  The shortest code is 5 bits
+    str = dp = rAlloc(len * 8 / 5 + 1);
+    node = 0;
+    bits = 0;
+    ones = 1;
+    for (i = 0; i < len; i++) {
+        for (bit = 7; bit >= 0; bit--) {
+            next = huffTree[node][(data[i] >> bit) & 1];
+            if (next == 0 || next == -257) {
+                //  Missing code or EOS
+                rFree(str);
+                return 0;
+            }
+            if (next < 0) {
+                *dp++ = (char) (-next - 1);
+                node = 0;
+                bits = 0;
+                ones = 1;
+            } else {
+                node = next;
+                bits++;
+                ones &= (data[i] >> bit) & 1;
+            }
+        }
+    }
+    if (bits > 7 || !ones) {
+        rFree(str);
+        return 0;
+    }
+    *dp = '\0';
+    return str;
+}
+
+static void buildHuffman(void)
+{
+    short *child;
+    uint  code;
+    int   bit, node, sym;
+
+    if (huffNodes) {
+        return;
+    }
+    huffNodes = 1;
+    for (sym = 0; sym <= 256; sym++) {
+        code = HuffCodes[sym];
+        node = 0;
+        for (bit = HuffLengths[sym] - 1; bit > 0; bit--) {
+            child = &huffTree[node][(code >> bit) & 1];
+            if (*child == 0) {
+                *child = (short) huffNodes++;
+            }
+            node = *child;
+        }
+        huffTree[node][code & 1] = (short) -(sym + 1);
+    }
+}
+
+#endif /* ME_WEB_HTTP2 */
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
+
+
+/********* Start of file ../../../src/io.c ************/
+
+/*
+    io.c - I/O for the web server
+
+    Copyright (c) All Rights Reserved. See copyright notice at the bottom of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#if ME_WEB_COMPRESS
+    #include <zlib.h>
+#endif
+
+
+
+/************************************ Forwards *********************************/
+
+static char *findPatternFrom(RBuf *buf, cchar *pattern, size_t patLen, size_t fromOffset);
+static bool isprintable(cchar *s, size_t len);
+static ssize consumeChunkStart(Web *web, size_t desiredSize);
+static int consumeChunkData(Web *web, ssize nbytes);
+static ssize readSocketBuffer(Web *web, size_t desiredSize);
+static ssize readSocketBlock(Web *web, size_t desiredSize);
+static void corkHeaders(Web *web, RBuf *headers);
+static RBuf *formatHeaders(Web *web);
+static bool isPipelined(Web *web);
+static size_t formatChunkDivider(Web *web, char *chunk, size_t chunkSize, size_t size);
+static void traceBody(Web *web, cvoid *buf, size_t len);
+static ssize writeOutput(Web *web, cvoid *buf, size_t bufsize, bool finalizing);
+#if ME_WEB_COMPRESS
+static ssize compressOutput(Web *web, cvoid *buf, size_t bufsize, int flush);
+static void startCompress(Web *web, ssize size);
+#endif
+
+/************************************* Code ***********************************/
 /*
     Read request body data into a buffer and return the number of bytes read.
     This is how users read the request body into their own buffers.
@@ -4085,16 +6719,11 @@ static int writeChunkDivider(Web *web, size_t bufsize);
  */
 PUBLIC ssize webRead(Web *web, char *buf, size_t bufsize)
 {
-    RBuf   *bp;
-    ssize  nbytes;
-    size_t outstanding;
+    RBuf  *bp;
+    ssize nbytes;
 
     bp = web->rx;
 
-    if (!web->chunked) {
-        outstanding = max(rGetBufLength(bp), (size_t) web->rxRemaining);
-        bufsize = min(bufsize, outstanding);
-    }
     if ((nbytes = readSocketBlock(web, bufsize)) < 0) {
         if (web->rxRemaining > 0) {
             return webNetError(web, "Cannot read from socket");
@@ -4123,7 +6752,16 @@ static ssize readSocket(Web *web, size_t toRead, Ticks deadline)
     ssize nbytes;
 
     bp = web->rx;
-    if ((nbytes = rReadSocket(web->sock, bp->end, toRead, deadline)) < 0) {
+#if ME_WEB_HTTP2
+    if (web->stream) {
+        nbytes = webReadStream(web, bp->end, toRead, deadline);
+    } else {
+        nbytes = rReadSocket(web->sock, bp->end, toRead, deadline);
+    }
+#else
+    nbytes = rReadSocket(web->sock, bp->end, toRead, deadline);
+#endif
+    if (nbytes < 0) {
         return R_ERR_CANT_READ;
     }
     rAdjustBufEnd(bp, nbytes);
@@ -4261,6 +6899,13 @@ static ssize readSocketBlock(Web *web, size_t desiredSize)
             return size;  // 0 for EOF, negative for error
         }
         desiredSize = (size_t) size;
+
+    } else if (web->rxRemaining < (int64) desiredSize) {
+        //  Buffered data beyond the request body belongs to the next pipelined request
+        if (web->rxRemaining <= 0) {
+            return 0;
+        }
+        desiredSize = (size_t) web->rxRemaining;
     }
     return readSocketBuffer(web, desiredSize);
 }
@@ -4446,13 +7091,56 @@ PUBLIC int webConsumeInput(Web *web)
     Write response headers
  */
 PUBLIC ssize webWriteHeaders(Web *web)
+{
+    RBuf *buf;
+
+    if ((buf = formatHeaders(web)) == 0) {
+        return 0;
+    }
+    corkHeaders(web, buf);
+    return webFlush(web);
+}
+
+/*
+    Add formatted headers to the cork buffer. The cork may already hold responses for prior pipelined requests.
+ */
+static void corkHeaders(Web *web, RBuf *headers)
+{
+    if (web->cork) {
+        rPutBlockToBuf(web->cork, rGetBufStart(headers), rGetBufLength(headers));
+        rFreeBuf(headers);
+    } else {
+        web->cork = headers;
+    }
+}
+
+/*
+    Test if the headers of another request have been received on the connection while processing this request.
+    Responses are then held so a batch of pipelined responses can be written together.
+ */
+static bool isPipelined(Web *web)
+{
+    size_t len;
+
+    if (!web->host->cork || web->close || web->upgrade || web->rxRemaining != 0) {
+        return 0;
+    }
+    if ((len = rGetBufLength(web->rx)) == 0) {
+        return 0;
+    }
+    return sncontains(rGetBufStart(web->rx), "\r\n\r\n", len) != 0;
+}
+
+/*
+    Format the response headers into a buffer. The caller is responsible for writing and freeing the buffer.
+ */
+static RBuf *formatHeaders(Web *web)
 {
     WebHost *host;
     Ticks   remaining;
     RName   *header;
     RBuf    *buf;
     cchar   *connection, *protocol;
-    ssize   nbytes;
     int     status;
 
     host = web->host;
@@ -4510,6 +7198,15 @@ PUBLIC ssize webWriteHeaders(Web *web)
     //  Set client-side cache control headers based on route configuration
     webSetCacheControlHeaders(web);
 
+#if ME_WEB_HTTP2
+    if (web->stream) {
+        //  HTTP/2 header block. The connection and transfer encoding headers above are omitted.
+        web->writingHeaders = 0;
+        web->wroteHeaders = 1;
+        return webEncodeStreamHeaders(web, status);
+    }
+#endif
+
 #if ME_DEBUG && KEEP
     /*
         If testing CORS, allow origin header to use the request origin
@@ -4550,14 +7247,9 @@ PUBLIC ssize webWriteHeaders(Web *web)
         //  Delay adding if using transfer encoding. This optimization eliminates a write per chunk.
         rPutStringToBuf(buf, "\r\n");
     }
-    if ((nbytes = webWrite(web, rGetBufStart(buf), rGetBufLength(buf))) < 0) {
-        rFreeBuf(buf);
-        return R_ERR_CANT_WRITE;
-    }
-    rFreeBuf(buf);
     web->writingHeaders = 0;
     web->wroteHeaders = 1;
-    return nbytes;
+    return buf;
 }
 
 /*
@@ -4592,109 +7284,316 @@ PUBLIC void webAddHeader(Web *web, cchar *key, cchar *fmt, ...)
     webAddHeaderDynamicString(web, key, value);
 }
 
-PUBLIC void webAddHeaderDynamicString(Web *web, cchar *key, char *value)
+PUBLIC void webAddHeaderDynamicString(Web *web, cchar *key, char *value)
+{
+    rAddDuplicateName(web->txHeaders, key, value, R_DYNAMIC_VALUE);
+}
+
+PUBLIC void webAddHeaderStaticString(Web *web, cchar *key, cchar *value)
+{
+    rAddDuplicateName(web->txHeaders, key, (void*) value, R_STATIC_VALUE);
+}
+
+/*
+    Add an Access-Control-Allow-Origin response header necessary for CORS requests.
+ */
+PUBLIC void webAddAccessControlHeader(Web *web)
+{
+    char  *hostname;
+    cchar *schema, *contentEncoding;
+
+    /*
+        Check if Content-Encoding is set (pre-compressed content)
+        If so, include both Origin and Accept-Encoding in Vary header
+     */
+    if (!rLookupName(web->txHeaders, "Vary")) {
+        contentEncoding = rLookupName(web->txHeaders, "Content-Encoding");
+        if (contentEncoding) {
+            webAddHeaderStaticString(web, "Vary", "Origin, Accept-Encoding");
+        } else {
+            webAddHeaderStaticString(web, "Vary", "Origin");
+        }
+    }
+    if (web->origin) {
+        webAddHeaderStaticString(web, "Access-Control-Allow-Origin", web->origin);
+    } else {
+        hostname = webGetHostName(web);
+        schema = web->sock->tls ? "https" : "http";
+        webAddHeader(web, "Access-Control-Allow-Origin", "%s://%s", schema, hostname);
+        rFree(hostname);
+    }
+}
+
+/*
+    Write body data. Caller should set bufsize to zero to signify end of body
+    if the content length is not defined. webFinalize invokes webWrite with bufsize zero.
+    Will write headers if not alread written. Will close the socket on socket errors.
+    NOTE: this call will block the fiber in webWriteSocket until the data is written.
+    Other fibers continue to run while waiting for the data to drain.
+ */
+PUBLIC ssize webWrite(Web *web, cvoid *buf, size_t bufsize)
+{
+    bool finalizing;
+
+    if (web->finalized) {
+        return 0;
+    }
+    finalizing = buf == NULL;
+    if (buf == NULL) {
+        bufsize = 0;
+    } else if (bufsize == 0 || bufsize >= MAXINT) {
+        bufsize = slen(buf);
+    }
+    if (web->buffer && !web->writingHeaders) {
+        if (buf) {
+            rPutBlockToBuf(web->buffer, buf, bufsize);
+            return (ssize) bufsize;
+        }
+        buf = rGetBufStart(web->buffer);
+        bufsize = rGetBufLength(web->buffer);
+        webSetContentLength(web, bufsize);
+    }
+#if ME_WEB_COMPRESS
+    if (!web->wroteHeaders && !web->deflate && web->route && web->route->compress) {
+        //  The response size is known if the first write is also the last
+        startCompress(web, web->txLen >= 0 ? web->txLen : (finalizing ? 0 : -1));
+    }
+    if (web->deflate) {
+        return compressOutput(web, buf, bufsize, finalizing ? Z_FINISH : web->deflateFlush);
+    }
+#endif
+    return writeOutput(web, buf, bufsize, finalizing);
+}
+
+/*
+    Write a block of output with the response headers (if not yet written) and chunk divider.
+ */
+static ssize writeOutput(Web *web, cvoid *buf, size_t bufsize, bool finalizing)
+{
+    RIOVec iov[3];
+    RBuf   *headers;
+    char   chunk[24];
+    ssize  written;
+    size_t chunkLen, corkLen;
+    bool   hold;
+
+    headers = 0;
+    if (!web->wroteHeaders) {
+        //  Headers are gathered with the body (and any chunk divider) and written together
+        if ((headers = formatHeaders(web)) == 0) {
+            return R_ERR_CANT_WRITE;
+        }
+        corkHeaders(web, headers);
+    }
+    if (web->head && bufsize > 0) {
+        // Non-finalizing head requests remit no body
+        webUpdateDeadline(web);
+        return 0;
+    }
+#if ME_WEB_HTTP2
+    if (web->stream) {
+        //  HTTP/2 frames the body so it is neither chunked nor corked
+        if (webWriteStream(web, buf, bufsize, finalizing) < 0) {
+            return R_ERR_CANT_WRITE;
+        }
+        if (bufsize > 0) {
+            traceBody(web, buf, bufsize);
+            web->txRemaining -= (ssize) bufsize;
+        }
+        webUpdateDeadline(web);
+        return (ssize) bufsize;
+    }
+#endif
+    chunkLen = formatChunkDivider(web, chunk, sizeof(chunk), bufsize);
+
+    /*
+        Cork the headers and first body output until finalized or more output is written.
+        Small responses are then emitted with a single write. If further pipelined requests are already buffered,
+        the finalized response is also held and written with the following responses.
+     */
+    corkLen = web->cork ? rGetBufLength(web->cork) : 0;
+    if (finalizing) {
+        hold = web->cork && isPipelined(web);
+    } else {
+        hold = headers && web->host->cork && bufsize > 0;
+    }
+    if (hold && corkLen + chunkLen + bufsize <= WEB_BUF_BOOST_4X) {
+        rPutBlockToBuf(web->cork, chunk, chunkLen);
+        rPutBlockToBuf(web->cork, buf, bufsize);
+    } else {
+        iov[0].base = web->cork ? rGetBufStart(web->cork) : 0;
+        iov[0].len = web->cork ? rGetBufLength(web->cork) : 0;
+        iov[1].base = chunk;
+        iov[1].len = chunkLen;
+        iov[2].base = buf;
+        iov[2].len = bufsize;
+        written = rWriteSocketv(web->sock, iov, 3, web->deadline);
+        rFreeBuf(web->cork);
+        web->cork = 0;
+        if (written < 0) {
+            return R_ERR_CANT_WRITE;
+        }
+    }
+    if (bufsize > 0) {
+        traceBody(web, buf, bufsize);
+        web->txRemaining -= (ssize) bufsize;
+    }
+    webUpdateDeadline(web);
+    return (ssize) bufsize;
+}
+
+#if ME_WEB_COMPRESS
+/*
+    Test if the response may be compressed. The size is the response length or -1 if unknown.
+ */
+PUBLIC bool webCanCompress(Web *web, cchar *mime, ssize size)
+{
+    WebRoute *route;
+    cchar    *prefix;
+    int      next;
+
+    route = web->route;
+    if (!route || !route->compress || !mime || web->head || web->http10) {
+        return 0;
+    }
+    if (!webAcceptsEncoding(web->acceptEncoding, "gzip")) {
+        return 0;
+    }
+    if (size >= 0 && size < route->compressMin) {
+        return 0;
+    }
+    for (ITERATE_ITEMS(route->compressMime, prefix, next)) {
+        if (sstarts(mime, prefix)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+    Start gzip compression of the response body if the route, client, status and mime type permit.
+    Compressed responses use chunked transfer encoding.
+ */
+static void startCompress(Web *web, ssize size)
 {
-    rAddDuplicateName(web->txHeaders, key, value, R_DYNAMIC_VALUE);
-}
+    z_stream *zs;
+    cchar    *mime;
 
-PUBLIC void webAddHeaderStaticString(Web *web, cchar *key, cchar *value)
-{
-    rAddDuplicateName(web->txHeaders, key, (void*) value, R_STATIC_VALUE);
+    /*
+        Static documents (with an ETag) are compressed once by the file cache rather than per request
+     */
+    if (web->status != 200 || rLookupName(web->txHeaders, "Content-Encoding") || rLookupName(web->txHeaders, "ETag")) {
+        return;
+    }
+    if ((mime = rLookupName(web->txHeaders, "Content-Type")) == 0) {
+        mime = web->mime ? web->mime : (web->ext ? rLookupName(web->host->mimeTypes, web->ext) : 0);
+    }
+    if (!webCanCompress(web, mime, size)) {
+        return;
+    }
+    zs = rAllocType(z_stream);
+    if (deflateInit2(zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        rFree(zs);
+        return;
+    }
+    web->deflate = zs;
+    //  Event streams are flushed on each write so events are not delayed. Otherwise output is flushed by webFlush.
+    web->deflateFlush = sstarts(mime, "text/event-stream") ? Z_SYNC_FLUSH : Z_NO_FLUSH;
+    web->txLen = -1;
+    webAddHeaderStaticString(web, "Content-Encoding", "gzip");
+    webAddHeaderStaticString(web, "Vary", "Origin, Accept-Encoding");
 }
 
 /*
-    Add an Access-Control-Allow-Origin response header necessary for CORS requests.
+    Compress output and write it. The flush mode is Z_NO_FLUSH to let deflate buffer small writes, Z_SYNC_FLUSH to
+    emit all compressed output for webFlush and streamed responses, or Z_FINISH to end the response.
+    Returns the number of uncompressed bytes consumed.
  */
-PUBLIC void webAddAccessControlHeader(Web *web)
+static ssize compressOutput(Web *web, cvoid *buf, size_t bufsize, int flush)
 {
-    char  *hostname;
-    cchar *schema, *contentEncoding;
+    z_stream *zs;
+    char     out[ME_BUFSIZE];
+    size_t   len;
+    int      rc;
 
-    /*
-        Check if Content-Encoding is set (pre-compressed content)
-        If so, include both Origin and Accept-Encoding in Vary header
-     */
-    if (!rLookupName(web->txHeaders, "Vary")) {
-        contentEncoding = rLookupName(web->txHeaders, "Content-Encoding");
-        if (contentEncoding) {
-            webAddHeaderStaticString(web, "Vary", "Origin, Accept-Encoding");
-        } else {
-            webAddHeaderStaticString(web, "Vary", "Origin");
+    zs = web->deflate;
+    zs->next_in = (Bytef*) buf;
+    zs->avail_in = (uInt) bufsize;
+    do {
+        zs->next_out = (Bytef*) out;
+        zs->avail_out = sizeof(out);
+        rc = deflate(zs, flush);
+        if (rc == Z_STREAM_ERROR) {
+            return R_ERR_CANT_WRITE;
+        }
+        len = sizeof(out) - zs->avail_out;
+        if (len > 0 && writeOutput(web, out, len, 0) < 0) {
+            return R_ERR_CANT_WRITE;
+        }
+    } while (zs->avail_out == 0 || (flush == Z_FINISH && rc != Z_STREAM_END));
+
+    if (flush == Z_FINISH) {
+        if (writeOutput(web, NULL, 0, 1) < 0) {
+            return R_ERR_CANT_WRITE;
         }
+        webFreeCompress(web);
     }
-    if (web->origin) {
-        webAddHeaderStaticString(web, "Access-Control-Allow-Origin", web->origin);
-    } else {
-        hostname = webGetHostName(web);
-        schema = web->sock->tls ? "https" : "http";
-        webAddHeader(web, "Access-Control-Allow-Origin", "%s://%s", schema, hostname);
-        rFree(hostname);
+    return (ssize) bufsize;
+}
+
+PUBLIC void webFreeCompress(Web *web)
+{
+    if (web->deflate) {
+        deflateEnd(web->deflate);
+        rFree(web->deflate);
+        web->deflate = 0;
     }
 }
+#endif /* ME_WEB_COMPRESS */
 
 /*
-    Write body data. Caller should set bufsize to zero to signify end of body
-    if the content length is not defined. webFinalize invokes webWrite with bufsize zero.
-    Will write headers if not alread written. Will close the socket on socket errors.
-    NOTE: this call will block the fiber in webWriteSocket until the data is written.
-    Other fibers continue to run while waiting for the data to drain.
+    Write corked output
  */
-PUBLIC ssize webWrite(Web *web, cvoid *buf, size_t bufsize)
+PUBLIC ssize webFlush(Web *web)
 {
-    ssize written;
+    ssize nbytes;
 
-    if (web->finalized) {
-        return 0;
-    }
-    if (buf == NULL) {
-        bufsize = 0;
-    } else if (bufsize == 0 || bufsize >= MAXINT) {
-        bufsize = slen(buf);
-    }
-    if (web->buffer && !web->writingHeaders) {
-        if (buf) {
-            rPutBlockToBuf(web->buffer, buf, bufsize);
-            return (ssize) bufsize;
-        }
-        buf = rGetBufStart(web->buffer);
-        bufsize = rGetBufLength(web->buffer);
-        webSetContentLength(web, bufsize);
-    }
-    if (!web->wroteHeaders && webWriteHeaders(web) < 0) {
-        //  Already closed
+#if ME_WEB_COMPRESS
+    //  Emit the compressed output buffered by deflate
+    if (web->deflate && compressOutput(web, NULL, 0, Z_SYNC_FLUSH) < 0) {
         return R_ERR_CANT_WRITE;
     }
-    if (web->head && !web->writingHeaders && bufsize > 0) {
-        // Non-finalizing head requests remit no body
-        webUpdateDeadline(web);
+#endif
+    if (!web->cork) {
         return 0;
     }
-    if (writeChunkDivider(web, bufsize) < 0) {
-        //  Already closed
+#if ME_WEB_HTTP2
+    if (web->stream) {
+        return webWriteStream(web, NULL, 0, 0);
+    }
+#endif
+    nbytes = rWriteSocket(web->sock, rGetBufStart(web->cork), rGetBufLength(web->cork), web->deadline);
+    rFreeBuf(web->cork);
+    web->cork = 0;
+    if (nbytes < 0) {
         return R_ERR_CANT_WRITE;
     }
-    if (bufsize > 0) {
-        if ((written = rWriteSocket(web->sock, buf, bufsize, web->deadline)) < 0) {
-            return R_ERR_CANT_WRITE;
-        }
-        if (web->wroteHeaders && web->host->flags & WEB_SHOW_RESP_BODY) {
-            if (isprintable(buf, (size_t) written)) {
-                if (web->moreBody) {
-                    write(rGetLogFile(), (char*) buf, (uint) written);
-                } else {
-                    rLog("raw", "web", "Response Body >>>>\n\n%*s", (int) written, (char*) buf);
-                    web->moreBody = 1;
-                }
+    webUpdateDeadline(web);
+    return nbytes;
+}
+
+static void traceBody(Web *web, cvoid *buf, size_t len)
+{
+    if (web->host->flags & WEB_SHOW_RESP_BODY) {
+        if (isprintable(buf, len)) {
+            if (web->moreBody) {
+                write(rGetLogFile(), (char*) buf, (uint) len);
+            } else {
+                rLog("raw", "web", "Response Body >>>>\n\n%*s", (int) len, (char*) buf);
+                web->moreBody = 1;
             }
         }
-        if (web->wroteHeaders) {
-            web->txRemaining -= written;
-        }
-    } else {
-        written = 0;
     }
-    webUpdateDeadline(web);
-    return written;
 }
 
 /*
@@ -4745,24 +7644,18 @@ PUBLIC ssize webWriteJson(Web *web, const Json *json)
 }
 
 /*
-    Write a transfer-chunk encoded divider if required
+    Format a transfer-chunk encoded divider if required. Returns the length of the divider.
  */
-static int writeChunkDivider(Web *web, size_t size)
+static size_t formatChunkDivider(Web *web, char *chunk, size_t chunkSize, size_t size)
 {
-    char chunk[24];
-
     if (web->txLen >= 0 || !web->wroteHeaders || web->upgraded) {
         return 0;
     }
     if (size == 0) {
-        scopy(chunk, sizeof(chunk), "\r\n0\r\n\r\n");
-    } else {
-        sfmtbuf(chunk, sizeof(chunk), "\r\n%zx\r\n", size);
+        return (size_t) scopy(chunk, chunkSize, "\r\n0\r\n\r\n");
     }
-    if (rWriteSocket(web->sock, chunk, slen(chunk), web->deadline) < 0) {
-        return webNetError(web, "Cannot write to socket");
-    }
-    return 0;
+    sfmtbuf(chunk, chunkSize, "\r\n%zx\r\n", size);
+    return slen(chunk);
 }
 
 /*
@@ -4809,12 +7702,13 @@ PUBLIC ssize webWriteResponseString(Web *web, int status, cchar *msg)
 
     webAddHeaderStaticString(web, "Content-Type", "text/plain");
 
-    if (webWriteHeaders(web) < 0) {
+    if (web->status != 204 && !web->head && web->txLen > 0) {
+        //  Headers are written with the body
+        (void) webWrite(web, msg, (size_t) web->txLen);
+        rc = webFinalize(web);
+    } else if (webWriteHeaders(web) < 0) {
         rc = R_ERR_CANT_WRITE;
     } else {
-        if (web->status != 204 && !web->head && web->txLen > 0) {
-            (void) webWrite(web, msg, (size_t) web->txLen);
-        }
         rc = webFinalize(web);
     }
     if (status != 200 && status != 201 && status != 204 && status != 301 && status != 302 && status != 401) {
@@ -5022,7 +7916,16 @@ PUBLIC int webNetError(Web *web, cchar *fmt, ...)
     }
     web->status = 550;
     va_end(args);
+#if ME_WEB_HTTP2
+    if (web->stream) {
+        //  Reset the stream rather than closing the connection shared with other streams
+        webResetStream(web);
+    } else {
+        rCloseSocket(web->sock);
+    }
+#else
     rCloseSocket(web->sock);
+#endif
     webHook(web, WEB_HOOK_ERROR);
     return R_ERR_CANT_COMPLETE;
 }
@@ -5068,7 +7971,11 @@ static bool isprintable(cchar *s, size_t len)
     When a subsequent POST|PUT|DELETE request is made, http.c:handleRequest will call webCheckSecurityToken to
     check the XSRF token.
 
-    Clients
+    Sessions are indexed by ID in host->sessions and are also linked into a list ordered by expiry time.
+    Touching a session moves it to the tail of the list, so pruning only visits expired sessions at the head.
+
+    If a session store is defined via webSetSessionStore, sessions are written through to the store when their
+    variables change and are loaded from the store when not found in memory. This permits sessions to survive restarts.
 
     Copyright (c) All Rights Reserved. See copyright notice at the bottom of the file.
  */
@@ -5085,7 +7992,13 @@ static bool isprintable(cchar *s, size_t len)
 /*********************************** Forwards *********************************/
 
 static WebSession *createSession(Web *web);
+static void linkSession(WebHost *host, WebSession *sp);
+static WebSession *loadSession(Web *web, cchar *id);
 static void pruneSessions(WebHost *host);
+static void removeSession(WebHost *host, WebSession *sp, bool store);
+static void saveSession(WebHost *host, WebSession *sp);
+static void touchSession(WebHost *host, WebSession *sp);
+static void unlinkSession(WebHost *host, WebSession *sp);
 
 /************************************ Locals **********************************/
 
@@ -5095,29 +8008,42 @@ PUBLIC int webInitSessions(WebHost *host)
     return 0;
 }
 
-static WebSession *webAllocSession(Web *web, int lifespan)
+PUBLIC void webSetSessionStore(WebHost *host, WebSessionStore *store)
+{
+    assert(host);
+
+    host->sessionStore = store;
+}
+
+/*
+    Allocate a session and add to the host session index and expiry list.
+    If the id is null, a new session ID is generated.
+ */
+static WebSession *webAllocSession(WebHost *host, cchar *id, int lifespan, Ticks expires)
 {
     WebSession *sp;
 
-    assert(web);
+    assert(host);
 
     if ((sp = rAllocType(WebSession)) == 0) {
         return 0;
     }
     sp->lifespan = lifespan;
-    sp->expires = rGetTicks() + lifespan;
-    sp->id = cryptID(32);
+    sp->expires = expires;
+    sp->id = id ? sclone(id) : cryptID(32);
 
     if ((sp->cache = rAllocHash(0, 0)) == 0) {
         rFree(sp->id);
         rFree(sp);
         return 0;
     }
-    if (rAddName(web->host->sessions, sp->id, sp, 0) == 0) {
+    if (rAddName(host->sessions, sp->id, sp, 0) == 0) {
+        rFreeHash(sp->cache);
         rFree(sp->id);
         rFree(sp);
         return 0;
     }
+    linkSession(host, sp);
     return sp;
 }
 
@@ -5139,10 +8065,25 @@ PUBLIC void webDestroySession(Web *web)
 
     if ((session = webGetSession(web, 0)) != 0) {
         webSetCookie(web, web->host->sessionCookie, NULL, "/", 0, 0);
-        rRemoveName(web->host->sessions, session->id);
-        webFreeSession(session);
+        removeSession(web->host, session, 1);
+        web->session = 0;
+    }
+}
+
+/*
+    Free all in-memory sessions. Sessions are retained in the session store (if any).
+ */
+PUBLIC void webFlushSessions(WebHost *host)
+{
+    Web *web;
+    int next;
+
+    for (ITERATE_ITEMS(host->webs, web, next)) {
         web->session = 0;
     }
+    while (host->sessionFirst) {
+        removeSession(host, host->sessionFirst, 0);
+    }
 }
 
 PUBLIC WebSession *webCreateSession(Web *web)
@@ -5166,7 +8107,9 @@ WebSession *webGetSession(Web *web, int create)
     if (!session) {
         id = webParseCookie(web, web->host->sessionCookie);
         if (id) {
-            session = rLookupName(web->host->sessions, id);
+            if ((session = rLookupName(web->host->sessions, id)) == 0) {
+                session = loadSession(web, id);
+            }
             rFree(id);
         }
         if (!session && create) {
@@ -5175,7 +8118,7 @@ WebSession *webGetSession(Web *web, int create)
         web->session = session;
     }
     if (session) {
-        session->expires = rGetTicks() + session->lifespan;
+        touchSession(web->host, session);
     }
     return session;
 }
@@ -5193,7 +8136,7 @@ static WebSession *createSession(Web *web)
         webError(web, 429, "Failed to create session");
         return 0;
     }
-    if ((session = webAllocSession(web, host->sessionTimeout)) == 0) {
+    if ((session = webAllocSession(host, 0, host->sessionTimeout, rGetTicks() + host->sessionTimeout)) == 0) {
         webError(web, 429, "Failed to create session");
         return 0;
     }
@@ -5261,7 +8204,9 @@ PUBLIC void webRemoveSessionVar(Web *web, cchar *key)
     assert(key && *key);
 
     if ((sp = webGetSession(web, 0)) != 0) {
-        rRemoveName(sp->cache, key);
+        if (rRemoveName(sp->cache, key) == 0) {
+            saveSession(web->host, sp);
+        }
     }
 }
 
@@ -5290,38 +8235,25 @@ PUBLIC cchar *webSetSessionVar(Web *web, cchar *key, cchar *fmt, ...)
     if ((np = rAddName(sp->cache, key, (void*) value, R_DYNAMIC_VALUE)) == 0) {
         return 0;
     }
+    saveSession(web->host, sp);
     return np->value;
 }
 
 /*
     Remove expired sessions. Timeout is set in web.json.
+    The expiry list is ordered so only the expired sessions at the head are visited.
  */
 static void pruneSessions(WebHost *host)
 {
-    WebSession *sp;
-    Ticks      when;
-    RName      *np;
-    RList      *expired;
-    int        count, oldCount, next;
+    Ticks when;
+    int   count, oldCount;
 
     when = rGetTicks();
     oldCount = rGetHashLength(host->sessions);
 
-    //  Collect expired sessions first to avoid modifying hash during iteration
-    expired = rAllocList(0, 0);
-    for (ITERATE_NAMES(host->sessions, np)) {
-        sp = (WebSession*) np->value;
-        if (sp->expires <= when) {
-            rAddItem(expired, sp);
-        }
-    }
-    //  Now remove and free the expired sessions
-    for (ITERATE_ITEMS(expired, sp, next)) {
-        rRemoveName(host->sessions, sp->id);
-        webFreeSession(sp);
+    while (host->sessionFirst && host->sessionFirst->expires <= when) {
+        removeSession(host, host->sessionFirst, 1);
     }
-    rFreeList(expired);
-
     count = rGetHashLength(host->sessions);
     if (oldCount != count || count) {
         rDebug("session", "Prune %d sessions. Remaining: %d", oldCount - count, count);
@@ -5329,6 +8261,148 @@ static void pruneSessions(WebHost *host)
     host->sessionEvent = rStartEvent((REventProc) pruneSessions, host, WEB_SESSION_PRUNE);
 }
 
+/*
+    Remove a session from memory and optionally from the session store
+ */
+static void removeSession(WebHost *host, WebSession *sp, bool store)
+{
+    if (store && host->sessionStore) {
+        host->sessionStore->remove(host->sessionStore, sp->id);
+    }
+    unlinkSession(host, sp);
+    rRemoveName(host->sessions, sp->id);
+    webFreeSession(sp);
+}
+
+/*
+    Insert a session into the expiry list. Sessions usually expire last, so search backwards from the tail.
+ */
+static void linkSession(WebHost *host, WebSession *sp)
+{
+    WebSession *prior;
+
+    for (prior = host->sessionLast; prior && prior->expires > sp->expires; prior = prior->prev) {
+        ;
+    }
+    sp->prev = prior;
+    if (prior) {
+        sp->next = prior->next;
+        prior->next = sp;
+    } else {
+        sp->next = host->sessionFirst;
+        host->sessionFirst = sp;
+    }
+    if (sp->next) {
+        sp->next->prev = sp;
+    } else {
+        host->sessionLast = sp;
+    }
+}
+
+static void unlinkSession(WebHost *host, WebSession *sp)
+{
+    if (sp->prev) {
+        sp->prev->next = sp->next;
+    } else {
+        host->sessionFirst = sp->next;
+    }
+    if (sp->next) {
+        sp->next->prev = sp->prev;
+    } else {
+        host->sessionLast = sp->prev;
+    }
+    sp->prev = sp->next = 0;
+}
+
+/*
+    Extend the session expiry and move to the end of the expiry list.
+    The store copy is refreshed once it has aged more than half the session lifespan.
+ */
+static void touchSession(WebHost *host, WebSession *sp)
+{
+    sp->expires = rGetTicks() + sp->lifespan;
+    if (sp != host->sessionLast) {
+        unlinkSession(host, sp);
+        linkSession(host, sp);
+    }
+    if (host->sessionStore && (sp->expires - sp->saved) > sp->lifespan / 2) {
+        saveSession(host, sp);
+    }
+}
+
+/*
+    Write the session variables to the session store as a JSON object
+ */
+static void saveSession(WebHost *host, WebSession *sp)
+{
+    WebSessionStore *store;
+    RBuf            *buf;
+    RName           *np;
+
+    if ((store = host->sessionStore) == 0) {
+        return;
+    }
+    buf = rAllocBuf(0);
+    rPutCharToBuf(buf, '{');
+    for (ITERATE_NAMES(sp->cache, np)) {
+        if (rGetBufLength(buf) > 1) {
+            rPutCharToBuf(buf, ',');
+        }
+        jsonPutValueToBuf(buf, np->name, JSON_JSON);
+        rPutCharToBuf(buf, ':');
+        jsonPutValueToBuf(buf, np->value, JSON_JSON);
+    }
+    rPutCharToBuf(buf, '}');
+    if (store->save(store, sp->id, rBufToString(buf), rGetTime() + (sp->expires - rGetTicks())) < 0) {
+        rError("session", "Cannot save session to the session store");
+    } else {
+        sp->saved = sp->expires;
+    }
+    rFreeBuf(buf);
+}
+
+/*
+    Load a session from the session store. Expired sessions are removed from the store.
+ */
+static WebSession *loadSession(Web *web, cchar *id)
+{
+    WebHost         *host;
+    WebSessionStore *store;
+    WebSession      *sp;
+    JsonNode        *child;
+    Json            *json;
+    Time            expires, now;
+    char            *data;
+
+    host = web->host;
+    if ((store = host->sessionStore) == 0) {
+        return 0;
+    }
+    if ((data = store->load(store, id, &expires)) == 0) {
+        return 0;
+    }
+    sp = 0;
+    now = rGetTime();
+    if (expires <= now) {
+        store->remove(store, id);
+
+    } else if (rGetHashLength(host->sessions) >= host->maxSessions) {
+        rError("session", "Too many sessions to load session from the session store");
+
+    } else if ((json = jsonParse(data, 0)) != 0) {
+        sp = webAllocSession(host, id, host->sessionTimeout, rGetTicks() + (expires - now));
+        if (sp) {
+            for (ITERATE_JSON(json, NULL, child, nid)) {
+                rAddName(sp->cache, child->name, sclone(child->value), R_TEMPORAL_NAME | R_DYNAMIC_VALUE);
+            }
+            sp->saved = sp->expires;
+        }
+        jsonFree(json);
+    }
+    rFree(data);
+    return sp;
+}
+
 /*
     Get a security token to use to mitiate CSRF threats and store it in the session state.
     This will create a security token and save it in session state.
@@ -5684,6 +8758,16 @@ static int addHeaders(Web *web)
 static void showRequestContext(Web *web, Json *json);
 static void showServerContext(Web *web, Json *json);
 
+static char *loadTestSession(WebSessionStore *store, cchar *id, Time *expires);
+static void removeTestSession(WebSessionStore *store, cchar *id);
+static int saveTestSession(WebSessionStore *store, cchar *id, cchar *data, Time expires);
+
+/*
+    In-memory session store that outlives webFlushSessions to emulate a persistent store.
+    The store is only installed while enabled via /test/session/store/enable so other tests use the built-in sessions.
+ */
+static WebSessionStore testSessionStore = { loadTestSession, saveTestSession, removeTestSession, NULL };
+
 /************************************* Code ***********************************/
 
 static void showRequest(Web *web)
@@ -5719,6 +8803,17 @@ static void showRequest(Web *web)
         jsonSetFmt(json, 0, SFMT(keybuf, "headers.%s", key), "%s", value);
     }
 
+    /*
+        Indexed header lookups and pre-resolved headers
+     */
+    key = value = 0;
+    while (webGetNextHeader(web, &key, &value)) {
+        jsonSetFmt(json, 0, SFMT(keybuf, "lookup.%s", key), "%s", webGetHeader(web, key));
+    }
+    if (web->hostHeader) {
+        jsonSetFmt(json, 0, "hostHeader", "%s", web->hostHeader);
+    }
+
     /*
         Form vars
      */
@@ -5843,6 +8938,13 @@ static void showServerContext(Web *web, Json *json)
     jsonSetFmt(json, 0, "host.maxHeader", "%lld", host->maxHeader);
     jsonSetFmt(json, 0, "host.maxSessions", "%lld", host->maxSessions);
     jsonSetFmt(json, 0, "host.maxUpload", "%lld", host->maxUpload);
+    jsonSetFmt(json, 0, "host.pool", "%d", rGetListLength(host->pool));
+    jsonSetFmt(json, 0, "host.maxPool", "%d", host->maxPool);
+    jsonSetFmt(json, 0, "host.poolHits", "%lld", host->poolHits);
+    jsonSetFmt(json, 0, "host.poolMisses", "%lld", host->poolMisses);
+    jsonSetFmt(json, 0, "host.cacheFiles", "%d", rGetListLength(host->fileOrder));
+    jsonSetFmt(json, 0, "host.cacheSize", "%lld", (int64) host->cacheSize);
+    jsonSetFmt(json, 0, "host.maxCache", "%lld", (int64) host->maxCache);
 }
 
 /*
@@ -5885,11 +8987,21 @@ static void errorAction(Web *web)
     webWriteResponseString(web, 200, "error\n");
 }
 
+/*
+    Respond after a delay to emulate an action that waits on another service
+ */
+static void delayAction(Web *web)
+{
+    rSleep(stoi(webGetQueryVar(web, "delay", "1000")));
+    webWriteResponseString(web, 200, "delayed\n");
+}
+
 static void bulkOutput(Web *web)
 {
     ssize count, i;
 
     count = stoi(webGetVar(web, "count", "100"));
+    webAddHeaderStaticString(web, "Content-Type", "text/plain");
     for (i = 0; i < count; i++) {
         webWriteFmt(web, "Hello World %010d\n", i);
     }
@@ -5935,6 +9047,21 @@ static void bufferAction(Web *web)
     webFinalize(web);
 }
 
+#if ME_WEB_SPLICE
+/*
+    Set the maximum PUT body bytes to splice per request: /test/splice?limit=N. Zero restores the default.
+    Used to force the buffered fallback after a short splice.
+ */
+static void spliceAction(Web *web)
+{
+    ssize limit;
+
+    limit = (ssize) stoi(webGetQueryVar(web, "limit", "0"));
+    webSetSpliceLimit(limit);
+    webWriteResponse(web, 200, "%lld\n", (int64) limit);
+}
+#endif
+
 static void sigAction(Web *web)
 {
     // Pretend to be authenticated with "user" role
@@ -5999,6 +9126,40 @@ static void cookieAction(Web *web)
 }
 
 
+/*
+    Test session store. Sessions are saved as "expires:data" strings.
+ */
+static char *loadTestSession(WebSessionStore *store, cchar *id, Time *expires)
+{
+    cchar *value;
+    char  *data;
+
+    if ((value = rLookupName(store->arg, id)) == 0) {
+        return 0;
+    }
+    if ((*expires = stoi(value)) < rGetTime()) {
+        rRemoveName(store->arg, id);
+        return 0;
+    }
+    if ((data = schr(value, ':')) == 0) {
+        return 0;
+    }
+    return sclone(&data[1]);
+}
+
+static int saveTestSession(WebSessionStore *store, cchar *id, cchar *data, Time expires)
+{
+    if (rAddName(store->arg, id, sfmt("%lld:%s", expires, data), R_DYNAMIC_VALUE) == 0) {
+        return R_ERR_MEMORY;
+    }
+    return 0;
+}
+
+static void removeTestSession(WebSessionStore *store, cchar *id)
+{
+    rRemoveName(store->arg, id);
+}
+
 static void sessionAction(Web *web)
 {
     cchar *sessionToken;
@@ -6025,6 +9186,26 @@ static void sessionAction(Web *web)
             webWriteFmt(web, "token mismatch");
         }
 
+    } else if (smatch(web->path, "/test/session/flush")) {
+        /*
+            Free in-memory sessions to emulate a restart. Sessions are reloaded from the test session store.
+         */
+        webFlushSessions(web->host);
+        webWriteFmt(web, "flushed");
+
+    } else if (smatch(web->path, "/test/session/store/enable")) {
+        if (!testSessionStore.arg) {
+            testSessionStore.arg = rAllocHash(0, R_TEMPORAL_NAME);
+        }
+        webSetSessionStore(web->host, &testSessionStore);
+        webWriteFmt(web, "enabled");
+
+    } else if (smatch(web->path, "/test/session/store/disable")) {
+        webSetSessionStore(web->host, NULL);
+        rFreeHash(testSessionStore.arg);
+        testSessionStore.arg = 0;
+        webWriteFmt(web, "disabled");
+
     } else if (smatch(web->path, "/test/session/form.html")) {
         /*
            if (web->get) {
@@ -6169,6 +9350,7 @@ PUBLIC void webTestInit(WebHost *host, cchar *prefix)
     webAddAction(host, SFMT(url, "%s/event", prefix), eventAction, NULL);
     webAddAction(host, SFMT(url, "%s/form", prefix), formAction, NULL);
     webAddAction(host, SFMT(url, "%s/bulk", prefix), bulkOutput, NULL);
+    webAddAction(host, SFMT(url, "%s/delay", prefix), delayAction, NULL);
     webAddAction(host, SFMT(url, "%s/error", prefix), errorAction, NULL);
     webAddAction(host, SFMT(url, "%s/success", prefix), successAction, NULL);
     webAddAction(host, SFMT(url, "%s/bench", prefix), successAction, NULL);
@@ -6187,6 +9369,9 @@ PUBLIC void webTestInit(WebHost *host, cchar *prefix)
     webAddAction(host, SFMT(url, "%s/sig", prefix), sigAction, NULL);
     webAddAction(host, SFMT(url, "%s/buffer", prefix), bufferAction, NULL);
     webAddAction(host, SFMT(url, "%s/recurse", prefix), recurseAction, NULL);
+#if ME_WEB_SPLICE
+    webAddAction(host, SFMT(url, "%s/splice", prefix), spliceAction, NULL);
+#endif
 #if ME_WEB_FIBER_BLOCKS
     webAddAction(host, SFMT(url, "%s/crash/null", prefix), crashNullAction, NULL);
     webAddAction(host, SFMT(url, "%s/crash/divide", prefix), crashDivideAction, NULL);
@@ -590,9 +590,10 @@ PUBLIC ssize webSocketSendBlock(WebSocket *ws, int type, cchar *buf, size_t len)
 
 static int writeFrame(WebSocket *ws, int type, int fin, cuchar *buf, size_t len)
 {
-    uchar *pp, prefix[16];
-    uchar *op, dataMask[4], *tbuf;
-    int   i, mask;
+    RIOVec iov[2];
+    uchar  *pp, prefix[16];
+    uchar  *op, dataMask[4], *tbuf;
+    int    i, mask;
 
     if (type < 0 || type > WS_MSG_MAX) {
         wsError(ws, 0, "Bad WebSocket packet type %d", type);
@@ -632,14 +633,12 @@ static int writeFrame(WebSocket *ws, int type, int fin, cuchar *buf, size_t len)
         buf = tbuf;
     }
     *pp = '\0';
-    if (rWriteSocket(ws->sock, prefix, (size_t) (pp - prefix), ws->deadline) < 0) {
-        if (type != WS_MSG_CLOSE) {
-            wsError(ws, 0, "Cannot write to socket");
-        }
-        rFree(tbuf);
-        return R_ERR_CANT_WRITE;
-    }
-    if (rWriteSocket(ws->sock, buf, len, ws->deadline) < 0) {
+    //  Write the frame header and payload with a single gathered write
+    iov[0].base = prefix;
+    iov[0].len = (size_t) (pp - prefix);
+    iov[1].base = buf;
+    iov[1].len = len;
+    if (rWriteSocketv(ws->sock, iov, 2, ws->deadline) < 0) {
         if (type != WS_MSG_CLOSE) {
             wsError(ws, 0, "Cannot write to socket");
         }
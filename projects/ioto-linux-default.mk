@@ -95,11 +95,12 @@ ME_WEB_AUTH           ?= 1
 ME_WEB_LIMITS         ?= 1
 ME_WEB_SESSIONS       ?= 1
 ME_WEB_UPLOAD         ?= 1
+ME_WEB_COMPRESS       ?= 0
 ME_WEB_GROUP          ?= \"$(WEB_GROUP)\"
 ME_WEB_USER           ?= \"$(WEB_USER)\"
 
 CFLAGS                += -Wno-unused-result -Wall -fstack-protector --param=ssp-buffer-size=4 -Wformat -Wformat-security -Wsign-compare -Wsign-conversion -Wl,-z,relro,-z,now -Wl,--as-needed -Wl,--no-copy-dt-needed-entries -Wl,-z,noexecheap -Wl,--no-warn-execstack -pie -fPIE
-DFLAGS                +=  $(patsubst %,-D%,$(filter ME_%,$(MAKEFLAGS))) "-DME_COM_COMPILER=$(ME_COM_COMPILER)" "-DME_COM_LIB=$(ME_COM_LIB)" "-DME_COM_MBEDTLS=$(ME_COM_MBEDTLS)" "-DME_COM_OPENSSL=$(ME_COM_OPENSSL)" "-DME_COM_SSL=$(ME_COM_SSL)" "-DME_COM_VXWORKS=$(ME_COM_VXWORKS)" "-DME_COM_CRYPT=$(ME_COM_CRYPT)" "-DME_COM_DB=$(ME_COM_DB)" "-DME_COM_JSON=$(ME_COM_JSON)" "-DME_COM_MQTT=$(ME_COM_MQTT)" "-DME_COM_OPENAI=$(ME_COM_OPENAI)" "-DME_COM_R=$(ME_COM_R)" "-DME_COM_UCTX=$(ME_COM_UCTX)" "-DME_COM_URL=$(ME_COM_URL)" "-DME_COM_WEB=$(ME_COM_WEB)" "-DME_COM_WEBSOCK=$(ME_COM_WEBSOCK)" "-DME_WEB_AUTH=$(ME_WEB_AUTH)" "-DME_WEB_LIMITS=$(ME_WEB_LIMITS)" "-DME_WEB_SESSIONS=$(ME_WEB_SESSIONS)" "-DME_WEB_UPLOAD=$(ME_WEB_UPLOAD)" 
+DFLAGS                +=  $(patsubst %,-D%,$(filter ME_%,$(MAKEFLAGS))) "-DME_COM_COMPILER=$(ME_COM_COMPILER)" "-DME_COM_LIB=$(ME_COM_LIB)" "-DME_COM_MBEDTLS=$(ME_COM_MBEDTLS)" "-DME_COM_OPENSSL=$(ME_COM_OPENSSL)" "-DME_COM_SSL=$(ME_COM_SSL)" "-DME_COM_VXWORKS=$(ME_COM_VXWORKS)" "-DME_COM_CRYPT=$(ME_COM_CRYPT)" "-DME_COM_DB=$(ME_COM_DB)" "-DME_COM_JSON=$(ME_COM_JSON)" "-DME_COM_MQTT=$(ME_COM_MQTT)" "-DME_COM_OPENAI=$(ME_COM_OPENAI)" "-DME_COM_R=$(ME_COM_R)" "-DME_COM_UCTX=$(ME_COM_UCTX)" "-DME_COM_URL=$(ME_COM_URL)" "-DME_COM_WEB=$(ME_COM_WEB)" "-DME_COM_WEBSOCK=$(ME_COM_WEBSOCK)" "-DME_WEB_AUTH=$(ME_WEB_AUTH)" "-DME_WEB_LIMITS=$(ME_WEB_LIMITS)" "-DME_WEB_SESSIONS=$(ME_WEB_SESSIONS)" "-DME_WEB_UPLOAD=$(ME_WEB_UPLOAD)" "-DME_WEB_COMPRESS=$(ME_WEB_COMPRESS)" 
 IFLAGS                += "-I$(BUILD)/inc"
 LDFLAGS               += 
 LIBPATHS              += "-L$(BUILD)/bin"
@@ -887,6 +888,9 @@ endif
 ifeq ($(ME_COM_OPENSSL),1)
     LIBS_56 += -lcrypto
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_56 += -lz
+endif
 
 $(BUILD)/bin/db: $(DEPS_56)
 	@echo '      [Link] $(BUILD)/bin/db'
@@ -918,6 +922,9 @@ endif
 ifeq ($(ME_COM_OPENSSL),1)
     LIBS_57 += -lcrypto
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_57 += -lz
+endif
 
 $(BUILD)/bin/ioto: $(DEPS_57)
 	@echo '      [Link] $(BUILD)/bin/ioto'
@@ -949,6 +956,9 @@ endif
 ifeq ($(ME_COM_OPENSSL),1)
     LIBS_58 += -lcrypto
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_58 += -lz
+endif
 
 $(BUILD)/bin/json: $(DEPS_58)
 	@echo '      [Link] $(BUILD)/bin/json'
@@ -980,6 +990,9 @@ endif
 ifeq ($(ME_COM_OPENSSL),1)
     LIBS_59 += -lcrypto
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_59 += -lz
+endif
 
 $(BUILD)/bin/password: $(DEPS_59)
 	@echo '      [Link] $(BUILD)/bin/password'
@@ -1011,6 +1024,9 @@ endif
 ifeq ($(ME_COM_OPENSSL),1)
     LIBS_60 += -lcrypto
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_60 += -lz
+endif
 
 $(BUILD)/bin/url: $(DEPS_60)
 	@echo '      [Link] $(BUILD)/bin/url'
@@ -1042,6 +1058,9 @@ endif
 ifeq ($(ME_COM_OPENSSL),1)
     LIBS_61 += -lcrypto
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_61 += -lz
+endif
 
 $(BUILD)/bin/web: $(DEPS_61)
 	@echo '      [Link] $(BUILD)/bin/web'
@@ -100,12 +100,13 @@ ME_WEB_AUTH           ?= 1
 ME_WEB_LIMITS         ?= 1
 ME_WEB_SESSIONS       ?= 1
 ME_WEB_UPLOAD         ?= 1
+ME_WEB_COMPRESS       ?= 0
 ME_WEB_GROUP          ?= \"$(WEB_GROUP)\"
 ME_WEB_USER           ?= \"$(WEB_USER)\"
 
 export PATH           := $(WIND_GNU_PATH)/$(WIND_HOST_TYPE)/bin:$(PATH)
 CFLAGS                += -fomit-frame-pointer -fno-builtin -fno-defer-pop -fvolatile
-DFLAGS                += -DCPU=ARMARCH7 -DRW_MULTI_THREAD -DTOOL=gnu -DTOOL_FAMILY=gnu -DVXWORKS -D_GNU_TOOL -D_VSB_CONFIG_FILE=\"/WindRiver/vxworks-7/samples/prebuilt_projects/vsb_vxsim_linux/h/config/vsbConfig.h" -D_WRS_KERNEL_ $(patsubst %,-D%,$(filter ME_%,$(MAKEFLAGS))) "-DME_COM_COMPILER=$(ME_COM_COMPILER)" "-DME_COM_LIB=$(ME_COM_LIB)" "-DME_COM_LINK=$(ME_COM_LINK)" "-DME_COM_MBEDTLS=$(ME_COM_MBEDTLS)" "-DME_COM_OPENSSL=$(ME_COM_OPENSSL)" "-DME_COM_SSL=$(ME_COM_SSL)" "-DME_COM_VXWORKS=$(ME_COM_VXWORKS)" "-DME_COM_CRYPT=$(ME_COM_CRYPT)" "-DME_COM_DB=$(ME_COM_DB)" "-DME_COM_JSON=$(ME_COM_JSON)" "-DME_COM_MQTT=$(ME_COM_MQTT)" "-DME_COM_OPENAI=$(ME_COM_OPENAI)" "-DME_COM_R=$(ME_COM_R)" "-DME_COM_UCTX=$(ME_COM_UCTX)" "-DME_COM_URL=$(ME_COM_URL)" "-DME_COM_WEB=$(ME_COM_WEB)" "-DME_COM_WEBSOCK=$(ME_COM_WEBSOCK)" "-DME_WEB_AUTH=$(ME_WEB_AUTH)" "-DME_WEB_LIMITS=$(ME_WEB_LIMITS)" "-DME_WEB_SESSIONS=$(ME_WEB_SESSIONS)" "-DME_WEB_UPLOAD=$(ME_WEB_UPLOAD)" 
+DFLAGS                += -DCPU=ARMARCH7 -DRW_MULTI_THREAD -DTOOL=gnu -DTOOL_FAMILY=gnu -DVXWORKS -D_GNU_TOOL -D_VSB_CONFIG_FILE=\"/WindRiver/vxworks-7/samples/prebuilt_projects/vsb_vxsim_linux/h/config/vsbConfig.h" -D_WRS_KERNEL_ $(patsubst %,-D%,$(filter ME_%,$(MAKEFLAGS))) "-DME_COM_COMPILER=$(ME_COM_COMPILER)" "-DME_COM_LIB=$(ME_COM_LIB)" "-DME_COM_LINK=$(ME_COM_LINK)" "-DME_COM_MBEDTLS=$(ME_COM_MBEDTLS)" "-DME_COM_OPENSSL=$(ME_COM_OPENSSL)" "-DME_COM_SSL=$(ME_COM_SSL)" "-DME_COM_VXWORKS=$(ME_COM_VXWORKS)" "-DME_COM_CRYPT=$(ME_COM_CRYPT)" "-DME_COM_DB=$(ME_COM_DB)" "-DME_COM_JSON=$(ME_COM_JSON)" "-DME_COM_MQTT=$(ME_COM_MQTT)" "-DME_COM_OPENAI=$(ME_COM_OPENAI)" "-DME_COM_R=$(ME_COM_R)" "-DME_COM_UCTX=$(ME_COM_UCTX)" "-DME_COM_URL=$(ME_COM_URL)" "-DME_COM_WEB=$(ME_COM_WEB)" "-DME_COM_WEBSOCK=$(ME_COM_WEBSOCK)" "-DME_WEB_AUTH=$(ME_WEB_AUTH)" "-DME_WEB_LIMITS=$(ME_WEB_LIMITS)" "-DME_WEB_SESSIONS=$(ME_WEB_SESSIONS)" "-DME_WEB_UPLOAD=$(ME_WEB_UPLOAD)" "-DME_WEB_COMPRESS=$(ME_WEB_COMPRESS)" 
 IFLAGS                += "-I$(BUILD)/inc"
 LDFLAGS               += "-Wl,-r"
 LIBPATHS              += "-L$(BUILD)/bin"
@@ -888,6 +889,9 @@ ifeq ($(ME_COM_OPENSSL),1)
     LIBPATHS_56 += -L"$(ME_COM_OPENSSL_PATH)/lib"
     LIBPATHS_56 += -L"$(ME_COM_OPENSSL_PATH)"
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_56 += -lz
+endif
 
 $(BUILD)/bin/db.out: $(DEPS_56)
 	@echo '      [Link] $(BUILD)/bin/db.out'
@@ -912,6 +916,9 @@ ifeq ($(ME_COM_OPENSSL),1)
     LIBPATHS_57 += -L"$(ME_COM_OPENSSL_PATH)/lib"
     LIBPATHS_57 += -L"$(ME_COM_OPENSSL_PATH)"
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_57 += -lz
+endif
 
 $(BUILD)/bin/ioto.out: $(DEPS_57)
 	@echo '      [Link] $(BUILD)/bin/ioto.out'
@@ -936,6 +943,9 @@ ifeq ($(ME_COM_OPENSSL),1)
     LIBPATHS_58 += -L"$(ME_COM_OPENSSL_PATH)/lib"
     LIBPATHS_58 += -L"$(ME_COM_OPENSSL_PATH)"
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_58 += -lz
+endif
 
 $(BUILD)/bin/json.out: $(DEPS_58)
 	@echo '      [Link] $(BUILD)/bin/json.out'
@@ -960,6 +970,9 @@ ifeq ($(ME_COM_OPENSSL),1)
     LIBPATHS_59 += -L"$(ME_COM_OPENSSL_PATH)/lib"
     LIBPATHS_59 += -L"$(ME_COM_OPENSSL_PATH)"
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_59 += -lz
+endif
 
 $(BUILD)/bin/password.out: $(DEPS_59)
 	@echo '      [Link] $(BUILD)/bin/password.out'
@@ -984,6 +997,9 @@ ifeq ($(ME_COM_OPENSSL),1)
     LIBPATHS_60 += -L"$(ME_COM_OPENSSL_PATH)/lib"
     LIBPATHS_60 += -L"$(ME_COM_OPENSSL_PATH)"
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_60 += -lz
+endif
 
 $(BUILD)/bin/url.out: $(DEPS_60)
 	@echo '      [Link] $(BUILD)/bin/url.out'
@@ -1008,6 +1024,9 @@ ifeq ($(ME_COM_OPENSSL),1)
     LIBPATHS_61 += -L"$(ME_COM_OPENSSL_PATH)/lib"
     LIBPATHS_61 += -L"$(ME_COM_OPENSSL_PATH)"
 endif
+ifeq ($(ME_WEB_COMPRESS),1)
+    LIBS_61 += -lz
+endif
 
 $(BUILD)/bin/web.out: $(DEPS_61)
 	@echo '      [Link] $(BUILD)/bin/web.out'
@@ -144,6 +144,9 @@
 #ifndef ME_WEB_UPLOAD
     #define ME_WEB_UPLOAD 1
 #endif
+#ifndef ME_WEB_COMPRESS
+    #define ME_WEB_COMPRESS 0
+#endif
 #ifndef ME_WEB_GROUP
     #define ME_WEB_GROUP "Administrator"
 #endif
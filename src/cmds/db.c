@@ -46,14 +46,15 @@ static void usage(void)
 PUBLIC int main(int argc, char *argv[])
 {
     Db           *db;
+    DbCursor     *cursor;
     Json         *props, *result;
     const RList  *grid;
     const DbItem *item;
     DbModel      *model;
     RbNode       *rp;
-    cchar        *argp, *load, *name, *path, *schema;
+    cchar        *argp, *load, *name, *path, *schema, *text;
     char         *prop, *value;
-    int          argind, expire, flags, index, reset, update;
+    int          argind, expire, flags, index, prior, reset, update;
 
     fields = rAllocList(0, 0);
     expire = 0;
@@ -140,14 +141,15 @@ PUBLIC int main(int argc, char *argv[])
                 emit(rp->data);
             }
         } else if (argind == argc) {
-            //  Entire model
-            grid = dbFind(db, model->name, props, NULL);
-            result = jsonParse("[]", 0);
-            for (ITERATE_ITEMS(grid, item, index)) {
-                jsonBlend(result, 0, "[$]", dbJson(item), 0, 0, 0);
+            //  Entire model. Stream the items so memory does not grow with the size of the model.
+            cursor = dbCursorOpen(db, model->name, props, NULL);
+            rPrintf("[\n");
+            for (prior = 0; (item = dbCursorNext(cursor)) != 0; prior = 1) {
+                text = jsonString(dbJson(item), JSON_HUMAN);
+                rPrintf("%s%.*s", prior ? ",\n" : "", (int) slen(text) - 1, text);
             }
-            rPrintf("%s\n", jsonString(result, JSON_HUMAN));
-            jsonFree(result);
+            rPrintf(prior ? "\n]\n" : "]\n");
+            dbCursorClose(cursor);
 
         } else {
             //  One or more model items
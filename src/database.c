@@ -22,14 +22,17 @@ PUBLIC int ioInitDb(void)
     DbItem *device;
     Ticks  maxAge, service;
     size_t maxSize;
-    cchar  *id;
+    cchar  *id, *sync;
     char   *path, *schema;
-    int    flags, index;
+    int    flags, index, syncPolicy;
 
     schema = rGetFilePath(jsonGet(ioto->config, 0, "database.schema", "@config/schema.json5"));
     path = rGetFilePath(jsonGet(ioto->config, 0, "database.path", "@db/device.db"));
 
     flags = ioto->nosave ? DB_READ_ONLY : 0;
+    if (jsonGetBool(ioto->config, 0, "database.mmap", 0)) {
+        flags |= DB_OPEN_MMAP;
+    }
     if ((ioto->db = dbOpen(path, schema, flags)) == 0) {
         rError("database", "Cannot open database %s or schema %s", path, schema);
         rFree(path);
@@ -42,7 +45,16 @@ PUBLIC int ioInitDb(void)
     maxAge = svalue(jsonGet(ioto->config, 0, "database.maxJournalAge", "1min")) * TPS;
     service = svalue(jsonGet(ioto->config, 0, "database.service", "1hour")) * TPS;
     maxSize = (size_t) svalue(jsonGet(ioto->config, 0, "database.maxJournalSize", "1mb"));
-    dbSetJournalParams(ioto->db, maxAge, maxSize);
+    sync = jsonGet(ioto->config, 0, "database.journalSync", "always");
+    if (smatch(sync, "batched")) {
+        syncPolicy = DB_SYNC_BATCH;
+    } else if (smatch(sync, "none")) {
+        syncPolicy = DB_SYNC_NONE;
+    } else {
+        syncPolicy = DB_SYNC_ALWAYS;
+    }
+    dbSetJournalParams(ioto->db, maxAge, maxSize, syncPolicy);
+    dbSetCacheSize(ioto->db, (size_t) svalue(jsonGet(ioto->config, 0, "database.cacheSize", "0")));
 
     dbAddContext(ioto->db, "deviceId", ioto->id);
 #if SERVICES_CLOUD
@@ -13,6 +13,15 @@
 
 static int parseShow(cchar *arg);
 
+#if SERVICES_DATABASE
+static char *loadDbSession(WebSessionStore *store, cchar *id, Time *expires);
+static void removeDbSession(WebSessionStore *store, cchar *id);
+static int saveDbSession(WebSessionStore *store, cchar *id, cchar *data, Time expires);
+static ssize writeElement(Web *web, const DbItem *item, bool *prior);
+
+static WebSessionStore dbSessionStore = { loadDbSession, saveDbSession, removeDbSession, NULL };
+#endif
+
 /************************************* Code ***********************************/
 
 PUBLIC int ioInitWeb(void)
@@ -48,6 +57,16 @@ PUBLIC int ioInitWeb(void)
         if ((url = jsonGet(ioto->config, 0, "web.auth.logout", 0)) != 0) {
             webAddAction(webHost, url, webLogoutUser, NULL);
         }
+        /*
+            Persist sessions in the database so they survive restarts. Requires the Session model in the schema.
+         */
+        if (smatch(jsonGet(ioto->config, 0, "web.sessions.store", 0), "db")) {
+            if (ioto->db && dbGetModel(ioto->db, "Session")) {
+                webSetSessionStore(webHost, &dbSessionStore);
+            } else {
+                rError("web", "Cannot use the database session store without a Session model");
+            }
+        }
     }
 #endif
 #if ESP32
@@ -117,6 +136,29 @@ PUBLIC ssize webWriteItem(Web *web, const DbItem *item)
     return webWrite(web, dbString(item, JSON_JSON), 0);
 }
 
+/*
+    Write an item as an element of a JSON array. The separator is only written once the item is known to
+    have content so a skipped item does not leave a dangling comma. Returns the number of bytes written.
+ */
+static ssize writeElement(Web *web, const DbItem *item, bool *prior)
+{
+    cchar *value;
+    ssize rc, wrote;
+
+    if (!item || (value = dbString(item, JSON_JSON)) == 0 || *value == '\0') {
+        return 0;
+    }
+    rc = 0;
+    if (*prior && (rc = webWrite(web, ",", 1)) < 0) {
+        return rc;
+    }
+    if ((wrote = webWrite(web, value, 0)) < 0) {
+        return wrote;
+    }
+    *prior = 1;
+    return rc + wrote;
+}
+
 /*
     Write a database grid of items as part of a response. Does not finalize the response.
  */
@@ -129,24 +171,48 @@ PUBLIC ssize webWriteItems(Web *web, RList *items)
     if (!items) {
         return 0;
     }
-    rc = 0;
     prior = 0;
-    webWrite(web, "[", 1);
+    if ((rc = webWrite(web, "[", 1)) < 0) {
+        return rc;
+    }
     for (ITERATE_ITEMS(items, item, index)) {
-        if (!item) {
-            continue;
+        if ((wrote = writeElement(web, item, &prior)) < 0) {
+            return wrote;
         }
-        if (prior) {
-            rc += webWrite(web, ",", 0);
-        }
-        if ((wrote = webWriteItem(web, item)) <= 0) {
-            continue;
+        rc += wrote;
+    }
+    if ((wrote = webWrite(web, "]", 1)) < 0) {
+        return wrote;
+    }
+    return rc + wrote;
+}
+
+/*
+    Write the items from a database cursor as part of a response. Does not finalize the response.
+ */
+PUBLIC ssize webWriteCursor(Web *web, DbCursor *cursor)
+{
+    const DbItem *item;
+    ssize        rc, wrote;
+    bool         prior;
+
+    if (!cursor) {
+        return 0;
+    }
+    prior = 0;
+    if ((rc = webWrite(web, "[", 1)) < 0) {
+        return rc;
+    }
+    while ((item = dbCursorNext(cursor)) != 0) {
+        if ((wrote = writeElement(web, item, &prior)) < 0) {
+            return wrote;
         }
         rc += wrote;
-        prior = 1;
     }
-    rc += webWrite(web, "]", 1);
-    return rc;
+    if ((wrote = webWrite(web, "]", 1)) < 0) {
+        return wrote;
+    }
+    return rc + wrote;
 }
 
 /*
@@ -251,6 +317,36 @@ PUBLIC void webLogoutUser(Web *web)
     webLogout(web);
     webRedirect(web, 302, "/");
 }
+
+/*
+    Database session store. Expired sessions are removed by the Session model TTL expires field.
+ */
+static char *loadDbSession(WebSessionStore *store, cchar *id, Time *expires)
+{
+    const DbItem *item;
+
+    if ((item = dbGet(ioto->db, "Session", DB_PROPS("id", id), DB_PARAMS())) == 0) {
+        return 0;
+    }
+    *expires = dbFieldDate(item, "expires");
+    return sclone(dbField(item, "data"));
+}
+
+static int saveDbSession(WebSessionStore *store, cchar *id, cchar *data, Time expires)
+{
+    const DbItem *item;
+    char         *date;
+
+    date = rGetIsoDate(expires);
+    item = dbUpdate(ioto->db, "Session", DB_PROPS("id", id, "data", data, "expires", date), DB_PARAMS(.upsert = 1));
+    rFree(date);
+    return item ? 0 : R_ERR_CANT_WRITE;
+}
+
+static void removeDbSession(WebSessionStore *store, cchar *id)
+{
+    dbRemove(ioto->db, "Session", DB_PROPS("id", id), DB_PARAMS());
+}
 #endif /* SERVICES_DATABASE */
 
 #else
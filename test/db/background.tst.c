@@ -0,0 +1,228 @@
+/*
+    background.tst.c - Unit tests for background (fiber-yielding) database saves
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT 20000
+
+static int ticks;
+
+/************************************ Code ************************************/
+
+static int countItems(Db *db)
+{
+    RList *list;
+    int   count;
+
+    list = dbFind(db, "Item", NULL, DB_PARAMS(.limit = ITEM_COUNT * 2));
+    count = list ? rGetListLength(list) : -1;
+    rFreeList(list);
+    return count;
+}
+
+static void tick(void *arg)
+{
+    ticks++;
+}
+
+/*
+    Copy the database files as they would be found after an outage
+ */
+static void copyFiles(cchar *from, cchar *to)
+{
+    char   src[ME_MAX_FNAME], dest[ME_MAX_FNAME], *data;
+    cchar  *ext[] = { "", ".jnl", ".jnl.prev", NULL };
+    size_t len;
+    int    i;
+
+    for (i = 0; ext[i]; i++) {
+        sfmtbuf(src, sizeof(src), "%s%s", from, ext[i]);
+        sfmtbuf(dest, sizeof(dest), "%s%s", to, ext[i]);
+        unlink(dest);
+        if ((data = rReadFile(src, &len)) != 0) {
+            rWriteFile(dest, data, len, 0644);
+            rFree(data);
+        }
+    }
+}
+
+static void backgroundSave()
+{
+    Db   *db;
+    char id[32];
+    int  i, changes;
+
+    db = dbOpen("./db/background.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    dbSetJournalParams(db, 3600 * TPS, 1024 * 1024 * 1024, DB_SYNC_NONE);
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    //  A tiny journal size triggers a save on the next change. No base exists so it is a full snapshot.
+    dbSetJournalParams(db, 3600 * TPS, 1, DB_SYNC_NONE);
+    tnotnull(dbCreate(db, "Item", DB_PROPS("id", "first"), NULL));
+    tnotnull(db->save);
+    ttrue(rFileExists("./db/background.db.jnl.prev"));
+
+    //  Mutate while the snapshot is written. Each change yields to let the save progress.
+    ticks = 0;
+    rStartEvent(tick, 0, 0);
+    changes = 0;
+    for (i = 0; db->save && i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", ITEM_COUNT - 1 - i);
+        dbRemove(db, "Item", DB_PROPS("id", id), NULL);
+        sfmtbuf(id, sizeof(id), "during-%d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+        changes++;
+        if (i == 2) {
+            //  Simulated outage mid-save
+            copyFiles("./db/background.db", "./db/outage.db");
+            copyFiles("./db/background.db", "./db/corrupt.db");
+        }
+        rSleep(0);
+    }
+    ttrue(changes > 2);
+    tnull(db->save);
+    tfalse(rFileExists("./db/background.db.jnl.prev"));
+    //  Other events ran during the save
+    ttrue(ticks > 0);
+    teqi(countItems(db), ITEM_COUNT + 1);
+    dbClose(db);
+
+    //  Reload the snapshot and the delta of changes made during the save
+    db = dbOpen("./db/background.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), ITEM_COUNT + 1);
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "first"), NULL));
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "during-0"), NULL));
+    sfmtbuf(id, sizeof(id), "during-%d", changes - 1);
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", id), NULL));
+    sfmtbuf(id, sizeof(id), "%08d", ITEM_COUNT - 1);
+    tnull(dbGet(db, "Item", DB_PROPS("id", id), NULL));
+    dbClose(db);
+
+    //  Recover from the outage using the previous and current journals
+    db = dbOpen("./db/outage.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), ITEM_COUNT + 1);
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "first"), NULL));
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "during-2"), NULL));
+    tnull(dbGet(db, "Item", DB_PROPS("id", "during-3"), NULL));
+    tfalse(rFileExists("./db/outage.db.jnl.prev"));
+    dbClose(db);
+
+    //  A corrupt current journal fails recovery even though the previous journal applied changes
+    ttrue(rGetFileSize("./db/corrupt.db.jnl.prev") > 0);
+    rWriteFile("./db/corrupt.db.jnl", "\xff\xff", 2, 0644);
+    tnull(dbOpen("./db/corrupt.db", "./schema.json", 0));
+}
+
+static void closeDuringSave()
+{
+    Db   *db;
+    char id[32];
+    int  i;
+
+    db = dbOpen("./db/close.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    dbSetJournalParams(db, 3600 * TPS, 1, DB_SYNC_NONE);
+    dbCreate(db, "Item", DB_PROPS("id", "last"), NULL);
+    tnotnull(db->save);
+    rSleep(0);
+
+    //  Closing abandons the background save and saves synchronously
+    dbClose(db);
+    rSleep(10);
+    tfalse(rFileExists("./db/close.db.jnl.prev"));
+    tfalse(rFileExists("./db/close.db.snap"));
+
+    db = dbOpen("./db/close.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), ITEM_COUNT + 1);
+    dbClose(db);
+}
+
+/*
+    Simulate an outage after the snapshot is saved and before the journal is recreated. The journal path is
+    redirected to /dev/full so recreating the journal fails and the files are left as they were at that point.
+ */
+static void crashWindow()
+{
+    Db   *db;
+    char id[32];
+    int  i, removed;
+
+    if (!rFileExists("/dev/full")) {
+        tinfo("Skipping crash window test as /dev/full is not available");
+        return;
+    }
+    db = dbOpen("./db/window.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    dbSetJournalParams(db, 3600 * TPS, 1024 * 1024 * 1024, DB_SYNC_NONE);
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    dbSetJournalParams(db, 3600 * TPS, 1, DB_SYNC_NONE);
+    tnotnull(dbCreate(db, "Item", DB_PROPS("id", "first"), NULL));
+    tnotnull(db->save);
+
+    unlink("./db/window.db.jnl");
+    teqi(symlink("/dev/full", "./db/window.db.jnl"), 0);
+
+    //  Remove items while the snapshot is written. The removals are saved in the delta after the snapshot.
+    for (removed = 0; db->save && removed < ITEM_COUNT; removed++) {
+        sfmtbuf(id, sizeof(id), "%08d", removed);
+        dbRemove(db, "Item", DB_PROPS("id", id), NULL);
+        rSleep(0);
+    }
+    tnull(db->save);
+    ttrue(removed > 0);
+
+    //  The previous journal holds the creation of the removed items and must not survive the snapshot
+    tfalse(rFileExists("./db/window.db.jnl.prev"));
+    unlink("./db/window.db.jnl");
+    copyFiles("./db/window.db", "./db/window-outage.db");
+    dbClose(db);
+
+    db = dbOpen("./db/window-outage.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), ITEM_COUNT + 1 - removed);
+    tnull(dbGet(db, "Item", DB_PROPS("id", "00000000"), NULL));
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "first"), NULL));
+    dbClose(db);
+}
+
+static void fiberMain(void *arg)
+{
+    backgroundSave();
+    closeDuringSave();
+    crashWindow();
+    rStop();
+}
+
+int main(void)
+{
+    rInit(fiberMain, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+    rServiceEvents();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -0,0 +1,136 @@
+/*
+    bench.tst.c - Database benchmarks
+
+    Measures the latency and bytes written for full snapshot and delta saves, load time with and
+    without memory mapping and the cost of repeated and prepared queries. The results are reported via
+    tinfo and are not checked against thresholds. Correctness is verified by the unit tests in test/db.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT  20000
+#define CHANGES     10
+#define FINDS       1000
+
+/************************************ Code ************************************/
+
+static void timeSave(Db *db, cchar *msg)
+{
+    Ticks start;
+
+    start = rGetTicks();
+    teqi(dbSave(db, NULL), 0);
+    tinfo("%s: %lld msec, %lld bytes", msg, (int64) (rGetTicks() - start), (int64) db->saveBytes);
+}
+
+static void benchSave()
+{
+    Db   *db;
+    char id[32];
+    int  i;
+
+    db = dbOpen("./db/bench.db", "../schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    dbSetJournalParams(db, 3600 * TPS, 1024 * 1024 * 1024, DB_SYNC_NONE);
+
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    timeSave(db, "Full save");
+
+    //  Change a handful of items
+    for (i = 0; i < CHANGES; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i * 997);
+        dbRemove(db, "Item", DB_PROPS("id", id), NULL);
+        sfmtbuf(id, sizeof(id), "new-%d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    timeSave(db, "Delta save");
+    dbClose(db);
+}
+
+static Db *timeOpen(cchar *path, int flags, cchar *msg)
+{
+    Db    *db;
+    Ticks start;
+
+    start = rGetTicks();
+    db = dbOpen(path, "../schema.json", flags);
+    tinfo("%s: %lld msec", msg, (int64) (rGetTicks() - start));
+    tnotnull(db);
+    return db;
+}
+
+static void benchLoad()
+{
+    Db   *db;
+    char id[32];
+
+    db = timeOpen("./db/bench.db", 0, "Load");
+    dbClose(db);
+
+    db = timeOpen("./db/bench.db", DB_OPEN_MMAP, "Load mapped");
+    sfmtbuf(id, sizeof(id), "%08d", ITEM_COUNT - 1);
+    dbUpdate(db, "Item", DB_PROPS("id", id), NULL);
+    dbCreate(db, "Item", DB_PROPS("id", "mapped"), NULL);
+    teqi(dbSave(db, NULL), 0);
+    dbClose(db);
+
+    db = timeOpen("./db/bench.db", DB_OPEN_MMAP, "Load mapped with delta");
+    dbClose(db);
+}
+
+static void benchFind()
+{
+    Db      *db;
+    DbQuery *query;
+    RList   *list;
+    Ticks   start;
+    int     i;
+
+    db = dbOpen("./db/bench.db", "../schema.json", 0);
+    tnotnull(db);
+
+    start = rGetTicks();
+    for (i = 0; i < FINDS; i++) {
+        list = dbFind(db, "Item", DB_PROPS("id", "00000998"), NULL);
+        rFreeList(list);
+    }
+    tinfo("Find x %d: %lld msec", FINDS, (int64) (rGetTicks() - start));
+
+    start = rGetTicks();
+    query = dbPrepare(db, "Item", DB_PROPS("id", "00000998"), NULL);
+    tnotnull(query);
+    for (i = 0; i < FINDS; i++) {
+        list = dbFindPrepared(query, NULL);
+        rFreeList(list);
+    }
+    dbFreeQuery(query);
+    tinfo("Find prepared x %d: %lld msec", FINDS, (int64) (rGetTicks() - start));
+    dbClose(db);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+
+    benchSave();
+    benchLoad();
+    benchFind();
+
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -0,0 +1,5 @@
+#!/bin/bash
+#
+#   TestMe cleanup script
+#
+rm -f db/*.db db/*.jnl
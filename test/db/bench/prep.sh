@@ -0,0 +1,7 @@
+#!/bin/bash
+#
+#   TestMe prep script
+#
+
+mkdir -p db
+rm -f db/*.db db/*.jnl
\ No newline at end of file
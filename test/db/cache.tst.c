@@ -0,0 +1,121 @@
+/*
+    cache.tst.c - Unit tests for the parsed item cache
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT 1000
+
+/************************************ Code ************************************/
+
+static int countParsed(Db *db)
+{
+    RbNode *rp;
+    int    count;
+
+    count = 0;
+    for (rp = rbFirst(db->primary); rp; rp = rbNext(db->primary, rp)) {
+        if (((DbItem*) rp->data)->json) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void testCache()
+{
+    Db           *db;
+    const DbItem *item;
+    RList        *list;
+    char         id[32];
+    size_t       size;
+    int          i;
+
+    db = dbOpen("./db/cache.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "user%d", i);
+        tnotnull(dbCreate(db, "User", DB_PROPS("id", id, "username", id, "email", "user@test.com", "role", "user"), NULL));
+    }
+    //  Without a budget, all parsed items are retained and sizes are not tracked
+    teqi(countParsed(db), ITEM_COUNT);
+    teqz(db->cacheSize, 0);
+
+    //  A budget estimates the size of the cached items
+    dbSetCacheSize(db, SIZE_MAX);
+    size = db->cacheSize;
+    ttrue(size > 0);
+    teqi(countParsed(db), ITEM_COUNT);
+
+    //  Setting a budget evicts the least recently used items
+    dbSetCacheSize(db, size / 10);
+    ttrue(db->cacheSize <= size / 10);
+    ttrue(db->cacheEvictions > 0);
+    ttrue(countParsed(db) < ITEM_COUNT / 5);
+
+    //  The most recently created item is still parsed
+    sfmtbuf(id, sizeof(id), "user%d", ITEM_COUNT - 1);
+    db->cacheHits = db->cacheMisses = 0;
+    item = dbGet(db, "User", DB_PROPS("id", id), NULL);
+    tnotnull(item);
+    teqi(db->cacheHits, 1);
+    teqi(db->cacheMisses, 0);
+
+    //  Evicted items are parsed again on access
+    item = dbGet(db, "User", DB_PROPS("id", "user0"), NULL);
+    tnotnull(item);
+    ttrue(db->cacheMisses > 0);
+    tnotnull(item->json);
+    tmatch(dbField(item, "username"), "user0");
+
+    //  Scanning all items stays within the budget
+    list = dbFind(db, "User", DB_PROPS("username", "user500"), NULL);
+    teqi(rGetListLength(list), 1);
+    rFreeList(list);
+    ttrue(db->cacheSize <= size / 10);
+
+    //  Updates to evicted items are preserved
+    for (i = 0; i < ITEM_COUNT; i += 10) {
+        sfmtbuf(id, sizeof(id), "user%d", i);
+        tnotnull(dbSetField(db, "User", "role", "guest", DB_PROPS("id", id), NULL));
+    }
+    ttrue(db->cacheSize <= size / 10);
+    list = dbFind(db, "User", DB_PROPS("role", "guest"), NULL);
+    teqi(rGetListLength(list), ITEM_COUNT / 10);
+    rFreeList(list);
+
+    //  Compacting empties the cache
+    dbCompact(db);
+    teqz(db->cacheSize, 0);
+    tnull(db->cache);
+    teqi(countParsed(db), 0);
+
+    //  Removing the budget retains all parsed items
+    dbSetCacheSize(db, 0);
+    list = dbFind(db, "User", DB_PROPS("role", "guest"), NULL);
+    rFreeList(list);
+    teqi(countParsed(db), ITEM_COUNT);
+    dbClose(db);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+
+    testCache();
+
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
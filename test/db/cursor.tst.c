@@ -0,0 +1,173 @@
+/*
+    cursor.tst.c - Unit tests for database cursors
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT 100
+
+/************************************ Code ************************************/
+
+static void createItems(Db *db)
+{
+    char id[32], email[32];
+    int  i;
+
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%03d", i);
+        //  Reverse email order so the secondary index order differs from the primary order
+        sfmtbuf(email, sizeof(email), "user%03d@example.com", ITEM_COUNT - i - 1);
+        tnotnull(dbCreate(db, "User", DB_PROPS("id", id, "username", id, "email", email,
+                                               "role", i % 2 ? "guest" : "user"), NULL));
+    }
+}
+
+static void iterate(Db *db)
+{
+    DbCursor     *cursor;
+    const DbItem *item;
+    RList        *list;
+    cchar        *prior;
+    int          count;
+
+    //  Cursor returns the same items as dbFind in the same order
+    list = dbFind(db, "User", DB_PROPS("role", "guest"), NULL);
+    cursor = dbCursorOpen(db, "User", DB_PROPS("role", "guest"), NULL);
+    tnotnull(cursor);
+    for (count = 0; (item = dbCursorNext(cursor)) != 0; count++) {
+        ttrue(item == rGetItem(list, count));
+    }
+    teqi(count, rGetListLength(list));
+    teqi(count, ITEM_COUNT / 2);
+    tnull(dbCursorNext(cursor));
+    tnull(dbCursorToken(cursor));
+    dbCursorClose(cursor);
+    rFreeList(list);
+
+    //  Secondary index order
+    cursor = dbCursorOpen(db, "User", NULL, DB_PARAMS(.index = "byEmail"));
+    tnotnull(cursor);
+    prior = 0;
+    for (count = 0; (item = dbCursorNext(cursor)) != 0; count++) {
+        if (prior) {
+            ttrue(scmp(prior, dbField(item, "email")) < 0);
+        }
+        prior = dbField(item, "email");
+    }
+    teqi(count, ITEM_COUNT);
+    dbCursorClose(cursor);
+}
+
+static void paginate(Db *db)
+{
+    DbCursor     *cursor;
+    const DbItem *item;
+    char         *next;
+    int          count, pages;
+
+    next = 0;
+    count = 0;
+    pages = 0;
+    do {
+        cursor = dbCursorOpen(db, 0, 0, DB_PARAMS(.limit = 30, .next = next));
+        tnotnull(cursor);
+        while ((item = dbCursorNext(cursor)) != 0) {
+            count++;
+        }
+        rFree(next);
+        next = sclone(dbCursorToken(cursor));
+        dbCursorClose(cursor);
+        pages++;
+    } while (next && *next);
+    rFree(next);
+    teqi(count, ITEM_COUNT);
+    teqi(pages, 4);
+}
+
+static void modify(Db *db)
+{
+    DbCursor     *cursor;
+    const DbItem *item;
+    char         id[32];
+    int          count, i;
+
+    //  Remove items ahead of the cursor and create new items while iterating
+    cursor = dbCursorOpen(db, "User", NULL, NULL);
+    tnotnull(cursor);
+    for (count = 0; (item = dbCursorNext(cursor)) != 0; count++) {
+        i = (int) stoi(dbField(item, "id"));
+        if (i % 10 == 0 && i + 1 < ITEM_COUNT) {
+            sfmtbuf(id, sizeof(id), "%03d", i + 1);
+            teqi(dbRemove(db, "User", DB_PROPS("id", id), NULL), 1);
+        }
+        if (i == 50) {
+            tnotnull(dbCreate(db, "User", DB_PROPS("id", "999", "username", "999", "email", "999@example.com",
+                                                   "role", "user"), NULL));
+        }
+    }
+    dbCursorClose(cursor);
+    //  Removed items are skipped and the item created ahead of the cursor is returned
+    teqi(count, ITEM_COUNT - ITEM_COUNT / 10 + 1);
+}
+
+static void expired(Db *db)
+{
+    DbCursor     *cursor;
+    const DbItem *item;
+    RList        *list;
+    char         *past, *future;
+
+    past = rGetIsoDate(rGetTime() - 60 * TPS);
+    future = rGetIsoDate(rGetTime() + 3600 * TPS);
+    tnotnull(dbCreate(db, "Event", DB_PROPS("id", "a", "message", "old", "expires", past, "source", "test",
+                                            "severity", "info", "subject", "expired"), NULL));
+    tnotnull(dbCreate(db, "Event", DB_PROPS("id", "b", "message", "new", "expires", future, "source", "test",
+                                            "severity", "info", "subject", "current"), NULL));
+
+    //  Expired items are removed by dbCursorNext so removing them before the cursor is closed is safe
+    cursor = dbCursorOpen(db, "Event", NULL, NULL);
+    tnotnull(cursor);
+    item = dbCursorNext(cursor);
+    tnotnull(item);
+    tmatch(dbField(item, "id"), "b");
+    teqi(dbRemove(db, "Event", DB_PROPS("id", "a"), NULL), 0);
+    tnull(dbCursorNext(cursor));
+    dbCursorClose(cursor);
+
+    list = dbFind(db, "Event", NULL, NULL);
+    teqi(rGetListLength(list), 1);
+    rFreeList(list);
+    rFree(past);
+    rFree(future);
+}
+
+int main(void)
+{
+    Db *db;
+
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+
+    db = dbOpen("./db/cursor.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    createItems(db);
+    iterate(db);
+    paginate(db);
+    modify(db);
+    expired(db);
+    dbClose(db);
+
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
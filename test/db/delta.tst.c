@@ -0,0 +1,138 @@
+/*
+    delta.tst.c - Unit tests for delta saves
+
+    Verifies that saves append small delta segments of changed items, that deltas reload correctly,
+    that large deltas are compacted into a new base snapshot and that torn delta segments are ignored.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT  2000
+#define CHANGES     10
+
+/************************************ Code ************************************/
+
+static int countItems(Db *db)
+{
+    RList *list;
+    int   count;
+
+    list = dbFind(db, "Item", NULL, DB_PARAMS(.limit = ITEM_COUNT * 2));
+    count = list ? rGetListLength(list) : -1;
+    rFreeList(list);
+    return count;
+}
+
+static void deltaSave()
+{
+    Db     *db;
+    char   id[32];
+    size_t base;
+    int    i, round;
+
+    db = dbOpen("./db/delta.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    dbSetJournalParams(db, 3600 * TPS, 1024 * 1024 * 1024, DB_SYNC_NONE);
+
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    teqi(dbSave(db, NULL), 0);
+    base = db->saveBytes;
+    ttrue(base > ITEM_COUNT * 10);
+    teqz(db->deltaSize, 0);
+
+    //  Change a handful of items
+    for (i = 0; i < CHANGES; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i * 97);
+        dbRemove(db, "Item", DB_PROPS("id", id), NULL);
+        sfmtbuf(id, sizeof(id), "new-%d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    teqi(dbSave(db, NULL), 0);
+    ttrue(db->saveBytes > 0);
+    ttrue(db->saveBytes < base / 10);
+    teqz(db->deltaSize, db->saveBytes);
+
+    //  Nothing changed
+    teqi(dbSave(db, NULL), 0);
+    teqz(db->saveBytes, 0);
+    dbClose(db);
+
+    //  Reload base and delta
+    db = dbOpen("./db/delta.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), ITEM_COUNT);
+    tnull(dbGet(db, "Item", DB_PROPS("id", "00000097"), NULL));
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "new-1"), NULL));
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "00000098"), NULL));
+
+    //  Large deltas are compacted into a new base snapshot
+    for (round = 0; round < 20 && db->deltaSize; round++) {
+        for (i = 0; i < ITEM_COUNT / 10; i++) {
+            sfmtbuf(id, sizeof(id), "%08d", ITEM_COUNT / 2 + i + round);
+            dbUpdate(db, "Item", DB_PROPS("id", id), DB_PARAMS(.upsert = 1));
+        }
+        teqi(dbSave(db, NULL), 0);
+    }
+    teqz(db->deltaSize, 0);
+    teqi(countItems(db), ITEM_COUNT);
+    dbClose(db);
+}
+
+static void tornDelta()
+{
+    Db    *db;
+    FILE  *fp;
+    ssize size;
+
+    db = dbOpen("./db/torn.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    dbCreate(db, "Item", DB_PROPS("id", "base"), NULL);
+    teqi(dbSave(db, NULL), 0);
+    dbCreate(db, "Item", DB_PROPS("id", "delta"), NULL);
+    teqi(dbSave(db, NULL), 0);
+    dbClose(db);
+
+    //  Simulate an outage while appending a delta segment
+    size = rGetFileSize("./db/torn.db");
+    fp = fopen("./db/torn.db", "a");
+    tnotnull(fp);
+    fwrite("\2\0\0\0\1\0\0\0\377\0\0\0", 12, 1, fp);
+    fclose(fp);
+
+    db = dbOpen("./db/torn.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), 2);
+    dbCreate(db, "Item", DB_PROPS("id", "after"), NULL);
+    teqi(dbSave(db, NULL), 0);
+    dbClose(db);
+    ttrue(rGetFileSize("./db/torn.db") > size);
+
+    db = dbOpen("./db/torn.db", "./schema.json", 0);
+    tnotnull(db);
+    teqi(countItems(db), 3);
+    dbClose(db);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+    deltaSave();
+    tornDelta();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -87,6 +87,73 @@ static void findCallback(Db *db)
     teqi(items->length, 1);
 }
 
+static void findPrepared(Db *db)
+{
+    DbQuery *query;
+    RList   *items, *expected;
+    cchar   *next;
+    char    name[32];
+    int     i;
+
+    for (i = 0; i < 10; i++) {
+        sfmtbuf(name, sizeof(name), "user%d", i);
+        tnotnull(dbCreate(db, "User", DB_PROPS("username", name, "email", "user@embedthis.com",
+                                               "role", i % 2 ? "guest" : "user"), NULL));
+    }
+    query = dbPrepare(db, "User", DB_PROPS("role", "guest"), NULL);
+    tnotnull(query);
+
+    //  Repeated executions return the same results
+    for (i = 0; i < 3; i++) {
+        items = dbFindPrepared(query, NULL);
+        teqi(rGetListLength(items), 5);
+        tmatch(dbField(rGetItem(items, 0), "role"), "guest");
+        rFreeList(items);
+    }
+
+    //  Changes are visible to later executions
+    dbCreate(db, "User", DB_PROPS("username", "late", "email", "late@embedthis.com", "role", "guest"), NULL);
+    items = dbFindPrepared(query, NULL);
+    teqi(rGetListLength(items), 6);
+    rFreeList(items);
+
+    //  Pagination matches dbFind
+    items = dbFindPrepared(query, DB_PARAMS(.limit = 4));
+    teqi(rGetListLength(items), 4);
+    next = dbNext(db, items);
+    expected = dbFind(db, "User", DB_PROPS("role", "guest"), DB_PARAMS(.limit = 4, .next = next));
+    rFreeList(items);
+    items = dbFindPrepared(query, DB_PARAMS(.limit = 4, .next = next));
+    teqi(rGetListLength(items), rGetListLength(expected));
+    rFreeList(items);
+    rFreeList(expected);
+    dbFreeQuery(query);
+
+    //  Where callbacks are retained by the query
+    query = dbPrepare(db, "User", NULL, DB_PARAMS(.where = (DbWhere) whereCallback, .arg = "whereArg"));
+    tnotnull(query);
+    items = dbFindPrepared(query, NULL);
+    teqi(rGetListLength(items), 1);
+    rFreeList(items);
+    dbFreeQuery(query);
+
+    //  Queries by the sort key of the primary index return the single matching item
+    tnotnull(dbCreate(db, "Item", DB_PROPS("id", "prepared-1"), NULL));
+    tnotnull(dbCreate(db, "Item", DB_PROPS("id", "prepared-2"), NULL));
+    query = dbPrepare(db, "Item", DB_PROPS("id", "prepared-2"), NULL);
+    tnotnull(query);
+    for (i = 0; i < 3; i++) {
+        items = dbFindPrepared(query, NULL);
+        teqi(rGetListLength(items), 1);
+        tmatch(dbField(rGetItem(items, 0), "id"), "prepared-2");
+        rFreeList(items);
+    }
+    dbFreeQuery(query);
+
+    //  Invalid properties are rejected when prepared
+    tnull(dbPrepare(db, "User", DB_PROPS("role", "unknown"), NULL));
+}
+
 int main(void)
 {
     Db  *db;
@@ -98,6 +165,7 @@ int main(void)
     createItems(db);
     findItems(db);
     findCallback(db);
+    findPrepared(db);
     closeDb(db);
     rTerm();
 }
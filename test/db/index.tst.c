@@ -0,0 +1,190 @@
+/*
+    index.c.tst - Unit tests for secondary indexes
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+#include    "json.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT 50
+
+/************************************ Code ************************************/
+
+static Db *openDb(int flags)
+{
+    Db  *db;
+
+    db = dbOpen("db/index.db", "./schema.json", flags);
+    tnotnull(db);
+    tmatch(dbGetError(db), 0);
+    return db;
+}
+
+static void createItems(Db *db)
+{
+    CDbItem     *item;
+    char        email[32], name[32];
+    int         i;
+
+    for (i = 0; i < ITEM_COUNT; i++) {
+        //  Create in reverse email order so the index order differs from the primary order
+        sfmtbuf(email, sizeof(email), "user%02d@example.com", ITEM_COUNT - i - 1);
+        sfmtbuf(name, sizeof(name), "user%02d", i);
+        item = dbCreate(db, "User", DB_PROPS(
+            "username", name,
+            "email", email,
+            "role", "user"
+        ), NULL);
+        tnotnull(item);
+    }
+    //  Items without the index sort field are not indexed
+    item = dbCreate(db, "Port", DB_PROPS("name", "eth0"), NULL);
+    tnotnull(item);
+}
+
+static void findByIndex(Db *db)
+{
+    RList       *list;
+    CDbItem     *item;
+    cchar       *prior;
+    int         i;
+
+    //  Exact lookup via the index
+    item = dbFindOne(db, "User", DB_PROPS("email", "user07@example.com"), DB_PARAMS(.index = "byEmail"));
+    tnotnull(item);
+    tmatch(dbField(item, "username"), "user42");
+
+    item = dbGet(db, "User", DB_PROPS("email", "user07@example.com"), DB_PARAMS(.index = "byEmail"));
+    tnotnull(item);
+    tmatch(dbField(item, "email"), "user07@example.com");
+
+    tmatch(dbGetField(db, "User", "username", DB_PROPS("email", "user10@example.com"),
+                      DB_PARAMS(.index = "byEmail")), "user39");
+
+    list = dbFind(db, "User", DB_PROPS("email", "user20@example.com"), DB_PARAMS(.index = "byEmail"));
+    teqi(rGetListLength(list), 1);
+    rFreeList(list);
+
+    //  Missing items
+    item = dbFindOne(db, "User", DB_PROPS("email", "unknown@example.com"), DB_PARAMS(.index = "byEmail"));
+    tnull(item);
+
+    //  Additional properties are matched against indexed items
+    item = dbFindOne(db, "User", DB_PROPS("email", "user07@example.com", "role", "admin"),
+                     DB_PARAMS(.index = "byEmail"));
+    tnull(item);
+
+    //  Full scan of the index returns items in index order and excludes unindexed items
+    list = dbFind(db, NULL, NULL, DB_PARAMS(.index = "byEmail"));
+    teqi(rGetListLength(list), ITEM_COUNT);
+    prior = "";
+    for (ITERATE_ITEMS(list, item, i)) {
+        ttrue(scmp(prior, dbField(item, "email")) < 0);
+        prior = dbField(item, "email");
+    }
+    rFreeList(list);
+
+    //  Unknown and unmaintained indexes
+    item = dbFindOne(db, "User", DB_PROPS("email", "user07@example.com"), DB_PARAMS(.index = "unknown"));
+    tnull(item);
+    tnotnull(dbGetError(db));
+    item = dbFindOne(db, "User", DB_PROPS("gs1sk", "x"), DB_PARAMS(.index = "gs1"));
+    tnull(item);
+}
+
+static void paginate(Db *db)
+{
+    RList       *list;
+    CDbItem     *item;
+    cchar       *next;
+    char        email[32];
+    int         count, i;
+
+    count = 0;
+    next = NULL;
+    do {
+        list = dbFind(db, "User", NULL, DB_PARAMS(.index = "byEmail", .next = next, .limit = 7));
+        next = dbNext(db, list);
+        for (ITERATE_ITEMS(list, item, i)) {
+            tmatch(dbField(item, "email"), sfmtbuf(email, sizeof(email), "user%02d@example.com", count + i));
+        }
+        count += rGetListLength(list);
+        rFreeList(list);
+    } while (next);
+    teqi(count, ITEM_COUNT);
+}
+
+static void updateItems(Db *db)
+{
+    CDbItem     *item;
+    char        *id;
+
+    item = dbFindOne(db, "User", DB_PROPS("email", "user07@example.com"), DB_PARAMS(.index = "byEmail"));
+    tnotnull(item);
+    //  Field references are invalidated by updates
+    id = sclone(dbField(item, "id"));
+
+    //  Change the indexed field via update
+    item = dbUpdate(db, "User", DB_PROPS("id", id, "email", "changed@example.com"), NULL);
+    tnotnull(item);
+    tnull(dbFindOne(db, "User", DB_PROPS("email", "user07@example.com"), DB_PARAMS(.index = "byEmail")));
+    item = dbFindOne(db, "User", DB_PROPS("email", "changed@example.com"), DB_PARAMS(.index = "byEmail"));
+    tnotnull(item);
+    tmatch(dbField(item, "id"), id);
+
+    //  Change the indexed field via set field
+    item = dbSetField(db, "User", "email", "again@example.com", DB_PROPS("id", id), NULL);
+    tnotnull(item);
+    tnull(dbFindOne(db, "User", DB_PROPS("email", "changed@example.com"), DB_PARAMS(.index = "byEmail")));
+    tnotnull(dbFindOne(db, "User", DB_PROPS("email", "again@example.com"), DB_PARAMS(.index = "byEmail")));
+
+    //  Remove the item
+    teqi(dbRemove(db, "User", DB_PROPS("id", id), NULL), 1);
+    tnull(dbFindOne(db, "User", DB_PROPS("email", "again@example.com"), DB_PARAMS(.index = "byEmail")));
+    rFree(id);
+}
+
+static void reload(void)
+{
+    Db      *db;
+    RList   *list;
+    CDbItem *item;
+
+    //  Indexes are rebuilt from the saved database and journal
+    db = openDb(0);
+    list = dbFind(db, NULL, NULL, DB_PARAMS(.index = "byEmail"));
+    teqi(rGetListLength(list), ITEM_COUNT - 1);
+    rFreeList(list);
+    item = dbFindOne(db, "User", DB_PROPS("email", "user20@example.com"), DB_PARAMS(.index = "byEmail"));
+    tnotnull(item);
+    tmatch(dbField(item, "username"), "user29");
+    dbClose(db);
+}
+
+int main(void)
+{
+    Db  *db;
+
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+
+    db = openDb(DB_OPEN_RESET);
+    createItems(db);
+    findByIndex(db);
+    paginate(db);
+    updateItems(db);
+    dbClose(db);
+    reload();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -0,0 +1,120 @@
+/*
+    journal.tst.c - Unit tests for journal sync policies and torn record recovery
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/************************************ Code ************************************/
+
+static void createUsers(Db *db, int start, int count)
+{
+    char name[32];
+    int  i;
+
+    for (i = start; i < start + count; i++) {
+        sfmtbuf(name, sizeof(name), "user%d", i);
+        tnotnull(dbCreate(db, "User", DB_PROPS("username", name, "email", "user@test.com", "role", "user"), NULL));
+    }
+}
+
+static int countUsers(Db *db)
+{
+    RList *list;
+    int   count;
+
+    list = dbFind(db, "User", NULL, NULL);
+    count = list ? rGetListLength(list) : -1;
+    rFreeList(list);
+    return count;
+}
+
+/*
+    Open a database recovered from a copy of another database's journal
+ */
+static Db *recover(cchar *journal, size_t len)
+{
+    unlink("./db/recover.db");
+    teqz(rWriteFile("./db/recover.db.jnl", journal, len, 0644), (ssize) len);
+    return dbOpen("./db/recover.db", "./schema.json", 0);
+}
+
+static void testBatched()
+{
+    Db     *db;
+    char   *journal;
+    size_t len, full;
+
+    db = dbOpen("./db/journal.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    dbSetJournalParams(db, 60 * TPS, 1024 * 1024, DB_SYNC_BATCH);
+    db->syncCount = 4;
+
+    //  Batched records are not written until the batch is full
+    createUsers(db, 0, 3);
+    teqi(db->pending, 3);
+    teqz(rGetFileSize("./db/journal.db.jnl"), 2);
+
+    createUsers(db, 3, 1);
+    teqi(db->pending, 0);
+    ttrue(rGetFileSize("./db/journal.db.jnl") > 2);
+
+    //  Changing the policy writes pending records
+    createUsers(db, 4, 1);
+    teqi(db->pending, 1);
+    dbSetJournalParams(db, 60 * TPS, 1024 * 1024, DB_SYNC_NONE);
+    teqi(db->pending, 0);
+    createUsers(db, 5, 1);
+    teqi(db->pending, 0);
+
+    journal = rReadFile("./db/journal.db.jnl", &full);
+    tnotnull(journal);
+    dbClose(db);
+
+    //  Complete journal recovers all changes
+    db = recover(journal, full);
+    tnotnull(db);
+    teqi(countUsers(db), 6);
+    dbClose(db);
+
+    //  Truncated final record is discarded
+    db = recover(journal, full - 5);
+    tnotnull(db);
+    teqi(countUsers(db), 5);
+    dbClose(db);
+
+    //  Corrupt final record is discarded
+    len = full;
+    journal[len - 3] ^= 0x1;
+    db = recover(journal, len);
+    tnotnull(db);
+    teqi(countUsers(db), 5);
+    dbClose(db);
+
+    //  Corrupt record header stops recovery at that record
+    journal[2] ^= 0x1;
+    db = recover(journal, len);
+    tnotnull(db);
+    teqi(countUsers(db), 0);
+    dbClose(db);
+    rFree(journal);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+
+    testBatched();
+
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -0,0 +1,83 @@
+/*
+    mmap.tst.c - Unit tests for memory mapped database loading
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "db.h"
+
+/*********************************** Locals ***********************************/
+
+#define ITEM_COUNT  2000
+
+/************************************ Code ************************************/
+
+static int countItems(Db *db)
+{
+    RList *list;
+    int   count;
+
+    list = dbFind(db, "Item", NULL, DB_PARAMS(.limit = ITEM_COUNT * 2));
+    count = list ? rGetListLength(list) : -1;
+    rFreeList(list);
+    return count;
+}
+
+static void mappedLoad()
+{
+    Db      *db;
+    CDbItem *item;
+    char    id[32];
+    int     i;
+
+    db = dbOpen("./db/mmap.db", "./schema.json", DB_OPEN_RESET);
+    tnotnull(db);
+    for (i = 0; i < ITEM_COUNT; i++) {
+        sfmtbuf(id, sizeof(id), "%08d", i);
+        dbCreate(db, "Item", DB_PROPS("id", id), NULL);
+    }
+    teqi(dbSave(db, NULL), 0);
+    dbClose(db);
+
+    db = dbOpen("./db/mmap.db", "./schema.json", DB_OPEN_MMAP);
+    tnotnull(db);
+#if ME_UNIX_LIKE
+    tnotnull(db->map);
+#endif
+    teqi(countItems(db), ITEM_COUNT);
+
+    //  Mapped items are copied when modified
+    sfmtbuf(id, sizeof(id), "%08d", ITEM_COUNT - 1);
+    item = dbUpdate(db, "Item", DB_PROPS("id", id), NULL);
+    tnotnull(item);
+    dbRemove(db, "Item", DB_PROPS("id", "00000001"), NULL);
+    tnotnull(dbCreate(db, "Item", DB_PROPS("id", "mapped"), NULL));
+    teqi(dbSave(db, NULL), 0);
+    teqi(countItems(db), ITEM_COUNT);
+    dbClose(db);
+
+    //  Reload the mapped base and the delta
+    db = dbOpen("./db/mmap.db", "./schema.json", DB_OPEN_MMAP);
+    tnotnull(db);
+    teqi(countItems(db), ITEM_COUNT);
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", "mapped"), NULL));
+    tnull(dbGet(db, "Item", DB_PROPS("id", "00000001"), NULL));
+    tnotnull(dbGet(db, "Item", DB_PROPS("id", id), NULL));
+    dbClose(db);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    rSetLog("stdout:all,!debug,!trace:all,!mbedtls", 0, 1);
+    mappedLoad();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
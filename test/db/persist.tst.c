@@ -20,7 +20,7 @@ static void testPersistParameters()
     tnotnull(db);
 
     //  Set journal parameters
-    dbSetJournalParams(db, 500, 1024);  // 500ms delay, 1KB max size
+    dbSetJournalParams(db, 500, 1024, DB_SYNC_ALWAYS);  // 500ms delay, 1KB max size
 
     //  Create some items
     item = dbCreate(db, "User", DB_PROPS(
@@ -107,7 +107,7 @@ static void testPersistRecovery()
     id = sclone(dbField(item, "id"));
 
     //  Force a write but don't save
-    dbSetJournalParams(db, 1, 1);  // Very small size/delay to force persist
+    dbSetJournalParams(db, 1, 1, DB_SYNC_ALWAYS);  // Very small size/delay to force persist
 
     item = dbUpdate(db, "User", DB_PROPS("id", id, "role", "admin"), NULL);
     tnotnull(item);
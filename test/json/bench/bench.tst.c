@@ -0,0 +1,291 @@
+/*
+    bench.tst.c - JSON library benchmarks
+
+    Measures the cost of building large documents, property lookup in large objects, parse throughput
+    for typical documents, numeric reads and updates and arena allocation. The results are reported via
+    tinfo and are not checked against thresholds. Correctness is verified by the unit tests in test/json.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "../test.h"
+
+/*********************************** Locals ***********************************/
+
+#define BUILD_PROPERTIES  10000
+#define LOOKUP_PROPERTIES 1000
+#define LOOKUPS           100000
+#define PARSE_SIZE        (1024 * 1024)
+#define PARSE_BYTES       (64 * 1024 * 1024)
+#define NUMBER_ITERATIONS 1000000
+#define ARENA_DEVICES     2000
+
+/************************************ Code ************************************/
+
+/*
+    Build the same 10K property object via jsonSet and the builder
+ */
+static void benchBuild()
+{
+    Json    *setObj, *buildObj;
+    Ticks   mark, setElapsed, buildElapsed;
+    char    key[32], value[32];
+    int     i;
+
+    setObj = jsonAlloc();
+    mark = rGetTicks();
+    for (i = 0; i < BUILD_PROPERTIES; i++) {
+        jsonSetFmt(setObj, 0, SFMT(key, "key-%d", i), "%d", i);
+    }
+    setElapsed = rGetTicks() - mark;
+
+    buildObj = jsonAlloc();
+    mark = rGetTicks();
+    jsonBuilderBegin(buildObj, JSON_OBJECT);
+    for (i = 0; i < BUILD_PROPERTIES; i++) {
+        jsonBuilderValue(buildObj, SFMT(key, "key-%d", i), SFMT(value, "%d", i), JSON_PRIMITIVE);
+    }
+    jsonBuilderEnd(buildObj);
+    buildElapsed = rGetTicks() - mark;
+
+    teqi(setObj->count, BUILD_PROPERTIES + 1);
+    teqi(buildObj->count, BUILD_PROPERTIES + 1);
+    tinfo("Build %d properties: jsonSet %lld msec, builder %lld msec", BUILD_PROPERTIES,
+          (long long) setElapsed, (long long) buildElapsed);
+    jsonFree(setObj);
+    jsonFree(buildObj);
+}
+
+/*
+    Lookup properties in an object large enough to be indexed
+ */
+static void benchLookup()
+{
+    Json    *obj;
+    Ticks   mark, elapsed;
+    char    key[32], value[32];
+    int     i, found;
+
+    obj = jsonAlloc();
+    jsonBuilderBegin(obj, JSON_OBJECT);
+    for (i = 0; i < LOOKUP_PROPERTIES; i++) {
+        jsonBuilderValue(obj, SFMT(key, "key-%d", i), SFMT(value, "%d", i), JSON_PRIMITIVE);
+    }
+    jsonBuilderEnd(obj);
+
+    found = 0;
+    mark = rGetTicks();
+    for (i = 0; i < LOOKUPS; i++) {
+        if (jsonGet(obj, 0, SFMT(key, "key-%d", i % LOOKUP_PROPERTIES), 0)) {
+            found++;
+        }
+    }
+    elapsed = rGetTicks() - mark;
+    teqi(found, LOOKUPS);
+    tinfo("%d lookups in a %d property object: %lld msec", LOOKUPS, LOOKUP_PROPERTIES, (long long) elapsed);
+    jsonFree(obj);
+}
+
+/*
+    Cloud sync style messages in strict JSON with escaped strings
+ */
+static char *makeSync(void)
+{
+    RBuf    *buf;
+    int     i;
+
+    buf = rAllocBuf(PARSE_SIZE + 1024);
+    rPutStringToBuf(buf, "[");
+    for (i = 0; rGetBufLength(buf) < PARSE_SIZE; i++) {
+        rPutToBuf(buf, "%s{\"id\":\"01HX%08dKQ7Z3\",\"model\":\"Store\",\"key\":\"sensor-%d\",\"value\":%d.%d,"
+                  "\"updated\":\"2025-01-%02dT10:20:30.000Z\",\"note\":\"Line one\\nLine \\\"two\\\" \\\\ end\","
+                  "\"tags\":[\"temp\",\"hall\",%d],\"enabled\":true,\"owner\":null}",
+                  i ? "," : "", i, i % 100, i, i % 10, i % 28 + 1, i);
+    }
+    rPutStringToBuf(buf, "]");
+    return rBufToStringAndFree(buf);
+}
+
+/*
+    Human edited JSON5 configuration with comments and indentation
+ */
+static char *makeConfig(void)
+{
+    RBuf    *buf;
+    int     i;
+
+    buf = rAllocBuf(PARSE_SIZE + 1024);
+    rPutStringToBuf(buf, "{\n");
+    for (i = 0; rGetBufLength(buf) < PARSE_SIZE; i++) {
+        rPutToBuf(buf,
+                  "    // Settings for route %d\n"
+                  "    route%d: {\n"
+                  "        /*\n"
+                  "            Match requests for this prefix and apply the role based access checks\n"
+                  "         */\n"
+                  "        match: '/api/v%d/',\n"
+                  "        handler: 'action',\n"
+                  "        methods: ['GET', 'POST', 'PUT'],\n"
+                  "        timeouts: { inactivity: '5mins', request: '10mins' },\n"
+                  "        limits: { body: '100K', upload: '20MB' },\n"
+                  "    },\n", i, i, i);
+    }
+    rPutStringToBuf(buf, "}\n");
+    return rBufToStringAndFree(buf);
+}
+
+/*
+    Database items with long string values
+ */
+static char *makeStrings(void)
+{
+    RBuf    *buf;
+    int     i, j;
+
+    buf = rAllocBuf(PARSE_SIZE + 4096);
+    rPutStringToBuf(buf, "[");
+    for (i = 0; rGetBufLength(buf) < PARSE_SIZE; i++) {
+        rPutToBuf(buf, "%s{\"pk\":\"item#%d\",\"body\":\"", i ? "," : "", i);
+        for (j = 0; j < 16; j++) {
+            rPutStringToBuf(buf, "The quick brown fox jumps over the lazy dog while the device reports its state. ");
+        }
+        rPutStringToBuf(buf, "\",\"data\":\"");
+        for (j = 0; j < 24; j++) {
+            rPutStringToBuf(buf, "QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVo0NTY3ODkwYWJjZGVm");
+        }
+        rPutStringToBuf(buf, "\"}");
+    }
+    rPutStringToBuf(buf, "]");
+    return rBufToStringAndFree(buf);
+}
+
+static void benchParse(cchar *name, char *text, int flags)
+{
+    Json    *obj;
+    Ticks   mark, elapsed;
+    char    *copy;
+    size_t  len, total;
+    int     count;
+
+    len = slen(text);
+    total = 0;
+    count = 0;
+    elapsed = 0;
+    while (total < PARSE_BYTES) {
+        copy = sclone(text);
+        mark = rGetTicks();
+        obj = jsonAlloc();
+        if (jsonParseText(obj, copy, flags) < 0) {
+            tfail("Cannot parse %s benchmark document: %s", name, obj->error);
+            jsonFree(obj);
+            break;
+        }
+        elapsed += rGetTicks() - mark;
+        count = obj->count;
+        jsonFree(obj);
+        total += len;
+    }
+    ttrue(count > 0);
+    tinfo("Parse %-8s %7.1f MB/s (%d nodes, %d KB)", name,
+          (double) total / (1024.0 * 1024.0) / ((double) max(elapsed, 1) / 1000.0), count, (int) (len / 1024));
+    rFree(text);
+}
+
+/*
+    Read and update cached numeric values
+ */
+static void benchNumbers()
+{
+    Json    *obj;
+    Ticks   mark, getElapsed, setElapsed;
+    int64   sum;
+    int     i;
+
+    obj = parse("{metrics: {temp: 21, humidity: 40, pressure: 1013}}");
+    sum = 0;
+    mark = rGetTicks();
+    for (i = 0; i < NUMBER_ITERATIONS; i++) {
+        sum += jsonGetNum(obj, 0, "metrics.pressure", 0);
+    }
+    getElapsed = rGetTicks() - mark;
+    teqll(sum, (int64) NUMBER_ITERATIONS * 1013);
+
+    mark = rGetTicks();
+    for (i = 0; i < NUMBER_ITERATIONS; i++) {
+        jsonSetNumber(obj, 0, "metrics.temp", i);
+    }
+    setElapsed = rGetTicks() - mark;
+    teqll(jsonGetNum(obj, 0, "metrics.temp", 0), NUMBER_ITERATIONS - 1);
+
+    tinfo("%d numeric reads %lld msec, %d numeric updates %lld msec", NUMBER_ITERATIONS, (long long) getElapsed,
+          NUMBER_ITERATIONS, (long long) setElapsed);
+    jsonFree(obj);
+}
+
+/*
+    Build, update and free the same document with and without an arena
+ */
+static Ticks makeDocument(bool arena, Ticks *freeElapsed, int *chunks)
+{
+    Json    *obj;
+    Ticks   mark, elapsed;
+    char    key[32];
+    int     i;
+
+    mark = rGetTicks();
+    obj = jsonAlloc();
+    if (arena) {
+        jsonSetArena(obj, 0);
+    }
+    for (i = 0; i < ARENA_DEVICES; i++) {
+        jsonSetFmt(obj, 0, SFMT(key, "devices[%d].name", i), "device-%d", i);
+        jsonSetNumber(obj, 0, SFMT(key, "devices[%d].temp", i), i);
+        jsonSet(obj, 0, SFMT(key, "devices[%d].online", i), "true", 0);
+    }
+    for (i = 0; i < ARENA_DEVICES; i += 2) {
+        jsonSetNumber(obj, 0, SFMT(key, "devices[%d].temp", i), i + 1);
+        jsonSet(obj, 0, SFMT(key, "devices[%d].status", i), "updated", 0);
+    }
+    elapsed = rGetTicks() - mark;
+    *chunks = jsonGetArenaChunks(obj);
+
+    mark = rGetTicks();
+    jsonFree(obj);
+    *freeElapsed = rGetTicks() - mark;
+    return elapsed;
+}
+
+static void benchArena()
+{
+    Ticks   heapBuild, heapFree, arenaBuild, arenaFree;
+    int     heapChunks, arenaChunks;
+
+    heapBuild = makeDocument(0, &heapFree, &heapChunks);
+    arenaBuild = makeDocument(1, &arenaFree, &arenaChunks);
+    teqi(heapChunks, 0);
+    ttrue(arenaChunks > 0);
+    tinfo("Document with %d devices: heap build %lld msec, free %lld msec. Arena build %lld msec, free %lld msec "
+          "(%d chunks)", ARENA_DEVICES, (long long) heapBuild, (long long) heapFree, (long long) arenaBuild,
+          (long long) arenaFree, arenaChunks);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    benchBuild();
+    benchLookup();
+    benchParse("sync", makeSync(), 0);
+    benchParse("config", makeConfig(), 0);
+    benchParse("strings", makeStrings(), 0);
+    benchNumbers();
+    benchArena();
+    rTerm();
+    return 0;
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -0,0 +1,162 @@
+/*
+    builder.tst.c - Unit tests for the JSON builder
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+
+/*********************************** Locals ***********************************/
+
+#define PROPERTIES 10000
+
+/************************************ Code ************************************/
+
+static void builderBasic()
+{
+    Json    *obj;
+    char    *s;
+    int     nid;
+
+    obj = jsonAlloc();
+    teqi(jsonBuilderBegin(obj, JSON_OBJECT), 0);
+    ttrue(jsonBuilderValue(obj, "name", "john", 0) > 0);
+    ttrue(jsonBuilderValue(obj, "age", "42", 0) > 0);
+    ttrue(jsonBuilderValue(obj, "admin", "true", 0) > 0);
+    ttrue(jsonBuilderValue(obj, "nothing", NULL, 0) > 0);
+    nid = jsonBuilderObject(obj, "address");
+    ttrue(nid > 0);
+    ttrue(jsonBuilderValue(obj, "city", "Seattle", JSON_STRING) > 0);
+    ttrue(jsonBuilderArray(obj, "zip") > 0);
+    ttrue(jsonBuilderValue(obj, "ignored", "98101", 0) > 0);
+    ttrue(jsonBuilderValue(obj, NULL, "98102", JSON_STRING) > 0);
+    ttrue(jsonBuilderObject(obj, NULL) > 0);
+    ttrue(jsonBuilderValue(obj, "primary", "false", 0) > 0);
+    ttrue(jsonBuilderEnd(obj) > 0);
+    ttrue(jsonBuilderEnd(obj) > 0);
+    teqi(jsonBuilderEnd(obj), nid);
+
+    //  Still building so updates are not permitted
+    ttrue(jsonSet(obj, 0, "color", "red", 0) < 0);
+    teqi(jsonBuilderEnd(obj), 0);
+    teqi(jsonBuilderEnd(obj), R_ERR_BAD_STATE);
+
+    s = jsonToString(obj, 0, 0, JSON_JSON);
+    tmatch(s, "{\"name\":\"john\",\"age\":42,\"admin\":true,\"address\":{\"city\":\"Seattle\","
+           "\"zip\":[98101,\"98102\",{\"primary\":false}]}}");
+    rFree(s);
+    tmatch(jsonGet(obj, 0, "address.zip[2].primary", 0), "false");
+    teqi(jsonGetType(obj, 0, "address.zip[1]"), JSON_STRING);
+
+    //  Unlocked after the outermost close
+    ttrue(jsonSet(obj, 0, "address.country", "US", 0) > 0);
+    tmatch(jsonGet(obj, 0, "address.country", 0), "US");
+    tmatch(jsonGet(obj, 0, "address.zip[0]", 0), "98101");
+    jsonFree(obj);
+}
+
+static void builderErrors()
+{
+    Json    *obj;
+
+    teqi(jsonBuilderBegin(NULL, JSON_OBJECT), R_ERR_BAD_ARGS);
+
+    obj = jsonAlloc();
+    teqi(jsonBuilderValue(obj, "name", "john", 0), R_ERR_BAD_STATE);
+    teqi(jsonBuilderEnd(obj), R_ERR_BAD_STATE);
+    teqi(jsonBuilderBegin(obj, JSON_STRING), R_ERR_BAD_ARGS);
+    teqi(jsonBuilderBegin(obj, JSON_ARRAY), 0);
+    teqi(jsonBuilderBegin(obj, JSON_ARRAY), R_ERR_BAD_STATE);
+    teqi(jsonBuilderValue(obj, NULL, "{}", JSON_OBJECT), R_ERR_BAD_ARGS);
+    teqi(jsonBuilderEnd(obj), 0);
+    checkJson(obj, "[]", 0);
+    jsonFree(obj);
+
+    //  Properties of an object require a name and the JSON must be empty
+    obj = parse("{}");
+    teqi(jsonBuilderBegin(obj, JSON_OBJECT), R_ERR_BAD_STATE);
+    jsonFree(obj);
+
+    obj = jsonAlloc();
+    jsonBuilderBegin(obj, JSON_OBJECT);
+    teqi(jsonBuilderValue(obj, NULL, "1", 0), R_ERR_BAD_ARGS);
+    teqi(jsonBuilderObject(obj, NULL), R_ERR_BAD_ARGS);
+
+    //  Free while building
+    jsonFree(obj);
+}
+
+/*
+    Build the same 10K property object via jsonSet and the builder and compare
+ */
+static void builderCompare()
+{
+    Json    *setObj, *buildObj;
+    char    *setText, *buildText, key[32], value[32];
+    int     i;
+
+    setObj = jsonAlloc();
+    for (i = 0; i < PROPERTIES; i++) {
+        jsonSetFmt(setObj, 0, SFMT(key, "key-%d", i), "%d", i);
+    }
+    buildObj = jsonAlloc();
+    jsonBuilderBegin(buildObj, JSON_OBJECT);
+    for (i = 0; i < PROPERTIES; i++) {
+        jsonBuilderValue(buildObj, SFMT(key, "key-%d", i), SFMT(value, "%d", i), JSON_PRIMITIVE);
+    }
+    jsonBuilderEnd(buildObj);
+
+    teqi(setObj->count, PROPERTIES + 1);
+    teqi(buildObj->count, PROPERTIES + 1);
+    setText = jsonToString(setObj, 0, 0, JSON_JSON);
+    buildText = jsonToString(buildObj, 0, 0, JSON_JSON);
+    tmatch(setText, buildText);
+    tmatch(jsonGet(buildObj, 0, "key-9999", 0), "9999");
+
+    rFree(setText);
+    rFree(buildText);
+    jsonFree(setObj);
+    jsonFree(buildObj);
+}
+
+/*
+    Append to nested objects via jsonSet to exercise insertNodes fixup of ancestors and following nodes
+ */
+static void insertNested()
+{
+    Json    *obj;
+    char    key[32];
+    int     i;
+
+    obj = parse("{a:{b:{c:1}},d:{e:2},f:[1,2]}");
+    for (i = 0; i < 100; i++) {
+        jsonSetNumber(obj, 0, SFMT(key, "a.b.n%d", i), i);
+        jsonSetNumber(obj, 0, SFMT(key, "d.m%d", i), i);
+        jsonSetNumber(obj, 0, "f[$]", i);
+    }
+    tmatch(jsonGet(obj, 0, "a.b.c", 0), "1");
+    tmatch(jsonGet(obj, 0, "a.b.n99", 0), "99");
+    tmatch(jsonGet(obj, 0, "d.e", 0), "2");
+    tmatch(jsonGet(obj, 0, "d.m99", 0), "99");
+    tmatch(jsonGet(obj, 0, "f[101]", 0), "99");
+    teqi(obj->nodes[0].last, obj->count);
+    jsonFree(obj);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    builderBasic();
+    builderErrors();
+    builderCompare();
+    insertNested();
+    rTerm();
+    return 0;
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
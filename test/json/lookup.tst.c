@@ -0,0 +1,177 @@
+/*
+    lookup.tst.c - Unit tests for property lookup in large objects
+
+    Objects with more than ME_JSON_INDEX properties are indexed on lookup. These tests modify indexed
+    objects and verify that lookups remain correct.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+
+/*********************************** Locals ***********************************/
+
+#define PROPERTIES 1000
+
+/************************************ Code ************************************/
+
+static Json *makeObject(int count)
+{
+    Json    *obj;
+    char    key[32], value[32];
+    int     i;
+
+    obj = jsonAlloc();
+    jsonBuilderBegin(obj, JSON_OBJECT);
+    for (i = 0; i < count; i++) {
+        if (i == count / 2) {
+            jsonBuilderObject(obj, "nested");
+            jsonBuilderValue(obj, "color", "red", 0);
+            jsonBuilderEnd(obj);
+        }
+        jsonBuilderValue(obj, SFMT(key, "key-%d", i), SFMT(value, "%d", i), JSON_PRIMITIVE);
+    }
+    jsonBuilderEnd(obj);
+    return obj;
+}
+
+static void lookupBasic()
+{
+    Json    *obj;
+    char    key[32], value[32];
+    int     i;
+
+    obj = makeObject(PROPERTIES);
+    for (i = 0; i < PROPERTIES; i += 7) {
+        tmatch(jsonGet(obj, 0, SFMT(key, "key-%d", i), 0), SFMT(value, "%d", i));
+    }
+    tmatch(jsonGet(obj, 0, "nested.color", 0), "red");
+    tnull(jsonGet(obj, 0, "missing", 0));
+    tmatch(jsonGet(obj, 0, "missing", "default"), "default");
+    jsonFree(obj);
+
+    //  Small objects and duplicate properties return the first match
+    obj = parse("{a:1,b:2,a:3}");
+    tmatch(jsonGet(obj, 0, "a", 0), "1");
+    jsonFree(obj);
+
+    obj = makeObject(PROPERTIES);
+    jsonSet(obj, 0, "key-0", "first", 0);
+    tmatch(jsonGet(obj, 0, "key-1", 0), "1");
+    tmatch(jsonGet(obj, 0, "key-0", 0), "first");
+    jsonFree(obj);
+}
+
+static void lookupMutate()
+{
+    Json    *obj, *src;
+    char    key[32];
+    int     i;
+
+    obj = makeObject(PROPERTIES);
+    tmatch(jsonGet(obj, 0, "key-999", 0), "999");
+
+    //  Append after the index is built
+    for (i = 0; i < 100; i++) {
+        jsonSetNumber(obj, 0, SFMT(key, "new-%d", i), i);
+        tmatch(jsonGet(obj, 0, key, 0), key + 4);
+    }
+    tmatch(jsonGet(obj, 0, "key-999", 0), "999");
+
+    //  Insert into a nested object which moves the following properties
+    jsonSet(obj, 0, "nested.size", "large", 0);
+    tmatch(jsonGet(obj, 0, "nested.size", 0), "large");
+    tmatch(jsonGet(obj, 0, "key-999", 0), "999");
+    tmatch(jsonGet(obj, 0, "new-99", 0), "99");
+
+    //  Remove properties
+    jsonRemove(obj, 0, "key-10");
+    tnull(jsonGet(obj, 0, "key-10", 0));
+    tmatch(jsonGet(obj, 0, "key-11", 0), "11");
+    jsonRemove(obj, 0, "nested");
+    tnull(jsonGet(obj, 0, "nested.color", 0));
+    tmatch(jsonGet(obj, 0, "key-999", 0), "999");
+
+    //  Change the type of a property which renames and replaces nodes
+    jsonSet(obj, 0, "key-20.inner", "value", 0);
+    tmatch(jsonGet(obj, 0, "key-20.inner", 0), "value");
+    tmatch(jsonGet(obj, 0, "key-21", 0), "21");
+
+    //  Blend into the object
+    src = parse("{'key-30': {deep: true}, extra: 42}");
+    jsonBlend(obj, 0, 0, src, 0, 0, 0);
+    tmatch(jsonGet(obj, 0, "key-30.deep", 0), "true");
+    tmatch(jsonGet(obj, 0, "extra", 0), "42");
+    tmatch(jsonGet(obj, 0, "key-998", 0), "998");
+    jsonFree(src);
+    jsonFree(obj);
+}
+
+static void lookupMany()
+{
+    Json    *obj, *clone;
+    char    key[32], value[32];
+    int     i, j;
+
+    /*
+        Several large objects and many small objects in one document
+     */
+    obj = jsonAlloc();
+    jsonBuilderBegin(obj, JSON_OBJECT);
+    for (i = 0; i < 100; i++) {
+        jsonBuilderObject(obj, SFMT(key, "small-%d", i));
+        jsonBuilderValue(obj, "color", "red", 0);
+        jsonBuilderEnd(obj);
+    }
+    for (i = 0; i < 20; i++) {
+        jsonBuilderObject(obj, SFMT(key, "obj-%d", i));
+        for (j = 0; j < 100; j++) {
+            jsonBuilderValue(obj, SFMT(key, "p%d", j), SFMT(value, "%d", i * 100 + j), JSON_PRIMITIVE);
+        }
+        jsonBuilderEnd(obj);
+    }
+    jsonBuilderEnd(obj);
+    for (i = 0; i < 20; i++) {
+        for (j = 0; j < 100; j += 9) {
+            teqi(jsonGetInt(obj, 0, SFMT(key, "obj-%d.p%d", i, j), 0), i * 100 + j);
+        }
+    }
+    jsonSetNumber(obj, 0, "obj-5.extra", 1);
+    for (i = 0; i < 20; i++) {
+        teqi(jsonGetInt(obj, 0, SFMT(key, "obj-%d.p99", i), 0), i * 100 + 99);
+    }
+    teqi(jsonGetInt(obj, 0, "obj-5.extra", 0), 1);
+
+    //  Only large objects are indexed
+    tmatch(jsonGet(obj, 0, "small-50.color", 0), "red");
+    tfalse(jsonGetNode(obj, 0, "small-50")->indexed);
+    ttrue(jsonGetNode(obj, 0, "obj-5")->indexed);
+
+    //  Clones have their own indexes
+    clone = jsonClone(obj, 0);
+    jsonRemove(clone, 0, "obj-5.p10");
+    for (i = 0; i < 20; i++) {
+        teqi(jsonGetInt(clone, 0, SFMT(key, "obj-%d.p50", i), 0), i * 100 + 50);
+    }
+    tnull(jsonGet(clone, 0, "obj-5.p10", 0));
+    teqi(jsonGetInt(obj, 0, "obj-5.p10", 0), 510);
+    jsonFree(clone);
+    jsonFree(obj);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    lookupBasic();
+    lookupMutate();
+    lookupMany();
+    rTerm();
+    return 0;
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -106,12 +106,155 @@ static void jsonUserFlagsTest()
     jsonFree(obj);
 }
 
+/*
+    Count the names and values individually allocated from the heap. Each is a separate rFree in jsonFree.
+ */
+static int countAllocated(Json *obj)
+{
+    JsonNode    *node;
+    int         count;
+
+    count = 0;
+    for (node = obj->nodes; node < &obj->nodes[obj->count]; node++) {
+        count += node->allocatedName + node->allocatedValue;
+    }
+    return count;
+}
+
+static void jsonArenaTest()
+{
+    Json    *obj, *clone, *src;
+    cchar   *value;
+    char    *big, key[32];
+    int     i;
+
+    ttrue(jsonSetArena(NULL, 0) < 0);
+    teqi(jsonGetArenaChunks(NULL), 0);
+
+    obj = parse("{name: 'John', age: 30, list: [1, 2], nested: {a: true}}");
+    teqi(jsonGetArenaChunks(obj), 0);
+    teqi(jsonSetArena(obj, 256), 0);
+
+    // Parsed strings are not copied. Updated strings come from the arena.
+    teqi(jsonGetArenaChunks(obj), 0);
+    jsonSet(obj, 0, "name", "Jane", 0);
+    jsonSet(obj, 0, "nested.b", "hello", 0);
+    jsonSetNumber(obj, 0, "list[$]", 3);
+    teqi(jsonGetArenaChunks(obj), 1);
+    checkValue(obj, "name", "Jane");
+    checkValue(obj, "nested.b", "hello");
+    checkValue(obj, "list[2]", "3");
+
+    // Numbers are updated in-place in an arena buffer
+    jsonSetNumber(obj, 0, "age", 31);
+    value = jsonGet(obj, 0, "age", 0);
+    for (i = 32; i < 100; i++) {
+        jsonSetNumber(obj, 0, "age", i);
+        ttrue(jsonGet(obj, 0, "age", 0) == value);
+    }
+    checkValue(obj, "age", "99");
+
+    // Changing to a string value and back does not reuse the arena number buffer for a heap string
+    jsonSet(obj, 0, "age", "a longer string value than a number buffer", 0);
+    jsonSetNumber(obj, 0, "age", 12);
+    checkValue(obj, "age", "12");
+
+    // Many small strings fill several chunks
+    for (i = 0; i < 100; i++) {
+        jsonSetFmt(obj, 0, SFMT(key, "key-%d", i), "value-%d", i);
+    }
+    ttrue(jsonGetArenaChunks(obj) > 1);
+    checkValue(obj, "key-0", "value-0");
+    checkValue(obj, "key-99", "value-99");
+
+    // Large strings get a dedicated chunk
+    big = sfmt("%*s", 1000, "x");
+    jsonSet(obj, 0, "big", big, JSON_STRING);
+    tmatch(jsonGet(obj, 0, "big", 0), big);
+    jsonSet(obj, 0, "after", "small", 0);
+    checkValue(obj, "after", "small");
+    rFree(big);
+
+    // Blend, remove and clone
+    src = parse("{nested: {c: [1, 2, {d: 'deep'}]}, extra: 'more'}");
+    jsonBlend(obj, 0, 0, src, 0, 0, 0);
+    jsonFree(src);
+    checkValue(obj, "nested.c[2].d", "deep");
+    checkValue(obj, "extra", "more");
+    jsonRemove(obj, 0, "key-50");
+    tnull(jsonGet(obj, 0, "key-50", 0));
+    checkValue(obj, "key-51", "value-51");
+
+    clone = jsonClone(obj, 0);
+    ttrue(jsonGetArenaChunks(clone) > 0);
+    teqi(countAllocated(clone), 0);
+    checkValue(clone, "nested.c[2].d", "deep");
+    checkValue(clone, "age", "12");
+    jsonSetNumber(clone, 0, "age", 13);
+    checkValue(clone, "age", "13");
+    checkValue(obj, "age", "12");
+
+    teqi(countAllocated(obj), 0);
+    jsonFree(obj);
+    jsonFree(clone);
+}
+
+/*
+    Build and update the same document with and without an arena
+ */
+static Json *makeDocument(bool arena)
+{
+    Json    *obj;
+    char    key[32];
+    int     i;
+
+    obj = jsonAlloc();
+    if (arena) {
+        jsonSetArena(obj, 0);
+    }
+    for (i = 0; i < 1000; i++) {
+        jsonSetFmt(obj, 0, SFMT(key, "devices[%d].name", i), "device-%d", i);
+        jsonSetNumber(obj, 0, SFMT(key, "devices[%d].temp", i), i);
+        jsonSet(obj, 0, SFMT(key, "devices[%d].online", i), "true", 0);
+    }
+    for (i = 0; i < 1000; i += 2) {
+        jsonSetNumber(obj, 0, SFMT(key, "devices[%d].temp", i), i + 1);
+        jsonSet(obj, 0, SFMT(key, "devices[%d].status", i), "updated", 0);
+    }
+    return obj;
+}
+
+static void jsonArenaCounts()
+{
+    Json    *heap, *arena;
+    char    *heapText, *arenaText;
+    int     heapCount, arenaCount;
+
+    heap = makeDocument(0);
+    arena = makeDocument(1);
+    heapText = jsonToString(heap, 0, 0, JSON_JSON);
+    arenaText = jsonToString(arena, 0, 0, JSON_JSON);
+    tmatch(heapText, arenaText);
+    rFree(heapText);
+    rFree(arenaText);
+
+    heapCount = countAllocated(heap);
+    arenaCount = countAllocated(arena) + jsonGetArenaChunks(arena);
+    teqi(countAllocated(arena), 0);
+    teqi(jsonGetArenaChunks(heap), 0);
+    ttrue(arenaCount * 100 < heapCount);
+    jsonFree(heap);
+    jsonFree(arena);
+}
+
 int main(void)
 {
     rInit(0, 0);
     jsonMemoryTest();
     jsonLockTest();
     jsonUserFlagsTest();
+    jsonArenaTest();
+    jsonArenaCounts();
     rTerm();
     return 0;
 }
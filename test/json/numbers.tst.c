@@ -0,0 +1,131 @@
+/*
+    numbers.tst.c - Unit tests for cached numeric values
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+
+/************************************ Code ************************************/
+
+static void numberGet()
+{
+    Json    *obj;
+
+    obj = parse("{count: 42, ratio: 1.5, big: 9007199254740993, text: '12abc', none: null, list: [1], "
+                "when: '2025-01-02T03:04:05.000Z', epoch: 1700000000000, flag: true}");
+
+    //  Repeated reads return the cached value
+    teqll(jsonGetNum(obj, 0, "count", 0), 42);
+    teqll(jsonGetNum(obj, 0, "count", 0), 42);
+    teqi(jsonGetInt(obj, 0, "count", 0), 42);
+    ttrue(jsonGetDouble(obj, 0, "ratio", 0) == 1.5);
+    ttrue(jsonGetDouble(obj, 0, "ratio", 0) == 1.5);
+    teqll(jsonGetNum(obj, 0, "ratio", 0), 1);
+    ttrue(jsonGetDouble(obj, 0, "ratio", 0) == 1.5);
+    teqll(jsonGetNum(obj, 0, "big", 0), 9007199254740993LL);
+    teqll(jsonGetNum(obj, 0, "text", 0), 12);
+    teqll(jsonGetNum(obj, 0, "flag", 7), 0);
+
+    //  Missing, null and container values
+    teqll(jsonGetNum(obj, 0, "missing", 7), 7);
+    teqi(jsonGetInt(obj, 0, "none", 7), 7);
+    ttrue(jsonGetDouble(obj, 0, "missing", 0.25) == 0.25);
+    teqll(jsonGetNum(obj, 0, "list", 7), 0);
+
+    //  Dates from ISO strings and numbers
+    teqll(jsonGetDate(obj, 0, "when", 0), rParseIsoDate("2025-01-02T03:04:05.000Z"));
+    teqll(jsonGetDate(obj, 0, "when", 0), rParseIsoDate("2025-01-02T03:04:05.000Z"));
+    teqll(jsonGetDate(obj, 0, "epoch", 0), 1700000000000LL);
+    teqll(jsonGetDate(obj, 0, "missing", 99), 99);
+    jsonFree(obj);
+}
+
+static void numberUpdate()
+{
+    Json    *obj, *src;
+    cchar   *value;
+    int     i;
+
+    /*
+        The cache must follow every kind of value update
+     */
+    obj = parse("{count: 42, child: {n: 1}}");
+    teqll(jsonGetNum(obj, 0, "count", 0), 42);
+    jsonSet(obj, 0, "count", "43", 0);
+    teqll(jsonGetNum(obj, 0, "count", 0), 43);
+    jsonSetFmt(obj, 0, "count", "%d", 44);
+    teqll(jsonGetNum(obj, 0, "count", 0), 44);
+    jsonSetDouble(obj, 0, "count", 2.5);
+    ttrue(jsonGetDouble(obj, 0, "count", 0) == 2.5);
+    teqll(jsonGetNum(obj, 0, "count", 0), 2);
+    jsonSetString(obj, 0, "count", "77");
+    teqll(jsonGetNum(obj, 0, "count", 0), 77);
+    jsonSet(obj, 0, "count", "null", JSON_PRIMITIVE);
+    teqll(jsonGetNum(obj, 0, "count", 5), 5);
+    jsonSetNodeValue(jsonGetNode(obj, 0, "count"), "88", JSON_PRIMITIVE, 0);
+    teqll(jsonGetNum(obj, 0, "count", 0), 88);
+
+    src = parse("{count: 99, child: {n: 2}}");
+    teqll(jsonGetNum(obj, 0, "child.n", 0), 1);
+    jsonBlend(obj, 0, 0, src, 0, 0, 0);
+    teqll(jsonGetNum(obj, 0, "count", 0), 99);
+    teqll(jsonGetNum(obj, 0, "child.n", 0), 2);
+    jsonFree(src);
+
+    //  Replace and append blends rewrite the value in place
+    jsonSetNumber(obj, 0, "count", 57);
+    teqll(jsonGetNum(obj, 0, "count", 0), 57);
+    src = parse("{count: 7}");
+    jsonBlend(obj, 0, 0, src, 0, 0, JSON_REPLACE);
+    tmatch(jsonGet(obj, 0, "count", 0), "5");
+    teqll(jsonGetNum(obj, 0, "count", 0), 5);
+    jsonBlend(obj, 0, 0, src, 0, 0, JSON_APPEND);
+    tmatch(jsonGet(obj, 0, "count", 0), "5 7");
+    jsonFree(src);
+
+    //  Repeated numeric updates reuse the value buffer
+    jsonSetNumber(obj, 0, "count", 1);
+    jsonSetNumber(obj, 0, "count", 2);
+    value = jsonGet(obj, 0, "count", 0);
+    for (i = 3; i < 100; i++) {
+        jsonSetNumber(obj, 0, "count", i);
+        ttrue(jsonGet(obj, 0, "count", 0) == value);
+    }
+    tmatch(value, "99");
+    teqll(jsonGetNum(obj, 0, "count", 0), 99);
+    jsonSetDouble(obj, 0, "count", 1.25);
+    ttrue(jsonGet(obj, 0, "count", 0) == value);
+    tmatch(value, "1.250000");
+    jsonSetNumber(obj, 0, "count", -9223372036854775807LL - 1);
+    tmatch(jsonGet(obj, 0, "count", 0), "-9223372036854775808");
+    teqll(jsonGetNum(obj, 0, "count", 0), -9223372036854775807LL - 1);
+    checkJson(obj, "{count:-9223372036854775808,child:{n:2}}", 0);
+
+    //  New numbers
+    jsonSetNumber(obj, 0, "child.m", 3);
+    teqll(jsonGetNum(obj, 0, "child.m", 0), 3);
+    checkJson(obj, "{count:-9223372036854775808,child:{n:2,m:3}}", 0);
+
+    //  Locked objects cannot be updated
+    jsonLock(obj);
+    ttrue(jsonSetNumber(obj, 0, "count", 5) < 0);
+    jsonUnlock(obj);
+    jsonFree(obj);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    numberGet();
+    numberUpdate();
+    rTerm();
+    return 0;
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
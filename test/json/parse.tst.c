@@ -0,0 +1,139 @@
+/*
+    parse.tst.c - Unit tests for the JSON parser
+
+    The boundary tests place quotes, escapes, comments and whitespace at every offset relative to the
+    block size used by the vectorized scanner.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+
+/************************************ Code ************************************/
+
+static void parseStrings()
+{
+    Json    *obj;
+    char    *text, *expect;
+    int     i;
+
+    /*
+        Escapes and the closing quote at each offset over several blocks
+     */
+    for (i = 0; i < 70; i++) {
+        text = sfmt("{s:\"%*s\\\"x\\\\y\\n\\u0041\",t:'%*s',u:`%*sz`}", i, "", i, "", i, "");
+        obj = parse(text);
+        tnotnull(obj);
+        expect = sfmt("%*s\"x\\y\nA", i, "");
+        tmatch(jsonGet(obj, 0, "s", 0), expect);
+        rFree(expect);
+        expect = sfmt("%*s", i, "");
+        tmatch(jsonGet(obj, 0, "t", 0), expect);
+        rFree(expect);
+        expect = sfmt("%*sz", i, "");
+        tmatch(jsonGet(obj, 0, "u", 0), expect);
+        rFree(expect);
+        jsonFree(obj);
+        rFree(text);
+    }
+
+    //  Other quote characters and control characters are retained
+    obj = parse("{a:\"it's `ok`\",b:'say \"hi\"',c:\"tab\there\"}");
+    tmatch(jsonGet(obj, 0, "a", 0), "it's `ok`");
+    tmatch(jsonGet(obj, 0, "b", 0), "say \"hi\"");
+    tmatch(jsonGet(obj, 0, "c", 0), "tab\there");
+    jsonFree(obj);
+
+    //  Errors
+    for (i = 0; i < 40; i++) {
+        text = sfmt("{s:\"%*s", i, "");
+        tfalse(quiet(text));
+        rFree(text);
+        text = sfmt("{s:\"%*s\\q\"}", i, "");
+        tfalse(quiet(text));
+        rFree(text);
+    }
+    tfalse(quiet("{s:\"abc\\u12\"}"));
+    tfalse(quiet("{s:\"abc\\u12zz\"}"));
+}
+
+static void parseSpace()
+{
+    Json    *obj;
+    char    *text, *error;
+    int     i;
+
+    /*
+        Whitespace runs of each length and line counting for error messages
+     */
+    for (i = 0; i < 70; i++) {
+        text = sfmt("{%*s\n\t\r a%*s:%*s1 ,\n%*sb: [ %*s2 ]%*s}", i, "", i, "", i, "", i, "", i, "", i, "");
+        obj = parse(text);
+        tnotnull(obj);
+        tmatch(jsonGet(obj, 0, "a", 0), "1");
+        tmatch(jsonGet(obj, 0, "b[0]", 0), "2");
+        jsonFree(obj);
+        rFree(text);
+    }
+    for (i = 1; i < 70; i++) {
+        text = sfmt("{%*s\n%*s\n\n%*s\r\n\t%*s#}", i, "", i, "", i, "", i, "");
+        obj = jsonParseString(text, &error, 0);
+        tnull(obj);
+        tcontains(error, "line 6");
+        rFree(error);
+        rFree(text);
+    }
+}
+
+static void parseComments()
+{
+    Json    *obj;
+    char    *text, *error;
+    int     i;
+
+    for (i = 0; i < 70; i++) {
+        text = sfmt("{// %*s\n a: 1, /* %*s \n * / ** %*s*/ b: 2 /*%*s*/}", i, "x", i, "y", i, "", i, "");
+        obj = parse(text);
+        tnotnull(obj);
+        tmatch(jsonGet(obj, 0, "a", 0), "1");
+        tmatch(jsonGet(obj, 0, "b", 0), "2");
+        jsonFree(obj);
+        rFree(text);
+    }
+    for (i = 0; i < 40; i++) {
+        text = sfmt("{a: 1 /* %*s\n\n", i, "");
+        obj = jsonParseString(text, &error, 0);
+        tnull(obj);
+        tcontains(error, "Cannot find end of comment started on line 1");
+        rFree(error);
+        rFree(text);
+    }
+    //  Line comment at the end of the text
+    obj = parse("{a: 1} // trailing");
+    tmatch(jsonGet(obj, 0, "a", 0), "1");
+    jsonFree(obj);
+
+    //  Line numbers following comments
+    text = sfmt("{\n// one\n/* two\nthree\n*/\n#}");
+    tnull(jsonParseString(text, &error, 0));
+    tcontains(error, "line 7");
+    rFree(error);
+    rFree(text);
+}
+
+int main(void)
+{
+    rInit(0, 0);
+    parseStrings();
+    parseSpace();
+    parseComments();
+    rTerm();
+    return 0;
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -171,6 +171,33 @@ static void iterateHash()
     rFreeHash(table);
 }
 
+static void clearHash()
+{
+    RHash *table;
+    char  name[32];
+    int   i;
+
+    table = rAllocHash(0, R_TEMPORAL_NAME | R_DYNAMIC_VALUE);
+    for (i = 0; i < HASH_COUNT; i++) {
+        sfmtbuf(name, sizeof(name), "name.%d", i);
+        rAddName(table, name, sclone(name), 0);
+    }
+    teqz(rGetHashLength(table), HASH_COUNT);
+
+    rClearHash(table);
+    teqz(rGetHashLength(table), 0);
+    tnull(rGetNextName(table, 0));
+    tnull(rLookupName(table, "name.1"));
+
+    //  Cleared table is reusable
+    for (i = 0; i < HASH_COUNT; i++) {
+        sfmtbuf(name, sizeof(name), "name.%d", i);
+        rAddName(table, name, sclone(name), 0);
+    }
+    teqz(rGetHashLength(table), HASH_COUNT);
+    tmatch(rLookupName(table, "name.7"), "name.7");
+    rFreeHash(table);
+}
 
 int main(void)
 {
@@ -180,6 +207,7 @@ int main(void)
     inserAndRemoveHash();
     hashScale();
     iterateHash();
+    clearHash();
     rTerm();
     return 0;
 }
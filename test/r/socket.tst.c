@@ -124,9 +124,10 @@ static RSocket *openServer(TestSocket *tp, cchar *host)
 }
 
 
-static void clientServer(cchar *host)
+static void clientServer(cchar *host, bool vector)
 {
     RSocket *sp;
+    RIOVec  iov[3];
     char    *buf;
     ssize   nbytes;
     int     i, rc, count;
@@ -153,7 +154,18 @@ static void clientServer(cchar *host)
     count = 10000;
 
     for (i = 0; i < count; i++) {
-        nbytes = rWriteSocket(sp, buf, slen(buf), ts->deadline);
+        if (vector) {
+            //  Gathered write including an empty element
+            iov[0].base = buf;
+            iov[0].len = 10;
+            iov[1].base = &buf[10];
+            iov[1].len = 0;
+            iov[2].base = &buf[10];
+            iov[2].len = slen(buf) - 10;
+            nbytes = rWriteSocketv(sp, iov, 3, ts->deadline);
+        } else {
+            nbytes = rWriteSocket(sp, buf, slen(buf), ts->deadline);
+        }
         if (nbytes < 0) {
             ttrue(nbytes > 0);
             break;
@@ -164,6 +176,8 @@ static void clientServer(cchar *host)
 
     //  Wait for read side to resume when read is complete
     rYieldFiber(0);
+    ttrue(sncmp(rGetBufStart(ts->buf), buf, slen(buf)) == 0);
+    ttrue(sncmp(rGetBufEnd(ts->buf) - slen(buf), buf, slen(buf)) == 0);
 
     //  Test complete
     rFreeSocket(ts->listen);
@@ -192,18 +206,24 @@ static void acceptFn(TestSocket *tp, RSocket *sp)
 
 static void clientServerIPv4()
 {
-    clientServer("127.0.0.1");
+    clientServer("127.0.0.1", 0);
 }
 
 
 static void clientServerIPv6()
 {
     if (hasIPv6) {
-        clientServer("::1");
+        clientServer("::1", 0);
     }
 }
 
 
+static void clientServerVector()
+{
+    clientServer("127.0.0.1", 1);
+}
+
+
 #if ME_COM_SSL && UNUSED
 static void clientSslv4()
 {
@@ -240,6 +260,7 @@ static void fiberMain(void *arg)
 #if !WIN
     clientServerIPv4();
     clientServerIPv6();
+    clientServerVector();
 #endif
 #if ME_COM_SSL && UNUSED
     clientSslv4();
@@ -0,0 +1,268 @@
+/*
+    timers.tst.c - Event queue scaling tests and microbenchmark
+
+    Schedules, cancels and runs a large number of timer events and verifies they run in due order.
+    Also verifies I/O wait deadlines expire on time, cancelled deadlines do not fire and handlers that set
+    expired deadlines do not starve other events.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "testme.h"
+#include    "r.h"
+
+/*********************************** Locals ***********************************/
+
+#define TIMER_COUNT 100000
+#define DELAYS      100             //  Distinct delays
+#define DELAY_STEP  5               //  Msec between distinct delays
+
+static REvent ids[TIMER_COUNT];
+static Ticks  due[TIMER_COUNT];     //  Earliest time each event may run
+static int    lastRun[DELAYS];      //  Last event index run for each delay
+static int    runCount;
+static int    earlyCount;
+static int    orderErrors;
+
+#define WAIT_COUNT  200             //  I/O waits with deadlines
+
+static RWait  *waits[WAIT_COUNT];
+static Ticks  waitDue[WAIT_COUNT];
+static int    fds[WAIT_COUNT][2];
+static int    expiredCount;
+
+#define REARM_COUNT 1000            //  Times a wait sets an already expired deadline
+
+static int    rearmCount;
+static int    rearmSeen;
+
+/************************************ Code ************************************/
+
+static int getDelay(int i)
+{
+    return (int) ((i * 7919L) % DELAYS);
+}
+
+static void timerProc(void *arg)
+{
+    ssize i;
+    int   slot;
+
+    i = (ssize) arg;
+    if (rGetTicks() < due[i]) {
+        earlyCount++;
+    }
+    //  Events with the same delay were scheduled in index order and must run in that order
+    slot = getDelay((int) i);
+    if (lastRun[slot] >= i) {
+        orderErrors++;
+    }
+    lastRun[slot] = (int) i;
+    runCount++;
+}
+
+static void scheduleTimers(void)
+{
+    Ticks start, elapsed;
+    ssize i;
+    int   d;
+
+    for (d = 0; d < DELAYS; d++) {
+        lastRun[d] = -1;
+    }
+    runCount = earlyCount = orderErrors = 0;
+
+    start = rGetTicks();
+    for (i = 0; i < TIMER_COUNT; i++) {
+        d = getDelay((int) i) * DELAY_STEP;
+        due[i] = rGetTicks() + d;
+        ids[i] = rAllocEvent(NULL, timerProc, (void*) i, d, R_EVENT_FAST);
+        tneqz(ids[i], 0);
+    }
+    elapsed = rGetTicks() - start;
+    tinfo("Schedule %d timers: %lld msec", TIMER_COUNT, (int64) elapsed);
+
+    //  Wait for all timers to run
+    start = rGetTicks();
+    while (runCount < TIMER_COUNT && rGetTicks() - start < 30 * TPS) {
+        rSleep(DELAYS * DELAY_STEP);
+    }
+    elapsed = rGetTicks() - start;
+    tinfo("Run %d timers: %lld msec", TIMER_COUNT, (int64) elapsed);
+
+    teqi(runCount, TIMER_COUNT);
+    teqi(earlyCount, 0);
+    teqi(orderErrors, 0);
+}
+
+static void cancelTimers(void)
+{
+    Ticks start, elapsed;
+    ssize i, j;
+    int   count;
+
+    runCount = 0;
+    for (i = 0; i < TIMER_COUNT; i++) {
+        ids[i] = rAllocEvent(NULL, timerProc, (void*) i, 3600 * TPS + getDelay((int) i), R_EVENT_FAST);
+    }
+    ttrue(rLookupEvent(ids[0]));
+    ttrue(rLookupEvent(ids[TIMER_COUNT - 1]));
+
+    //  Cancel in a scattered order so removals come from throughout the queue
+    start = rGetTicks();
+    count = 0;
+    for (i = 0; i < TIMER_COUNT; i++) {
+        j = (i * 7919L) % TIMER_COUNT;
+        if (rStopEvent(ids[j]) == 0) {
+            count++;
+        }
+    }
+    elapsed = rGetTicks() - start;
+    tinfo("Cancel %d timers: %lld msec", TIMER_COUNT, (int64) elapsed);
+
+    teqi(count, TIMER_COUNT);
+    tfalse(rLookupEvent(ids[0]));
+    tfalse(rLookupEvent(ids[TIMER_COUNT - 1]));
+    teqi(rStopEvent(ids[0]), R_ERR_CANT_FIND);
+    teqi(runCount, 0);
+}
+
+static void runEarly(void)
+{
+    REvent early, late;
+    ssize  i;
+
+    //  Run a long delayed event now, ahead of earlier due events
+    runCount = 0;
+    for (i = 0; i < DELAYS; i++) {
+        lastRun[i] = -1;
+    }
+    i = 0;
+    due[i] = 0;
+    late = rAllocEvent(NULL, timerProc, (void*) i, 3600 * TPS, R_EVENT_FAST);
+    early = rAllocEvent(NULL, timerProc, (void*) (i + DELAYS), 3600 * TPS, R_EVENT_FAST);
+    due[i + DELAYS] = 0;
+    teqi(rRunEvent(late), 0);
+    rSleep(20);
+    teqi(runCount, 1);
+    tfalse(rLookupEvent(late));
+    ttrue(rLookupEvent(early));
+    teqi(rStopEvent(early), 0);
+}
+
+static void waitProc(cvoid *arg, int mask)
+{
+    ssize i;
+
+    i = (ssize) arg;
+    if (rGetTicks() < waitDue[i] || mask != 0 || (i % 2)) {
+        earlyCount++;
+    }
+    expiredCount++;
+}
+
+static void ioDeadlines(void)
+{
+    Ticks start;
+    ssize i;
+
+    expiredCount = earlyCount = 0;
+    for (i = 0; i < WAIT_COUNT; i++) {
+        ttrue(pipe(fds[i]) == 0);
+        waits[i] = rAllocWait(fds[i][0]);
+        tnotnull(waits[i]);
+        waitDue[i] = rGetTicks() + 10 + (i * 7919L) % 200;
+        rSetWaitHandler(waits[i], waitProc, (void*) i, 0, 0, R_WAIT_MAIN_FIBER);
+        rSetWaitMask(waits[i], R_READABLE, waitDue[i]);
+    }
+    //  Cancel the deadlines of odd waits. These must never fire.
+    for (i = 1; i < WAIT_COUNT; i += 2) {
+        rSetWaitMask(waits[i], R_READABLE, 0);
+    }
+    start = rGetTicks();
+    while (expiredCount < WAIT_COUNT / 2 && rGetTicks() - start < 10 * TPS) {
+        rSleep(50);
+    }
+    rSleep(50);
+    teqi(expiredCount, WAIT_COUNT / 2);
+    teqi(earlyCount, 0);
+
+    for (i = 0; i < WAIT_COUNT; i++) {
+        rFreeWait(waits[i]);
+        close(fds[i][0]);
+        close(fds[i][1]);
+    }
+}
+
+static void noteRearm(void *arg)
+{
+    rearmSeen = rearmCount;
+}
+
+static void rearmProc(cvoid *arg, int mask)
+{
+    if (++rearmCount == 1) {
+        rStartEvent(noteRearm, 0, 0);
+    }
+    if (rearmCount < REARM_COUNT) {
+        rSetWaitMask((RWait*) arg, R_READABLE, rGetTicks() - 1);
+    }
+}
+
+/*
+    A wait that keeps setting an expired deadline must not starve other events
+ */
+static void expiredRearm(void)
+{
+    RWait *wp;
+    Ticks start;
+    int   fd[2];
+
+    ttrue(pipe(fd) == 0);
+    wp = rAllocWait(fd[0]);
+    tnotnull(wp);
+    rearmCount = 0;
+    rearmSeen = -1;
+    rSetWaitHandler(wp, rearmProc, wp, 0, 0, R_WAIT_MAIN_FIBER);
+    rSetWaitMask(wp, R_READABLE, rGetTicks() + 10);
+
+    start = rGetTicks();
+    while (rearmCount < REARM_COUNT && rGetTicks() - start < 10 * TPS) {
+        rSleep(10);
+    }
+    teqi(rearmCount, REARM_COUNT);
+    //  The event started by the first invocation ran while the wait was still being rearmed
+    ttrue(rearmSeen >= 0 && rearmSeen < REARM_COUNT);
+
+    rFreeWait(wp);
+    close(fd[0]);
+    close(fd[1]);
+}
+
+static void fiberMain(void *arg)
+{
+    scheduleTimers();
+    cancelTimers();
+    runEarly();
+    ioDeadlines();
+    expiredRearm();
+    rStop();
+}
+
+int main(void)
+{
+    rInit(fiberMain, 0);
+    rServiceEvents();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This software is distributed under commercial and open source licenses.
+    You may use the Embedthis Open Source license or you may acquire a
+    commercial license from Embedthis Software. You agree to be fully bound
+    by the terms of either license. Consult the LICENSE.md distributed with
+    this software for full details and other copyrights.
+ */
@@ -811,6 +811,8 @@ void saveBenchGroup(cchar *groupName, BenchResult **results, int count)
         jsonSetNumber(testResult, 0, "minLatency", (int64) result->minTime);
         jsonSetNumber(testResult, 0, "maxLatency", (int64) result->maxTime);
         jsonSetNumber(testResult, 0, "bytesTransferred", (int64) result->bytesTransferred);
+        jsonSetDouble(testResult, 0, "throughput", result->totalTime > 0 ?
+                      (result->bytesTransferred / (1024.0 * 1024.0)) / (result->totalTime / 1000.0) : 0.0);
         jsonSetNumber(testResult, 0, "iterations", result->iterations);
         jsonSetNumber(testResult, 0, "errors", result->errors);
 
@@ -859,9 +861,9 @@ static void saveMarkdownResults(cchar *version, cchar *timestamp, cchar *platfor
     // Write table header
     fprintf(fp, "## Performance Results\n\n");
     fprintf(fp, "| Category | Test | Req/Sec | Avg Latency (ms) | P95 (ms) | P99 (ms) | "
-            "Min (ms) | Max (ms) | Bytes | Errors | Iterations |\n");
+            "Min (ms) | Max (ms) | Bytes | MB/s | Errors | Iterations |\n");
     fprintf(fp, "|----------|------|---------|------------------|----------|----------|"
-            "----------|----------|-------|--------|------------|\n");
+            "----------|----------|-------|------|--------|------------|\n");
 
     // Iterate through result groups (top-level children of globalResults)
     for (ITERATE_JSON(globalResults, NULL, groupNode, groupNid)) {
@@ -898,12 +900,14 @@ static void saveMarkdownResults(cchar *version, cchar *timestamp, cchar *platfor
             categoryLabel = "**Multipart Uploads**";
         } else if (scmp(groupNode->name, "connections") == 0) {
             categoryLabel = "**Connections**";
+        } else if (scmp(groupNode->name, "put_large") == 0) {
+            categoryLabel = "**Large Uploads**";
         } else {
             categoryLabel = groupNode->name;
         }
 
         // Write category header row
-        fprintf(fp, "| %s | | | | | | | | | | |\n", categoryLabel);
+        fprintf(fp, "| %s | | | | | | | | | | | |\n", categoryLabel);
 
         // Get node ID for this group to iterate its children
         groupId = jsonGetId(globalResults, 0, groupNode->name);
@@ -911,7 +915,7 @@ static void saveMarkdownResults(cchar *version, cchar *timestamp, cchar *platfor
         // Iterate through tests in this group
         for (ITERATE_JSON_ID(globalResults, groupId, testNode, testNid)) {
             int64  iterations, minLat, maxLat, bytesTransferred, errors;
-            double reqPerSec, avgLat, p95Lat, p99Lat, bytesMB;
+            double reqPerSec, avgLat, p95Lat, p99Lat, bytesMB, throughput;
             char   path[256];
 
             if (!testNode->name) continue;
@@ -933,6 +937,8 @@ static void saveMarkdownResults(cchar *version, cchar *timestamp, cchar *platfor
             maxLat = jsonGetNum(globalResults, 0, path, 0);
             snprintf(path, sizeof(path), "%s.%s.bytesTransferred", groupNode->name, testNode->name);
             bytesTransferred = jsonGetNum(globalResults, 0, path, 0);
+            snprintf(path, sizeof(path), "%s.%s.throughput", groupNode->name, testNode->name);
+            throughput = jsonGetDouble(globalResults, 0, path, 0);
             snprintf(path, sizeof(path), "%s.%s.errors", groupNode->name, testNode->name);
             errors = jsonGetNum(globalResults, 0, path, 0);
 
@@ -950,6 +956,11 @@ static void saveMarkdownResults(cchar *version, cchar *timestamp, cchar *platfor
             } else {
                 fprintf(fp, "%lld", (long long) bytesTransferred);
             }
+            if (throughput > 0) {
+                fprintf(fp, " | %.1f", throughput);
+            } else {
+                fprintf(fp, " | ");
+            }
             fprintf(fp, " | %lld | %lld |\n", (long long) errors, (long long) iterations);
         }
     }
@@ -964,6 +975,7 @@ static void saveMarkdownResults(cchar *version, cchar *timestamp, cchar *platfor
     fprintf(fp, "- **URL Library tests**: Standard HTTP client (includes client overhead)\n");
     fprintf(fp, "- All latency values are in milliseconds\n");
     fprintf(fp, "- Bytes column shows total data transferred during test\n");
+    fprintf(fp, "- MB/s column is the bytes transferred divided by the total request time\n");
 
     fclose(fp);
     printf("Results saved to: doc/benchmarks/%s/%s.md\n", basePlatform, reportName);
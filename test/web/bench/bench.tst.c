@@ -19,15 +19,17 @@
 #define URL_TIMEOUT_MS   10000   // 10 second timeout to prevent hangs
 
 #define NUM_SOAK_GROUPS  9
-#define NUM_BENCH_GROUPS 12
+#define NUM_BENCH_GROUPS 15
+#define LARGE_UPLOAD     (16 * 1024 * 1024)
+#define ROUTE_BATCH      10000   // Route lookups per recorded sample
 
 /*
     List of all benchmark classes in run order
  */
 static cchar *benchClasses[] = {
     "throughput", "static", "https", "raw_http", "raw_https",
-    "websockets", "put", "upload", "auth", "actions", "mixed", "connections",
-    NULL
+    "websockets", "put", "upload", "auth", "actions", "mixed", "connections", "routes", "pipeline",
+    "put_large", NULL
 };
 
 /*
@@ -51,8 +53,11 @@ static void benchStaticFilesRaw(Ticks duration, cchar *host, int port, bool useT
 static void benchHTTPS(Ticks duration);
 static void benchPut(Ticks duration);
 static void benchUpload(Ticks duration);
+static void benchPutLarge(Ticks duration);
 static void benchAuth(Ticks duration);
 static void benchActions(Ticks duration);
+static void benchRoutes(Ticks duration);
+static void benchPipeline(Ticks duration, cchar *host, int port);
 static void benchMixed(Ticks duration);
 static void benchWebSockets(Ticks duration);
 static void benchConnections(Ticks duration, cchar *host, int port, bool useTls, bool useSession, int resultIndex);
@@ -172,6 +177,9 @@ static bool runBenchClass(cchar *testClass, Ticks duration)
     } else if (smatch(testClass, "upload")) {
         benchUpload(duration);
 
+    } else if (smatch(testClass, "put_large")) {
+        benchPutLarge(duration);
+
     } else if (smatch(testClass, "auth")) {
         benchAuth(duration);
 
@@ -181,6 +189,14 @@ static bool runBenchClass(cchar *testClass, Ticks duration)
     } else if (smatch(testClass, "mixed")) {
         benchMixed(duration);
 
+    } else if (smatch(testClass, "routes")) {
+        benchRoutes(duration);
+
+    } else if (smatch(testClass, "pipeline")) {
+        parseEndpoint(HTTP, "http://", &host, &httpPort);
+        benchPipeline(duration, host, httpPort);
+        rFree(host);
+
     } else if (smatch(testClass, "websockets")) {
         benchWebSockets(duration);
 
@@ -487,6 +503,89 @@ cleanup:
     }
 }
 
+/*
+   Benchmark 16MB uploads on a warm connection and report the upload rate in MB/s.
+   Cleartext PUT bodies are spliced to the file on Linux. HTTPS PUT and multipart uploads are buffered.
+ */
+static void benchPutLarge(Ticks duration)
+{
+    ConnectionCtx *ctx;
+    RequestResult result;
+    RBuf          *buf;
+    Ticks         startTime, groupDuration, elapsed;
+    int64         bytes;
+    char          url[256], path[256], headers[256], *data, *boundary;
+    cchar         *names[] = { "16MB_put_http", "16MB_put_https", "16MB_multipart_http" };
+    size_t        i;
+    int           classIndex, counter, iterations;
+
+    initBenchContext(bctx, "Large uploads", "Benchmarking large uploads...");
+
+    data = rAlloc(LARGE_UPLOAD);
+    for (i = 0; i < LARGE_UPLOAD; i++) {
+        data[i] = (char) ('0' + i % 10);
+    }
+    boundary = "----WebKitFormBoundary7MA4YWxkTrZu0gW";
+
+    ctx = createConnectionCtx(true, URL_TIMEOUT_MS);
+    bctx->connCtx = ctx;
+    bctx->resultOffset = 0;
+
+    for (classIndex = 0; classIndex < 3 && !bctx->fatal; classIndex++) {
+        bctx->results[classIndex] = initResult(names[classIndex], bctx->soak, NULL);
+        bctx->classIndex = classIndex;
+        bctx->bytes = LARGE_UPLOAD;
+        groupDuration = calcEqualDuration(duration, 3);
+        benchTrace("Testing %s for %.1f seconds...", names[classIndex], groupDuration / 1000.0);
+
+        bytes = 0;
+        elapsed = 0;
+        counter = 0;
+        for (iterations = 0; elapsed < groupDuration; ) {
+            iterations++;
+            if (iterLimit(iterations, true, 0)) break;
+            SFMT(headers, "X-Sequence: %d\r\n", bctx->seq++);
+            if (classIndex < 2) {
+                SFMT(url, "%s/put/bench-large-%d-%d.txt", classIndex == 0 ? HTTP : HTTPS, getpid(), counter);
+                startTime = rGetTicks();
+                result = executeRequest(ctx, "PUT", url, data, LARGE_UPLOAD, headers);
+                unlink(SFMT(path, "site/put/bench-large-%d-%d.txt", getpid(), counter));
+            } else {
+                buf = rAllocBuf(LARGE_UPLOAD + 1024);
+                rPutToBuf(buf, "--%s\r\nContent-Disposition: form-data; name=\"file\"; "
+                          "filename=\"bench-large-%d-%d.txt\"\r\nContent-Type: text/plain\r\n\r\n",
+                          boundary, getpid(), counter);
+                rPutBlockToBuf(buf, data, LARGE_UPLOAD);
+                rPutToBuf(buf, "\r\n--%s--\r\n", boundary);
+                SFMT(headers, "Content-Type: multipart/form-data; boundary=%s\r\nX-Sequence: %d\r\n",
+                     boundary, bctx->seq++);
+                SFMT(url, "%s/test/bench/", HTTP);
+                startTime = rGetTicks();
+                result = executeRequest(ctx, "POST", url, rGetBufStart(buf), rGetBufLength(buf), headers);
+                rFreeBuf(buf);
+                unlink(SFMT(path, "tmp/bench-large-%d-%d.txt", getpid(), counter));
+            }
+            if (!processResponse(bctx, &result, url, startTime)) {
+                goto cleanup;
+            }
+            if (result.success) {
+                bytes += LARGE_UPLOAD;
+            }
+            elapsed += max(result.elapsed, 1);
+            counter++;
+        }
+        if (!bctx->soak && bytes) {
+            tinfo("  %s: %.1f MB/s", names[classIndex], (bytes / (1024.0 * 1024.0)) / (elapsed / 1000.0));
+        }
+    }
+    freeConnectionCtx(ctx);
+    bctx->connCtx = NULL;
+
+cleanup:
+    finishBenchContext(bctx, 3, "put_large");
+    rFree(data);
+}
+
 /*
    Benchmark multipart/form-data uploads with keep-alive vs cold connections
    Tests: 1KB, 10KB, 100KB, 1MB files using duration-based testing
@@ -697,6 +796,195 @@ static void benchActions(Ticks duration)
     finishBenchContext(bctx, 2, "actions");
 }
 
+/*
+   Benchmark route table lookup in-process (no network overhead)
+   Tests: 10, 100 and 1000 routes resolving the last defined route using duration-based testing
+ */
+static void benchRoutes(Ticks duration)
+{
+    WebHost  *host;
+    WebRoute *route;
+    Json     *config;
+    RBuf     *buf;
+    Ticks    startTime, groupStart, groupDuration;
+    char     path[80], name[64];
+    int64    lookups;
+    int      counts[] = { 10, 100, 1000 };
+    int      classIndex, count, i, iterations;
+
+    initBenchContext(bctx, "Route", "Benchmarking route lookup...");
+
+    for (classIndex = 0; classIndex < 3; classIndex++) {
+        count = counts[classIndex];
+        SFMT(name, "routes_%d", count);
+        bctx->results[classIndex] = initResult(name, bctx->soak, NULL);
+
+        //  Define distinct routes sharing a common prefix. The target is the last route defined.
+        buf = rAllocBuf(0);
+        rPutStringToBuf(buf, "{web: {routes: [");
+        for (i = 0; i < count; i++) {
+            rPutToBuf(buf, "{match: '/api/v1/resource%d/', handler: 'action'},", i);
+        }
+        rPutStringToBuf(buf, "]}}");
+        if ((config = jsonParse(rBufToString(buf), 0)) == 0) {
+            rFreeBuf(buf);
+            ttrue(false, "Cannot parse route configuration");
+            bctx->fatal = true;
+            return;
+        }
+        rFreeBuf(buf);
+        host = webAllocHost(config, 0);
+        tnotnull(host);
+        SFMT(path, "/api/v1/resource%d/item", count - 1);
+
+        groupDuration = calcEqualDuration(duration, 3);
+        groupStart = rGetTicks();
+        lookups = 0;
+        iterations = 0;
+        while (rGetTicks() - groupStart < groupDuration) {
+            iterations++;
+            if (iterLimit(iterations, true, 0)) break;
+            startTime = rGetTicks();
+            for (i = 0; i < ROUTE_BATCH; i++) {
+                route = webLookupRoute(host, path);
+            }
+            lookups += ROUTE_BATCH;
+            recordRequest(bctx->results[classIndex], route != NULL, rGetTicks() - startTime, 0);
+        }
+        if (!bctx->soak && lookups) {
+            tinfo("  %d routes: %.1f nsec per lookup", count,
+                  (rGetTicks() - groupStart) * 1e6 / (double) lookups);
+        }
+        webFreeHost(host);
+        jsonFree(config);
+    }
+    finishBenchContext(bctx, 3, "routes");
+}
+
+/*
+    Read pipelined responses until the expected number of complete responses has been received.
+    Responses must have a Content-Length. Reading stops early if the server closes the connection after a
+    response (the per-connection request limit). Returns the number of complete responses.
+ */
+static int readPipelined(RSocket *sp, int depth, Ticks deadline, bool *closed)
+{
+    RBuf   *buf;
+    char   *end, *start;
+    ssize  contentLen, nbytes;
+    size_t headerLen;
+    int    count;
+
+    *closed = false;
+    buf = rAllocBuf(ME_BUFSIZE);
+    for (count = 0; count < depth && !*closed; ) {
+        //  Consume complete responses already buffered
+        start = rGetBufStart(buf);
+        if ((end = sncontains(start, "\r\n\r\n", rGetBufLength(buf))) != 0) {
+            headerLen = (size_t) (end - start) + 4;
+            if (!sstarts(start, "HTTP/1.1 200") || (contentLen = parseContentLength(start, headerLen)) < 0) {
+                break;
+            }
+            if (rGetBufLength(buf) >= headerLen + (size_t) contentLen) {
+                *closed = sncontains(start, "Connection: close", headerLen) != 0;
+                rAdjustBufStart(buf, (ssize) (headerLen + (size_t) contentLen));
+                count++;
+                continue;
+            }
+        }
+        rCompactBuf(buf);
+        rReserveBufSpace(buf, ME_BUFSIZE);
+        if ((nbytes = rReadSocket(sp, rGetBufEnd(buf), rGetBufSpace(buf) - 1, deadline)) <= 0) {
+            break;
+        }
+        rAdjustBufEnd(buf, nbytes);
+        rAddNullToBuf(buf);
+    }
+    rFreeBuf(buf);
+    return count;
+}
+
+/*
+   Benchmark HTTP/1.1 pipelining on a single keep-alive connection using raw sockets
+   Tests: batches of 1, 4 and 16 GET requests for a 1KB file written with one write before reading the responses.
+   Each batch is recorded as one sample. The request rate is reported separately.
+ */
+static void benchPipeline(Ticks duration, cchar *host, int port)
+{
+    ConnectionCtx *ctx;
+    RSocket       *sp;
+    RBuf          *request;
+    Ticks         deadline, groupStart, groupDuration, startTime;
+    char          name[64];
+    int64         requests;
+    int           depths[] = { 1, 4, 16 };
+    int           classIndex, count, depth, i, iterations;
+    bool          closed, success;
+
+    initBenchContext(bctx, "Pipeline", "Benchmarking pipelined requests...");
+
+    ctx = createSocketCtx(true, URL_TIMEOUT_MS, host, port, false);
+    bctx->connCtx = ctx;
+    bctx->resultOffset = 0;
+
+    for (classIndex = 0; classIndex < 3 && !bctx->fatal; classIndex++) {
+        depth = depths[classIndex];
+        SFMT(name, "pipeline_%d", depth);
+        bctx->results[classIndex] = initResult(name, bctx->soak, NULL);
+        bctx->classIndex = classIndex;
+
+        request = rAllocBuf(0);
+        for (i = 0; i < depth; i++) {
+            rPutToBuf(request, "GET /static/1K.txt HTTP/1.1\r\nHost: %s\r\nX-SEQ: %d\r\n\r\n",
+                      host, bctx->seq++);
+        }
+        groupDuration = calcEqualDuration(duration, 3);
+        benchTrace("Testing pipeline depth %d for %.1f seconds...", depth, groupDuration / 1000.0);
+        groupStart = rGetTicks();
+        requests = 0;
+        iterations = 0;
+        while (rGetTicks() - groupStart < groupDuration) {
+            iterations++;
+            if (iterLimit(iterations, true, 0)) break;
+            startTime = rGetTicks();
+            deadline = startTime + URL_TIMEOUT_MS;
+            count = 0;
+            closed = false;
+            if ((sp = getSocket(ctx)) != 0) {
+                if (rWriteSocket(sp, rGetBufStart(request), rGetBufLength(request), deadline) >= 0) {
+                    count = readPipelined(sp, depth, deadline, &closed);
+                }
+                if (count < depth || closed) {
+                    rCloseSocket(sp);
+                }
+            }
+            releaseConnection(ctx);
+            success = count == depth || (closed && count > 0);
+            requests += count;
+            bctx->totalRequests++;
+            if (!success) {
+                bctx->errorCount++;
+                bctx->errors++;
+                logRequestError(bctx->category, "/static/1K.txt", 0, bctx->errorCount, bctx->soak);
+                if (bctx->stopOnErrors) {
+                    bctx->fatal = true;
+                }
+            }
+            if (!bctx->soak) {
+                recordRequest(bctx->results[classIndex], success, rGetTicks() - startTime, count * 1024);
+            }
+            if (bctx->fatal) break;
+        }
+        if (!bctx->soak && requests) {
+            tinfo("  Pipeline depth %d: %.0f requests/sec", depth,
+                  requests * 1000.0 / (double) max(rGetTicks() - groupStart, 1));
+        }
+        rFreeBuf(request);
+    }
+    freeConnectionCtx(ctx);
+    bctx->connCtx = NULL;
+    finishBenchContext(bctx, 3, "pipeline");
+}
+
 /*
    Benchmark authenticated routes with digest authentication
    Tests: Digest auth with session reuse, cold auth using duration-based testing
@@ -1372,7 +1660,8 @@ static cchar *initBench(void)
         if (!isValidBenchClass(testClass)) {
             tinfo("Error: Invalid TESTME_CLASS='%s'", testClass);
             tinfo(
-                "Valid values: static, https, raw_http, raw_https, put, upload, auth, actions, mixed, websockets, connections, throughput");
+                "Valid values: static, https, raw_http, raw_https, put, upload, auth, actions, mixed, websockets, "
+                "connections, routes, pipeline, put_large, throughput");
             bctx->fatal = true;
             return NULL;
         }
@@ -1,5 +1,5 @@
 /*
-    compressed.tst.c - Test pre-compressed content serving
+    compressed.tst.c - Test pre-compressed and on-the-fly compressed content serving
  */
 #include "test.h"
 
@@ -236,8 +236,188 @@ static void testRangeWithCompression(void)
     urlFree(up);
 }
 
+static void testRefusedEncoding(void)
+{
+    Url  *up;
+    char url[128];
+
+    //  Encodings with a zero quality value are not acceptable
+    up = urlAlloc(0);
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/compressed/app.js", HTTP), NULL, 0,
+                  "Accept-Encoding: br;q=0, gzip;q=0\r\n"), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: br; q=0, gzip;q=0.5\r\n"), 200);
+    tmatch(urlGetHeader(up, "Content-Encoding"), "gzip");
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: *;q=0\r\n"), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: gzip;q=0, *\r\n"), 200);
+    tmatch(urlGetHeader(up, "Content-Encoding"), "br");
+
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/compress/test/show", HTTP), NULL, 0, "Accept-Encoding: gzip;q=0\r\n"),
+         200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    urlFree(up);
+}
+
+/*
+    The file cache is disabled by default, so the cached variant tests use an in-process host with features.json5
+ */
+static void testCachedVariants(cchar *endpoint)
+{
+    Url  *up;
+    char url[128];
+
+    /*
+        Cached variants must only be served to clients that accept their encoding.
+        The document has a gzip variant and no brotli variant.
+     */
+    up = urlAlloc(0);
+    SFMT(url, "%s/compressed/gzip-only.txt", endpoint);
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: br, gzip\r\n"), 200);
+    tmatch(urlGetHeader(up, "Content-Encoding"), "gzip");
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: br\r\n"), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tmatch(urlGetResponse(up), "Document with a gzip variant and no brotli variant\n");
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: br, gzip\r\n"), 200);
+    tmatch(urlGetHeader(up, "Content-Encoding"), "gzip");
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, NULL), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    urlFree(up);
+}
+
+#if ME_WEB_COMPRESS
+/*
+    Check that a response body is gzip compressed
+ */
+static void checkGzipped(Url *up)
+{
+    RBuf  *buf;
+    uchar *data;
+
+    tmatch(urlGetHeader(up, "Content-Encoding"), "gzip");
+    tnotnull(scontains(urlGetHeader(up, "Vary"), "Accept-Encoding"));
+    buf = urlGetResponseBuf(up);
+    ttrue(rGetBufLength(buf) > 2);
+    data = (uchar*) rGetBufStart(buf);
+    ttrue(data[0] == 0x1f && data[1] == 0x8b);
+}
+#endif
+
+static void testDynamicCompression(void)
+{
+    Url  *up;
+    Json *json;
+    char url[128];
+
+    up = urlAlloc(0);
+
+    //  JSON action output is compressed when the client accepts gzip
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/compress/test/show", HTTP), NULL, 0, "Accept-Encoding: gzip\r\n"), 200);
+#if ME_WEB_COMPRESS
+    checkGzipped(up);
+    tnull(urlGetHeader(up, "Content-Length"));
+#else
+    //  Servers built without ME_WEB_COMPRESS send identity responses
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tnotnull(scontains(urlGetResponse(up), "\"url\""));
+#endif
+
+    //  Identity response otherwise
+    json = urlJson(up, "GET", url, NULL, 0, NULL);
+    tnotnull(json);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    jsonFree(json);
+
+    //  Responses below the minimum size are not compressed
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/compress/test/success", HTTP), NULL, 0, "Accept-Encoding: gzip\r\n"),
+         200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tmatch(urlGetResponse(up), "success\n");
+
+    urlFree(up);
+}
+
+/*
+    Test that many small writes are buffered by the compressor rather than flushed one by one
+ */
+static void testBufferedCompression(void)
+{
+#if ME_WEB_COMPRESS
+    Url    *up;
+    RBuf   *buf;
+    char   url[128];
+
+    up = urlAlloc(0);
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/compress/test/bulk", HTTP), "count=1000", (size_t) -1,
+                  "Accept-Encoding: gzip\r\nContent-Type: application/x-www-form-urlencoded\r\n"), 200);
+    checkGzipped(up);
+    buf = urlGetResponseBuf(up);
+    //  1000 lines are 23,000 bytes. Flushing each line would emit more than 5 bytes per line.
+    ttrue(rGetBufLength(buf) < 4000);
+    urlFree(up);
+#endif
+}
+
+static void testGeneratedVariant(cchar *endpoint)
+{
+    Url   *up;
+    char  url[128], *etag;
+
+    up = urlAlloc(0);
+
+    //  Uncompressed documents are compressed once and served from the file cache
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/gzip/index.html", endpoint), NULL, 0, "Accept-Encoding: gzip\r\n"), 200);
+    etag = sclone(urlGetHeader(up, "ETag"));
+    tnotnull(etag);
+#if ME_WEB_COMPRESS
+    checkGzipped(up);
+    tnotnull(scontains(etag, "-gzip"));
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: gzip\r\n"), 200);
+    checkGzipped(up);
+    tmatch(urlGetHeader(up, "ETag"), etag);
+
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: gzip\r\nIf-None-Match: %s\r\n", etag), 304);
+
+    //  Identity variant has a distinct ETag
+    teqi(urlFetch(up, "GET", url, NULL, 0, NULL), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tfalse(smatch(urlGetHeader(up, "ETag"), etag));
+
+    //  A variant generated for a client accepting br and gzip is keyed as gzip and not sent to br only clients
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/gzip/sockets.html", endpoint), NULL, 0, "Accept-Encoding: br, gzip\r\n"),
+         200);
+    checkGzipped(up);
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: br\r\n"), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tnotnull(scontains(urlGetResponse(up), "<html"));
+    teqi(urlFetch(up, "GET", url, NULL, 0, "Accept-Encoding: gzip\r\n"), 200);
+    checkGzipped(up);
+#else
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tnull(scontains(etag, "-gzip"));
+    tnotnull(scontains(urlGetResponse(up), "<html"));
+
+    //  Identity responses are the same with and without gzip acceptance
+    teqi(urlFetch(up, "GET", url, NULL, 0, NULL), 200);
+    tnull(urlGetHeader(up, "Content-Encoding"));
+    tmatch(urlGetHeader(up, "ETag"), etag);
+#endif
+    rFree(etag);
+    urlFree(up);
+}
+
 static void fiberMain(void *data)
 {
+    WebHost *host;
+    char    *endpoint;
+
     if (setup(&HTTP, &HTTPS)) {
         testPrecompressedBrotli();
         testPrecompressedGzip();
@@ -250,6 +430,15 @@ static void fiberMain(void *data)
         testMimeType();
         testETag();
         testRangeWithCompression();
+        testRefusedEncoding();
+        testDynamicCompression();
+        testBufferedCompression();
+        if ((host = startHost("features.json5", &endpoint)) != 0) {
+            testCachedVariants(endpoint);
+            testGeneratedVariant(endpoint);
+            stopHost(host);
+            rFree(endpoint);
+        }
     }
     rFree(HTTP);
     rFree(HTTPS);
@@ -0,0 +1,131 @@
+/*
+    cursor.tst.c - Unit tests for writing database items as a response
+
+    Runs an in-process host with actions that write items via webWriteItems and webWriteCursor and
+    verifies the responses are well formed JSON arrays and the returned counts include every byte written.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+#include    "ioto.h"
+
+/*********************************** Locals ***********************************/
+
+#define ENDPOINT    "http://localhost:4275"
+#define HOST_CONFIG "{ web: { documents: './site', listen: ['http://:4275'], " \
+                    "routes: [{ match: '/items/', handler: 'action' }] } }"
+#define SCHEMA      "{ version: '1.0.0', format: 'onetable:1.1.0', indexes: { primary: { sort: 'sk' } }, " \
+                    "models: { Item: { sk: { type: 'string', value: 'item#${id}' }, " \
+                    "id: { type: 'string', required: true } } } }"
+
+static Db    *db;
+static ssize written;
+
+/************************************ Code ************************************/
+
+static void cursorAction(Web *web)
+{
+    DbCursor *cursor;
+
+    cursor = dbCursorOpen(db, "Item", NULL, NULL);
+    written = webWriteCursor(web, cursor);
+    dbCursorClose(cursor);
+    webFinalize(web);
+}
+
+static void itemsAction(Web *web)
+{
+    RList *items;
+
+    items = dbFind(db, "Item", NULL, NULL);
+    written = webWriteItems(web, items);
+    rFreeList(items);
+    webFinalize(web);
+}
+
+/*
+    Fetch the items and check the response is a JSON array of count items
+ */
+static void checkItems(cchar *path, int count)
+{
+    Url   *up;
+    Json  *json;
+    cchar *response;
+    char  url[128];
+
+    up = urlAlloc(0);
+    written = -1;
+    teqi(urlFetch(up, "GET", SFMT(url, "%s%s", ENDPOINT, path), NULL, 0, NULL), 200);
+    response = urlGetResponse(up);
+    tnotnull(response);
+    teqz(written, slen(response));
+    json = jsonParse(response, 0);
+    tnotnull(json);
+    teqi(jsonGetLength(json, 0, NULL), count);
+    jsonFree(json);
+    urlFree(up);
+}
+
+static void writeItems(void)
+{
+    WebHost *host;
+    Json    *config;
+    char    id[16];
+    int     i;
+
+    tnotnull(rWriteFile("./cursor-schema.json5", SCHEMA, slen(SCHEMA), 0644) == (ssize) slen(SCHEMA));
+    db = dbOpen("./cursor.db", "./cursor-schema.json5", DB_OPEN_RESET);
+    tnotnull(db);
+
+    webInit();
+    config = jsonParse(HOST_CONFIG, 0);
+    tnotnull(config);
+    host = webAllocHost(config, 0);
+    tnotnull(host);
+    webAddAction(host, "/items/cursor", cursorAction, NULL);
+    webAddAction(host, "/items/list", itemsAction, NULL);
+    teqi(webStartHost(host), 0);
+
+    //  Empty results are an empty array
+    checkItems("/items/cursor", 0);
+    checkItems("/items/list", 0);
+
+    for (i = 0; i < 3; i++) {
+        sfmtbuf(id, sizeof(id), "%d", i);
+        tnotnull(dbCreate(db, "Item", DB_PROPS("id", id), NULL));
+    }
+    checkItems("/items/cursor", 3);
+    checkItems("/items/list", 3);
+
+    webStopHost(host);
+    webFreeHost(host);
+    jsonFree(config);
+    webTerm();
+    dbClose(db);
+    unlink("./cursor.db");
+    unlink("./cursor.db.jnl");
+    unlink("./cursor-schema.json5");
+}
+
+static void fiberMain(void *data)
+{
+    if (setup(NULL, NULL)) {
+        writeItems();
+    }
+    rStop();
+}
+
+int main(void)
+{
+    rInit(fiberMain, 0);
+    rServiceEvents();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
@@ -16,6 +16,7 @@
     - Partial content handling (ranges already tested separately)
     - Hidden files and dot files
     - Case sensitivity in filenames
+    - In-memory file cache hits and invalidation
 
     Copyright (c) All Rights Reserved. See details at the end of the file.
  */
@@ -349,6 +350,78 @@ static void testMultipleSimultaneousRequests(void)
     urlFree(up2);
 }
 
+/*
+    The file cache is disabled by default, so test it with an in-process host using features.json5
+ */
+static void testFileCache(void)
+{
+    WebHost *host;
+    Url     *up;
+    Json    *json;
+    char    url[128], path[128], *endpoint, *etag;
+    int     status, pid;
+
+    if ((host = startHost("features.json5", &endpoint)) == 0) {
+        return;
+    }
+    up = urlAlloc(0);
+    pid = getpid();
+
+    status = urlFetch(up, "PUT", SFMT(url, "%s/upload/cache-%d.txt", endpoint, pid), "first", 5,
+                      "Content-Type: text/plain\r\n");
+    ttrue(status == 201 || status == 204);
+
+    //  First request loads the cache, the second is served from memory
+    urlClose(up);
+    status = urlFetch(up, "GET", url, NULL, 0, NULL);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "first");
+    etag = sclone(urlGetHeader(up, "ETag"));
+    tnotnull(etag);
+    tnotnull(urlGetHeader(up, "Last-Modified"));
+
+    status = urlFetch(up, "GET", url, NULL, 0, NULL);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "first");
+    tmatch(urlGetHeader(up, "ETag"), etag);
+    teqi(stoi(urlGetHeader(up, "Content-Length")), 5);
+
+    //  Conditional request against the cached ETag
+    status = urlFetch(up, "GET", url, NULL, 0, "If-None-Match: %s\r\n", etag);
+    teqi(status, 304);
+
+    json = urlJson(up, "GET", SFMT(path, "%s/test/show", endpoint), NULL, 0, NULL);
+    ttrue(jsonGetInt(json, 0, "host.cacheFiles", 0) > 0);
+    ttrue(jsonGetNum(json, 0, "host.cacheSize", 0) >= 5);
+    jsonFree(json);
+
+    //  PUT invalidates the cached document
+    status = urlFetch(up, "PUT", url, "second document", 15, "Content-Type: text/plain\r\n");
+    ttrue(status == 201 || status == 204);
+    status = urlFetch(up, "GET", url, NULL, 0, NULL);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "second document");
+
+    //  External modifications are detected when the document is revalidated
+    rSleep(1100);
+    rWriteFile(SFMT(path, "site/upload/cache-%d.txt", pid), "third", 5, 0644);
+    rSleep(1100);
+    status = urlFetch(up, "GET", url, NULL, 0, NULL);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "third");
+
+    //  DELETE removes the document from the cache
+    status = urlFetch(up, "DELETE", url, NULL, 0, NULL);
+    teqi(status, 204);
+    status = urlFetch(up, "GET", url, NULL, 0, NULL);
+    teqi(status, 404);
+
+    rFree(etag);
+    urlFree(up);
+    stopHost(host);
+    rFree(endpoint);
+}
+
 static void fiberMain(void *data)
 {
     if (setup(&HTTP, &HTTPS)) {
@@ -362,6 +435,7 @@ static void fiberMain(void *data)
         testNonExistentFile();
         testFileCaseSensitivity();
         testMultipleSimultaneousRequests();
+        testFileCache();
     }
     rFree(HTTP);
     rFree(HTTPS);
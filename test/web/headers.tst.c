@@ -210,6 +210,38 @@ static void testHeaderCaseInsensitivity()
     urlFree(up);
 }
 
+static void testHeaderIndex()
+{
+    Json  *json;
+    RBuf  *buf;
+    cchar *host;
+    char  url[128], key[80], value[32];
+    int   i;
+
+    //  The Host header is the endpoint of the HTTP URL
+    host = scontains(HTTP, "://");
+    host = host ? host + 3 : HTTP;
+
+    //  Enough headers to exceed the header index and a repeated header
+    buf = rAllocBuf(0);
+    rPutStringToBuf(buf, "X-Repeat: first\r\nX-Repeat: second\r\n");
+    for (i = 0; i < 40; i++) {
+        rPutToBuf(buf, "X-Custom-%d: value%d\r\n", i, i);
+    }
+    json = urlGetJson(SFMT(url, "%s/test/show", HTTP), "%s", rBufToString(buf));
+    tnotnull(json);
+
+    tmatch(jsonGet(json, 0, "hostHeader", 0), host);
+    tmatch(jsonGet(json, 0, "lookup.Host", 0), host);
+    tmatch(jsonGet(json, 0, "lookup['X-Repeat']", 0), "first");
+    for (i = 0; i < 40; i++) {
+        SFMT(key, "lookup['X-Custom-%d']", i);
+        tmatch(jsonGet(json, 0, key, 0), SFMT(value, "value%d", i));
+    }
+    jsonFree(json);
+    rFreeBuf(buf);
+}
+
 static void fiberMain(void *data)
 {
     if (setup(&HTTP, &HTTPS)) {
@@ -222,6 +254,7 @@ static void fiberMain(void *data)
         testCacheHeaders();
         testConnectionHeader();
         testHeaderCaseInsensitivity();
+        testHeaderIndex();
     }
     rFree(HTTP);
     rFree(HTTPS);
@@ -0,0 +1,310 @@
+/*
+    http2.tst.c - Unit tests for HTTP/2 with prior knowledge
+
+    Frames are written on a raw socket so the tests do not depend on an HTTP/2 client library.
+    HTTP/2 is disabled by default, so the tests run an in-process host using features.json5.
+    Request header blocks use the HPACK examples from RFC 7541 Appendix C.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+
+/*********************************** Locals ***********************************/
+
+#define MAX_STREAMS 8
+
+typedef struct Response {
+    int status;
+    RBuf *body;
+    bool end;
+} Response;
+
+static char *HTTP;
+static int  goaway;
+
+/*
+    RFC 7541 C.4.1: GET http://www.example.com/ and C.4.2 which references the dynamic table entry added by C.4.1
+ */
+static cuchar C41[] = {
+    0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff
+};
+static cuchar C42[] = { 0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf };
+
+/************************************ Code ************************************/
+
+static void putFrame(RBuf *buf, int type, int flags, int id, cvoid *data, size_t len)
+{
+    rPutCharToBuf(buf, (char) (len >> 16));
+    rPutCharToBuf(buf, (char) (len >> 8));
+    rPutCharToBuf(buf, (char) len);
+    rPutCharToBuf(buf, (char) type);
+    rPutCharToBuf(buf, (char) flags);
+    rPutCharToBuf(buf, (char) (id >> 24));
+    rPutCharToBuf(buf, (char) (id >> 16));
+    rPutCharToBuf(buf, (char) (id >> 8));
+    rPutCharToBuf(buf, (char) id);
+    if (len > 0) {
+        rPutBlockToBuf(buf, data, len);
+    }
+}
+
+/*
+    Add a literal header field without indexing using an indexed name below 15
+ */
+static void putLiteral(RBuf *buf, int index, cchar *value)
+{
+    rPutCharToBuf(buf, (char) index);
+    rPutCharToBuf(buf, (char) slen(value));
+    rPutStringToBuf(buf, value);
+}
+
+/*
+    Header block for a request to localhost
+ */
+static RBuf *requestHeaders(cchar *method, cchar *path)
+{
+    RBuf *buf;
+
+    buf = rAllocBuf(0);
+    rPutCharToBuf(buf, smatch(method, "POST") ? (char) 0x83 : (char) 0x82);
+    rPutCharToBuf(buf, (char) 0x86);
+    putLiteral(buf, 4, path);
+    putLiteral(buf, 1, "localhost");
+    return buf;
+}
+
+static void putHeaders(RBuf *frames, int id, RBuf *headers, bool end)
+{
+    putFrame(frames, 1, end ? 0x5 : 0x4, id, rGetBufStart(headers), rGetBufLength(headers));
+    rFreeBuf(headers);
+}
+
+static int statusCode(uchar index)
+{
+    static int codes[] = { 200, 204, 206, 304, 400, 404, 500 };
+
+    if (index >= 0x88 && index <= 0x8e) {
+        return codes[index - 0x88];
+    }
+    return 0;
+}
+
+/*
+    Send the connection preface and the request frames, then read response frames until all streams have ended.
+    Responses are indexed by stream ID / 2. The error code of a GOAWAY frame is saved in goaway.
+ */
+static bool exchange(RBuf *frames, Response *responses, int count)
+{
+    RSocket *sock;
+    RBuf    *buf, *out;
+    uchar   *p;
+    cchar   *host, *path, *query, *hash, *scheme;
+    char    *ubuf;
+    ssize   nbytes;
+    size_t  len;
+    int     ended, id, port, type;
+
+    memset(responses, 0, sizeof(Response) * MAX_STREAMS);
+    goaway = -1;
+    if ((ubuf = webParseUrl(HTTP, &scheme, &host, &port, &path, &query, &hash)) == 0) {
+        return 0;
+    }
+    sock = rAllocSocket();
+    if (rConnectSocket(sock, host, port, rGetTicks() + 5000) < 0) {
+        rFreeSocket(sock);
+        rFree(ubuf);
+        return 0;
+    }
+    rFree(ubuf);
+
+    out = rAllocBuf(0);
+    rPutStringToBuf(out, WEB_HTTP2_PREFACE "SM\r\n\r\n");
+    putFrame(out, 4, 0, 0, NULL, 0);
+    rPutBlockToBuf(out, rGetBufStart(frames), rGetBufLength(frames));
+    nbytes = rWriteSocket(sock, rGetBufStart(out), rGetBufLength(out), rGetTicks() + 5000);
+    rFreeBuf(out);
+    if (nbytes < 0) {
+        rFreeSocket(sock);
+        return 0;
+    }
+    buf = rAllocBuf(ME_BUFSIZE);
+    ended = 0;
+    while (ended < count) {
+        rReserveBufSpace(buf, ME_BUFSIZE);
+        if ((nbytes = rReadSocket(sock, rGetBufEnd(buf), rGetBufSpace(buf), rGetTicks() + 5000)) <= 0) {
+            break;
+        }
+        rAdjustBufEnd(buf, nbytes);
+        while (rGetBufLength(buf) >= 9) {
+            p = (uchar*) rGetBufStart(buf);
+            len = (size_t) (p[0] << 16 | p[1] << 8 | p[2]);
+            if (rGetBufLength(buf) < 9 + len) {
+                break;
+            }
+            type = p[3];
+            id = (p[5] & 0x7f) << 24 | p[6] << 16 | p[7] << 8 | p[8];
+            if (id > 0 && id / 2 < MAX_STREAMS) {
+                if (type == 1 && len > 0) {
+                    responses[id / 2].status = statusCode(p[9]);
+                } else if (type == 0) {
+                    if (!responses[id / 2].body) {
+                        responses[id / 2].body = rAllocBuf(0);
+                    }
+                    rPutBlockToBuf(responses[id / 2].body, (char*) &p[9], len);
+                }
+                if ((type == 0 || type == 1) && (p[4] & 0x1)) {
+                    responses[id / 2].end = 1;
+                    ended++;
+                }
+            } else if (type == 7 && len >= 8) {
+                //  GOAWAY
+                goaway = p[13] << 24 | p[14] << 16 | p[15] << 8 | p[16];
+                ended = count;
+            }
+            rAdjustBufStart(buf, (ssize) (9 + len));
+        }
+        rCompactBuf(buf);
+    }
+    rFreeBuf(buf);
+    rFreeSocket(sock);
+    return ended >= count;
+}
+
+static void freeResponses(Response *responses)
+{
+    int i;
+
+    for (i = 0; i < MAX_STREAMS; i++) {
+        rFreeBuf(responses[i].body);
+    }
+}
+
+static bool bodyContains(Response *response, cchar *pattern)
+{
+    if (!response->body) {
+        return 0;
+    }
+    rAddNullToBuf(response->body);
+    return scontains(rGetBufStart(response->body), pattern) != 0;
+}
+
+static void testGet(void)
+{
+    Response responses[MAX_STREAMS];
+    RBuf     *frames;
+
+    frames = rAllocBuf(0);
+    putFrame(frames, 1, 0x5, 1, C41, sizeof(C41));
+    ttrue(exchange(frames, responses, 1));
+    teqi(responses[0].status, 200);
+    ttrue(responses[0].end);
+    ttrue(bodyContains(&responses[0], "<html"));
+    freeResponses(responses);
+    rFreeBuf(frames);
+}
+
+static void testMultiplex(void)
+{
+    Response responses[MAX_STREAMS];
+    RBuf     *frames;
+
+    /*
+        Several streams written at once. Stream 3 depends on the dynamic table entry added by stream 1.
+     */
+    frames = rAllocBuf(0);
+    putFrame(frames, 1, 0x5, 1, C41, sizeof(C41));
+    putFrame(frames, 1, 0x5, 3, C42, sizeof(C42));
+    putHeaders(frames, 5, requestHeaders("GET", "/size/1K.txt"), 1);
+    putHeaders(frames, 7, requestHeaders("GET", "/test/show?n=7"), 1);
+    putHeaders(frames, 9, requestHeaders("GET", "/not-found.html"), 1);
+    putHeaders(frames, 11, requestHeaders("GET", "/size/10K.txt"), 1);
+    ttrue(exchange(frames, responses, 6));
+    teqi(responses[0].status, 200);
+    teqi(responses[1].status, 200);
+    teqi(responses[2].status, 200);
+    ttrue(responses[2].body && rGetBufLength(responses[2].body) == (size_t) rGetFileSize("site/size/1K.txt"));
+    teqi(responses[3].status, 200);
+    ttrue(bodyContains(&responses[3], "\"query\":{\"n\":7}"));
+    teqi(responses[4].status, 404);
+    teqi(responses[5].status, 200);
+    ttrue(responses[5].body && rGetBufLength(responses[5].body) == (size_t) rGetFileSize("site/size/10K.txt"));
+    freeResponses(responses);
+    rFreeBuf(frames);
+}
+
+static void testPost(void)
+{
+    Response responses[MAX_STREAMS];
+    RBuf     *frames, *headers;
+    cchar    *body;
+
+    /*
+        Request body in a DATA frame without a content length. The end of the stream ends the body.
+     */
+    body = "name=h2&x";
+    frames = rAllocBuf(0);
+    headers = requestHeaders("POST", "/test/form");
+    //  content-type (static index 31) literal without indexing
+    rPutCharToBuf(headers, 0x0f);
+    rPutCharToBuf(headers, 0x10);
+    rPutCharToBuf(headers, (char) slen("application/x-www-form-urlencoded"));
+    rPutStringToBuf(headers, "application/x-www-form-urlencoded");
+    putHeaders(frames, 1, headers, 0);
+    putFrame(frames, 0, 0x1, 1, body, slen(body));
+    ttrue(exchange(frames, responses, 1));
+    teqi(responses[0].status, 200);
+    ttrue(bodyContains(&responses[0], "h2"));
+    freeResponses(responses);
+    rFreeBuf(frames);
+}
+
+static void testWindowOverflow(void)
+{
+    Response responses[MAX_STREAMS];
+    RBuf     *frames;
+    uchar    increment[] = { 0x7f, 0xff, 0x00, 0x00 };
+    uchar    settings[] = { 0x00, 0x04, 0x00, 0x01, 0x00, 0x00 };
+
+    /*
+        Raise the window of an open stream to the maximum, then increase INITIAL_WINDOW_SIZE by one.
+        The stream window would exceed 2^31-1 which is a FLOW_CONTROL_ERROR (RFC 9113 6.9.2).
+     */
+    frames = rAllocBuf(0);
+    putHeaders(frames, 1, requestHeaders("POST", "/test/form"), 0);
+    putFrame(frames, 8, 0, 1, increment, sizeof(increment));
+    putFrame(frames, 4, 0, 0, settings, sizeof(settings));
+    ttrue(exchange(frames, responses, 1));
+    teqi(goaway, 0x3);
+    freeResponses(responses);
+    rFreeBuf(frames);
+}
+
+static void fiberMain(void *arg)
+{
+    WebHost *host;
+
+    if (setup(NULL, NULL) && (host = startHost("features.json5", &HTTP)) != 0) {
+        testGet();
+        testMultiplex();
+        testPost();
+        testWindowOverflow();
+        stopHost(host);
+    }
+    rFree(HTTP);
+    rStop();
+}
+
+int main(void)
+{
+    rInit(fiberMain, 0);
+    rServiceEvents();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
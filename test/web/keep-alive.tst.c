@@ -42,10 +42,45 @@ static void keepAliveTest(void)
     urlFree(up);
 }
 
+/*
+    Closed connections return their web object to the host pool for reuse by later connections
+ */
+static void poolTest(void)
+{
+    Url   *up;
+    Json  *json;
+    int64 hits, misses;
+    char  url[128];
+    int   i;
+
+    up = urlAlloc(0);
+    json = urlJson(up, "GET", SFMT(url, "%s/test/show", HTTP), NULL, 0, NULL);
+    hits = jsonGetNum(json, 0, "host.poolHits", -1);
+    misses = jsonGetNum(json, 0, "host.poolMisses", -1);
+    ttrue(hits >= 0);
+    ttrue(misses > 0);
+    ttrue(jsonGetInt(json, 0, "host.maxPool", -1) > 0);
+    jsonFree(json);
+
+    for (i = 0; i < 10; i++) {
+        urlClose(up);
+        json = urlJson(up, "GET", SFMT(url, "%s/test/show", HTTP), NULL, 0, NULL);
+        tnotnull(json);
+        jsonFree(json);
+    }
+    urlClose(up);
+    json = urlJson(up, "GET", SFMT(url, "%s/test/show", HTTP), NULL, 0, NULL);
+    ttrue(jsonGetNum(json, 0, "host.poolHits", -1) >= hits + 10);
+    ttrue(jsonGetInt(json, 0, "host.pool", -1) >= 0);
+    jsonFree(json);
+    urlFree(up);
+}
+
 static void fiberMain(void *arg)
 {
     if (setup(&HTTP, &HTTPS)) {
         keepAliveTest();
+        poolTest();
     }
     rFree(HTTP);
     rFree(HTTPS);
@@ -0,0 +1,210 @@
+/*
+    pipeline.tst.c - Unit tests for HTTP/1.1 request pipelining
+
+    Multiple requests are written to a keep-alive connection before any response is read.
+    Responses must be returned complete and in request order.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************** Includes **********************************/
+
+#include    "test.h"
+
+/*********************************** Locals ***********************************/
+
+static char *HTTP;
+static char *HTTPS;
+
+/************************************ Code ************************************/
+
+/*
+    Connect, write all the requests in one write and read the responses until the server closes the connection
+ */
+static char *pipeline(cchar *requests)
+{
+    RSocket *sock;
+    RBuf    *buf;
+    cchar   *host, *path, *query, *hash, *scheme;
+    char    *ubuf;
+    ssize   nbytes;
+    int     port;
+
+    if ((ubuf = webParseUrl(HTTP, &scheme, &host, &port, &path, &query, &hash)) == 0) {
+        return 0;
+    }
+    sock = rAllocSocket();
+    if (rConnectSocket(sock, host, port, rGetTicks() + 5000) < 0) {
+        rFreeSocket(sock);
+        rFree(ubuf);
+        return 0;
+    }
+    rFree(ubuf);
+    if (rWriteSocket(sock, requests, slen(requests), rGetTicks() + 5000) < 0) {
+        rFreeSocket(sock);
+        return 0;
+    }
+    buf = rAllocBuf(ME_BUFSIZE);
+    do {
+        rReserveBufSpace(buf, ME_BUFSIZE);
+        if ((nbytes = rReadSocket(sock, rGetBufEnd(buf), rGetBufSpace(buf), rGetTicks() + 5000)) > 0) {
+            rAdjustBufEnd(buf, nbytes);
+        }
+    } while (nbytes > 0);
+    rAddNullToBuf(buf);
+    rFreeSocket(sock);
+    return rBufToStringAndFree(buf);
+}
+
+/*
+    Expect a pattern in the response and return the position following it
+ */
+static cchar *expectAfter(cchar *response, cchar *pattern)
+{
+    cchar *cp;
+
+    if (!response || (cp = scontains(response, pattern)) == 0) {
+        ttrue(false, "Missing \"%s\" in pipelined response", pattern);
+        return 0;
+    }
+    return cp + slen(pattern);
+}
+
+static void testOrder(void)
+{
+    RBuf  *requests;
+    cchar *cp;
+    char  *response, pattern[80];
+    int   i;
+
+    /*
+        Dynamic responses (chunked) must be returned in request order
+     */
+    requests = rAllocBuf(0);
+    for (i = 1; i <= 5; i++) {
+        rPutToBuf(requests, "GET /test/show?n=%d HTTP/1.1\r\nHost: localhost\r\n%s\r\n", i,
+                  i == 5 ? "Connection: close\r\n" : "");
+    }
+    response = pipeline(rBufToString(requests));
+    tnotnull(response);
+    cp = response;
+    for (i = 1; i <= 5 && cp; i++) {
+        cp = expectAfter(cp, "HTTP/1.1 200 OK");
+        cp = expectAfter(cp, SFMT(pattern, "\"count\":%d,\"query\":{\"n\":%d}", i, i));
+    }
+    rFree(response);
+    rFreeBuf(requests);
+}
+
+static void testMixed(void)
+{
+    cchar *cp;
+    char  *response;
+
+    /*
+        A request with a body, a static file and an error response in one pipelined batch
+     */
+    response = pipeline(
+        "POST /test/form HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+        "Content-Length: 11\r\n\r\nname=pipe&x"
+        "GET /size/1K.txt HTTP/1.1\r\nHost: localhost\r\n\r\n"
+        "GET /not-found.html HTTP/1.1\r\nHost: localhost\r\n\r\n"
+        "GET /test/show?n=4 HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+    tnotnull(response);
+    cp = expectAfter(response, "HTTP/1.1 200 OK");
+    cp = expectAfter(cp, "pipe");
+    cp = expectAfter(cp, "HTTP/1.1 200 OK");
+    cp = expectAfter(cp, "Content-Length: ");
+    cp = expectAfter(cp, "HTTP/1.1 404");
+    cp = expectAfter(cp, "HTTP/1.1 200 OK");
+    expectAfter(cp, "\"query\":{\"n\":4}");
+    rFree(response);
+}
+
+static void testDepth(void)
+{
+    RBuf  *requests;
+    cchar *cp;
+    char  *response;
+    int   count, i;
+
+    /*
+        More responses than fit in a single corked write
+     */
+    requests = rAllocBuf(0);
+    for (i = 0; i < 64; i++) {
+        rPutToBuf(requests, "GET /size/1K.txt HTTP/1.1\r\nHost: localhost\r\n%s\r\n",
+                  i == 63 ? "Connection: close\r\n" : "");
+    }
+    response = pipeline(rBufToString(requests));
+    tnotnull(response);
+    count = 0;
+    for (cp = response; cp && (cp = scontains(cp, "HTTP/1.1 200 OK")) != 0; cp++) {
+        count++;
+    }
+    teqi(count, 64);
+    rFree(response);
+    rFreeBuf(requests);
+}
+
+static void testBlockingAction(void)
+{
+    RSocket *sock;
+    RBuf    *buf;
+    cchar   *host, *path, *query, *hash, *scheme, *requests;
+    char    *ubuf;
+    ssize   nbytes;
+    Ticks   deadline;
+    int     port;
+
+    /*
+        A finished response must not be held while a following pipelined action blocks
+     */
+    ubuf = webParseUrl(HTTP, &scheme, &host, &port, &path, &query, &hash);
+    tnotnull(ubuf);
+    sock = rAllocSocket();
+    teqi(rConnectSocket(sock, host, port, rGetTicks() + 5000), 0);
+    rFree(ubuf);
+    requests = "GET /size/1K.txt HTTP/1.1\r\nHost: localhost\r\n\r\n"
+               "GET /test/delay?delay=3000 HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+    ttrue(rWriteSocket(sock, requests, slen(requests), rGetTicks() + 5000) > 0);
+
+    buf = rAllocBuf(ME_BUFSIZE);
+    deadline = rGetTicks() + 1500;
+    do {
+        rReserveBufSpace(buf, ME_BUFSIZE);
+        if ((nbytes = rReadSocket(sock, rGetBufEnd(buf), rGetBufSpace(buf), deadline)) > 0) {
+            rAdjustBufEnd(buf, nbytes);
+            rAddNullToBuf(buf);
+        }
+    } while (nbytes > 0 && !scontains(rBufToString(buf), "END OF DOCUMENT"));
+    tnotnull(scontains(rBufToString(buf), "END OF DOCUMENT"));
+    tnull(scontains(rBufToString(buf), "delayed"));
+    rFreeBuf(buf);
+    rFreeSocket(sock);
+}
+
+static void fiberMain(void *arg)
+{
+    if (setup(&HTTP, &HTTPS)) {
+        testOrder();
+        testMixed();
+        testDepth();
+        testBlockingAction();
+    }
+    rFree(HTTP);
+    rFree(HTTPS);
+    rStop();
+}
+
+int main(void)
+{
+    rInit(fiberMain, 0);
+    rServiceEvents();
+    rTerm();
+}
+
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This is proprietary software and requires a commercial license from the author.
+ */
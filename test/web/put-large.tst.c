@@ -16,6 +16,8 @@
     - Concurrent PUTs
     - Empty file PUTs
     - Content-Length validation
+    - Multi-megabyte PUTs over HTTP (spliced to the file on Linux) and HTTPS with throughput
+    - Body data split between the header read and the spliced remainder
 
     Copyright (c) All Rights Reserved. See details at the end of the file.
  */
@@ -451,6 +453,149 @@ static void testPutContentLength(void)
     urlFree(up);
 }
 
+/*
+    Fill a buffer with a position dependent pattern so misplaced or dropped data is detected
+ */
+static char *makePattern(size_t size)
+{
+    char   *data;
+    size_t i;
+
+    data = rAlloc(size + 1);
+    for (i = 0; i < size; i++) {
+        data[i] = (char) ('a' + (i % 26) + (i / 4096) % 7);
+    }
+    data[size] = '\0';
+    return data;
+}
+
+static bool matchPutFile(cchar *filename, cchar *data, size_t size)
+{
+    char   path[256], *contents;
+    size_t len;
+    bool   match;
+
+    if ((contents = rReadFile(SFMT(path, "./site/upload/%s", filename), &len)) == 0) {
+        return 0;
+    }
+    match = len == size && memcmp(contents, data, size) == 0;
+    rFree(contents);
+    return match;
+}
+
+static void testPutMegabytes(void)
+{
+    Url    *up;
+    Ticks  start, elapsed;
+    char   url[128], filename[64], *data;
+    cchar  *base;
+    size_t size;
+    int    status, secure;
+
+    /*
+        Larger than the rx buffer so cleartext PUTs use the splice path. HTTPS uses the buffered path.
+     */
+    size = 8 * 1024 * 1024;
+    data = makePattern(size);
+
+    for (secure = 0; secure <= 1; secure++) {
+        base = secure ? HTTPS : HTTP;
+        up = urlAlloc(0);
+        SFMT(filename, "mb-%d-%d.dat", getpid(), secure);
+        start = rGetTicks();
+        status = urlFetch(up, "PUT", SFMT(url, "%s/upload/%s", base, filename), data, size,
+                          "Content-Type: application/octet-stream\r\n");
+        elapsed = max(rGetTicks() - start, 1);
+        ttrue(status == 201 || status == 204);
+        ttrue(matchPutFile(filename, data, size));
+        tinfo("PUT %zu MB over %s: %.1f MB/s", size / (1024 * 1024), secure ? "HTTPS" : "HTTP",
+              (size / (1024.0 * 1024.0)) / (elapsed / 1000.0));
+        urlClose(up);
+        urlFetch(up, "DELETE", url, NULL, 0, NULL);
+        urlFree(up);
+    }
+    rFree(data);
+}
+
+static void testPutSplitBody(void)
+{
+    RSocket *sock;
+    RBuf    *buf;
+    cchar   *host, *path, *query, *hash, *scheme;
+    char    *ubuf, filename[64], response[512], *data;
+    size_t  size, first;
+    ssize   nbytes;
+    int     port;
+
+    /*
+        Write the headers with the start of the body so part of the body is buffered with the headers and the
+        remainder is received separately
+     */
+    size = 1024 * 1024 + 77;
+    first = 1000;
+    data = makePattern(size);
+    SFMT(filename, "split-%d.dat", getpid());
+
+    ubuf = webParseUrl(HTTP, &scheme, &host, &port, &path, &query, &hash);
+    sock = rAllocSocket();
+    ttrue(rConnectSocket(sock, host, port, rGetTicks() + 5000) == 0);
+    rFree(ubuf);
+
+    buf = rAllocBuf(0);
+    rPutToBuf(buf, "PUT /upload/%s HTTP/1.1\r\nHost: localhost\r\nContent-Length: %zu\r\n"
+              "Connection: close\r\n\r\n", filename, size);
+    rPutBlockToBuf(buf, data, first);
+    ttrue(rWriteSocket(sock, rGetBufStart(buf), rGetBufLength(buf), rGetTicks() + 5000) > 0);
+    rSleep(20);
+    ttrue(rWriteSocket(sock, &data[first], size - first, rGetTicks() + 5000) == (ssize) (size - first));
+
+    nbytes = rReadSocket(sock, response, sizeof(response) - 1, rGetTicks() + 5000);
+    ttrue(nbytes > 0);
+    response[max(nbytes, 0)] = '\0';
+    ttrue(scontains(response, "HTTP/1.1 201") || scontains(response, "HTTP/1.1 204"));
+    ttrue(matchPutFile(filename, data, size));
+
+    unlink(SFMT(response, "./site/upload/%s", filename));
+    rFreeBuf(buf);
+    rFreeSocket(sock);
+    rFree(data);
+}
+
+static void testPutShortSplice(void)
+{
+#if ME_WEB_SPLICE
+    Url    *up;
+    char   url[128], filename[64], *data, *result;
+    size_t size;
+    int    status;
+
+    /*
+        Limit the server splice so the body is completed by buffered writes after a short splice.
+        The buffered writes must follow the spliced data in the file.
+     */
+    result = urlGet(SFMT(url, "%s/test/splice?limit=%d", HTTP, 64 * 1024), NULL);
+    tmatch(result, "65536\n");
+    rFree(result);
+
+    size = 1024 * 1024 + 33;
+    data = makePattern(size);
+    up = urlAlloc(0);
+    SFMT(filename, "short-%d.dat", getpid());
+    status = urlFetch(up, "PUT", SFMT(url, "%s/upload/%s", HTTP, filename), data, size,
+                      "Content-Type: application/octet-stream\r\n");
+    ttrue(status == 201 || status == 204);
+    ttrue(matchPutFile(filename, data, size));
+    urlClose(up);
+    urlFetch(up, "DELETE", url, NULL, 0, NULL);
+    urlFree(up);
+    rFree(data);
+
+    result = urlGet(SFMT(url, "%s/test/splice?limit=0", HTTP), NULL);
+    tmatch(result, "0\n");
+    rFree(result);
+#endif
+}
+
 static void fiberMain(void *data)
 {
     if (setup(&HTTP, &HTTPS)) {
@@ -464,6 +609,9 @@ static void fiberMain(void *data)
         testPutConcurrent();
         testPutEmpty();
         testPutContentLength();
+        testPutMegabytes();
+        testPutSplitBody();
+        testPutShortSplice();
     }
     rFree(HTTP);
     rFree(HTTPS);
@@ -150,6 +150,59 @@ static void testMultipleSessions()
     urlFree(up2);
 }
 
+/*
+    Sessions are written through to the session store and reloaded after being flushed from memory
+ */
+static void testSessionStore()
+{
+    Url   *up;
+    char  *token, *cookie, url[128];
+    int   status;
+
+    up = urlAlloc(0);
+
+    //  The test session store is only used by this test
+    status = urlFetch(up, "GET", SFMT(url, "%s/test/session/store/enable", HTTP), NULL, 0, NULL);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "enabled");
+
+    urlClose(up);
+    status = urlFetch(up, "GET", SFMT(url, "%s/test/session/create", HTTP), NULL, 0, NULL);
+    teqi(status, 200);
+    token = sclone(urlGetResponse(up));
+    cookie = sclone(urlGetCookie(up, WEB_SESSION_COOKIE));
+    tnotnull(cookie);
+
+    //  Emulate a restart by discarding all in-memory sessions
+    urlClose(up);
+    status = urlFetch(up, "GET", SFMT(url, "%s/test/session/flush", HTTP), NULL, 0, NULL);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "flushed");
+
+    //  The session should be reloaded from the store
+    urlClose(up);
+    status = urlFetch(up, "GET", SFMT(url, "%s/test/session/check?%s", HTTP, token), NULL, 0,
+                      "Cookie: %s=%s\r\n", WEB_SESSION_COOKIE, cookie);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "success");
+
+    //  Without the store, flushed sessions are lost
+    urlClose(up);
+    status = urlFetch(up, "GET", SFMT(url, "%s/test/session/store/disable", HTTP), NULL, 0, NULL);
+    teqi(status, 200);
+    urlClose(up);
+    teqi(urlFetch(up, "GET", SFMT(url, "%s/test/session/flush", HTTP), NULL, 0, NULL), 200);
+    urlClose(up);
+    status = urlFetch(up, "GET", SFMT(url, "%s/test/session/check?%s", HTTP, token), NULL, 0,
+                      "Cookie: %s=%s\r\n", WEB_SESSION_COOKIE, cookie);
+    teqi(status, 200);
+    tmatch(urlGetResponse(up), "token mismatch");
+
+    rFree(token);
+    rFree(cookie);
+    urlFree(up);
+}
+
 static void fiberMain(void *arg)
 {
     if (setup(&HTTP, &HTTPS)) {
@@ -157,6 +210,7 @@ static void fiberMain(void *arg)
         testSessionPersistence();
         testSessionCookieAttributes();
         testMultipleSessions();
+        testSessionStore();
     }
     rFree(HTTP);
     rFree(HTTPS);
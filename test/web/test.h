@@ -48,3 +48,46 @@ PUBLIC bool setup(char **HTTP, char **HTTPS)
     }
     return 1;
 }
+
+/*
+    Start an in-process host using the given config file and return its first listen endpoint in *endpoint.
+    Used by tests of features that are not enabled in web.json5. Stop the host via stopHost.
+ */
+PUBLIC WebHost *startHost(cchar *path, char **endpoint)
+{
+    WebHost *host;
+    Json    *config;
+
+    if ((config = jsonParseFile(path, NULL, 0)) == 0) {
+        tfail("Cannot parse host config");
+        return 0;
+    }
+    webInit();
+    if ((host = webAllocHost(config, 0)) == 0) {
+        tfail("Cannot allocate host");
+        jsonFree(config);
+        return 0;
+    }
+    webTestInit(host, "/test");
+    if (webStartHost(host) < 0) {
+        tfail("Cannot start host");
+        webFreeHost(host);
+        jsonFree(config);
+        return 0;
+    }
+    *endpoint = jsonGetClone(config, 0, "web.listen[0]", NULL);
+    return host;
+}
+
+PUBLIC void stopHost(WebHost *host)
+{
+    Json *config;
+
+    if (host) {
+        config = host->config;
+        webStopHost(host);
+        webFreeHost(host);
+        jsonFree(config);
+        webTerm();
+    }
+}